@@ -1,14 +1,26 @@
 ﻿#include "AbilitySystem/ActionComponent.h"
 #include "AbilitySystem/ActionAgentInterface.h"
 #include "AbilitySystem/ActionCueLibrary.h"
+#include "AbilitySystem/ActionEffectBatch.h"
+#include "AbilitySystem/ActionExecutionSubsystem.h"
 #include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatEncounter.h"
 #include "AbilitySystem/CombatSubsystem.h"
+#include "AbilitySystem/CombatVisibilityGrid.h"
 #include "AbilitySystem/ProdigyAbilityUtils.h"
 #include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/StatusComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
 
 UActionComponent::UActionComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+
+	// Only while exploration cooldowns are pending (see ScheduleCooldownExpiry)
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UActionComponent::OnRegister()
@@ -70,14 +82,20 @@ void UActionComponent::OnTurnBegan()
 		}
 	}
 
-	// --- decrement combat cooldowns ---
-	for (auto& KVP : Cooldowns)
+	// --- decrement combat cooldowns (one pass over the dense array) ---
+	++CooldownsRevision;
+
+	TArray<int32, TInlineAllocator<8>> ReadySlots;
+	for (int32 Slot = 0; Slot < CooldownTurns.Num(); ++Slot)
 	{
-		FActionCooldownState& S = KVP.Value;
-		if (S.TurnsRemaining > 0)
-		{
-			--S.TurnsRemaining;
-		}
+		int32& Turns = CooldownTurns[Slot];
+		if (Turns == 1) ReadySlots.Add(Slot);
+		Turns = FMath::Max(0, Turns - 1);
+	}
+
+	for (const int32 Slot : ReadySlots)
+	{
+		OnCooldownChanged.Broadcast(GetActionTagForSlot(Slot), true);
 	}
 
 	if (UAttributesComponent* Attr = OwnerActor->FindComponentByClass<UAttributesComponent>())
@@ -85,6 +103,12 @@ void UActionComponent::OnTurnBegan()
 		Attr->TickTurnEffects(OwnerActor);
 	}
 
+	// Turn-based status durations (headless combat core ticks them at the same point)
+	if (UStatusComponent* Status = OwnerActor->FindComponentByClass<UStatusComponent>())
+	{
+		Status->TickStartOfTurn();
+	}
+
 	ACTION_LOG(Log, TEXT("OnTurnBegan: cooldown turns decremented"));
 }
 
@@ -106,11 +130,47 @@ bool UActionComponent::TryGetActionDefinition(FGameplayTag ActionTag, UActionDef
 TArray<FGameplayTag> UActionComponent::GetKnownActionTags() const
 {
 	TArray<FGameplayTag> Out;
-	Out.Reserve(ActionMap.Num());
+	Out.Reserve(SlotDefinitions.Num());
 
-	for (const auto& Pair : ActionMap)
+	for (const UActionDefinition* Def : SlotDefinitions)
 	{
-		Out.Add(Pair.Key);
+		Out.Add(Def->ActionTag);
+	}
+	return Out;
+}
+
+int32 UActionComponent::GetCooldownTurnsRemaining(FGameplayTag ActionTag) const
+{
+	const int32 Slot = FindActionSlot(ActionTag);
+	return Slot != INDEX_NONE ? CooldownTurns[Slot] : 0;
+}
+
+int32 UActionComponent::FindActionSlot(FGameplayTag ActionTag) const
+{
+	const int32* Slot = ActionSlots.Find(ActionTag);
+	return Slot ? *Slot : INDEX_NONE;
+}
+
+FGameplayTag UActionComponent::GetActionTagForSlot(int32 Slot) const
+{
+	return SlotDefinitions.IsValidIndex(Slot) ? SlotDefinitions[Slot]->ActionTag : FGameplayTag();
+}
+
+bool UActionComponent::IsSlotOnCooldown(int32 Slot, float Now) const
+{
+	return CooldownTurns[Slot] > 0 || (CooldownEndTimes[Slot] > 0.f && Now < CooldownEndTimes[Slot]);
+}
+
+TMap<FGameplayTag, FActionCooldownState> UActionComponent::GetCooldowns() const
+{
+	TMap<FGameplayTag, FActionCooldownState> Out;
+	for (int32 Slot = 0; Slot < SlotDefinitions.Num(); ++Slot)
+	{
+		if (CooldownTurns[Slot] <= 0 && CooldownEndTimes[Slot] <= 0.f) continue;
+
+		FActionCooldownState& S = Out.Add(GetActionTagForSlot(Slot));
+		S.TurnsRemaining = CooldownTurns[Slot];
+		S.CooldownEndTime = CooldownEndTimes[Slot];
 	}
 	return Out;
 }
@@ -122,22 +182,43 @@ void UActionComponent::BeginPlay()
 
 void UActionComponent::BuildMapIfNeeded()
 {
-	ActionMap.Reset();
+	ActionSlots.Reset();
+	SlotDefinitions.Reset();
+
 	for (UActionDefinition* Def : KnownActions)
 	{
 		if (!IsValid(Def)) continue;
 		if (!Def->ActionTag.IsValid()) continue;
-		ActionMap.Add(Def->ActionTag, Def);
+
+		// Duplicate tag: the later definition wins, the slot stays
+		if (const int32* Existing = ActionSlots.Find(Def->ActionTag))
+		{
+			SlotDefinitions[*Existing] = Def;
+			continue;
+		}
+
+		ActionSlots.Add(Def->ActionTag, SlotDefinitions.Add(Def));
 	}
+
+	CooldownTurns.Init(0, SlotDefinitions.Num());
+	CooldownEndTimes.Init(0.f, SlotDefinitions.Num());
+	CooldownWheel.Reset();
+	++CooldownsRevision;
 }
 
 const UActionDefinition* UActionComponent::FindDef(FGameplayTag Tag) const
 {
-	if (const TObjectPtr<UActionDefinition>* Found = ActionMap.Find(Tag))
-	{
-		return Found->Get();
-	}
-	return nullptr;
+	const int32 Slot = FindActionSlot(Tag);
+	return Slot != INDEX_NONE ? SlotDefinitions[Slot].Get() : nullptr;
+}
+
+void UActionComponent::ScheduleCooldownExpiry(int32 Slot)
+{
+	const UWorld* World = GetWorld();
+	if (!World) return;
+
+	CooldownWheel.Schedule(Slot, World->GetTimeSeconds(), CooldownEndTimes[Slot]);
+	SetComponentTickEnabled(true);
 }
 
 void UActionComponent::SetInCombat(bool bNowInCombat)
@@ -152,22 +233,34 @@ void UActionComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// No per-frame cooldown ticking anymore:
-	// - Exploration cooldowns are based on CooldownEndTime vs World Time
-	// - Combat cooldowns decrement on turn events (OnTurnBegan)
-}
+	// Only ticks while exploration cooldowns are pending (combat ones decrement in OnTurnBegan)
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
 
+	TArray<int32, TInlineAllocator<8>> Expired;
+	CooldownWheel.Advance(Now, Expired);
 
-bool UActionComponent::PassesTagGates(AActor* Instigator, const UActionDefinition* Def,
-                                      EActionFailReason& OutFail) const
-{
-	if (!IsValid(Instigator) || !Def) return false;
+	for (const int32 Slot : Expired)
+	{
+		// Restarted since this entry was scheduled (its own entry comes later)
+		if (!CooldownEndTimes.IsValidIndex(Slot) || CooldownEndTimes[Slot] <= 0.f || Now < CooldownEndTimes[Slot]) continue;
 
-	FGameplayTagContainer Owned;
-	if (Instigator->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass()))
+		CooldownEndTimes[Slot] = 0.f;
+		++CooldownsRevision;
+
+		OnCooldownChanged.Broadcast(GetActionTagForSlot(Slot), true);
+	}
+
+	if (CooldownWheel.IsEmpty())
 	{
-		IActionAgentInterface::Execute_GetOwnedGameplayTags(Instigator, Owned);
+		SetComponentTickEnabled(false);
 	}
+}
+
+
+bool UActionComponent::PassesTagGates(const FGameplayTagContainer& Owned, const UActionDefinition* Def,
+                                      EActionFailReason& OutFail)
+{
+	if (!Def) return false;
 
 	// Blocked wins
 	for (const FGameplayTag& T : Def->BlockedTags)
@@ -219,10 +312,98 @@ bool UActionComponent::IsTargetValid(const UActionDefinition* Def, const FAction
 	}
 }
 
+bool UActionComponent::PassesRangeAndSight(const UActionDefinition* Def, const FActionContext& Context, FQueryInputs& Inputs, EActionFailReason& OutFail) const
+{
+	if (!Def || (Def->MaxRange <= 0.f && Def->MinRange <= 0.f && !Def->bRequiresLineOfSight)) return true;
+	if (!IsValid(Context.Instigator)) return true;
+
+	FVector TargetLocation;
+	switch (Def->TargetingMode)
+	{
+	case EActionTargetingMode::Unit:
+		if (Context.TargetActor == Context.Instigator) return true;
+		TargetLocation = Context.TargetActor->GetActorLocation();
+		break;
+
+	case EActionTargetingMode::Point:
+		TargetLocation = Context.TargetLocation;
+		break;
+
+	default:
+		return true;
+	}
+
+	const FVector From = Context.Instigator->GetActorLocation();
+
+	if (!ProdigyCombatCore::IsInRange(FVector::Dist2D(From, TargetLocation), Def->MinRange, Def->MaxRange))
+	{
+		OutFail = EActionFailReason::OutOfRange;
+		return false;
+	}
+
+	if (Def->bRequiresLineOfSight)
+	{
+		if (!Inputs.bEncounterResolved)
+		{
+			Inputs.bEncounterResolved = true;
+			if (bInCombat)
+			{
+				const UGameInstance* GI = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+				const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+				Inputs.Encounter = Combat ? Combat->FindEncounterObjectForActor(Context.Instigator) : nullptr;
+			}
+		}
+
+		const UCombatEncounter* Encounter = Inputs.Encounter;
+		if (!ProdigyCombatVisibility::HasLineOfSight(GetWorld(), Encounter ? Encounter->GetVisibilityGrid() : nullptr, From, TargetLocation))
+		{
+			OutFail = EActionFailReason::NoLineOfSight;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UActionComponent::GatherQueryInputs(const FActionContext& Context, FQueryInputs& Out) const
+{
+	Out.Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+
+	AActor* Instigator = Context.Instigator;
+	Out.bInstigatorIsAgent = IsValid(Instigator) && Instigator->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass());
+	if (!Out.bInstigatorIsAgent) return;
+
+	IActionAgentInterface::Execute_GetOwnedGameplayTags(Instigator, Out.OwnedTags);
+
+	if (bInCombat)
+	{
+		Out.CurrentAP = IActionAgentInterface::Execute_GetAttributeCurrentValue(Instigator, ProdigyTags::Attr::AP);
+	}
+}
+
 FActionQueryResult UActionComponent::QueryAction(FGameplayTag ActionTag, const FActionContext& Context) const
 {
 	FActionQueryResult R;
+	QueryActions(MakeArrayView(&ActionTag, 1), Context, MakeArrayView(&R, 1));
+	return R;
+}
+
+void UActionComponent::QueryActions(TConstArrayView<FGameplayTag> ActionTags, const FActionContext& Context, TArrayView<FActionQueryResult> OutResults) const
+{
+	check(OutResults.Num() == ActionTags.Num());
 
+	FQueryInputs Inputs;
+	GatherQueryInputs(Context, Inputs);
+
+	for (int32 i = 0; i < ActionTags.Num(); ++i)
+	{
+		OutResults[i] = QueryWithInputs(ActionTags[i], Context, Inputs);
+	}
+}
+
+FActionQueryResult UActionComponent::QueryWithInputs(FGameplayTag ActionTag, const FActionContext& Context, FQueryInputs& Inputs) const
+{
+	FActionQueryResult R;
 
 	const UActionDefinition* Def = FindDef(ActionTag);
 	if (!Def)
@@ -247,41 +428,35 @@ FActionQueryResult UActionComponent::QueryAction(FGameplayTag ActionTag, const F
 	if (!R.bTargetValid)
 	{
 		R.FailReason = EActionFailReason::InvalidTarget;
+		return R;
+	}
 
-		UActionCueLibrary::PlayInvalidTargetCue(GetWorld(), GetOwner());
-		
+	// Range / line of sight
+	EActionFailReason SpatialFail = EActionFailReason::None;
+	if (!PassesRangeAndSight(Def, Context, Inputs, SpatialFail))
+	{
+		R.FailReason = SpatialFail;
 		return R;
 	}
 
 	// Tag gates
 	EActionFailReason GateFail = EActionFailReason::None;
-	if (!PassesTagGates(Context.Instigator, Def, GateFail))
+	if (!IsValid(Context.Instigator) || !PassesTagGates(Inputs.OwnedTags, Def, GateFail))
 	{
 		R.FailReason = GateFail;
 		return R;
 	}
 
 	// Cooldown
-	if (const FActionCooldownState* S = Cooldowns.Find(ActionTag))
+	const int32 Slot = FindActionSlot(ActionTag);
+	if (IsSlotOnCooldown(Slot, Inputs.Now))
 	{
-		const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
-
-		if (S->IsOnCooldown(Now))
-		{
-			R.FailReason = EActionFailReason::OnCooldown;
-
-			// UI preview
-			R.CooldownTurns = S->TurnsRemaining;
-			R.CooldownSeconds = S->GetSecondsRemaining(Now);
+		R.FailReason = EActionFailReason::OnCooldown;
 
-			ACTION_LOG(Log, TEXT("Query BLOCK Tag=%s Reason=Cooldown Turns=%d Sec=%.2f"),
-			           *ActionTag.ToString(),
-			           S->TurnsRemaining,
-			           R.CooldownSeconds
-			);
-
-			return R;
-		}
+		// UI preview
+		R.CooldownTurns = CooldownTurns[Slot];
+		R.CooldownSeconds = CooldownEndTimes[Slot] > 0.f ? FMath::Max(0.f, CooldownEndTimes[Slot] - Inputs.Now) : 0.f;
+		return R;
 	}
 
 	// Costs
@@ -290,22 +465,10 @@ FActionQueryResult UActionComponent::QueryAction(FGameplayTag ActionTag, const F
 		R.APCost = Def->Combat.APCost;
 		R.CooldownTurns = Def->Combat.CooldownTurns;
 
-		if (R.APCost > 0)
+		if (R.APCost > 0 && (!Inputs.bInstigatorIsAgent || Inputs.CurrentAP < (float)R.APCost))
 		{
-			if (!IsValid(Context.Instigator) || !Context.Instigator->GetClass()->ImplementsInterface(
-				UActionAgentInterface::StaticClass()))
-			{
-				R.FailReason = EActionFailReason::InsufficientAP;
-				return R;
-			}
-
-			const FGameplayTag APTag = ProdigyTags::Attr::AP;
-			const float CurAP = IActionAgentInterface::Execute_GetAttributeCurrentValue(Context.Instigator, APTag);
-			if (CurAP < (float)R.APCost)
-			{
-				R.FailReason = EActionFailReason::InsufficientAP;
-				return R;
-			}
+			R.FailReason = EActionFailReason::InsufficientAP;
+			return R;
 		}
 	}
 	else
@@ -314,17 +477,6 @@ FActionQueryResult UActionComponent::QueryAction(FGameplayTag ActionTag, const F
 	}
 
 	R.bCanExecute = true;
-
-	UE_LOG(LogActionExec, Verbose,
-	       TEXT("[ActionComp:%s] Query OK Tag=%s Mode=%s APCost=%d CDTurns=%d CDSec=%.2f"),
-	       *GetNameSafe(GetOwner()),
-	       *ActionTag.ToString(),
-	       bInCombat ? TEXT("Combat") : TEXT("Exploration"),
-	       R.APCost,
-	       R.CooldownTurns,
-	       R.CooldownSeconds
-	);
-
 	return R;
 }
 
@@ -332,35 +484,101 @@ void UActionComponent::StartCooldown(const UActionDefinition* Def)
 {
 	if (!Def) return;
 
-	FActionCooldownState& S = Cooldowns.FindOrAdd(Def->ActionTag);
+	const int32 Slot = FindActionSlot(Def->ActionTag);
+	if (Slot == INDEX_NONE) return;
+
+	++CooldownsRevision;
+
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
 
 	if (bInCombat)
 	{
-		const int32 Planned = FMath::Max(0, Def->Combat.CooldownTurns);
-		S.TurnsRemaining = Planned;
+		CooldownTurns[Slot] = FMath::Max(0, Def->Combat.CooldownTurns);
 
 		// Clear realtime
-		S.CooldownEndTime = 0.f;
+		CooldownEndTimes[Slot] = 0.f;
 
 		ACTION_LOG(Log, TEXT("StartCooldown Combat: Tag=%s Turns=%d"),
-		           *Def->ActionTag.ToString(), S.TurnsRemaining);
+		           *Def->ActionTag.ToString(), CooldownTurns[Slot]);
 	}
 	else
 	{
-		// Realtime (absolute time)
-		const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
-		S.CooldownEndTime = Now + FMath::Max(0.f, Def->Exploration.CooldownSeconds);
+		// Realtime (absolute time); the wheel says when it's over
+		const float Seconds = FMath::Max(0.f, Def->Exploration.CooldownSeconds);
+		CooldownEndTimes[Slot] = Seconds > 0.f ? Now + Seconds : 0.f;
 
 		// Clear turn-based
-		S.TurnsRemaining = 0;
+		CooldownTurns[Slot] = 0;
+
+		if (Seconds > 0.f)
+		{
+			ScheduleCooldownExpiry(Slot);
+		}
 
 		ACTION_LOG(Log, TEXT("StartCooldown Explore: Tag=%s End=%.2f (Now=%.2f, Sec=%.2f)"),
-		           *Def->ActionTag.ToString(), S.CooldownEndTime, Now, Def->Exploration.CooldownSeconds);
+		           *Def->ActionTag.ToString(), CooldownEndTimes[Slot], Now, Def->Exploration.CooldownSeconds);
+	}
+
+	if (IsSlotOnCooldown(Slot, Now))
+	{
+		OnCooldownChanged.Broadcast(Def->ActionTag, false);
+	}
+}
+
+void UActionComponent::RestoreCooldowns(const TMap<FGameplayTag, FActionCooldownState>& InCooldowns)
+{
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+
+	TArray<bool, TInlineAllocator<16>> WasOnCooldown;
+	WasOnCooldown.SetNumUninitialized(SlotDefinitions.Num());
+	for (int32 Slot = 0; Slot < SlotDefinitions.Num(); ++Slot)
+	{
+		WasOnCooldown[Slot] = IsSlotOnCooldown(Slot, Now);
+	}
+
+	CooldownTurns.Init(0, SlotDefinitions.Num());
+	CooldownEndTimes.Init(0.f, SlotDefinitions.Num());
+	CooldownWheel.Reset();
+
+	for (const TPair<FGameplayTag, FActionCooldownState>& Pair : InCooldowns)
+	{
+		const int32 Slot = FindActionSlot(Pair.Key);
+		if (Slot == INDEX_NONE) continue;
+
+		CooldownTurns[Slot] = FMath::Max(0, Pair.Value.TurnsRemaining);
+		CooldownEndTimes[Slot] = Pair.Value.CooldownEndTime;
+
+		if (CooldownEndTimes[Slot] > Now)
+		{
+			ScheduleCooldownExpiry(Slot);
+		}
+		else
+		{
+			CooldownEndTimes[Slot] = 0.f;
+		}
+	}
+	++CooldownsRevision;
+
+	for (int32 Slot = 0; Slot < SlotDefinitions.Num(); ++Slot)
+	{
+		const bool bOnCooldown = IsSlotOnCooldown(Slot, Now);
+		if (bOnCooldown != WasOnCooldown[Slot])
+		{
+			OnCooldownChanged.Broadcast(GetActionTagForSlot(Slot), !bOnCooldown);
+		}
 	}
 }
 
 bool UActionComponent::ExecuteAction(FGameplayTag ActionTag, const FActionContext& Context)
 {
+	FActionExecutionHandle Handle;
+	return ExecuteActionTracked(ActionTag, Context, Handle);
+}
+
+bool UActionComponent::ExecuteActionTracked(FGameplayTag ActionTag, const FActionContext& Context, FActionExecutionHandle& OutHandle)
+{
+	OutHandle = FActionExecutionHandle();
+
 	ACTION_LOG(Log,
 	           TEXT("ExecuteAction START Tag=%s Instigator=%s Target=%s InCombat=%d"),
 	           *ActionTag.ToString(),
@@ -388,7 +606,12 @@ bool UActionComponent::ExecuteAction(FGameplayTag ActionTag, const FActionContex
 
 		ACTION_LOG(Log, TEXT("ExecuteAction BLOCKED: Reason=%s APCost=%d CDTurns=%d CDSec=%.2f"),
 			*ReasonStr, Q.APCost, Q.CooldownTurns, Q.CooldownSeconds);
-		
+
+		// Failure feedback lives here, not in QueryAction (UI refreshes query every button)
+		if (Q.FailReason == EActionFailReason::InvalidTarget)
+		{
+			UActionCueLibrary::PlayInvalidTargetCue(GetWorld(), GetOwner());
+		}
 		return false;
 	}
 
@@ -422,20 +645,22 @@ bool UActionComponent::ExecuteAction(FGameplayTag ActionTag, const FActionContex
 		}
 	}
 
-	// Apply effects
-	int32 AppliedEffects = 0;
-	for (const UActionEffect* E : Def->Effects)
+	// Who gets hit: everyone in the area, else the single target
+	FActionContext Ctx = Context;
+	TArray<AActor*, TInlineAllocator<16>> Targets;
+	if (Def->Area.IsArea())
 	{
-		if (!IsValid(E)) continue;
+		TArray<AActor*> AreaTargets;
+		ResolveAreaTargets(Def, Context, AreaTargets);
 
-		const bool bOk = E->Apply(Context);
-		AppliedEffects++;
+		Ctx.AreaTargets.Append(AreaTargets);
+		Targets.Append(AreaTargets);
 
-		ACTION_LOG(Verbose,
-		           TEXT("Effect Applied: %s Result=%d"),
-		           *GetNameSafe(E),
-		           bOk ? 1 : 0
-		);
+		ACTION_LOG(Log, TEXT("Area resolved: Shape=%d Targets=%d"), (int32)Def->Area.Shape, Targets.Num());
+	}
+	else if (IsValid(Context.TargetActor))
+	{
+		Targets.Add(Context.TargetActor);
 	}
 
 	ACTION_LOG(Log,
@@ -447,12 +672,122 @@ bool UActionComponent::ExecuteAction(FGameplayTag ActionTag, const FActionContex
 
 	StartCooldown(Def);
 
+	// Windup / impacts / projectiles / recovery; the AI turn moves on once it completes (OnActionExecuted)
+	if (UActionExecutionSubsystem* Executor = GetWorld() ? GetWorld()->GetSubsystem<UActionExecutionSubsystem>() : nullptr)
+	{
+		OutHandle = Executor->Execute(this, Def, Ctx, Targets);
+
+		if (OutHandle.IsValid())
+		{
+			ACTION_LOG(Log, TEXT("ExecuteAction STARTED Tag=%s Targets=%d"), *ActionTag.ToString(), Targets.Num());
+		}
+		return true;
+	}
+
+	ApplyActionImpact(Def, Ctx, Targets);
+	FinishAction(Def, Ctx);
+	return true;
+}
+
+void UActionComponent::ApplyActionImpact(const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets)
+{
+	if (!Def) return;
+
+	// Apply effects: the definition's compiled program into one batch for the whole impact
+	// (attribute writes, cues and world events each go out once)
+	FActionEffectBatch Batch;
+	const int32 AppliedEffects = Def->GetProgram().Execute(Context, Targets, Batch);
+
+	Batch.Flush(GetWorld());
+
 	ACTION_LOG(Log,
-	           TEXT("ExecuteAction SUCCESS Tag=%s Effects=%d CooldownStarted"),
-	           *ActionTag.ToString(),
-	           AppliedEffects
+	           TEXT("ExecuteAction IMPACT Tag=%s Effects=%d Targets=%d"),
+	           *Def->ActionTag.ToString(),
+	           AppliedEffects,
+	           Targets.Num()
 	);
+}
 
-	OnActionExecuted.Broadcast(ActionTag, Context);
-	return true;
+void UActionComponent::FinishAction(const UActionDefinition* Def, const FActionContext& Context)
+{
+	if (!Def) return;
+
+	ACTION_LOG(Log, TEXT("ExecuteAction SUCCESS Tag=%s"), *Def->ActionTag.ToString());
+
+	OnActionExecuted.Broadcast(Def->ActionTag, Context);
+}
+
+void UActionComponent::ResolveAreaTargets(const UActionDefinition* Def, const FActionContext& Context, TArray<AActor*>& Out) const
+{
+	AActor* Instigator = Context.Instigator;
+	if (!IsValid(Instigator)) return;
+
+	// Aim point: explicit location, else the target unit, else straight ahead
+	FVector TargetPoint = Instigator->GetActorLocation() + Instigator->GetActorForwardVector() * Def->Area.Range;
+	if (!Context.TargetLocation.IsNearlyZero())
+	{
+		TargetPoint = Context.TargetLocation;
+	}
+	else if (IsValid(Context.TargetActor))
+	{
+		TargetPoint = Context.TargetActor->GetActorLocation();
+	}
+
+	const FActionAreaQuery Query = FActionAreaQuery::Make(Def->Area, Instigator->GetActorLocation(), Instigator->GetActorForwardVector(), TargetPoint);
+
+	// In combat the encounter roster is the candidate set
+	UWorld* World = GetWorld();
+	UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	UCombatSubsystem* CombatSubsystem = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	if (const UCombatEncounter* Encounter = CombatSubsystem ? CombatSubsystem->FindEncounterObjectForActor(Instigator) : nullptr)
+	{
+		Encounter->QueryArea(Query, Def->Area, Instigator, Out);
+		return;
+	}
+
+	// Exploration: one pawn overlap around the shape's bounds, then the exact shape test
+	if (!World) return;
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(ActionAreaQuery), false);
+	World->OverlapMultiByObjectType(Overlaps, Query.GetBoundsCenter(), FQuat::Identity,
+		FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Query.GetBoundsRadius()), Params);
+
+	const int32 InstigatorTeam = ProdigyCombatCore::ResolveTeamForActor(Instigator);
+
+	TArray<FActionAreaHit, TInlineAllocator<16>> Hits;
+	for (const FOverlapResult& O : Overlaps)
+	{
+		AActor* A = O.GetActor();
+		if (!IsValid(A) || Hits.ContainsByPredicate([A](const FActionAreaHit& H) { return H.Actor == A; })) continue;
+		if (!A->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass())) continue;
+		if (ProdigyAbilityUtils::IsDeadByAttributes(A)) continue;
+
+		if (A == Instigator)
+		{
+			if (!Def->Area.bAffectsInstigator) continue;
+		}
+		else if (!Def->Area.AffectsTeam(InstigatorTeam, ProdigyCombatCore::ResolveTeamForActor(A)))
+		{
+			continue;
+		}
+
+		float Distance = 0.f;
+		if (Query.Contains(A->GetActorLocation(), A->GetSimpleCollisionRadius(), Distance))
+		{
+			Hits.Add({ A, Distance });
+		}
+	}
+
+	// The instigator's own capsule is rarely in its overlap (self radius/cone), add it explicitly
+	if (Def->Area.bAffectsInstigator && !Hits.ContainsByPredicate([Instigator](const FActionAreaHit& H) { return H.Actor == Instigator; }))
+	{
+		float Distance = 0.f;
+		if (Query.Contains(Instigator->GetActorLocation(), Instigator->GetSimpleCollisionRadius(), Distance))
+		{
+			Hits.Add({ Instigator, Distance });
+		}
+	}
+
+	ActionArea::FinishHits(Hits, Def->Area.MaxTargets, Out);
 }
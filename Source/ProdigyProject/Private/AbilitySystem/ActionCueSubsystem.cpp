@@ -71,6 +71,12 @@ void UActionCueSubsystem::PlayCue(const FGameplayTag& CueTag, const FActionCueCo
 		return;
 	}
 
+	if (CoalesceDepth > 0)
+	{
+		CoalesceCue(CueTag, Ctx);
+		return;
+	}
+
 	UWorld* World = GetWorld();
 	if (!World)
 	{
@@ -224,6 +230,68 @@ void UActionCueSubsystem::PlayCue(const FGameplayTag& CueTag, const FActionCueCo
 }
 
 
+void UActionCueSubsystem::PlayCueBatch(TConstArrayView<FActionCueBatchEntry> Entries)
+{
+	if (Entries.Num() == 0) return;
+
+	const UActionCueSettings* Settings = GetDefault<UActionCueSettings>();
+
+	// Nested batches (a cue triggering gameplay) keep the outer set
+	const bool bWasInBatch = bInCueBatch;
+	if (!bWasInBatch)
+	{
+		BatchGlobalCueSet = Settings ? LoadCueSetSoft(Settings->GlobalCueSet) : nullptr;
+		bInCueBatch = true;
+	}
+
+	for (const FActionCueBatchEntry& E : Entries)
+	{
+		PlayCue(E.CueTag, E.Context);
+	}
+
+	if (!bWasInBatch)
+	{
+		bInCueBatch = false;
+		BatchGlobalCueSet = nullptr;
+	}
+}
+
+void UActionCueSubsystem::BeginCoalesce()
+{
+	++CoalesceDepth;
+}
+
+void UActionCueSubsystem::EndCoalesce()
+{
+	if (CoalesceDepth <= 0) return;
+	if (--CoalesceDepth > 0) return;
+
+	const TArray<FActionCueBatchEntry> Cues = MoveTemp(CoalescedCues);
+	CoalescedCues.Reset();
+
+	UE_LOG(LogActionCue, Log, TEXT("[Cue] Coalesced playback: %d cues"), Cues.Num());
+	PlayCueBatch(Cues);
+}
+
+void UActionCueSubsystem::CoalesceCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx)
+{
+	for (FActionCueBatchEntry& E : CoalescedCues)
+	{
+		if (E.CueTag != CueTag || E.Context.TargetActor != Ctx.TargetActor) continue;
+
+		// Latest context, but "alive before the first hit" and the total damage (killing-blow gating)
+		const float HPBefore = E.Context.TargetHPBefore;
+		const float Damage = E.Context.AppliedDamage + Ctx.AppliedDamage;
+
+		E.Context = Ctx;
+		E.Context.TargetHPBefore = HPBefore >= 0.f ? HPBefore : Ctx.TargetHPBefore;
+		E.Context.AppliedDamage = Damage;
+		return;
+	}
+
+	CoalescedCues.Add({ CueTag, Ctx });
+}
+
 bool UActionCueSubsystem::ResolveCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx, FActionCueDef& OutDef) const
 {
 	if (UActionCueSet* Set = ResolveCueSet(CueTag, Ctx))
@@ -395,7 +463,7 @@ UActionCueSet* UActionCueSubsystem::ResolveCueSet(const FGameplayTag& CueTag, co
 	const UActionCueSettings* Settings = GetDefault<UActionCueSettings>();
 	if (Settings)
 	{
-		if (UActionCueSet* GlobalSet = LoadCueSetSoft(Settings->GlobalCueSet))
+		if (UActionCueSet* GlobalSet = bInCueBatch ? BatchGlobalCueSet.Get() : LoadCueSetSoft(Settings->GlobalCueSet))
 		{
 			if (SetHasCue(GlobalSet)) return GlobalSet;
 		}
@@ -1 +1,30 @@
 ﻿#include "AbilitySystem/ActionDefinition.h"
+
+const FActionProgram& UActionDefinition::GetProgram() const
+{
+	if (!bProgramCompiled)
+	{
+		Program.Compile(*this);
+		bProgramCompiled = true;
+	}
+	return Program;
+}
+
+void UActionDefinition::PostLoad()
+{
+	Super::PostLoad();
+
+	// Effects are instanced subobjects, loaded by now (formulas compile on demand if they haven't yet)
+	bProgramCompiled = false;
+	GetProgram();
+}
+
+#if WITH_EDITOR
+void UActionDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Any edit (effect list or an effect's own properties) invalidates it
+	bProgramCompiled = false;
+}
+#endif
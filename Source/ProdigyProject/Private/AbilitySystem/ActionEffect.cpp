@@ -5,3 +5,22 @@ bool UActionEffect::Apply_Implementation(const FActionContext& Context) const
 {
 	return true;
 }
+
+int32 UActionEffect::ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const
+{
+	// Targetless actions (None / Self / Point without an area) still run once
+	if (Targets.Num() == 0)
+	{
+		return Apply(Context) ? 1 : 0;
+	}
+
+	int32 Applied = 0;
+
+	FActionContext PerTarget = Context;
+	for (AActor* Target : Targets)
+	{
+		PerTarget.TargetActor = Target;
+		Applied += Apply(PerTarget) ? 1 : 0;
+	}
+	return Applied;
+}
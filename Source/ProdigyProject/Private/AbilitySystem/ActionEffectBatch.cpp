@@ -0,0 +1,221 @@
+﻿#include "AbilitySystem/ActionEffectBatch.h"
+
+#include "AbilitySystem/ActionAgentInterface.h"
+#include "Engine/World.h"
+
+namespace
+{
+	// No Blueprint override of any agent event the batch calls (checked once per class)
+	bool HasNativeAgentEvents(const UClass* Class)
+	{
+		static TMap<TWeakObjectPtr<const UClass>, bool> Cache;
+		if (const bool* Found = Cache.Find(Class))
+		{
+			return *Found;
+		}
+
+		static const FName Events[] =
+		{
+			GET_FUNCTION_NAME_CHECKED(IActionAgentInterface, HasAttribute),
+			GET_FUNCTION_NAME_CHECKED(IActionAgentInterface, GetAttributeCurrentValue),
+			GET_FUNCTION_NAME_CHECKED(IActionAgentInterface, GetAttributeFinalValue),
+			GET_FUNCTION_NAME_CHECKED(IActionAgentInterface, ModifyAttributeCurrentValue),
+			GET_FUNCTION_NAME_CHECKED(IActionAgentInterface, AddStatusTag),
+		};
+
+		bool bNative = true;
+		for (const FName Event : Events)
+		{
+			const UFunction* Func = Class->FindFunctionByName(Event);
+			bNative &= Func && Func->GetOwnerClass()->HasAnyClassFlags(CLASS_Native);
+		}
+
+		Cache.Add(Class, bNative);
+		return bNative;
+	}
+}
+
+const FActionEffectBatch::FAgent& FActionEffectBatch::GetAgent(AActor* A) const
+{
+	for (const FAgent& Agent : Agents)
+	{
+		if (Agent.Actor == A) return Agent;
+	}
+
+	FAgent& Agent = Agents.AddDefaulted_GetRef();
+	Agent.Actor = A;
+
+	if (IsValid(A) && A->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass()))
+	{
+		Agent.bAgent = true;
+		if (HasNativeAgentEvents(A->GetClass()))
+		{
+			Agent.Native = Cast<IActionAgentInterface>(A);
+		}
+	}
+	return Agent;
+}
+
+const FActionEffectBatch::FWrite* FActionEffectBatch::FindWrite(const AActor* A, const FGameplayTag& Tag) const
+{
+	// A handful of targets x effects: linear beats hashing here
+	for (const FWrite& W : Writes)
+	{
+		if (W.Actor == A && W.Tag == Tag)
+		{
+			return &W;
+		}
+	}
+	return nullptr;
+}
+
+bool FActionEffectBatch::GetValue(AActor* A, const FGameplayTag& Tag, float& OutValue) const
+{
+	if (const FWrite* W = FindWrite(A, Tag))
+	{
+		OutValue = W->NewValue;
+		return true;
+	}
+
+	if (!IsValid(A) || !Tag.IsValid()) return false;
+
+	const FAgent& Agent = GetAgent(A);
+	if (!Agent.bAgent) return false;
+
+	if (Agent.Native)
+	{
+		if (!Agent.Native->HasAttribute_Implementation(Tag)) return false;
+		OutValue = Agent.Native->GetAttributeCurrentValue_Implementation(Tag);
+		return true;
+	}
+
+	if (!IActionAgentInterface::Execute_HasAttribute(A, Tag)) return false;
+
+	OutValue = IActionAgentInterface::Execute_GetAttributeCurrentValue(A, Tag);
+	return true;
+}
+
+bool FActionEffectBatch::GetFinalValue(AActor* A, const FGameplayTag& Tag, float& OutValue) const
+{
+	if (!IsValid(A) || !Tag.IsValid()) return false;
+
+	const FAgent& Agent = GetAgent(A);
+	if (!Agent.bAgent) return false;
+
+	if (Agent.Native)
+	{
+		if (!Agent.Native->HasAttribute_Implementation(Tag)) return false;
+		OutValue = Agent.Native->GetAttributeFinalValue_Implementation(Tag);
+		return true;
+	}
+
+	if (!IActionAgentInterface::Execute_HasAttribute(A, Tag)) return false;
+
+	OutValue = IActionAgentInterface::Execute_GetAttributeFinalValue(A, Tag);
+	return true;
+}
+
+bool FActionEffectBatch::AddStatus(AActor* A, const FGameplayTag& StatusTag, int32 Turns, float Seconds, AActor* Instigator) const
+{
+	if (!IsValid(A) || !StatusTag.IsValid()) return false;
+
+	const FAgent& Agent = GetAgent(A);
+	if (!Agent.bAgent) return false;
+
+	return Agent.Native
+		? Agent.Native->AddStatusTag_Implementation(StatusTag, Turns, Seconds, Instigator)
+		: IActionAgentInterface::Execute_AddStatusTag(A, StatusTag, Turns, Seconds, Instigator);
+}
+
+void FActionEffectBatch::SetValue(AActor* A, const FGameplayTag& Tag, float NewValue, AActor* Instigator, bool bReportHealth)
+{
+	if (FWrite* W = FindWrite(A, Tag))
+	{
+		W->NewValue = NewValue;
+		W->Instigator = Instigator;
+		W->bReportHealth |= bReportHealth;
+		return;
+	}
+
+	float OldValue = 0.f;
+	if (!GetValue(A, Tag, OldValue)) return;
+
+	FWrite& W = Writes.AddDefaulted_GetRef();
+	W.Actor = A;
+	W.Tag = Tag;
+	W.OldValue = OldValue;
+	W.NewValue = NewValue;
+	W.Instigator = Instigator;
+	W.bReportHealth = bReportHealth;
+}
+
+void FActionEffectBatch::AddCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx)
+{
+	if (!CueTag.IsValid()) return;
+
+	FActionCueBatchEntry& E = Cues.AddDefaulted_GetRef();
+	E.CueTag = CueTag;
+	E.Context = Ctx;
+}
+
+int32 FActionEffectBatch::Flush(UWorld* World)
+{
+	int32 Applied = 0;
+	TArray<FWorldCombatEvent> Events;
+
+	// 1) Attribute writes, one per actor + attribute
+	for (const FWrite& W : Writes)
+	{
+		const float Delta = W.NewValue - W.OldValue;
+		if (!IsValid(W.Actor) || FMath::IsNearlyZero(Delta)) continue;
+
+		IActionAgentInterface* Native = GetAgent(W.Actor).Native;
+
+		const bool bModified = Native
+			? Native->ModifyAttributeCurrentValue_Implementation(W.Tag, Delta, W.Instigator)
+			: IActionAgentInterface::Execute_ModifyAttributeCurrentValue(W.Actor, W.Tag, Delta, W.Instigator);
+		if (!bModified) continue;
+		++Applied;
+
+		if (!W.bReportHealth) continue;
+
+		// Read back: the component may clamp further
+		const float Final = Native
+			? Native->GetAttributeCurrentValue_Implementation(W.Tag)
+			: IActionAgentInterface::Execute_GetAttributeCurrentValue(W.Actor, W.Tag);
+		const float Change = Final - W.OldValue;
+		if (FMath::IsNearlyZero(Change)) continue;
+
+		FWorldCombatEvent& E = Events.AddDefaulted_GetRef();
+		E.TargetActor = W.Actor;
+		E.InstigatorActor = W.Instigator;
+		E.Amount = FMath::Abs(Change);
+		E.bHeal = Change > 0.f;
+		E.OldHP = W.OldValue;
+		E.NewHP = Final;
+	}
+
+	// 2) Cues (killing-blow gating uses the HP snapshots taken when they were queued)
+	if (Cues.Num() > 0 && World)
+	{
+		if (UActionCueSubsystem* CueSubsystem = World->GetSubsystem<UActionCueSubsystem>())
+		{
+			CueSubsystem->PlayCueBatch(Cues);
+		}
+	}
+
+	// 3) World events
+	if (Events.Num() > 0 && World)
+	{
+		if (UWorldCombatEvents* WorldEvents = World->GetSubsystem<UWorldCombatEvents>())
+		{
+			WorldEvents->BroadcastBatch(Events);
+		}
+	}
+
+	Writes.Reset();
+	Cues.Reset();
+	Agents.Reset();
+
+	return Applied;
+}
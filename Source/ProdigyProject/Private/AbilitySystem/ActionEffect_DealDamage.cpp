@@ -1,9 +1,9 @@
 ﻿#include "AbilitySystem/ActionEffect_DealDamage.h"
-#include "AbilitySystem/ActionAgentInterface.h"
 #include "AbilitySystem/ActionComponent.h"
 #include "AbilitySystem/ActionCueSettings.h"
 #include "AbilitySystem/ActionCueSubsystem.h"
-#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/ActionEffectBatch.h"
+#include "AbilitySystem/ActionProgram.h"
 #include "AbilitySystem/WorldCombatEvents.h"
 #include "Character/Components/HealthBarWidgetComponent.h"
 #include "GameFramework/Character.h"
@@ -12,168 +12,70 @@
 class UHealthBarWidgetComponent;
 class UActionCueSettings;
 
-bool UActionEffect_DealDamage::Apply_Implementation(const FActionContext& Context) const
+void UActionEffect_DealDamage::PostLoad()
 {
-	if (!IsValid(Context.TargetActor)) return false;
-	if (!IsValid(Context.Instigator)) return false;
-
-	const FGameplayTag HealthTag = HealthAttributeTag.IsValid()
-		? HealthAttributeTag
-		: ProdigyTags::Attr::Health;
+	Super::PostLoad();
 
-	if (!Context.TargetActor->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass()))
-	{
-		UE_LOG(LogActionExec, Error,
-			TEXT("[DealDamage] Target %s missing ActionAgentInterface"),
-			*GetNameSafe(Context.TargetActor));
-		return false;
-	}
+	DamageFormula.Compile(this);
+}
 
-	const bool bHasHealth = IActionAgentInterface::Execute_HasAttribute(Context.TargetActor, HealthTag);
-	if (!bHasHealth)
-	{
-		UE_LOG(LogActionExec, Error,
-			TEXT("[DealDamage] Target %s missing attribute %s in DefaultAttributes"),
-			*GetNameSafe(Context.TargetActor),
-			*HealthTag.ToString());
-		return false;
-	}
+bool UActionEffect_DealDamage::Apply_Implementation(const FActionContext& Context) const
+{
+	// Single target = a batch of one
+	AActor* Target = Context.TargetActor;
 
-	const float OldHP = IActionAgentInterface::Execute_GetAttributeCurrentValue(Context.TargetActor, HealthTag);
+	FActionEffectBatch Batch;
+	const int32 Applied = ApplyToTargets(Context, MakeArrayView(&Target, 1), Batch);
+	Batch.Flush(IsValid(Context.Instigator) ? Context.Instigator->GetWorld() : nullptr);
 
-	const float AppliedDamage = FMath::Max(0.f, Damage);
-	const float Delta = -AppliedDamage;
+	return Applied > 0;
+}
 
-	if (FMath::IsNearlyZero(Delta))
-	{
-		return true;
-	}
+bool UActionEffect_DealDamage::TraceSurface(UWorld* World, const AActor* Instigator, const FVector& Toward, FGameplayTag& OutSurfaceTag, FVector& OutImpact) const
+{
+	const FVector From = Instigator->GetActorLocation();
 
-	const bool bOk = IActionAgentInterface::Execute_ModifyAttributeCurrentValue(
-		Context.TargetActor, HealthTag, Delta, Context.Instigator);
-	if (!bOk) return false;
+	FVector To = Toward;
+	To += (To - From).GetSafeNormal() * FMath::Max(0.f, SurfaceTraceDistanceExtra);
 
-	if (bClampMinZero)
-	{
-		const float NewHP = IActionAgentInterface::Execute_GetAttributeCurrentValue(Context.TargetActor, HealthTag);
-		if (NewHP < 0.f)
-		{
-			const float ClampDelta = 0.f - NewHP;
-			(void)IActionAgentInterface::Execute_ModifyAttributeCurrentValue(
-				Context.TargetActor, HealthTag, ClampDelta, Context.Instigator);
-		}
-	}
+	FHitResult Hit;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(ActionCueSurfaceTrace), false);
+	Params.AddIgnoredActor(Instigator);
+	Params.bReturnPhysicalMaterial = true;
 
-	const float FinalHP = IActionAgentInterface::Execute_GetAttributeCurrentValue(Context.TargetActor, HealthTag);
+	if (!World->LineTraceSingleByChannel(Hit, From, To, SurfaceTraceChannel, Params)) return false;
 
-	// Compute "actual applied" HP loss after clamping/any internal rules
-	const float AppliedDamageForEvents = FMath::Max(0.f, OldHP - FinalHP);
+	OutImpact = Hit.ImpactPoint.IsNearlyZero() ? Hit.Location : Hit.ImpactPoint;
 
-	// --- CUE (with pre/post HP snapshots so killing blow hit plays) ---
-	if (bPlayHitCue && AppliedDamage > 0.f)
+	if (Hit.PhysMaterial.IsValid())
 	{
-		UWorld* World = nullptr;
-		if (IsValid(Context.Instigator)) World = Context.Instigator->GetWorld();
-		if (!World && IsValid(Context.TargetActor)) World = Context.TargetActor->GetWorld();
-
-		if (World)
+		if (const UActionCueSettings* Settings = GetDefault<UActionCueSettings>())
 		{
-			if (UActionCueSubsystem* Cues = World->GetSubsystem<UActionCueSubsystem>())
-			{
-				FGameplayTag SurfaceTag;
-				FVector CueLoc = Context.TargetActor->GetActorLocation();
+			FGameplayTag Resolved = Settings->DefaultSurfaceTag;
 
-				if (const UActionCueSettings* Settings = GetDefault<UActionCueSettings>())
-				{
-					SurfaceTag = Settings->DefaultSurfaceTag;
-				}
+			for (const FActionCueSurfaceTagMapEntry& E : Settings->SurfaceTagsByPhysicalMaterial)
+			{
+				if (E.PhysicalMaterial.IsNull()) continue;
 
-				if (bResolveSurfaceTypeByTrace)
+				const UPhysicalMaterial* PM = E.PhysicalMaterial.LoadSynchronous();
+				if (PM && PM == Hit.PhysMaterial.Get())
 				{
-					const FVector From = Context.Instigator->GetActorLocation();
-
-					FVector To = Context.TargetActor->GetActorLocation();
-					To += (To - From).GetSafeNormal() * FMath::Max(0.f, SurfaceTraceDistanceExtra);
-
-					FHitResult Hit;
-					FCollisionQueryParams Params(SCENE_QUERY_STAT(ActionCueSurfaceTrace), false);
-					Params.AddIgnoredActor(Context.Instigator);
-					Params.bReturnPhysicalMaterial = true;
-
-					const bool bHit = World->LineTraceSingleByChannel(Hit, From, To, SurfaceTraceChannel, Params);
-					if (bHit)
+					if (E.SurfaceTag.IsValid())
 					{
-						CueLoc = Hit.ImpactPoint.IsNearlyZero() ? Hit.Location : Hit.ImpactPoint;
-
-						if (Hit.PhysMaterial.IsValid())
-						{
-							if (const UActionCueSettings* Settings = GetDefault<UActionCueSettings>())
-							{
-								FGameplayTag Resolved = Settings->DefaultSurfaceTag;
-
-								for (const FActionCueSurfaceTagMapEntry& E : Settings->SurfaceTagsByPhysicalMaterial)
-								{
-									if (E.PhysicalMaterial.IsNull()) continue;
-
-									const UPhysicalMaterial* PM = E.PhysicalMaterial.LoadSynchronous();
-									if (PM && PM == Hit.PhysMaterial.Get())
-									{
-										if (E.SurfaceTag.IsValid())
-										{
-											Resolved = E.SurfaceTag;
-										}
-										break;
-									}
-								}
-
-								SurfaceTag = Resolved;
-							}
-						}
+						Resolved = E.SurfaceTag;
 					}
+					break;
 				}
-
-				FActionCueContext CueCtx;
-				CueCtx.InstigatorActor = Context.Instigator;
-				CueCtx.TargetActor = Context.TargetActor;
-				CueCtx.Location = CueLoc;
-				CueCtx.OptionalSubTarget = Context.OptionalSubTarget;
-				CueCtx.WeaponTag = WeaponTagForCue;
-				CueCtx.SurfaceTag = SurfaceTag;
-
-				// snapshots for gating
-				CueCtx.TargetHPBefore = OldHP;
-				CueCtx.TargetHPAfter = FinalHP;
-				CueCtx.AppliedDamage = AppliedDamage;
-
-				// Use the subsystem directly so it receives the extended context
-				const FGameplayTag HitCueTag = FGameplayTag::RequestGameplayTag(FName("Cue.Action.Hit"));
-				Cues->PlayCue(HitCueTag, CueCtx);
 			}
-		}
-	}
 
-	UE_LOG(LogActionExec, Warning,
-		TEXT("[DealDamage] %s HP %.2f -> %.2f (Damage=%.2f Actual=%.2f) Inst=%s"),
-		*GetNameSafe(Context.TargetActor),
-		OldHP,
-		FinalHP,
-		AppliedDamage,
-		AppliedDamageForEvents,
-		*GetNameSafe(Context.Instigator));
-
-	if (UWorld* World = Context.TargetActor ? Context.TargetActor->GetWorld() : nullptr)
-	{
-		if (UWorldCombatEvents* Events = World->GetSubsystem<UWorldCombatEvents>())
-		{
-			Events->OnWorldDamageEvent.Broadcast(
-				Context.TargetActor,
-				Context.Instigator,
-				AppliedDamageForEvents,
-				OldHP,
-				FinalHP
-			);
+			OutSurfaceTag = Resolved;
 		}
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+int32 UActionEffect_DealDamage::ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const
+{
+	return ProdigyActionProgram::ExecuteOp(FActionOp::FromEffect(this), Context, Targets, Batch);
+}
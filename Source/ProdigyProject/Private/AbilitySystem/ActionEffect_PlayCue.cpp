@@ -1,6 +1,8 @@
 ﻿#include "AbilitySystem/ActionEffect_PlayCue.h"
 
 #include "AbilitySystem/ActionCueSubsystem.h"
+#include "AbilitySystem/ActionEffectBatch.h"
+#include "AbilitySystem/ActionProgram.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogCueEffect, Log, All);
 
@@ -31,28 +33,18 @@ bool UActionEffect_PlayCue::Apply_Implementation(const FActionContext& Context)
 		return false;
 	}
 
-	// Bridge old context -> new cue context (no renames to FActionContext)
-	FActionCueContext Ctx;
-	Ctx.InstigatorActor = Context.Instigator;
-	Ctx.TargetActor     = Context.TargetActor;
+	// Single target = a batch of one (none: one cue for the cast)
+	AActor* Target = Context.TargetActor;
+	const TConstArrayView<AActor*> Targets = IsValid(Target) ? MakeArrayView(&Target, 1) : TConstArrayView<AActor*>();
 
-	// Prefer explicit TargetLocation if set; else fall back to TargetActor location; else zero.
-	if (!Context.TargetLocation.IsNearlyZero())
-	{
-		Ctx.Location = Context.TargetLocation;
-	}
-	else if (IsValid(Context.TargetActor))
-	{
-		Ctx.Location = Context.TargetActor->GetActorLocation();
-	}
-	else
-	{
-		Ctx.Location = FVector::ZeroVector;
-	}
+	FActionEffectBatch Batch;
+	const int32 Applied = ApplyToTargets(Context, Targets, Batch);
+	Batch.Flush(World);
 
-	// If your FActionCueContext has OptionalSubTarget, keep it.
-	Ctx.OptionalSubTarget = Context.OptionalSubTarget;
+	return Applied > 0;
+}
 
-	Subsys->PlayCue(CueTag, Ctx);
-	return true;
+int32 UActionEffect_PlayCue::ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const
+{
+	return ProdigyActionProgram::ExecuteOp(FActionOp::FromEffect(this), Context, Targets, Batch);
 }
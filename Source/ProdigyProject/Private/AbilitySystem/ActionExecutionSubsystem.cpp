@@ -0,0 +1,331 @@
+﻿#include "AbilitySystem/ActionExecutionSubsystem.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/CombatProjectileSubsystem.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+namespace
+{
+	bool IsTravelling(const UActionDefinition* Def)
+	{
+		return Def->Projectile.IsProjectile()
+			&& Def->TargetingMode != EActionTargetingMode::Self
+			&& Def->TargetingMode != EActionTargetingMode::None;
+	}
+}
+
+void UActionExecutionSubsystem::Deinitialize()
+{
+	Executions.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UActionExecutionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UActionExecutionSubsystem, STATGROUP_Tickables);
+}
+
+UActionExecutionSubsystem::FExecution* UActionExecutionSubsystem::Find(FActionExecutionHandle Handle)
+{
+	return Executions.FindByPredicate([Handle](const FExecution& E) { return E.Handle == Handle; });
+}
+
+const UActionExecutionSubsystem::FExecution* UActionExecutionSubsystem::Find(FActionExecutionHandle Handle) const
+{
+	return Executions.FindByPredicate([Handle](const FExecution& E) { return E.Handle == Handle; });
+}
+
+bool UActionExecutionSubsystem::IsRunning(FActionExecutionHandle Handle) const
+{
+	return Handle.IsValid() && Find(Handle) != nullptr;
+}
+
+bool UActionExecutionSubsystem::HasExecutionsFrom(const AActor* Instigator) const
+{
+	return Executions.ContainsByPredicate([Instigator](const FExecution& E) { return E.Instigator.Get() == Instigator; });
+}
+
+FActionContext UActionExecutionSubsystem::MakeContext(const FExecution& E) const
+{
+	FActionContext Ctx;
+	Ctx.Instigator = E.Instigator.Get();
+	Ctx.TargetActor = E.TargetActor.Get();
+	Ctx.TargetLocation = E.TargetLocation;
+	Ctx.OptionalSubTarget = E.OptionalSubTarget;
+
+	const UActionDefinition* Def = E.Def.Get();
+	if (Def && Def->Area.IsArea())
+	{
+		for (const TWeakObjectPtr<AActor>& T : E.Targets)
+		{
+			if (AActor* A = T.Get())
+			{
+				Ctx.AreaTargets.Add(A);
+			}
+		}
+	}
+	return Ctx;
+}
+
+FActionExecutionHandle UActionExecutionSubsystem::Execute(UActionComponent* Source, const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets)
+{
+	if (!Source || !Def) return FActionExecutionHandle();
+
+	const FActionTiming& Timing = Def->Timing;
+
+	FExecution E;
+	E.Handle.Id = NextId++;
+	if (NextId == 0) NextId = 1;
+
+	E.Source = Source;
+	E.Def = Def;
+	E.Instigator = Context.Instigator;
+	E.TargetActor = Context.TargetActor;
+	E.TargetLocation = Context.TargetLocation;
+	E.OptionalSubTarget = Context.OptionalSubTarget;
+	E.Targets.Reserve(Targets.Num());
+	for (AActor* A : Targets)
+	{
+		E.Targets.Add(A);
+	}
+
+	// Phases follow the combat playback speed (instant = all of it now, no montage to wait on)
+	float TimeScale = 1.f;
+	if (Source->IsInCombat())
+	{
+		const UGameInstance* GI = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+		if (const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr)
+		{
+			TimeScale = Combat->ScaleDelay(1.f);
+		}
+	}
+
+	E.Windup = Timing.WindupSeconds * TimeScale;
+	E.Interval = Timing.ImpactIntervalSeconds * TimeScale;
+	E.Recovery = Timing.RecoverySeconds * TimeScale;
+	E.NumImpacts = FMath::Max(1, Timing.NumImpacts);
+
+	// Commit: montage starts now; notifies drive the impacts only if it actually plays
+	if (Timing.Montage && TimeScale > 0.f)
+	{
+		if (ACharacter* Character = Cast<ACharacter>(Context.Instigator))
+		{
+			const float Length = Character->PlayAnimMontage(Timing.Montage, 1.f / TimeScale);
+			E.bWaitsForNotifies = Timing.bImpactsFromAnimNotifies && Length > 0.f;
+		}
+	}
+
+	const FActionExecutionHandle Handle = E.Handle;
+	Executions.Add(MoveTemp(E));
+
+	if (Step(Handle))
+	{
+		Complete(Handle);
+	}
+
+	return IsRunning(Handle) ? Handle : FActionExecutionHandle();
+}
+
+void UActionExecutionSubsystem::SignalImpact(const AActor* Instigator)
+{
+	FExecution* E = Executions.FindByPredicate([Instigator](const FExecution& X)
+	{
+		return X.bWaitsForNotifies && X.Phase == EPhase::Windup && X.Instigator.Get() == Instigator;
+	});
+	if (!E) return;
+
+	// Right now, on the notify's frame
+	++E->PendingNotifies;
+
+	const FActionExecutionHandle Handle = E->Handle;
+	if (Step(Handle))
+	{
+		Complete(Handle);
+	}
+}
+
+void UActionExecutionSubsystem::NotifyProjectileResolved(FActionExecutionHandle Handle)
+{
+	if (FExecution* E = Find(Handle))
+	{
+		E->PendingProjectiles = FMath::Max(0, E->PendingProjectiles - 1);
+	}
+}
+
+void UActionExecutionSubsystem::Cancel(FActionExecutionHandle Handle)
+{
+	if (!Handle.IsValid()) return;
+
+	const int32 Index = Executions.IndexOfByPredicate([Handle](const FExecution& E) { return E.Handle == Handle; });
+	if (Index == INDEX_NONE) return;
+
+	UE_LOG(LogActionExec, Log, TEXT("[Execution] %s cancelled"), *GetNameSafe(Executions[Index].Def.Get()));
+	Executions.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	if (UCombatProjectileSubsystem* Projectiles = GetWorld() ? GetWorld()->GetSubsystem<UCombatProjectileSubsystem>() : nullptr)
+	{
+		Projectiles->CancelForExecution(Handle);
+	}
+}
+
+bool UActionExecutionSubsystem::Step(FActionExecutionHandle Handle)
+{
+	for (;;)
+	{
+		FExecution* E = Find(Handle);
+		if (!E) return false;
+
+		if (!E->Source.IsValid() || !E->Def.IsValid()) return true;
+
+		if (E->Age >= MaxActionSeconds)
+		{
+			UE_LOG(LogActionExec, Warning, TEXT("[Execution] %s timed out (phase %d, impacts %d/%d, projectiles %d)"),
+			       *GetNameSafe(E->Def.Get()), static_cast<int32>(E->Phase), E->ImpactsDone, E->NumImpacts, E->PendingProjectiles);
+
+			// Whatever is still flying would land after the action is over
+			if (E->PendingProjectiles > 0)
+			{
+				if (UCombatProjectileSubsystem* Projectiles = GetWorld() ? GetWorld()->GetSubsystem<UCombatProjectileSubsystem>() : nullptr)
+				{
+					Projectiles->CancelForExecution(Handle);
+				}
+			}
+			return true;
+		}
+
+		switch (E->Phase)
+		{
+		case EPhase::Windup:
+		{
+			const float Due = E->Windup + E->ImpactsDone * E->Interval;
+
+			bool bImpact = false;
+			if (!E->bWaitsForNotifies)
+			{
+				bImpact = E->Age >= Due;
+			}
+			else if (E->PendingNotifies > 0)
+			{
+				--E->PendingNotifies;
+				bImpact = true;
+			}
+			else if (E->Age >= Due + NotifyGraceSeconds)
+			{
+				UE_LOG(LogActionExec, Warning, TEXT("[Execution] %s impact %d: no notify, going by timing"),
+				       *GetNameSafe(E->Def.Get()), E->ImpactsDone + 1);
+				bImpact = true;
+			}
+
+			if (!bImpact) return false;
+
+			++E->ImpactsDone;
+			if (E->ImpactsDone >= E->NumImpacts)
+			{
+				E->Phase = EPhase::Landing;
+			}
+
+			Impact(Handle);
+			break;
+		}
+
+		case EPhase::Landing:
+			if (E->PendingProjectiles > 0) return false;
+
+			E->Phase = EPhase::Recovery;
+			E->RecoveryStart = E->Age;
+			break;
+
+		case EPhase::Recovery:
+		default:
+			return E->Age >= E->RecoveryStart + E->Recovery;
+		}
+	}
+}
+
+void UActionExecutionSubsystem::Impact(FActionExecutionHandle Handle)
+{
+	FExecution* E = Find(Handle);
+	if (!E) return;
+
+	UActionComponent* Source = E->Source.Get();
+	const UActionDefinition* Def = E->Def.Get();
+	if (!Source || !Def) return;
+
+	const FActionContext Ctx = MakeContext(*E);
+
+	TArray<AActor*, TInlineAllocator<16>> Targets;
+	for (const TWeakObjectPtr<AActor>& T : E->Targets)
+	{
+		if (AActor* A = T.Get())
+		{
+			Targets.Add(A);
+		}
+	}
+
+	// Travelling: effects land with the projectile, which holds recovery until then
+	UCombatProjectileSubsystem* Projectiles = GetWorld() ? GetWorld()->GetSubsystem<UCombatProjectileSubsystem>() : nullptr;
+	if (Projectiles && IsTravelling(Def))
+	{
+		++E->PendingProjectiles;
+		Projectiles->Launch(Source, Def, Ctx, Targets, Handle);
+		return;
+	}
+
+	Source->ApplyActionImpact(Def, Ctx, Targets);
+}
+
+void UActionExecutionSubsystem::Complete(FActionExecutionHandle Handle)
+{
+	const int32 Index = Executions.IndexOfByPredicate([Handle](const FExecution& E) { return E.Handle == Handle; });
+	if (Index == INDEX_NONE) return;
+
+	// Out first: OnActionExecuted moves the turn on, which can start the next action right away
+	const FExecution E = MoveTemp(Executions[Index]);
+	Executions.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	// Source / def gone: no OnActionExecuted, but whoever waits on the handle still hears about it
+	UActionComponent* Source = E.Source.Get();
+	const UActionDefinition* Def = E.Def.Get();
+	const bool bFinished = Source && Def;
+	if (bFinished)
+	{
+		Source->FinishAction(Def, MakeContext(E));
+	}
+
+	OnExecutionCompletedNative.Broadcast(Handle, bFinished);
+}
+
+void UActionExecutionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Executions.Num() == 0) return;
+
+	TArray<FActionExecutionHandle, TInlineAllocator<8>> Handles;
+	for (FExecution& E : Executions)
+	{
+		E.Age += DeltaTime;
+		Handles.Add(E.Handle);
+	}
+
+	// Completed after the pass: OnActionExecuted can start new executions
+	TArray<FActionExecutionHandle, TInlineAllocator<8>> Done;
+	for (const FActionExecutionHandle Handle : Handles)
+	{
+		if (Step(Handle))
+		{
+			Done.Add(Handle);
+		}
+	}
+
+	for (const FActionExecutionHandle Handle : Done)
+	{
+		Complete(Handle);
+	}
+}
@@ -0,0 +1,339 @@
+﻿#include "AbilitySystem/ActionProgram.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionCueSettings.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/ActionEffectBatch.h"
+#include "AbilitySystem/ActionEffect_ApplyStatus.h"
+#include "AbilitySystem/ActionEffect_DealDamage.h"
+#include "AbilitySystem/ActionEffect_ModifyAttribute.h"
+#include "AbilitySystem/ActionEffect_PlayCue.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+
+namespace
+{
+	const FGameplayTag& HitCueTag()
+	{
+		static const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName("Cue.Action.Hit"));
+		return Tag;
+	}
+
+	// Only set when it compiled: a broken expression falls back to the flat value, same as before
+	const FCombatFormula* ResolveFormula(const FCombatFormula& Formula, const UActionEffect* Owner)
+	{
+		return Formula.IsSet() && Formula.GetProgram(Owner).IsValid() ? &Formula : nullptr;
+	}
+
+	// Flat value, or one formula result per target (all read before any of this op's writes)
+	void ResolveValues(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, const FActionEffectBatch& Batch, TArrayView<float> OutValues)
+	{
+		if (Op.Formula)
+		{
+			Op.Formula->EvaluateLive(Op.Effect, Context.Instigator, Targets, Batch, OutValues);
+			return;
+		}
+
+		for (float& V : OutValues) V = Op.Value;
+	}
+
+	FActionCueContext MakeCueContext(const FActionContext& Context, AActor* TargetActor, bool bUseTargetLocation)
+	{
+		FActionCueContext Ctx;
+		Ctx.InstigatorActor = Context.Instigator;
+		Ctx.TargetActor = TargetActor;
+
+		// Explicit TargetLocation if asked for; else the target's location; else zero
+		if (bUseTargetLocation)
+		{
+			Ctx.Location = Context.TargetLocation;
+		}
+		else if (IsValid(TargetActor))
+		{
+			Ctx.Location = TargetActor->GetActorLocation();
+		}
+
+		Ctx.OptionalSubTarget = Context.OptionalSubTarget;
+		return Ctx;
+	}
+
+	int32 ExecuteDealDamage(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch)
+	{
+		if (!IsValid(Context.Instigator)) return 0;
+
+		TArray<float, TInlineAllocator<16>> DamageByTarget;
+		DamageByTarget.SetNumUninitialized(Targets.Num());
+		ResolveValues(Op, Context, Targets, Batch, DamageByTarget);
+
+		// Cue-only settings stay on the effect (cold path, once per cast)
+		const UActionEffect_DealDamage* Effect = Cast<UActionEffect_DealDamage>(Op.Effect);
+		UWorld* World = Context.Instigator->GetWorld();
+
+		// Surface is traced once per cast and shared by every hit (towards the single target, or the area's aim point)
+		bool bSurfaceTraced = false;
+		bool bSurfaceHit = false;
+		FGameplayTag SurfaceTag;
+		FVector SurfaceImpact = FVector::ZeroVector;
+
+		if (const UActionCueSettings* Settings = GetDefault<UActionCueSettings>())
+		{
+			SurfaceTag = Settings->DefaultSurfaceTag;
+		}
+
+		int32 Applied = 0;
+
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			AActor* Target = Targets[TargetIndex];
+			if (!IsValid(Target)) continue;
+
+			const float AppliedDamage = FMath::Max(0.f, DamageByTarget[TargetIndex]);
+
+			float OldHP = 0.f;
+			if (!Batch.GetValue(Target, Op.AttributeTag, OldHP))
+			{
+				UE_LOG(LogActionExec, Error,
+					TEXT("[DealDamage] Target %s is not an action agent or lacks attribute %s"),
+					*GetNameSafe(Target),
+					*Op.AttributeTag.ToString());
+				continue;
+			}
+
+			++Applied;
+
+			if (FMath::IsNearlyZero(AppliedDamage)) continue;
+
+			// Clamp up front (shared with the headless combat core) so the attribute changes once
+			const float ResolvedHP = ProdigyCombatCore::ResolveModifiedValue(OldHP, -AppliedDamage, Op.bClampMinZero, false, 0.f);
+
+			Batch.SetValue(Target, Op.AttributeTag, ResolvedHP, Context.Instigator, Op.bReportHealth);
+
+			UE_LOG(LogActionExec, Verbose,
+				TEXT("[DealDamage] %s HP %.2f -> %.2f (Damage=%.2f) Inst=%s"),
+				*GetNameSafe(Target),
+				OldHP,
+				ResolvedHP,
+				AppliedDamage,
+				*GetNameSafe(Context.Instigator));
+
+			// --- CUE (with pre/post HP snapshots so killing blow hit plays) ---
+			if (!Op.Tag.IsValid() || !World) continue;
+
+			if (Effect && Effect->bResolveSurfaceTypeByTrace && !bSurfaceTraced)
+			{
+				bSurfaceTraced = true;
+
+				const FVector Toward = (Targets.Num() > 1 && !Context.TargetLocation.IsNearlyZero())
+					? Context.TargetLocation
+					: Target->GetActorLocation();
+
+				bSurfaceHit = Effect->TraceSurface(World, Context.Instigator, Toward, SurfaceTag, SurfaceImpact);
+			}
+
+			FActionCueContext CueCtx;
+			CueCtx.InstigatorActor = Context.Instigator;
+			CueCtx.TargetActor = Target;
+
+			// Single target: the traced impact point; AoE: each victim's own location
+			CueCtx.Location = (bSurfaceHit && Targets.Num() == 1) ? SurfaceImpact : Target->GetActorLocation();
+
+			CueCtx.OptionalSubTarget = Context.OptionalSubTarget;
+			CueCtx.WeaponTag = Effect ? Effect->WeaponTagForCue : FGameplayTag();
+			CueCtx.SurfaceTag = SurfaceTag;
+
+			// snapshots for gating
+			CueCtx.TargetHPBefore = OldHP;
+			CueCtx.TargetHPAfter = ResolvedHP;
+			CueCtx.AppliedDamage = AppliedDamage;
+
+			Batch.AddCue(Op.Tag, CueCtx);
+		}
+
+		return Applied;
+	}
+
+	bool ModifyActor(const FActionOp& Op, AActor* A, AActor* Instigator, float Delta, FActionEffectBatch& Batch)
+	{
+		if (FMath::IsNearlyZero(Delta)) return true;
+		if (!IsValid(A)) return false;
+
+		// Must exist (explicit, no magic)
+		float OldValue = 0.f;
+		if (!Batch.GetValue(A, Op.AttributeTag, OldValue)) return false;
+
+		float MaxV = 0.f;
+		if (Op.bClampToMax)
+		{
+			if (!Op.MaxAttributeTag.IsValid() || !Batch.GetValue(A, Op.MaxAttributeTag, MaxV)) return false;
+		}
+
+		// Explicit clamp options (shared with the headless combat core)
+		const float NewValue = ProdigyCombatCore::ResolveModifiedValue(OldValue, Delta, Op.bClampMinZero, Op.bClampToMax, MaxV);
+		if (FMath::IsNearlyEqual(NewValue, OldValue)) return true;
+
+		// Written as a delta on flush (so the attribute component broadcasts correctly);
+		// Health changes also go out as world damage / heal events for floating text
+		Batch.SetValue(A, Op.AttributeTag, NewValue, Instigator, Op.bReportHealth);
+		return true;
+	}
+
+	int32 ExecuteModifyAttribute(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch)
+	{
+		if (!Op.AttributeTag.IsValid()) return 0;
+
+		// Instigator-side effects (self heal, costs) happen once per cast, not once per hit
+		if (Op.bTargetsInstigator)
+		{
+			// Formula "Target." still means the action's target here
+			AActor* ActionTarget = Context.TargetActor;
+			float Delta = 0.f;
+			ResolveValues(Op, Context, MakeArrayView(&ActionTarget, 1), Batch, MakeArrayView(&Delta, 1));
+
+			return ModifyActor(Op, Context.Instigator, Context.Instigator, Delta, Batch) ? 1 : 0;
+		}
+
+		TArray<float, TInlineAllocator<16>> Deltas;
+		Deltas.SetNumUninitialized(Targets.Num());
+		ResolveValues(Op, Context, Targets, Batch, Deltas);
+
+		int32 Applied = 0;
+		for (int32 i = 0; i < Targets.Num(); ++i)
+		{
+			Applied += ModifyActor(Op, Targets[i], Context.Instigator, Deltas[i], Batch) ? 1 : 0;
+		}
+		return Applied;
+	}
+
+	int32 ExecuteApplyStatus(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch)
+	{
+		if (!Op.Tag.IsValid()) return 0;
+
+		// Targetless actions still hit whatever the context points at (the old per-Apply behaviour)
+		if (Targets.Num() == 0)
+		{
+			return Batch.AddStatus(Context.TargetActor, Op.Tag, Op.Turns, Op.Seconds, Context.Instigator) ? 1 : 0;
+		}
+
+		int32 Applied = 0;
+		for (AActor* A : Targets)
+		{
+			Applied += Batch.AddStatus(A, Op.Tag, Op.Turns, Op.Seconds, Context.Instigator) ? 1 : 0;
+		}
+		return Applied;
+	}
+
+	int32 ExecutePlayCue(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch)
+	{
+		if (!Op.Tag.IsValid())
+		{
+			UE_LOG(LogActionExec, Error, TEXT("[PlayCue] %s: invalid CueTag"), *GetNameSafe(Op.Effect));
+			return 0;
+		}
+
+		// No targets (self / ground actions): one cue for the cast
+		if (Targets.Num() == 0)
+		{
+			Batch.AddCue(Op.Tag, MakeCueContext(Context, Context.TargetActor, !Context.TargetLocation.IsNearlyZero()));
+			return 1;
+		}
+
+		// One cue per hit target, at the target (the aimed point only matters for single target casts)
+		const bool bUseTargetLocation = Targets.Num() == 1 && Targets[0] == Context.TargetActor && !Context.TargetLocation.IsNearlyZero();
+		for (AActor* A : Targets)
+		{
+			Batch.AddCue(Op.Tag, MakeCueContext(Context, A, bUseTargetLocation));
+		}
+		return Targets.Num();
+	}
+}
+
+FActionOp FActionOp::FromEffect(const UActionEffect* InEffect)
+{
+	FActionOp Op;
+	Op.Effect = InEffect;
+
+	if (const UActionEffect_DealDamage* DD = Cast<UActionEffect_DealDamage>(InEffect))
+	{
+		Op.Kind = EActionOpKind::DealDamage;
+		Op.AttributeTag = DD->HealthAttributeTag.IsValid() ? DD->HealthAttributeTag : ProdigyTags::Attr::Health;
+		Op.Value = DD->Damage;
+		Op.Formula = ResolveFormula(DD->DamageFormula, DD);
+		Op.Tag = DD->bPlayHitCue ? HitCueTag() : FGameplayTag();
+		Op.bClampMinZero = DD->bClampMinZero;
+		Op.bReportHealth = true;
+	}
+	else if (const UActionEffect_ModifyAttribute* MA = Cast<UActionEffect_ModifyAttribute>(InEffect))
+	{
+		Op.Kind = EActionOpKind::ModifyAttribute;
+		Op.AttributeTag = MA->AttributeTag;
+		Op.MaxAttributeTag = MA->MaxAttributeTag;
+		Op.Value = MA->Delta;
+		Op.Formula = ResolveFormula(MA->DeltaFormula, MA);
+		Op.bTargetsInstigator = MA->Target == EActionEffectTarget::Instigator;
+		Op.bClampMinZero = MA->bClampMinZero;
+		Op.bClampToMax = MA->bClampToMaxAttribute;
+		Op.bReportHealth = MA->AttributeTag.MatchesTagExact(ProdigyTags::Attr::Health);
+	}
+	else if (const UActionEffect_ApplyStatus* AS = Cast<UActionEffect_ApplyStatus>(InEffect);
+		AS && AS->GetClass()->HasAnyClassFlags(CLASS_Native))
+	{
+		// Blueprint subclasses may override Apply (ApplyStatus has no batched path): they stay Effect ops
+		Op.Kind = EActionOpKind::ApplyStatus;
+		Op.Tag = AS->StatusTag;
+		Op.Turns = AS->Turns;
+		Op.Seconds = AS->Seconds;
+	}
+	else if (const UActionEffect_PlayCue* PC = Cast<UActionEffect_PlayCue>(InEffect))
+	{
+		Op.Kind = EActionOpKind::PlayCue;
+		Op.Tag = PC->CueTag;
+	}
+
+	return Op;
+}
+
+void FActionProgram::Compile(const UActionDefinition& Def)
+{
+	Ops.Reset(Def.Effects.Num());
+	NumFallbackOps = 0;
+
+	for (const UActionEffect* E : Def.Effects)
+	{
+		if (!IsValid(E)) continue;
+
+		const FActionOp& Op = Ops.Add_GetRef(FActionOp::FromEffect(E));
+		NumFallbackOps += Op.Kind == EActionOpKind::Effect ? 1 : 0;
+	}
+}
+
+int32 FActionProgram::Execute(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const
+{
+	int32 Ran = 0;
+	for (const FActionOp& Op : Ops)
+	{
+		const int32 Hits = ProdigyActionProgram::ExecuteOp(Op, Context, Targets, Batch);
+		++Ran;
+
+		UE_LOG(LogActionExec, Verbose, TEXT("[Program] Op %s Hits=%d"), *GetNameSafe(Op.Effect), Hits);
+	}
+	return Ran;
+}
+
+int32 ProdigyActionProgram::ExecuteOp(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch)
+{
+	switch (Op.Kind)
+	{
+	case EActionOpKind::DealDamage:
+		return ExecuteDealDamage(Op, Context, Targets, Batch);
+	case EActionOpKind::ModifyAttribute:
+		return ExecuteModifyAttribute(Op, Context, Targets, Batch);
+	case EActionOpKind::ApplyStatus:
+		return ExecuteApplyStatus(Op, Context, Targets, Batch);
+	case EActionOpKind::PlayCue:
+		return ExecutePlayCue(Op, Context, Targets, Batch);
+	case EActionOpKind::Effect:
+	default:
+		// Effect ops are built from IsValid effects; the definition keeps them alive
+		return Op.Effect ? Op.Effect->ApplyToTargets(Context, Targets, Batch) : 0;
+	}
+}
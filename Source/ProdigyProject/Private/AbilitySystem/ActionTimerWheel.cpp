@@ -0,0 +1,57 @@
+﻿#include "AbilitySystem/ActionTimerWheel.h"
+
+void FActionTimerWheel::Schedule(int32 Id, double Now, double DueTime)
+{
+	// Empty wheel: restart the clock here instead of catching up from the last timer
+	if (NumPending == 0)
+	{
+		CurrentTick = ToTick(Now);
+	}
+
+	// Rounded up, and never in the tick already processed
+	const int64 DueTick = FMath::Max(CurrentTick + 1, static_cast<int64>(FMath::CeilToDouble(DueTime / TickSeconds)));
+
+	Buckets[DueTick % NumBuckets].Add({ DueTick, Id });
+	++NumPending;
+}
+
+void FActionTimerWheel::Advance(double Now, TArray<int32, TInlineAllocator<8>>& OutExpired)
+{
+	const int64 Target = ToTick(Now);
+	if (Target <= CurrentTick) return;
+
+	if (NumPending == 0)
+	{
+		CurrentTick = Target;
+		return;
+	}
+
+	// A long hitch only needs one lap
+	const int64 Steps = FMath::Min<int64>(Target - CurrentTick, NumBuckets);
+
+	for (int64 Step = 1; Step <= Steps && NumPending > 0; ++Step)
+	{
+		TArray<FTimer>& Bucket = Buckets[(CurrentTick + Step) % NumBuckets];
+
+		// Later laps share the bucket: only what's due goes
+		for (int32 i = Bucket.Num() - 1; i >= 0; --i)
+		{
+			if (Bucket[i].DueTick > Target) continue;
+
+			OutExpired.Add(Bucket[i].Id);
+			Bucket.RemoveAtSwap(i, EAllowShrinking::No);
+			--NumPending;
+		}
+	}
+
+	CurrentTick = Target;
+}
+
+void FActionTimerWheel::Reset()
+{
+	for (TArray<FTimer>& Bucket : Buckets)
+	{
+		Bucket.Reset();
+	}
+	NumPending = 0;
+}
@@ -1 +1,96 @@
 ﻿#include "AbilitySystem/ActionTypes.h"
+
+FActionAreaQuery FActionAreaQuery::Make(const FActionAreaOfEffect& Area, const FVector& InstigatorLocation, const FVector& InstigatorForward, const FVector& TargetPoint)
+{
+	FActionAreaQuery Q;
+	Q.Shape = Area.Shape;
+	Q.Range = FMath::Max(0.f, Area.Range);
+	Q.CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(Area.HalfAngleDegrees, 0.f, 180.f)));
+	Q.HalfWidth = FMath::Max(0.f, Area.HalfWidth);
+
+	if (Area.Shape == EActionAreaShape::Radius)
+	{
+		Q.Origin = TargetPoint;
+		return Q;
+	}
+
+	Q.Origin = InstigatorLocation;
+
+	// Aim at the target; standing on it falls back to facing
+	FVector Dir = TargetPoint - InstigatorLocation;
+	Dir.Z = 0.f;
+	if (!Dir.Normalize())
+	{
+		Dir = FVector(InstigatorForward.X, InstigatorForward.Y, 0.f);
+		if (!Dir.Normalize())
+		{
+			Dir = FVector::ForwardVector;
+		}
+	}
+	Q.Direction = Dir;
+
+	return Q;
+}
+
+FVector FActionAreaQuery::GetBoundsCenter() const
+{
+	return Shape == EActionAreaShape::Line ? Origin + Direction * (Range * 0.5f) : Origin;
+}
+
+float FActionAreaQuery::GetBoundsRadius() const
+{
+	// Radius / Cone fit in a Range sphere around the origin; a line around its mid point
+	return Shape == EActionAreaShape::Line
+		? FMath::Sqrt(FMath::Square(Range * 0.5f) + FMath::Square(HalfWidth))
+		: Range;
+}
+
+bool FActionAreaQuery::Contains(const FVector& Location, float TargetRadius, float& OutDistance) const
+{
+	FVector Offset = Location - Origin;
+	Offset.Z = 0.f;
+
+	OutDistance = Offset.Size();
+
+	switch (Shape)
+	{
+	case EActionAreaShape::Radius:
+		return OutDistance <= Range + TargetRadius;
+
+	case EActionAreaShape::Cone:
+	{
+		if (OutDistance > Range + TargetRadius) return false;
+		if (OutDistance <= TargetRadius) return true;
+
+		// Widen the cone by the target's angular size so a capsule half inside counts
+		const float Cos = FVector::DotProduct(Offset / OutDistance, Direction);
+		const float Slack = FMath::Asin(FMath::Clamp(TargetRadius / OutDistance, 0.f, 1.f));
+		return FMath::Acos(FMath::Clamp(Cos, -1.f, 1.f)) <= FMath::Acos(CosHalfAngle) + Slack;
+	}
+
+	case EActionAreaShape::Line:
+	{
+		const float Along = FVector::DotProduct(Offset, Direction);
+		if (Along < -TargetRadius || Along > Range + TargetRadius) return false;
+
+		const float Across = FMath::Abs(FVector::CrossProduct(Direction, Offset).Z);
+		return Across <= HalfWidth + TargetRadius;
+	}
+
+	default:
+		return false;
+	}
+}
+
+void ActionArea::FinishHits(TArray<FActionAreaHit, TInlineAllocator<16>>& Hits, int32 MaxTargets, TArray<AActor*>& Out)
+{
+	// Stable: equal distances keep roster order, so the same cast always picks the same targets
+	Hits.StableSort([](const FActionAreaHit& A, const FActionAreaHit& B) { return A.Distance < B.Distance; });
+
+	const int32 Num = MaxTargets > 0 ? FMath::Min(MaxTargets, Hits.Num()) : Hits.Num();
+	Out.Reserve(Out.Num() + Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Out.Add(Hits[i].Actor);
+	}
+}
@@ -0,0 +1,18 @@
+﻿#include "AbilitySystem/AnimNotify_ActionImpact.h"
+
+#include "AbilitySystem/ActionExecutionSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+void UAnimNotify_ActionImpact::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+
+	UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr;
+	if (!World || !World->IsGameWorld()) return;
+
+	if (UActionExecutionSubsystem* Executor = World->GetSubsystem<UActionExecutionSubsystem>())
+	{
+		Executor->SignalImpact(MeshComp->GetOwner());
+	}
+}
@@ -93,6 +93,7 @@ void UAttributesComponent::BuildMapFromDefaults()
 	}
 
 	bDefaultsInitialized = true;
+	++ValuesRevision;
 
 	UE_LOG(LogAttributes, Log,
 		TEXT("BuildMapFromDefaults OK: Owner=%s merged %d attributes from %s (FirstInit=1)"),
@@ -140,10 +141,67 @@ void UAttributesComponent::BroadcastChanged(const FGameplayTag Tag, float OldVal
 {
 	if (!Tag.IsValid()) return;
 
+	// Every current value write ends here, even the ones too small to report
+	++ValuesRevision;
+
 	const float Delta = NewValue - OldValue;
 	if (FMath::IsNearlyZero(Delta)) return;
 
 	OnAttributeChanged.Broadcast(Tag, NewValue, Delta, InstigatorActor);
+	OnAttributeChangedNative.Broadcast(this, Tag, NewValue, Delta, InstigatorActor);
+
+	// Death edge: only crossings of a lethal resource, so listeners never have to filter every change
+	if (!bDead && OldValue > 0.f && NewValue <= 0.f && IsLethalResource(Tag))
+	{
+		bDead = true;
+		Killer = InstigatorActor;
+
+		UE_LOG(LogAttributes, Log, TEXT("[Death] %s died (%s) Killer=%s"),
+			*GetNameSafe(GetOwner()), *Tag.ToString(), *GetNameSafe(InstigatorActor));
+
+		OnDied.Broadcast(InstigatorActor, Tag);
+		OnDiedNative.Broadcast(this, InstigatorActor, Tag);
+	}
+	else if (bDead && OldValue <= 0.f && NewValue > 0.f && IsLethalResource(Tag) && !HasDepletedLethalResource())
+	{
+		// Revived: the last depleted lethal resource came back
+		bDead = false;
+		Killer.Reset();
+	}
+}
+
+bool UAttributesComponent::IsLethalResource(const FGameplayTag& Tag) const
+{
+	if (Tag == ProdigyTags::Attr::Health) return true;
+	if (!IsValid(AttributeSet)) return false;
+
+	for (const FProdigyResourcePair& Pair : AttributeSet->ResourcePairs)
+	{
+		if (Pair.bLethalAtZero && Pair.CurrentTag == Tag)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UAttributesComponent::HasDepletedLethalResource() const
+{
+	const FAttributeEntry* Health = FindEntry(ProdigyTags::Attr::Health);
+	if (Health && Health->CurrentValue <= 0.f) return true;
+	if (!IsValid(AttributeSet)) return false;
+
+	for (const FProdigyResourcePair& Pair : AttributeSet->ResourcePairs)
+	{
+		if (!Pair.bLethalAtZero) continue;
+
+		const FAttributeEntry* E = FindEntry(Pair.CurrentTag);
+		if (E && E->CurrentValue <= 0.f)
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
 bool UAttributesComponent::SetBaseValue(FGameplayTag AttributeTag, float NewBaseValue, AActor* InstigatorActor)
@@ -157,6 +215,7 @@ bool UAttributesComponent::SetBaseValue(FGameplayTag AttributeTag, float NewBase
 	}
 
 	E->BaseValue = NewBaseValue;
+	++ValuesRevision;
 	return true;
 }
 
@@ -192,7 +251,7 @@ bool UAttributesComponent::ModifyCurrentValue(FGameplayTag AttributeTag, float D
 	const float Old = E->CurrentValue;
 	E->CurrentValue = Old + Delta;
 
-	UE_LOG(LogActionExec, Warning,
+	UE_LOG(LogActionExec, Verbose,
 	TEXT("[Attr:%s] %s: %.2f -> %.2f (Delta=%.2f) Inst=%s"),
 	*GetNameSafe(GetOwner()),
 	*AttributeTag.ToString(),
@@ -219,6 +278,15 @@ bool UAttributesComponent::CopyCurrentValue(FGameplayTag FromTag, FGameplayTag T
 	return true;
 }
 
+void UAttributesComponent::GetAttributeEntries(TArray<FAttributeEntry>& OutEntries) const
+{
+	OutEntries.Reset(AttributeMap.Num());
+	for (const auto& Pair : AttributeMap)
+	{
+		OutEntries.Add(Pair.Value);
+	}
+}
+
 static void ApplyModsToValue(float& InOutValue, const TArray<FAttributeMod>& Mods, const FGameplayTag& TargetTag)
 {
 	// Very simple order:
@@ -255,12 +323,17 @@ float UAttributesComponent::GetFinalValue(FGameplayTag AttributeTag) const
 	const FAttributeEntry* E = FindEntry(AttributeTag);
 	if (!E) return 0.f;
 
-	float V = E->BaseValue;
+	return ComputeFinalValue(*E, ModSources);
+}
+
+float UAttributesComponent::ComputeFinalValue(const FAttributeEntry& Entry, const TMap<TWeakObjectPtr<UObject>, FAttrModSource>& InModSources)
+{
+	float V = Entry.BaseValue;
 
-	for (const auto& Pair : ModSources)
+	for (const auto& Pair : InModSources)
 	{
 		const FAttrModSource& Source = Pair.Value;
-		ApplyModsToValue(V, Source.Mods, AttributeTag);
+		ApplyModsToValue(V, Source.Mods, Entry.AttributeTag);
 	}
 
 	return V;
@@ -276,6 +349,7 @@ void UAttributesComponent::SetModsForSource(UObject* Source, const TArray<FAttri
 
 	FAttrModSource& S = ModSources.FindOrAdd(Source);
 	S.Mods = Mods;
+	++ModsRevision;
 
 	for (const FAttributeMod& M : Mods)
 	{
@@ -300,6 +374,10 @@ void UAttributesComponent::ClearModsForSource(UObject* Source, UObject* Instigat
 	}
 
 	const int32 Removed = ModSources.Remove(Source);
+	if (Removed > 0)
+	{
+		++ModsRevision;
+	}
 
 	UE_LOG(LogAttributes, Log, TEXT("[Mods] Clear Source=%s Removed=%d"),
 		*GetNameSafe(Source), Removed);
@@ -464,6 +542,7 @@ bool UAttributesComponent::AddOrRefreshTurnEffect(
 		}
 
 		E.InstigatorActor = InstigatorActor;
+		++TurnEffectsRevision;
 
 		UE_LOG(LogAttributes, Warning,
 			TEXT("[TurnEffect] Refresh Effect=%s Attr=%s Delta=%.2f Turns=%d Owner=%s"),
@@ -480,6 +559,7 @@ bool UAttributesComponent::AddOrRefreshTurnEffect(
 	NewE.InstigatorActor = InstigatorActor;
 
 	TurnEffects.Add(NewE);
+	++TurnEffectsRevision;
 
 	UE_LOG(LogAttributes, Warning,
 		TEXT("[TurnEffect] Add Effect=%s Attr=%s Delta=%.2f Turns=%d Owner=%s"),
@@ -492,6 +572,8 @@ void UAttributesComponent::TickTurnEffects(AActor* OwnerTurnActor)
 {
 	if (TurnEffects.Num() == 0) return;
 
+	++TurnEffectsRevision;
+
 	// Tick reverse to allow RemoveAtSwap
 	for (int32 i = TurnEffects.Num() - 1; i >= 0; --i)
 	{
@@ -556,6 +638,44 @@ void UAttributesComponent::ClearTurnEffect(FGameplayTag EffectTag)
 		if (TurnEffects[i].EffectTag.MatchesTagExact(EffectTag))
 		{
 			TurnEffects.RemoveAtSwap(i);
+			++TurnEffectsRevision;
 		}
 	}
-}
\ No newline at end of file
+}
+
+void UAttributesComponent::RestoreState(
+	const TArray<FAttributeEntry>* InEntries,
+	const TMap<TWeakObjectPtr<UObject>, FAttrModSource>* InModSources,
+	const TArray<FPeriodicTurnEffect>* InTurnEffects,
+	AActor* InstigatorActor)
+{
+	// Mods first: captured currents were already clamped against them, no re-clamp needed
+	if (InModSources)
+	{
+		ModSources = *InModSources;
+		++ModsRevision;
+	}
+
+	if (InTurnEffects)
+	{
+		TurnEffects = *InTurnEffects;
+		++TurnEffectsRevision;
+	}
+
+	if (!InEntries) return;
+
+	for (const FAttributeEntry& Captured : *InEntries)
+	{
+		FAttributeEntry* E = FindEntryMutable(Captured.AttributeTag);
+		if (!E) continue;
+
+		E->BaseValue = Captured.BaseValue;
+
+		const float Old = E->CurrentValue;
+		E->CurrentValue = Captured.CurrentValue;
+
+		BroadcastChanged(Captured.AttributeTag, Old, E->CurrentValue, InstigatorActor);
+	}
+
+	++ValuesRevision;
+}
@@ -0,0 +1,298 @@
+﻿#include "AbilitySystem/CombatAIPlanner.h"
+
+#include "AbilitySystem/ProdigyGameplayTags.h"
+
+namespace
+{
+	// Decided fights dwarf any health difference
+	constexpr float WinScore = 1000.f;
+
+	struct FPlannerMove
+	{
+		// INDEX_NONE = pass
+		int32 Slot = INDEX_NONE;
+		int32 Target = INDEX_NONE;
+	};
+
+	using FPlannerMoves = TArray<FPlannerMove, TInlineAllocator<32>>;
+
+	struct FPlannerSearch
+	{
+		int32 Team = 0;
+		int32 MaxTargets = 6;
+
+		double Deadline = 0.0;
+		const std::atomic<bool>* bCancel = nullptr;
+		bool bEnforceDeadline = false;
+
+		int32 Nodes = 0;
+		bool bAborted = false;
+
+		bool ShouldStop()
+		{
+			// Clock reads are cheap but not free; every 32 nodes is plenty at these node costs
+			if (!bAborted && bEnforceDeadline && (Nodes & 31) == 0)
+			{
+				bAborted = FPlatformTime::Seconds() > Deadline || (bCancel && bCancel->load(std::memory_order_relaxed));
+			}
+			return bAborted;
+		}
+	};
+
+	float HealthFraction(const FCombatCoreCombatant& C)
+	{
+		if (!C.IsAlive()) return 0.f;
+
+		const float MaxHealth = C.GetFinal(ProdigyTags::Attr::MaxHealth);
+		return MaxHealth > 0.f ? FMath::Clamp(C.GetCurrent(ProdigyTags::Attr::Health) / MaxHealth, 0.f, 1.f) : 1.f;
+	}
+
+	bool IsDecided(const FCombatCoreState& State, int32& OutWinningTeam)
+	{
+		TArray<FCombatCoreRosterEntry, TInlineAllocator<16>> Roster;
+		for (const FCombatCoreCombatant& C : State.Combatants)
+		{
+			Roster.Add({ C.Team, C.IsAlive() });
+		}
+
+		if (!ProdigyCombatCore::IsCombatOver(Roster)) return false;
+
+		OutWinningTeam = ProdigyCombatCore::GetWinningTeam(Roster);
+		return true;
+	}
+
+	void GatherMoves(const FCombatCoreState& State, int32 Index, int32 MaxTargets, FPlannerMoves& Out)
+	{
+		Out.Reset();
+
+		// Living targets, lowest health first so the cap keeps the most decisive ones
+		TArray<int32, TInlineAllocator<16>> Targets;
+		for (int32 i = 0; i < State.Combatants.Num(); ++i)
+		{
+			if (State.Combatants[i].IsAlive())
+			{
+				Targets.Add(i);
+			}
+		}
+
+		Targets.StableSort([&State](int32 A, int32 B)
+		{
+			return HealthFraction(State.Combatants[A]) < HealthFraction(State.Combatants[B]);
+		});
+
+		if (Targets.Num() > MaxTargets)
+		{
+			Targets.SetNum(MaxTargets);
+		}
+
+		const FCombatCoreCombatant& C = State.Combatants[Index];
+		for (int32 Slot = 0; Slot < C.ActionIndices.Num(); ++Slot)
+		{
+			const FCombatCoreAction* Action = State.GetAction(Index, Slot);
+			if (!Action) continue;
+
+			if (Action->TargetingMode == EActionTargetingMode::Unit)
+			{
+				for (const int32 Target : Targets)
+				{
+					if (ProdigyCombatCore::QueryAction(State, Index, Slot, Target) == EActionFailReason::None)
+					{
+						Out.Add({ Slot, Target });
+					}
+				}
+			}
+			else if (ProdigyCombatCore::QueryAction(State, Index, Slot, Index) == EActionFailReason::None)
+			{
+				Out.Add({ Slot, Index });
+			}
+		}
+	}
+
+	// Ends Index's turn and starts the next living combatant's (same order as RunToCompletion).
+	// Returns who acts next, INDEX_NONE if nobody is left.
+	int32 AdvanceTurn(FCombatCoreState& State, int32 Index)
+	{
+		const FCombatCoreCombatant& C = State.Combatants[Index];
+		if (C.IsAlive())
+		{
+			State.TurnQueue.Insert(Index, State.TurnClock + ProdigyCombatCore::GetTurnDelay(C));
+		}
+
+		++State.TurnNumber;
+
+		for (;;)
+		{
+			double ReadyTime = 0.0;
+			const int32 Next = State.TurnQueue.Pop(&ReadyTime);
+			if (Next == INDEX_NONE) return INDEX_NONE;
+
+			if (!State.Combatants[Next].IsAlive()) continue;
+
+			State.CurrentIndex = Next;
+			State.TurnClock = ReadyTime;
+			ProdigyCombatCore::BeginTurn(State, Next);
+
+			// Killed by its own turn effects: dropped, like the live encounter does
+			if (State.Combatants[Next].IsAlive())
+			{
+				return Next;
+			}
+		}
+	}
+
+	float Leaf(const FPlannerSearch& S, const FCombatCoreState& State, int32 Depth)
+	{
+		// Remaining depth rewards early wins and late losses
+		const float V = FCombatAIPlanner::Evaluate(State, S.Team);
+		if (V >= WinScore) return V + Depth;
+		if (V <= -WinScore) return V - Depth;
+		return V;
+	}
+
+	float Search(FPlannerSearch& S, const FCombatCoreState& State, int32 Acting, int32 Depth);
+
+	float ScoreMove(FPlannerSearch& S, const FCombatCoreState& State, int32 Acting, const FPlannerMove& Move, int32 Depth)
+	{
+		FCombatCoreState Next = State;
+		if (Move.Slot != INDEX_NONE)
+		{
+			ProdigyCombatCore::ExecuteAction(Next, Acting, Move.Slot, Move.Target);
+		}
+
+		int32 WinningTeam = INDEX_NONE;
+		if (Depth <= 1 || IsDecided(Next, WinningTeam))
+		{
+			return Leaf(S, Next, Depth - 1);
+		}
+
+		const int32 NextActing = AdvanceTurn(Next, Acting);
+		if (NextActing == INDEX_NONE || IsDecided(Next, WinningTeam))
+		{
+			return Leaf(S, Next, Depth - 1);
+		}
+
+		return Search(S, Next, NextActing, Depth - 1);
+	}
+
+	float Search(FPlannerSearch& S, const FCombatCoreState& State, int32 Acting, int32 Depth)
+	{
+		++S.Nodes;
+		if (S.ShouldStop()) return 0.f;
+
+		FPlannerMoves Moves;
+		GatherMoves(State, Acting, S.MaxTargets, Moves);
+
+		// Own side maximizes (passing included); other teams are chance nodes over what they can actually do
+		const bool bMaximize = State.Combatants[Acting].Team == S.Team;
+		if (bMaximize || Moves.Num() == 0)
+		{
+			Moves.Add(FPlannerMove());
+		}
+
+		float Best = -MAX_flt;
+		float Sum = 0.f;
+
+		for (const FPlannerMove& Move : Moves)
+		{
+			const float V = ScoreMove(S, State, Acting, Move, Depth);
+			if (S.bAborted) return 0.f;
+
+			Best = FMath::Max(Best, V);
+			Sum += V;
+		}
+
+		return bMaximize ? Best : Sum / Moves.Num();
+	}
+}
+
+float FCombatAIPlanner::Evaluate(const FCombatCoreState& State, int32 Team)
+{
+	int32 WinningTeam = INDEX_NONE;
+	if (IsDecided(State, WinningTeam))
+	{
+		// Nobody left standing counts as even
+		if (WinningTeam == INDEX_NONE) return 0.f;
+		return WinningTeam == Team ? WinScore : -WinScore;
+	}
+
+	float Score = 0.f;
+	for (const FCombatCoreCombatant& C : State.Combatants)
+	{
+		if (!C.IsAlive()) continue;
+
+		const float Value = 1.f + HealthFraction(C);
+		Score += (C.Team == Team) ? Value : -Value;
+	}
+	return Score;
+}
+
+FCombatAIPlan FCombatAIPlanner::Plan(const FCombatCoreState& State, int32 CombatantIndex, const FCombatAIPlannerSettings& Settings,
+                                     const std::atomic<bool>* bCancel)
+{
+	FCombatAIPlan Out;
+
+	if (!State.Actions.IsValid() || !State.Combatants.IsValidIndex(CombatantIndex)) return Out;
+	if (!State.Combatants[CombatantIndex].IsAlive()) return Out;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The acting combatant is mid-turn: off the queue until it finishes
+	FCombatCoreState Root = State;
+	Root.TurnQueue.Remove(CombatantIndex);
+	Root.CurrentIndex = CombatantIndex;
+
+	FPlannerSearch S;
+	S.Team = Root.Combatants[CombatantIndex].Team;
+	S.MaxTargets = FMath::Max(1, Settings.MaxTargetsPerAction);
+	S.Deadline = StartTime + FMath::Max(0.0, Settings.TimeBudgetSeconds);
+	S.bCancel = bCancel;
+
+	FPlannerMoves Moves;
+	GatherMoves(Root, CombatantIndex, S.MaxTargets, Moves);
+	Moves.Add(FPlannerMove());
+
+	Out.CombatantIndex = CombatantIndex;
+
+	const int32 MaxDepth = FMath::Max(1, Settings.MaxDepth);
+	for (int32 Depth = 1; Depth <= MaxDepth; ++Depth)
+	{
+		// Depth 1 is one evaluation per move and always finishes
+		S.bEnforceDeadline = Depth > 1;
+
+		int32 BestMove = INDEX_NONE;
+		float BestScore = -MAX_flt;
+
+		for (int32 i = 0; i < Moves.Num(); ++i)
+		{
+			const float V = ScoreMove(S, Root, CombatantIndex, Moves[i], Depth);
+			if (S.bAborted) break;
+
+			// Strict: ties keep the earlier move, so acting beats passing
+			if (V > BestScore)
+			{
+				BestScore = V;
+				BestMove = i;
+			}
+		}
+
+		// Out of time mid-depth: keep the last complete answer
+		if (S.bAborted || BestMove == INDEX_NONE) break;
+
+		const FPlannerMove& Best = Moves[BestMove];
+		const FCombatCoreAction* Action = Best.Slot != INDEX_NONE ? Root.GetAction(CombatantIndex, Best.Slot) : nullptr;
+
+		Out.ActionSlot = Action ? Best.Slot : INDEX_NONE;
+		Out.ActionTag = Action ? Action->ActionTag : FGameplayTag();
+		Out.TargetIndex = Action ? Best.Target : INDEX_NONE;
+		Out.bPass = Action == nullptr;
+		Out.Score = BestScore;
+		Out.Depth = Depth;
+
+		// Forced win inside the horizon: looking deeper can't beat it
+		if (BestScore >= WinScore) break;
+	}
+
+	Out.Nodes = S.Nodes;
+	Out.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Out;
+}
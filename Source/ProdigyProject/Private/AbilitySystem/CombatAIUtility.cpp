@@ -0,0 +1,280 @@
+﻿#include "AbilitySystem/CombatAIUtility.h"
+
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/CombatCore.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarCombatAILogUtility(
+	TEXT("Prodigy.Combat.AI.LogUtility"),
+	0,
+	TEXT("1 = log the full utility scoring matrix (actions x targets) for every utility AI decision."));
+
+bool ProdigyCombatAIUtility::ShouldLogMatrix()
+{
+	return CVarCombatAILogUtility.GetValueOnGameThread() != 0;
+}
+
+int32 FCombatAIUtilityInputs::AddTarget(FName Name, int32 InTeam, float InHealthFraction, float InDistance, const FGameplayTagContainer& InTags, bool bInSight)
+{
+	TargetInSight.Add(bInSight);
+	TargetNames.Add(Name);
+	TargetTeams.Add(InTeam);
+	TargetHealthFractions.Add(InHealthFraction);
+	TargetDistances.Add(InDistance);
+	return TargetTags.Add(InTags);
+}
+
+namespace
+{
+	using FUtilityColumn = TArray<float, TInlineAllocator<32>>;
+
+	// Raw -> 0..1 -> curve -> [MinFactor, 1]. One loop per curve so each stays a straight, branch-free pass.
+	void EvaluateResponse(const FCombatAIConsideration& C, const float* Raw, float* Out, int32 Num)
+	{
+		const float Range = C.InputMax - C.InputMin;
+		const float Scale = FMath::IsNearlyZero(Range) ? 0.f : 1.f / Range;
+		const float Offset = -C.InputMin * Scale;
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Out[i] = FMath::Clamp(Raw[i] * Scale + Offset, 0.f, 1.f);
+		}
+
+		switch (C.Curve)
+		{
+		case ECombatAIResponseCurve::Inverse:
+			for (int32 i = 0; i < Num; ++i) Out[i] = 1.f - Out[i];
+			break;
+		case ECombatAIResponseCurve::Quadratic:
+			for (int32 i = 0; i < Num; ++i) Out[i] = Out[i] * Out[i];
+			break;
+		case ECombatAIResponseCurve::InverseQuadratic:
+			for (int32 i = 0; i < Num; ++i) Out[i] = (1.f - Out[i]) * (1.f - Out[i]);
+			break;
+		case ECombatAIResponseCurve::Step:
+			for (int32 i = 0; i < Num; ++i) Out[i] = Out[i] >= 0.5f ? 1.f : 0.f;
+			break;
+		case ECombatAIResponseCurve::Linear:
+		default:
+			break;
+		}
+
+		const float Floor = FMath::Clamp(C.MinFactor, 0.f, 1.f);
+		const float Span = 1.f - Floor;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Out[i] = Floor + Span * Out[i];
+		}
+	}
+
+	// Tag columns are shared by every consideration asking about the same status
+	const FUtilityColumn& GetTagColumn(const FCombatAIUtilityInputs& In, const FGameplayTag& Tag,
+	                                   TArray<TPair<FGameplayTag, FUtilityColumn>, TInlineAllocator<4>>& Cache)
+	{
+		for (const TPair<FGameplayTag, FUtilityColumn>& Entry : Cache)
+		{
+			if (Entry.Key == Tag) return Entry.Value;
+		}
+
+		TPair<FGameplayTag, FUtilityColumn>& Entry = Cache.AddDefaulted_GetRef();
+		Entry.Key = Tag;
+		Entry.Value.SetNumUninitialized(In.NumTargets());
+		for (int32 t = 0; t < In.NumTargets(); ++t)
+		{
+			Entry.Value[t] = (Tag.IsValid() && In.TargetTags[t].HasTag(Tag)) ? 1.f : 0.f;
+		}
+		return Entry.Value;
+	}
+
+	float GetActionInput(const FCombatAIConsideration& C, const FCombatAIUtilityInputs& In, const UActionDefinition& Def)
+	{
+		switch (C.Input)
+		{
+		case ECombatAIConsiderationInput::SelfHealthFraction:
+			return In.HealthFraction;
+		case ECombatAIConsiderationInput::SelfHasStatus:
+			return (C.Tag.IsValid() && In.OwnedTags.HasTag(C.Tag)) ? 1.f : 0.f;
+		case ECombatAIConsiderationInput::APRemaining:
+			return In.AP - Def.Combat.APCost;
+		case ECombatAIConsiderationInput::CooldownReady:
+		{
+			const int32* Turns = In.CooldownTurns.Find(C.Tag.IsValid() ? C.Tag : Def.ActionTag);
+			return (Turns && *Turns > 0) ? 0.f : 1.f;
+		}
+		default:
+			return 0.f;
+		}
+	}
+}
+
+void ProdigyCombatAIUtility::Score(const UCombatAIUtilityProfile& Profile, const FCombatAIUtilityInputs& In, FCombatAIUtilityMatrix& Out)
+{
+	const int32 NT = In.NumTargets();
+	const int32 NA = Profile.Actions.Num();
+
+	Out.NumActions = NA;
+	Out.NumTargets = NT;
+	Out.Scores.Reset();
+	Out.Scores.SetNumZeroed(NA * NT);
+	Out.Ready.Init(false, NA);
+	Out.ActionTags.Reset();
+	Out.ActionTags.SetNum(NA);
+	Out.TargetNames = In.TargetNames;
+	Out.BestAction = INDEX_NONE;
+	Out.BestTarget = INDEX_NONE;
+	Out.BestScore = 0.f;
+
+	if (NT == 0 || NA == 0) return;
+
+	// Target masks: enemies, allies (self included), self only
+	FUtilityColumn EnemyMask, AllyMask, SelfMask, IsEnemy;
+	EnemyMask.SetNumUninitialized(NT);
+	AllyMask.SetNumUninitialized(NT);
+	SelfMask.SetNumZeroed(NT);
+	for (int32 t = 0; t < NT; ++t)
+	{
+		const bool bEnemy = In.TargetTeams[t] != In.Team;
+		EnemyMask[t] = bEnemy ? 1.f : 0.f;
+		AllyMask[t] = bEnemy ? 0.f : 1.f;
+	}
+	if (In.SelfTarget != INDEX_NONE)
+	{
+		SelfMask[In.SelfTarget] = 1.f;
+	}
+	IsEnemy = EnemyMask;
+
+	TArray<TPair<FGameplayTag, FUtilityColumn>, TInlineAllocator<4>> TagColumns;
+	FUtilityColumn Response;
+	Response.SetNumUninitialized(NT);
+
+	for (int32 a = 0; a < NA; ++a)
+	{
+		const FCombatAIActionUtility& U = Profile.Actions[a];
+		const UActionDefinition* Def = U.Action;
+		float* Row = Out.Scores.GetData() + a * NT;
+
+		if (!IsValid(Def) || !Def->bUsableInCombat) continue;
+		Out.ActionTags[a] = Def->ActionTag;
+
+		// Executing would fail anyway: leave the row at 0 (still dumped)
+		const int32* Cooldown = In.CooldownTurns.Find(Def->ActionTag);
+		const bool bReady = (!Cooldown || *Cooldown <= 0) && In.AP >= Def->Combat.APCost;
+		Out.Ready[a] = bReady;
+		if (!bReady) continue;
+
+		// Per action factors collapse into one scalar
+		float Base = FMath::Max(0.f, U.Weight);
+		for (const FCombatAIConsideration& C : U.Considerations)
+		{
+			if (C.IsPerTarget()) continue;
+
+			const float Raw = GetActionInput(C, In, *Def);
+			float Factor = 0.f;
+			EvaluateResponse(C, &Raw, &Factor, 1);
+			Base *= Factor;
+		}
+
+		const FUtilityColumn& Mask = Def->TargetingMode != EActionTargetingMode::Unit ? SelfMask
+			: (U.bTargetsAllies ? AllyMask : EnemyMask);
+
+		for (int32 t = 0; t < NT; ++t)
+		{
+			Row[t] = Base * Mask[t];
+		}
+
+		// Same gates QueryAction applies: a pair the action can't reach never wins
+		if (Def->TargetingMode == EActionTargetingMode::Unit && (Def->MaxRange > 0.f || Def->MinRange > 0.f || Def->bRequiresLineOfSight))
+		{
+			for (int32 t = 0; t < NT; ++t)
+			{
+				if (t == In.SelfTarget) continue;
+
+				const bool bReachable = ProdigyCombatCore::IsInRange(In.TargetDistances[t], Def->MinRange, Def->MaxRange)
+					&& (!Def->bRequiresLineOfSight || In.TargetInSight[t]);
+				if (!bReachable)
+				{
+					Row[t] = 0.f;
+				}
+			}
+		}
+
+		// Whatever else the live query refuses (tag gates, dead targets...)
+		if (In.Usable.Num() == NA * NT)
+		{
+			for (int32 t = 0; t < NT; ++t)
+			{
+				if (!In.Usable[a * NT + t])
+				{
+					Row[t] = 0.f;
+				}
+			}
+		}
+
+		if (Base <= 0.f) continue;
+
+		// Per target factors: one response column each, multiplied into the row
+		for (const FCombatAIConsideration& C : U.Considerations)
+		{
+			if (!C.IsPerTarget()) continue;
+
+			const float* Raw = nullptr;
+			switch (C.Input)
+			{
+			case ECombatAIConsiderationInput::TargetHealthFraction: Raw = In.TargetHealthFractions.GetData(); break;
+			case ECombatAIConsiderationInput::TargetDistance:       Raw = In.TargetDistances.GetData(); break;
+			case ECombatAIConsiderationInput::TargetIsEnemy:        Raw = IsEnemy.GetData(); break;
+			case ECombatAIConsiderationInput::TargetHasStatus:      Raw = GetTagColumn(In, C.Tag, TagColumns).GetData(); break;
+			default: break;
+			}
+			if (!Raw) continue;
+
+			EvaluateResponse(C, Raw, Response.GetData(), NT);
+			for (int32 t = 0; t < NT; ++t)
+			{
+				Row[t] *= Response[t];
+			}
+		}
+	}
+
+	// Strict: ties keep the earlier action / target (profile order is the designer's priority)
+	for (int32 i = 0; i < Out.Scores.Num(); ++i)
+	{
+		if (Out.Scores[i] > Out.BestScore)
+		{
+			Out.BestScore = Out.Scores[i];
+			Out.BestAction = i / NT;
+			Out.BestTarget = i % NT;
+		}
+	}
+
+	if (Out.BestScore < Profile.MinScoreToAct)
+	{
+		Out.BestAction = INDEX_NONE;
+		Out.BestTarget = INDEX_NONE;
+	}
+}
+
+void FCombatAIUtilityMatrix::Dump(TArray<FString>& OutLines) const
+{
+	FString Header = FString::Printf(TEXT("%-28s"), TEXT("Action \\ Target"));
+	for (const FName& Name : TargetNames)
+	{
+		Header += FString::Printf(TEXT(" %12.12s"), *Name.ToString());
+	}
+	OutLines.Add(Header);
+
+	for (int32 a = 0; a < NumActions; ++a)
+	{
+		FString Line = FString::Printf(TEXT("%-26.26s%s "), *ActionTags[a].ToString(), Ready[a] ? TEXT("  ") : TEXT(" x"));
+		for (int32 t = 0; t < NumTargets; ++t)
+		{
+			const bool bBest = a == BestAction && t == BestTarget;
+			Line += FString::Printf(TEXT(" %11.4f%s"), Get(a, t), bBest ? TEXT("*") : TEXT(" "));
+		}
+		OutLines.Add(Line);
+	}
+
+	OutLines.Add(HasDecision()
+		? FString::Printf(TEXT("Best: %s -> %s (%.4f)"), *ActionTags[BestAction].ToString(), *TargetNames[BestTarget].ToString(), BestScore)
+		: FString::Printf(TEXT("Best: none (top score %.4f below threshold)"), BestScore));
+}
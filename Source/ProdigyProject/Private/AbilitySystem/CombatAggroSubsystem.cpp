@@ -0,0 +1,350 @@
+﻿#include "AbilitySystem/CombatAggroSubsystem.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "Character/CombatantCharacterBase.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+void UCombatAggroSubsystem::Deinitialize()
+{
+	for (const FEntry& E : Entries)
+	{
+		if (ACombatantCharacterBase* A = E.Actor.Get())
+		{
+			if (USceneComponent* Root = A->GetRootComponent())
+			{
+				Root->TransformUpdated.RemoveAll(this);
+			}
+		}
+	}
+
+	Entries.Reset();
+	FreeEntries.Reset();
+	EntryByActor.Reset();
+	Cells.Reset();
+	LinkGroups.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatAggroSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatAggroSubsystem, STATGROUP_Tickables);
+}
+
+FIntPoint UCombatAggroSubsystem::ToCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UCombatAggroSubsystem::AddToCell(int32 EntryIndex)
+{
+	FEntry& E = Entries[EntryIndex];
+	TArray<int32>& Cell = Cells.FindOrAdd(E.Cell);
+	E.IndexInCell = Cell.Add(EntryIndex);
+}
+
+void UCombatAggroSubsystem::RemoveFromCell(int32 EntryIndex)
+{
+	FEntry& E = Entries[EntryIndex];
+	TArray<int32>* Cell = Cells.Find(E.Cell);
+	if (!Cell || !Cell->IsValidIndex(E.IndexInCell)) return;
+
+	Cell->RemoveAtSwap(E.IndexInCell, EAllowShrinking::No);
+	if (Cell->IsValidIndex(E.IndexInCell))
+	{
+		Entries[(*Cell)[E.IndexInCell]].IndexInCell = E.IndexInCell;
+	}
+	if (Cell->Num() == 0)
+	{
+		Cells.Remove(E.Cell);
+	}
+
+	E.IndexInCell = INDEX_NONE;
+}
+
+void UCombatAggroSubsystem::Register(ACombatantCharacterBase* Combatant)
+{
+	if (!IsValid(Combatant) || EntryByActor.Contains(Combatant)) return;
+
+	const int32 Index = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+
+	FEntry& E = Entries[Index];
+	E.Actor = Combatant;
+	E.Location = Combatant->GetActorLocation();
+	E.Cell = ToCell(E.Location);
+	AddToCell(Index);
+
+	EntryByActor.Add(Combatant, Index);
+
+	if (!Combatant->AggroLinkGroup.IsNone())
+	{
+		LinkGroups.FindOrAdd(Combatant->AggroLinkGroup).Add(Index);
+	}
+
+	MaxAggroRadius = FMath::Max(MaxAggroRadius, Combatant->AggroRadius);
+
+	if (USceneComponent* Root = Combatant->GetRootComponent())
+	{
+		Root->TransformUpdated.AddUObject(this, &UCombatAggroSubsystem::HandleTransformUpdated);
+	}
+}
+
+void UCombatAggroSubsystem::Unregister(ACombatantCharacterBase* Combatant)
+{
+	int32 Index = INDEX_NONE;
+	if (!EntryByActor.RemoveAndCopyValue(Combatant, Index)) return;
+
+	if (USceneComponent* Root = Combatant ? Combatant->GetRootComponent() : nullptr)
+	{
+		Root->TransformUpdated.RemoveAll(this);
+	}
+
+	RemoveFromCell(Index);
+
+	if (Combatant && !Combatant->AggroLinkGroup.IsNone())
+	{
+		if (TArray<int32>* Group = LinkGroups.Find(Combatant->AggroLinkGroup))
+		{
+			Group->RemoveSwap(Index);
+			if (Group->Num() == 0)
+			{
+				LinkGroups.Remove(Combatant->AggroLinkGroup);
+			}
+		}
+	}
+
+	Entries[Index] = FEntry();
+	FreeEntries.Add(Index);
+}
+
+void UCombatAggroSubsystem::HandleTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport)
+{
+	const int32* Index = Component ? EntryByActor.Find(Component->GetOwner()) : nullptr;
+	if (!Index) return;
+
+	FEntry& E = Entries[*Index];
+	E.Location = Component->GetComponentLocation();
+
+	// Most moves stay inside the cell: just the cached location
+	const FIntPoint NewCell = ToCell(E.Location);
+	if (NewCell == E.Cell) return;
+
+	RemoveFromCell(*Index);
+	E.Cell = NewCell;
+	AddToCell(*Index);
+}
+
+int32 UCombatAggroSubsystem::QueryRadius(const FVector& Center, float Radius, TArray<ACombatantCharacterBase*>& Out) const
+{
+	const int32 Before = Out.Num();
+	if (Radius <= 0.f) return 0;
+
+	const FIntPoint Min = ToCell(Center - FVector(Radius, Radius, 0.f));
+	const FIntPoint Max = ToCell(Center + FVector(Radius, Radius, 0.f));
+	const float RadiusSq = Radius * Radius;
+
+	for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+	{
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+			if (!Cell) continue;
+
+			for (const int32 Index : *Cell)
+			{
+				const FEntry& E = Entries[Index];
+				if (FVector::DistSquared(E.Location, Center) > RadiusSq) continue;
+
+				if (ACombatantCharacterBase* A = E.Actor.Get())
+				{
+					Out.Add(A);
+				}
+			}
+		}
+	}
+
+	return Out.Num() - Before;
+}
+
+int32 UCombatAggroSubsystem::QueryOutside(TConstArrayView<FVector> Centers, float Radius, TArray<ACombatantCharacterBase*>& Out) const
+{
+	const int32 Before = Out.Num();
+	const float RadiusSq = FMath::Square(FMath::Max(0.f, Radius));
+
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : Cells)
+	{
+		const FBox2D Bounds(FVector2D(Pair.Key) * CellSize, FVector2D(Pair.Key + FIntPoint(1, 1)) * CellSize);
+
+		bool bReached = false;
+		for (const FVector& C : Centers)
+		{
+			if (Bounds.ComputeSquaredDistanceToPoint(FVector2D(C)) <= RadiusSq)
+			{
+				bReached = true;
+				break;
+			}
+		}
+
+		for (const int32 Index : Pair.Value)
+		{
+			const FEntry& E = Entries[Index];
+			if (bReached && Centers.ContainsByPredicate([&E, RadiusSq](const FVector& C) { return FVector::DistSquared2D(E.Location, C) <= RadiusSq; }))
+			{
+				continue;
+			}
+
+			if (ACombatantCharacterBase* A = E.Actor.Get())
+			{
+				Out.Add(A);
+			}
+		}
+	}
+
+	return Out.Num() - Before;
+}
+
+bool UCombatAggroSubsystem::CanBePulled(const ACombatantCharacterBase* Combatant) const
+{
+	if (!IsValid(Combatant) || Combatant->IsActorBeingDestroyed()) return false;
+	if (Combatant->IsPlayerControlled() || Combatant->IsDead()) return false;
+
+	const UWorld* World = GetWorld();
+	const UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	return !Combat || !Combat->IsActorInCombat(const_cast<ACombatantCharacterBase*>(Combatant));
+}
+
+void UCombatAggroSubsystem::GatherCombatPull(AActor* Instigator, AActor* Target, TArray<AActor*>& OutParticipants) const
+{
+	OutParticipants.Reset();
+	if (IsValid(Target)) OutParticipants.Add(Target);
+	if (IsValid(Instigator)) OutParticipants.AddUnique(Instigator);
+
+	const ACombatantCharacterBase* InstigatorCombatant = Cast<ACombatantCharacterBase>(Instigator);
+	const FName InstigatorFaction = InstigatorCombatant ? InstigatorCombatant->AggroFaction : NAME_None;
+
+	// Breadth-first over everyone pulled so far; each link group is expanded once
+	TSet<FName> VisitedGroups;
+	TArray<ACombatantCharacterBase*> Nearby;
+
+	for (int32 i = 0; i < OutParticipants.Num(); ++i)
+	{
+		const ACombatantCharacterBase* Pulled = Cast<ACombatantCharacterBase>(OutParticipants[i]);
+		if (!Pulled || Pulled == Instigator) continue;
+
+		auto TryAdd = [&](ACombatantCharacterBase* Candidate)
+		{
+			if (OutParticipants.Contains(Candidate) || !CanBePulled(Candidate)) return;
+			if (!InstigatorFaction.IsNone() && Candidate->AggroFaction == InstigatorFaction) return;
+
+			OutParticipants.Add(Candidate);
+		};
+
+		if (!Pulled->AggroFaction.IsNone())
+		{
+			Nearby.Reset();
+			QueryRadius(Pulled->GetActorLocation(), PullRadius, Nearby);
+
+			for (ACombatantCharacterBase* Candidate : Nearby)
+			{
+				if (Candidate->AggroFaction == Pulled->AggroFaction)
+				{
+					TryAdd(Candidate);
+				}
+			}
+		}
+
+		if (!Pulled->AggroLinkGroup.IsNone() && !VisitedGroups.Contains(Pulled->AggroLinkGroup))
+		{
+			VisitedGroups.Add(Pulled->AggroLinkGroup);
+
+			if (const TArray<int32>* Group = LinkGroups.Find(Pulled->AggroLinkGroup))
+			{
+				for (const int32 Index : *Group)
+				{
+					if (ACombatantCharacterBase* Candidate = Entries[Index].Actor.Get())
+					{
+						TryAdd(Candidate);
+					}
+				}
+			}
+		}
+	}
+
+	if (OutParticipants.Num() > 2)
+	{
+		UE_LOG(LogActionExec, Log, TEXT("[Aggro] %s -> %s pulled %d extra combatant(s)"),
+		       *GetNameSafe(Instigator), *GetNameSafe(Target), OutParticipants.Num() - 2);
+	}
+}
+
+void UCombatAggroSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bExplorationAggro || MaxAggroRadius <= 0.f) return;
+
+	AggroCheckAccumulator += DeltaTime;
+	if (AggroCheckAccumulator < AggroCheckInterval) return;
+	AggroCheckAccumulator = 0.f;
+
+	RunExplorationAggro();
+}
+
+void UCombatAggroSubsystem::RunExplorationAggro()
+{
+	UWorld* World = GetWorld();
+	UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	if (!Combat) return;
+
+	TArray<ACombatantCharacterBase*> Nearby;
+
+	// Players are few: query around each of them instead of around every aggressive NPC
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		ACombatantCharacterBase* Player = PC ? Cast<ACombatantCharacterBase>(PC->GetPawn()) : nullptr;
+		if (!IsValid(Player) || Player->IsDead() || Combat->IsActorInCombat(Player)) continue;
+
+		Nearby.Reset();
+		QueryRadius(Player->GetActorLocation(), MaxAggroRadius, Nearby);
+
+		ACombatantCharacterBase* Aggressor = nullptr;
+		float BestDistSq = TNumericLimits<float>::Max();
+
+		for (ACombatantCharacterBase* Candidate : Nearby)
+		{
+			if (Candidate->AggroRadius <= 0.f) continue;
+			if (!Player->AggroFaction.IsNone() && Candidate->AggroFaction == Player->AggroFaction) continue;
+			if (!CanBePulled(Candidate)) continue;
+
+			const float DistSq = FVector::DistSquared(Candidate->GetActorLocation(), Player->GetActorLocation());
+			if (DistSq > FMath::Square(Candidate->AggroRadius) || DistSq >= BestDistSq) continue;
+
+			Aggressor = Candidate;
+			BestDistSq = DistSq;
+		}
+
+		if (!Aggressor) continue;
+
+		TArray<AActor*> Parts;
+		GatherCombatPull(Player, Aggressor, Parts);
+
+		UE_LOG(LogActionExec, Warning, TEXT("[Aggro] %s aggroed on %s (%d participants)"),
+		       *GetNameSafe(Aggressor), *GetNameSafe(Player), Parts.Num());
+
+		// Primary fight (HUD follows it); the aggressor gets the first turn
+		if (!Combat->IsInCombat())
+		{
+			Combat->EnterCombat(Parts, Aggressor);
+		}
+		else
+		{
+			Combat->StartEncounter(Parts, Aggressor);
+		}
+	}
+}
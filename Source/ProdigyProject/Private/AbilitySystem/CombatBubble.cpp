@@ -0,0 +1,235 @@
+﻿#include "AbilitySystem/CombatBubble.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/CombatAggroSubsystem.h"
+#include "AbilitySystem/CombatBubbleSubsystem.h"
+#include "AbilitySystem/StatusComponent.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Character/CombatantCharacterBase.h"
+#include "Engine/World.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Navigation/PathFollowingComponent.h"
+
+namespace
+{
+	bool IsInsideAny(const FVector& Location, TConstArrayView<FVector> Centers, float RadiusSq)
+	{
+		for (const FVector& C : Centers)
+		{
+			if (FVector::DistSquared2D(Location, C) <= RadiusSq) return true;
+		}
+		return false;
+	}
+
+	// Stopped outright: nothing outside should move or run out a timer while the fight is on
+	bool ShouldSuspend(const UActorComponent* Component)
+	{
+		return Component->IsA<UMovementComponent>() || Component->IsA<UStatusComponent>() || Component->IsA<UPathFollowingComponent>();
+	}
+}
+
+void FCombatBubble::ThrottleActor(AActor* Actor, AActor* Anchor)
+{
+	if (Actor->IsActorTickEnabled() && Actor->GetActorTickInterval() < Settings.ThrottledTickInterval)
+	{
+		FRecord& R = Records.AddDefaulted_GetRef();
+		R.Anchor = Anchor;
+		R.Object = Actor;
+		R.Kind = ERecordKind::ActorTick;
+		R.OldInterval = Actor->GetActorTickInterval();
+
+		Actor->SetActorTickInterval(Settings.ThrottledTickInterval);
+	}
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (!Component || !Component->IsComponentTickEnabled()) continue;
+
+		const bool bSuspend = ShouldSuspend(Component);
+		if (!bSuspend && Component->GetComponentTickInterval() >= Settings.ThrottledTickInterval) continue;
+
+		FRecord& R = Records.AddDefaulted_GetRef();
+		R.Anchor = Anchor;
+		R.Object = Component;
+		R.Kind = ERecordKind::ComponentTick;
+		R.bSuspended = bSuspend;
+		R.OldInterval = Component->GetComponentTickInterval();
+
+		if (bSuspend)
+		{
+			Component->SetComponentTickEnabled(false);
+		}
+		else
+		{
+			Component->SetComponentTickInterval(Settings.ThrottledTickInterval);
+		}
+	}
+}
+
+bool FCombatBubble::ThrottlePawn(APawn* Pawn)
+{
+	if (!IsValid(Pawn) || Pawn->IsPlayerControlled()) return false;
+
+	const int32 Before = Records.Num();
+
+	// The controller has no place of its own: it goes with its pawn
+	if (AAIController* AIC = Cast<AAIController>(Pawn->GetController()))
+	{
+		if (UBrainComponent* Brain = AIC->GetBrainComponent(); Brain && Brain->IsRunning() && !Brain->IsPaused())
+		{
+			FRecord& R = Records.AddDefaulted_GetRef();
+			R.Anchor = Pawn;
+			R.Object = Brain;
+			R.Kind = ERecordKind::Brain;
+
+			Brain->PauseLogic(TEXT("CombatBubble"));
+		}
+
+		ThrottleActor(AIC, Pawn);
+	}
+
+	ThrottleActor(Pawn, Pawn);
+	return Records.Num() > Before;
+}
+
+bool FCombatBubble::Throttle(AActor* Actor)
+{
+	if (APawn* Pawn = Cast<APawn>(Actor))
+	{
+		return ThrottlePawn(Pawn);
+	}
+
+	const int32 Before = Records.Num();
+	ThrottleActor(Actor, Actor);
+	return Records.Num() > Before;
+}
+
+void FCombatBubble::Apply(UWorld* World, TConstArrayView<FVector> Centers, const FCombatBubbleSettings& InSettings)
+{
+	if (bActive || !World) return;
+
+	bActive = true;
+	Settings = InSettings;
+	Records.Reset();
+	BubbleCenters.Reset();
+	BubbleCenters.Append(Centers.GetData(), Centers.Num());
+	BubbleWorld = World;
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumActors = 0;
+
+	// Who's outside comes from the aggro grid: no pass over the world's actors
+	TArray<ACombatantCharacterBase*> Outside;
+	if (const UCombatAggroSubsystem* Aggro = World->GetSubsystem<UCombatAggroSubsystem>())
+	{
+		Aggro->QueryOutside(Centers, Settings.Radius, Outside);
+	}
+
+	for (ACombatantCharacterBase* Combatant : Outside)
+	{
+		NumActors += ThrottlePawn(Combatant);
+	}
+
+	// Everything else out there (NPCs, props, pickups) was tracked as it appeared
+	if (UCombatBubbleSubsystem* Tracked = World->GetSubsystem<UCombatBubbleSubsystem>())
+	{
+		const float RadiusSq = FMath::Square(Settings.Radius);
+
+		for (const TWeakObjectPtr<AActor>& Weak : Tracked->GetActors())
+		{
+			AActor* Actor = Weak.Get();
+			if (!Actor || IsInsideAny(Actor->GetActorLocation(), Centers, RadiusSq)) continue;
+
+			NumActors += Throttle(Actor);
+		}
+	}
+
+	// Reinforcements / spawners while the bubble is up
+	SpawnHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateRaw(this, &FCombatBubble::HandleActorSpawned));
+
+	UE_LOG(LogActionExec, Log, TEXT("[Combat] Bubble on: %d actors outside (%d tick changes) in %.2f ms"),
+	       NumActors, Records.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FCombatBubble::HandleActorSpawned(AActor* Actor)
+{
+	if (!bActive || !IsValid(Actor)) return;
+	if (!Actor->IsA<ACombatantCharacterBase>() && !UCombatBubbleSubsystem::ShouldTrack(Actor)) return;
+	if (IsInsideAny(Actor->GetActorLocation(), BubbleCenters, FMath::Square(Settings.Radius))) return;
+
+	Throttle(Actor);
+}
+
+void FCombatBubble::Restore(const FRecord& R)
+{
+	UObject* Object = R.Object.Get();
+	if (!Object) return;
+
+	switch (R.Kind)
+	{
+	case ERecordKind::ActorTick:
+		CastChecked<AActor>(Object)->SetActorTickInterval(R.OldInterval);
+		break;
+
+	case ERecordKind::ComponentTick:
+	{
+		UActorComponent* Component = CastChecked<UActorComponent>(Object);
+		if (R.bSuspended)
+		{
+			Component->SetComponentTickEnabled(true);
+		}
+		else
+		{
+			Component->SetComponentTickInterval(R.OldInterval);
+		}
+		break;
+	}
+
+	case ERecordKind::Brain:
+		CastChecked<UBrainComponent>(Object)->ResumeLogic(TEXT("CombatBubble"));
+		break;
+	}
+}
+
+void FCombatBubble::ReleaseAround(TConstArrayView<FVector> Centers)
+{
+	if (!bActive) return;
+
+	BubbleCenters.Append(Centers.GetData(), Centers.Num());
+
+	const float RadiusSq = FMath::Square(Settings.Radius);
+
+	for (int32 i = Records.Num() - 1; i >= 0; --i)
+	{
+		const AActor* Anchor = Records[i].Anchor.Get();
+		if (Anchor && !IsInsideAny(Anchor->GetActorLocation(), Centers, RadiusSq)) continue;
+
+		Restore(Records[i]);
+		Records.RemoveAtSwap(i, EAllowShrinking::No);
+	}
+}
+
+void FCombatBubble::RestoreAll()
+{
+	if (!bActive) return;
+
+	for (const FRecord& R : Records)
+	{
+		Restore(R);
+	}
+
+	UE_LOG(LogActionExec, Log, TEXT("[Combat] Bubble off: %d tick changes restored"), Records.Num());
+
+	if (UWorld* World = BubbleWorld.Get())
+	{
+		World->RemoveOnActorSpawnedHandler(SpawnHandle);
+	}
+	SpawnHandle.Reset();
+	BubbleWorld.Reset();
+	BubbleCenters.Empty();
+
+	Records.Empty();
+	bActive = false;
+}
@@ -0,0 +1,102 @@
+﻿#include "AbilitySystem/CombatBubbleSubsystem.h"
+
+#include "AbilitySystem/StatusComponent.h"
+#include "Character/CombatantCharacterBase.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+
+const FName UCombatBubbleSubsystem::BubbleTag(TEXT("CombatBubble"));
+
+void UCombatBubbleSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The only full pass: what's already loaded
+	for (const ULevel* Level : InWorld.GetLevels())
+	{
+		RegisterLevel(Level);
+	}
+
+	SpawnHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UCombatBubbleSubsystem::HandleActorSpawned));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UCombatBubbleSubsystem::HandleLevelAdded);
+}
+
+void UCombatBubbleSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(SpawnHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	SpawnHandle.Reset();
+	LevelAddedHandle.Reset();
+	Actors.Reset();
+	Known.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UCombatBubbleSubsystem::ShouldTrack(const AActor* Actor)
+{
+	if (!IsValid(Actor) || !Actor->GetRootComponent()) return false;
+
+	// The aggro grid has these
+	if (Actor->IsA<ACombatantCharacterBase>()) return false;
+
+	if (Actor->IsA<APawn>() || Actor->ActorHasTag(BubbleTag)) return true;
+
+	return Actor->FindComponentByClass<UMovementComponent>() || Actor->FindComponentByClass<UStatusComponent>();
+}
+
+void UCombatBubbleSubsystem::Register(AActor* Actor)
+{
+	if (!ShouldTrack(Actor)) return;
+
+	bool bKnown = false;
+	Known.Add(Actor, &bKnown);
+	if (!bKnown)
+	{
+		Actors.Add(Actor);
+	}
+}
+
+void UCombatBubbleSubsystem::RegisterLevel(const ULevel* Level)
+{
+	if (!Level) return;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		Register(Actor);
+	}
+}
+
+TConstArrayView<TWeakObjectPtr<AActor>> UCombatBubbleSubsystem::GetActors()
+{
+	const int32 Removed = Actors.RemoveAllSwap([](const TWeakObjectPtr<AActor>& A) { return !A.IsValid(); }, EAllowShrinking::No);
+	if (Removed > 0)
+	{
+		Known.Reset();
+		for (const TWeakObjectPtr<AActor>& A : Actors)
+		{
+			Known.Add(A.Get());
+		}
+	}
+
+	return Actors;
+}
+
+void UCombatBubbleSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	Register(Actor);
+}
+
+void UCombatBubbleSubsystem::HandleLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == GetWorld())
+	{
+		RegisterLevel(Level);
+	}
+}
@@ -0,0 +1,920 @@
+﻿#include "AbilitySystem/CombatCore.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/ActionEffect_ApplyStatus.h"
+#include "AbilitySystem/ActionEffect_DealDamage.h"
+#include "AbilitySystem/ActionEffect_ModifyAttribute.h"
+#include "AbilitySystem/AttributeSetDataAsset.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatSnapshot.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/StatusComponent.h"
+#include "Character/CombatantCharacterBase.h"
+
+DEFINE_LOG_CATEGORY(LogCombatCore);
+
+// =======================
+// Data helpers
+// =======================
+
+FCombatCoreAction FCombatCoreAction::FromDefinition(const UActionDefinition& Def)
+{
+	FCombatCoreAction Out;
+	Out.ActionTag = Def.ActionTag;
+	Out.TargetingMode = Def.TargetingMode;
+	Out.APCost = Def.Combat.APCost;
+	Out.CooldownTurns = Def.Combat.CooldownTurns;
+	Out.bUsableInCombat = Def.bUsableInCombat;
+	Out.MinRange = Def.MinRange;
+	Out.MaxRange = Def.MaxRange;
+	Out.bRequiresLineOfSight = Def.bRequiresLineOfSight;
+	Out.RequiredTags = Def.RequiredTags;
+	Out.BlockedTags = Def.BlockedTags;
+	Out.Area = Def.Area;
+	Out.NumImpacts = FMath::Max(1, Def.Timing.NumImpacts);
+	Out.Definition = FSoftObjectPath(&Def);
+
+	Out.Effects.Reserve(Def.Effects.Num());
+
+	for (const UActionEffect* E : Def.Effects)
+	{
+		if (!IsValid(E)) continue;
+
+		FCombatCoreEffect CE;
+
+		if (const UActionEffect_DealDamage* DD = Cast<UActionEffect_DealDamage>(E))
+		{
+			CE.Kind = ECombatCoreEffectKind::ModifyAttribute;
+			CE.Tag = DD->HealthAttributeTag.IsValid() ? DD->HealthAttributeTag : ProdigyTags::Attr::Health;
+			CE.Delta = -FMath::Max(0.f, DD->Damage);
+			CE.bClampMinZero = DD->bClampMinZero;
+			CE.Formula = DD->DamageFormula.GetProgram(DD);
+			CE.bFormulaIsDamage = true;
+		}
+		else if (const UActionEffect_ModifyAttribute* MA = Cast<UActionEffect_ModifyAttribute>(E))
+		{
+			CE.Kind = ECombatCoreEffectKind::ModifyAttribute;
+			CE.Tag = MA->AttributeTag;
+			CE.Delta = MA->Delta;
+			CE.Formula = MA->DeltaFormula.GetProgram(MA);
+			CE.bTargetsInstigator = (MA->Target == EActionEffectTarget::Instigator);
+			CE.bClampMinZero = MA->bClampMinZero;
+			if (MA->bClampToMaxAttribute)
+			{
+				CE.ClampMaxTag = MA->MaxAttributeTag;
+			}
+		}
+		else if (const UActionEffect_ApplyStatus* AS = Cast<UActionEffect_ApplyStatus>(E))
+		{
+			CE.Kind = ECombatCoreEffectKind::ApplyStatus;
+			CE.Tag = AS->StatusTag;
+			CE.Turns = AS->Turns;
+
+			// Live it lasts until both durations run out; seconds have no turn-clock equivalent
+			if (AS->Seconds > 0.f)
+			{
+				Out.bSimulatable = false;
+				UE_LOG(LogCombatCore, Verbose, TEXT("[CombatCore] %s not simulatable: %s lasts %.1fs"),
+				       *GetNameSafe(&Def), *AS->StatusTag.ToString(), AS->Seconds);
+			}
+		}
+
+		Out.Effects.Add(CE);
+	}
+
+	return Out;
+}
+
+FCombatCoreAttribute* FCombatCoreCombatant::FindAttribute(const FGameplayTag& Tag)
+{
+	return Attributes.FindByPredicate([&Tag](const FCombatCoreAttribute& A) { return A.Tag == Tag; });
+}
+
+const FCombatCoreAttribute* FCombatCoreCombatant::FindAttribute(const FGameplayTag& Tag) const
+{
+	return Attributes.FindByPredicate([&Tag](const FCombatCoreAttribute& A) { return A.Tag == Tag; });
+}
+
+float FCombatCoreCombatant::GetCurrent(const FGameplayTag& Tag) const
+{
+	const FCombatCoreAttribute* A = FindAttribute(Tag);
+	return A ? A->Current : 0.f;
+}
+
+float FCombatCoreCombatant::GetFinal(const FGameplayTag& Tag) const
+{
+	const FCombatCoreAttribute* A = FindAttribute(Tag);
+	return A ? A->Final : 0.f;
+}
+
+bool FCombatCoreCombatant::HasStatus(const FGameplayTag& Tag) const
+{
+	return Statuses.ContainsByPredicate([&Tag](const FCombatCoreStatus& S) { return S.Tag == Tag; });
+}
+
+void FCombatCoreCombatant::GetOwnedTags(FGameplayTagContainer& OutTags) const
+{
+	OutTags.Reset();
+	for (const FCombatCoreStatus& S : Statuses)
+	{
+		OutTags.AddTag(S.Tag);
+	}
+}
+
+bool FCombatCoreCombatant::IsAlive() const
+{
+	// Same rule as ProdigyAbilityUtils::IsDeadByAttributes
+	return GetCurrent(ProdigyTags::Attr::Health) > 0.f;
+}
+
+const FCombatCoreAction* FCombatCoreState::GetAction(int32 CombatantIndex, int32 Slot) const
+{
+	if (!Actions.IsValid() || !Combatants.IsValidIndex(CombatantIndex)) return nullptr;
+
+	const FCombatCoreCombatant& C = Combatants[CombatantIndex];
+	if (!C.ActionIndices.IsValidIndex(Slot)) return nullptr;
+
+	const int32 LibIndex = C.ActionIndices[Slot];
+	return Actions->IsValidIndex(LibIndex) ? &(*Actions)[LibIndex] : nullptr;
+}
+
+int32 FCombatCoreState::FindActionSlot(int32 CombatantIndex, const FGameplayTag& ActionTag) const
+{
+	if (!Actions.IsValid() || !Combatants.IsValidIndex(CombatantIndex)) return INDEX_NONE;
+
+	const FCombatCoreCombatant& C = Combatants[CombatantIndex];
+	for (int32 Slot = 0; Slot < C.ActionIndices.Num(); ++Slot)
+	{
+		const int32 LibIndex = C.ActionIndices[Slot];
+		if (Actions->IsValidIndex(LibIndex) && (*Actions)[LibIndex].ActionTag == ActionTag)
+		{
+			return Slot;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FCombatCoreState::BuildRoster(TArray<FCombatCoreRosterEntry>& OutRoster) const
+{
+	OutRoster.Reset(Combatants.Num());
+	for (const FCombatCoreCombatant& C : Combatants)
+	{
+		FCombatCoreRosterEntry& R = OutRoster.AddDefaulted_GetRef();
+		R.Team = C.Team;
+		R.bAlive = C.IsAlive();
+	}
+}
+
+// =======================
+// Shared rules
+// =======================
+
+float ProdigyCombatCore::ResolveModifiedValue(float OldValue, float Delta, bool bClampMinZero, bool bHasMax, float MaxValue)
+{
+	float NewValue = OldValue + Delta;
+
+	if (bClampMinZero)
+	{
+		NewValue = FMath::Max(0.f, NewValue);
+	}
+
+	if (bHasMax)
+	{
+		NewValue = FMath::Min(NewValue, MaxValue);
+	}
+
+	return NewValue;
+}
+
+double ProdigyCombatCore::ComputeTurnDelay(float Speed, bool bHasted, bool bSlowed)
+{
+	// Clamp so a zero / negative speed can't stall or reverse the queue
+	const float EffectiveSpeed = FMath::Max(1.f, Speed);
+
+	double Delay = DefaultSpeed / EffectiveSpeed;
+
+	if (bHasted) Delay *= 0.5;
+	if (bSlowed) Delay *= 2.0;
+
+	return Delay;
+}
+
+double ProdigyCombatCore::GetTurnDelay(const FCombatCoreCombatant& C)
+{
+	const float Speed = C.FindAttribute(ProdigyTags::Attr::Speed) ? C.GetFinal(ProdigyTags::Attr::Speed) : DefaultSpeed;
+
+	return ComputeTurnDelay(Speed, C.HasStatus(ProdigyTags::Status::Hasted), C.HasStatus(ProdigyTags::Status::Slowed));
+}
+
+bool ProdigyCombatCore::IsInRange(float Distance2D, float MinRange, float MaxRange)
+{
+	if (Distance2D < MinRange) return false;
+	return MaxRange <= 0.f || Distance2D <= MaxRange;
+}
+
+int32 ProdigyCombatCore::SelectAITarget(TArrayView<const FCombatCoreRosterEntry> Roster, int32 SelfIndex)
+{
+	if (!Roster.IsValidIndex(SelfIndex)) return INDEX_NONE;
+
+	const int32 SelfTeam = Roster[SelfIndex].Team;
+	int32 Fallback = INDEX_NONE;
+
+	for (int32 i = 0; i < Roster.Num(); ++i)
+	{
+		if (i == SelfIndex || !Roster[i].bAlive) continue;
+
+		if (Roster[i].Team != SelfTeam)
+		{
+			return i;
+		}
+
+		if (Fallback == INDEX_NONE)
+		{
+			Fallback = i;
+		}
+	}
+
+	return Fallback;
+}
+
+int32 ProdigyCombatCore::GetWinningTeam(TArrayView<const FCombatCoreRosterEntry> Roster)
+{
+	int32 Team = INDEX_NONE;
+
+	for (const FCombatCoreRosterEntry& R : Roster)
+	{
+		if (!R.bAlive) continue;
+
+		if (Team == INDEX_NONE)
+		{
+			Team = R.Team;
+		}
+		else if (Team != R.Team)
+		{
+			return INDEX_NONE;
+		}
+	}
+
+	return Team;
+}
+
+bool ProdigyCombatCore::IsCombatOver(TArrayView<const FCombatCoreRosterEntry> Roster)
+{
+	int32 FirstTeam = INDEX_NONE;
+
+	for (const FCombatCoreRosterEntry& R : Roster)
+	{
+		if (!R.bAlive) continue;
+
+		if (FirstTeam == INDEX_NONE)
+		{
+			FirstTeam = R.Team;
+		}
+		else if (FirstTeam != R.Team)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FGameplayTag ProdigyCombatCore::GetDefaultAIActionTag()
+{
+	return ProdigyTags::Action::Attack::Basic;
+}
+
+// =======================
+// Headless rules
+// =======================
+
+static void ClampResources(FCombatCoreCombatant& C)
+{
+	for (const TPair<FGameplayTag, FGameplayTag>& Pair : C.ResourcePairs)
+	{
+		FCombatCoreAttribute* Cur = C.FindAttribute(Pair.Key);
+		const FCombatCoreAttribute* Max = C.FindAttribute(Pair.Value);
+		if (!Cur || !Max) continue;
+
+		Cur->Current = FMath::Clamp(Cur->Current, 0.f, Max->Final);
+	}
+}
+
+void ProdigyCombatCore::BeginTurn(FCombatCoreState& State, int32 CombatantIndex)
+{
+	if (!State.Combatants.IsValidIndex(CombatantIndex)) return;
+
+	FCombatCoreCombatant& C = State.Combatants[CombatantIndex];
+
+	// AP refresh to FINAL MaxAP
+	if (FCombatCoreAttribute* AP = C.FindAttribute(ProdigyTags::Attr::AP))
+	{
+		if (C.FindAttribute(ProdigyTags::Attr::MaxAP))
+		{
+			AP->Current = C.GetFinal(ProdigyTags::Attr::MaxAP);
+		}
+	}
+
+	// Cooldowns
+	for (int32& Turns : C.CooldownTurns)
+	{
+		if (Turns > 0)
+		{
+			--Turns;
+		}
+	}
+
+	// Periodic effects (reverse for RemoveAtSwap, same as UAttributesComponent::TickTurnEffects)
+	for (int32 i = C.TurnEffects.Num() - 1; i >= 0; --i)
+	{
+		FCombatCoreTurnEffect& E = C.TurnEffects[i];
+
+		FCombatCoreAttribute* Attr = C.FindAttribute(E.AttributeTag);
+		if (!Attr || E.TurnsRemaining <= 0 || FMath::IsNearlyZero(E.DeltaPerTurn))
+		{
+			C.TurnEffects.RemoveAtSwap(i);
+			continue;
+		}
+
+		Attr->Current += E.DeltaPerTurn;
+		ClampResources(C);
+
+		E.TurnsRemaining -= 1;
+		if (E.TurnsRemaining <= 0)
+		{
+			C.TurnEffects.RemoveAtSwap(i);
+		}
+	}
+
+	// Status durations (same as UStatusComponent::TickStartOfTurn). Seconds aren't modelled:
+	// actions applying them are bSimulatable = false, and live statuses come over with their turns only.
+	for (int32 i = C.Statuses.Num() - 1; i >= 0; --i)
+	{
+		FCombatCoreStatus& S = C.Statuses[i];
+		if (S.TurnsRemaining > 0) S.TurnsRemaining--;
+
+		if (S.TurnsRemaining <= 0)
+		{
+			C.Statuses.RemoveAtSwap(i);
+		}
+	}
+}
+
+// bAreaResolved: the caller brings the area's hits, so no position is needed to aim it
+static EActionFailReason QueryActionImpl(const FCombatCoreState& State, int32 CombatantIndex, int32 Slot, int32 TargetIndex, bool bAreaResolved)
+{
+	const FCombatCoreAction* Action = State.GetAction(CombatantIndex, Slot);
+	if (!Action) return EActionFailReason::NoDefinition;
+
+	// No headless model of it
+	if (!Action->bSimulatable) return EActionFailReason::NoDefinition;
+
+	if (!Action->bUsableInCombat) return EActionFailReason::BlockedByTags;
+
+	const FCombatCoreCombatant& C = State.Combatants[CombatantIndex];
+
+	// Target validity
+	switch (Action->TargetingMode)
+	{
+	case EActionTargetingMode::None:
+	case EActionTargetingMode::Self:
+		break;
+
+	case EActionTargetingMode::Unit:
+		if (!State.Combatants.IsValidIndex(TargetIndex) || !State.Combatants[TargetIndex].IsAlive())
+		{
+			return EActionFailReason::InvalidTarget;
+		}
+		break;
+
+	case EActionTargetingMode::Point:
+	default:
+		// No world locations headless (a replayed area cast comes with its hits)
+		if (!bAreaResolved || !Action->Area.IsArea())
+		{
+			return EActionFailReason::InvalidTarget;
+		}
+		break;
+	}
+
+	// Areas are aimed from the instigator's position
+	if (Action->Area.IsArea() && !bAreaResolved && !C.bHasLocation)
+	{
+		return EActionFailReason::InvalidTarget;
+	}
+
+	// Range / sight: only between two world positions (the grid can't tell = allowed, no traces off the game thread)
+	if (Action->TargetingMode == EActionTargetingMode::Unit && TargetIndex != CombatantIndex)
+	{
+		const FCombatCoreCombatant& T = State.Combatants[TargetIndex];
+		if (C.bHasLocation && T.bHasLocation)
+		{
+			if (!IsInRange(FVector::Dist2D(C.Location, T.Location), Action->MinRange, Action->MaxRange))
+			{
+				return EActionFailReason::OutOfRange;
+			}
+
+			if (Action->bRequiresLineOfSight && State.Visibility.IsValid()
+				&& State.Visibility->Query(C.Location, T.Location) == ECombatLineOfSight::Blocked)
+			{
+				return EActionFailReason::NoLineOfSight;
+			}
+		}
+	}
+
+	// Tag gates
+	FGameplayTagContainer Owned;
+	C.GetOwnedTags(Owned);
+
+	if (Owned.HasAny(Action->BlockedTags)) return EActionFailReason::BlockedByTags;
+	if (!Owned.HasAll(Action->RequiredTags)) return EActionFailReason::MissingRequiredTags;
+
+	// Cooldown
+	if (C.CooldownTurns.IsValidIndex(Slot) && C.CooldownTurns[Slot] > 0)
+	{
+		return EActionFailReason::OnCooldown;
+	}
+
+	// AP
+	if (Action->APCost > 0 && C.GetCurrent(ProdigyTags::Attr::AP) < (float)Action->APCost)
+	{
+		return EActionFailReason::InsufficientAP;
+	}
+
+	return EActionFailReason::None;
+}
+
+EActionFailReason ProdigyCombatCore::QueryAction(const FCombatCoreState& State, int32 CombatantIndex, int32 Slot, int32 TargetIndex)
+{
+	return QueryActionImpl(State, CombatantIndex, Slot, TargetIndex, /*bAreaResolved*/ false);
+}
+
+bool ProdigyCombatCore::ResolveAreaTargets(const FCombatCoreState& State, int32 CombatantIndex, const FCombatCoreAction& Action, int32 TargetIndex, TArray<int32>& Out)
+{
+	if (!State.Combatants.IsValidIndex(CombatantIndex)) return false;
+
+	const FCombatCoreCombatant& C = State.Combatants[CombatantIndex];
+	if (!C.bHasLocation) return false;
+
+	// Aim point: the target unit, else straight ahead (UActionComponent::ResolveAreaTargets)
+	FVector TargetPoint = C.Location + C.Forward * Action.Area.Range;
+	if (State.Combatants.IsValidIndex(TargetIndex) && State.Combatants[TargetIndex].bHasLocation)
+	{
+		TargetPoint = State.Combatants[TargetIndex].Location;
+	}
+
+	const FActionAreaQuery Query = FActionAreaQuery::Make(Action.Area, C.Location, C.Forward, TargetPoint);
+
+	struct FCoreAreaHit
+	{
+		int32 Index;
+		float Distance;
+	};
+
+	TArray<FCoreAreaHit, TInlineAllocator<16>> Hits;
+	for (int32 Index = 0; Index < State.Combatants.Num(); ++Index)
+	{
+		const FCombatCoreCombatant& T = State.Combatants[Index];
+		if (!T.IsAlive() || !T.bHasLocation) continue;
+
+		if (Index == CombatantIndex)
+		{
+			if (!Action.Area.bAffectsInstigator) continue;
+		}
+		else if (!Action.Area.AffectsTeam(C.Team, T.Team))
+		{
+			continue;
+		}
+
+		float Distance = 0.f;
+		if (Query.Contains(T.Location, T.Radius, Distance))
+		{
+			Hits.Add({ Index, Distance });
+		}
+	}
+
+	// Closest first, index (= slot) order on ties, same as ActionArea::FinishHits
+	Hits.StableSort([](const FCoreAreaHit& A, const FCoreAreaHit& B) { return A.Distance < B.Distance; });
+
+	const int32 Num = Action.Area.MaxTargets > 0 ? FMath::Min(Action.Area.MaxTargets, Hits.Num()) : Hits.Num();
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Out.Add(Hits[i].Index);
+	}
+	return true;
+}
+
+static void ApplyCoreEffect(FCombatCoreState& State, const FCombatCoreEffect& E, int32 InstigatorIndex, int32 TargetIndex)
+{
+	const int32 ReceiverIndex = E.bTargetsInstigator ? InstigatorIndex : TargetIndex;
+	if (!State.Combatants.IsValidIndex(ReceiverIndex)) return;
+
+	FCombatCoreCombatant& R = State.Combatants[ReceiverIndex];
+
+	switch (E.Kind)
+	{
+	case ECombatCoreEffectKind::ModifyAttribute:
+	{
+		FCombatCoreAttribute* Attr = R.FindAttribute(E.Tag);
+		if (!Attr) return;
+
+		float Delta = E.Delta;
+		if (E.Formula.IsValid() && State.Combatants.IsValidIndex(InstigatorIndex))
+		{
+			const FCombatCoreCombatant* ActionTarget = State.Combatants.IsValidIndex(TargetIndex) ? &State.Combatants[TargetIndex] : nullptr;
+			const float Value = E.Formula.EvaluateCore(State.Combatants[InstigatorIndex], ActionTarget);
+			Delta = E.bFormulaIsDamage ? -FMath::Max(0.f, Value) : Value;
+		}
+		if (FMath::IsNearlyZero(Delta)) return;
+
+		const FCombatCoreAttribute* Max = E.ClampMaxTag.IsValid() ? R.FindAttribute(E.ClampMaxTag) : nullptr;
+		if (E.ClampMaxTag.IsValid() && !Max) return;
+
+		Attr->Current = ProdigyCombatCore::ResolveModifiedValue(
+			Attr->Current, Delta, E.bClampMinZero, Max != nullptr, Max ? Max->Current : 0.f);
+		break;
+	}
+
+	case ECombatCoreEffectKind::ApplyStatus:
+	{
+		if (!E.Tag.IsValid()) return;
+
+		if (FCombatCoreStatus* Existing = R.Statuses.FindByPredicate([&E](const FCombatCoreStatus& S) { return S.Tag == E.Tag; }))
+		{
+			Existing->TurnsRemaining = FMath::Max(Existing->TurnsRemaining, E.Turns);
+		}
+		else
+		{
+			R.Statuses.Add({ E.Tag, FMath::Max(0, E.Turns) });
+		}
+		break;
+	}
+
+	case ECombatCoreEffectKind::Opaque:
+	default:
+		break;
+	}
+}
+
+bool ProdigyCombatCore::ExecuteAction(FCombatCoreState& State, int32 CombatantIndex, int32 Slot, int32 TargetIndex, const TArray<int32>* AreaTargets)
+{
+	if (QueryActionImpl(State, CombatantIndex, Slot, TargetIndex, AreaTargets != nullptr) != EActionFailReason::None)
+	{
+		return false;
+	}
+
+	const FCombatCoreAction& Action = *State.GetAction(CombatantIndex, Slot);
+
+	// Self / None actions resolve "Target" effects on the instigator
+	const int32 EffectTarget = (Action.TargetingMode == EActionTargetingMode::Unit) ? TargetIndex : CombatantIndex;
+
+	// Who gets hit: everyone in the area, else the single target (resolved before anything changes, like the live cast)
+	TArray<int32> Targets;
+	if (!Action.Area.IsArea())
+	{
+		Targets.Add(EffectTarget);
+	}
+	else if (AreaTargets)
+	{
+		Targets = *AreaTargets;
+	}
+	else
+	{
+		ResolveAreaTargets(State, CombatantIndex, Action, TargetIndex, Targets);
+	}
+
+	FCombatCoreCombatant& C = State.Combatants[CombatantIndex];
+
+	if (Action.APCost > 0)
+	{
+		if (FCombatCoreAttribute* AP = C.FindAttribute(ProdigyTags::Attr::AP))
+		{
+			AP->Current -= (float)Action.APCost;
+		}
+	}
+
+	for (int32 Impact = 0; Impact < Action.NumImpacts; ++Impact)
+	{
+		for (const FCombatCoreEffect& E : Action.Effects)
+		{
+			// Instigator-side effects happen once per impact, not once per hit (formula target = the action's target)
+			if (E.bTargetsInstigator)
+			{
+				ApplyCoreEffect(State, E, CombatantIndex, EffectTarget);
+				continue;
+			}
+
+			// A status from an empty area still lands on the action's target (live ApplyStatus does the same)
+			if (Targets.Num() == 0 && E.Kind == ECombatCoreEffectKind::ApplyStatus)
+			{
+				ApplyCoreEffect(State, E, CombatantIndex, TargetIndex);
+				continue;
+			}
+
+			for (const int32 Target : Targets)
+			{
+				ApplyCoreEffect(State, E, CombatantIndex, Target);
+			}
+		}
+	}
+
+	if (C.CooldownTurns.IsValidIndex(Slot))
+	{
+		C.CooldownTurns[Slot] = FMath::Max(0, Action.CooldownTurns);
+	}
+
+	return true;
+}
+
+void ProdigyCombatCore::RunAITurn(FCombatCoreState& State, int32 CombatantIndex)
+{
+	TArray<FCombatCoreRosterEntry, TInlineAllocator<16>> Roster;
+	Roster.Reserve(State.Combatants.Num());
+	for (const FCombatCoreCombatant& C : State.Combatants)
+	{
+		Roster.Add({ C.Team, C.IsAlive() });
+	}
+
+	const int32 Target = SelectAITarget(Roster, CombatantIndex);
+	if (Target == INDEX_NONE) return;
+
+	const int32 Slot = State.FindActionSlot(CombatantIndex, GetDefaultAIActionTag());
+	if (Slot == INDEX_NONE) return;
+
+	// Blocked -> pass, same as the live AI
+	ExecuteAction(State, CombatantIndex, Slot, Target);
+}
+
+void ProdigyCombatCore::SeedTurnQueue(FCombatCoreState& State, int32 FirstToAct)
+{
+	State.TurnQueue.Reset();
+	State.TurnClock = 0.0;
+
+	if (State.Combatants.IsValidIndex(FirstToAct) && State.Combatants[FirstToAct].IsAlive())
+	{
+		State.TurnQueue.Insert(FirstToAct, 0.0);
+	}
+
+	for (int32 i = 0; i < State.Combatants.Num(); ++i)
+	{
+		if (i == FirstToAct || !State.Combatants[i].IsAlive()) continue;
+
+		State.TurnQueue.Insert(i, GetTurnDelay(State.Combatants[i]));
+	}
+}
+
+FCombatCoreOutcome ProdigyCombatCore::RunToCompletion(FCombatCoreState& State, int32 MaxTurns)
+{
+	FCombatCoreOutcome Out;
+
+	if (State.TurnQueue.IsEmpty())
+	{
+		SeedTurnQueue(State, State.CurrentIndex);
+	}
+
+	TArray<FCombatCoreRosterEntry> Roster;
+	State.BuildRoster(Roster);
+
+	while (State.TurnNumber < MaxTurns && !IsCombatOver(Roster))
+	{
+		double ReadyTime = 0.0;
+		const int32 Index = State.TurnQueue.Pop(&ReadyTime);
+		if (Index == INDEX_NONE) break;
+
+		// Dead combatants are dropped lazily when they reach the front
+		if (!State.Combatants[Index].IsAlive()) continue;
+
+		State.CurrentIndex = Index;
+		State.TurnClock = ReadyTime;
+
+		BeginTurn(State, Index);
+
+		if (State.Combatants[Index].IsAlive())
+		{
+			RunAITurn(State, Index);
+		}
+
+		++State.TurnNumber;
+
+		State.BuildRoster(Roster);
+
+		const FCombatCoreCombatant& C = State.Combatants[Index];
+		if (C.IsAlive())
+		{
+			State.TurnQueue.Insert(Index, ReadyTime + GetTurnDelay(C));
+		}
+	}
+
+	Out.WinningTeam = IsCombatOver(Roster) ? GetWinningTeam(Roster) : INDEX_NONE;
+	Out.Turns = State.TurnNumber;
+	return Out;
+}
+
+// =======================
+// Builders
+// =======================
+
+int32 ProdigyCombatCore::GetFactionTeam(FName Faction)
+{
+	// FNames compare case-insensitively, so hash the lowered string; top range is reserved for factions
+	const uint32 Crc = FCrc::StrCrc32(*Faction.ToString().ToLower());
+	return static_cast<int32>((Crc & 0x3FFFFFFF) | 0x40000000);
+}
+
+int32 ProdigyCombatCore::ResolveTeamForActor(const AActor* Actor)
+{
+	const ACombatantCharacterBase* Combatant = Cast<ACombatantCharacterBase>(Actor);
+	if (!Combatant) return UnalignedTeam;
+
+	if (Combatant->CombatTeam != INDEX_NONE)
+	{
+		return Combatant->CombatTeam;
+	}
+
+	return Combatant->AggroFaction.IsNone() ? UnalignedTeam : GetFactionTeam(Combatant->AggroFaction);
+}
+
+int32 ProdigyCombatCore::AddActionToLibrary(TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, const UActionDefinition* Def)
+{
+	if (!IsValid(Def) || !Def->ActionTag.IsValid()) return INDEX_NONE;
+
+	if (const int32* Found = IndexByDef.Find(Def))
+	{
+		return *Found;
+	}
+
+	const int32 NewIndex = Library.Add(FCombatCoreAction::FromDefinition(*Def));
+	IndexByDef.Add(Def, NewIndex);
+	return NewIndex;
+}
+
+static void AppendResourcePairs(const UAttributeSetDataAsset* AttributeSet, FCombatCoreCombatant& Out)
+{
+	if (!IsValid(AttributeSet)) return;
+
+	for (const FProdigyResourcePair& Pair : AttributeSet->ResourcePairs)
+	{
+		if (!Pair.CurrentTag.IsValid() || !Pair.MaxTag.IsValid()) continue;
+		Out.ResourcePairs.Emplace(Pair.CurrentTag, Pair.MaxTag);
+	}
+}
+
+bool ProdigyCombatCore::MakeCombatantFromActor(AActor* Actor, TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, FCombatCoreCombatant& Out)
+{
+	if (!IsValid(Actor)) return false;
+
+	const UAttributesComponent* Attr = Actor->FindComponentByClass<UAttributesComponent>();
+	const UActionComponent* AC = Actor->FindComponentByClass<UActionComponent>();
+	if (!Attr || !AC)
+	{
+		UE_LOG(LogCombatCore, Warning, TEXT("[CombatCore] %s skipped: needs AttributesComponent + ActionComponent"),
+		       *GetNameSafe(Actor));
+		return false;
+	}
+
+	Out = FCombatCoreCombatant();
+	Out.DebugName = Actor->GetFName();
+	Out.Team = ResolveTeamForActor(Actor);
+	Out.Location = Actor->GetActorLocation();
+	Out.Forward = Actor->GetActorForwardVector();
+	Out.Radius = Actor->GetSimpleCollisionRadius();
+	Out.bHasLocation = true;
+
+	TArray<FAttributeEntry> Entries;
+	Attr->GetAttributeEntries(Entries);
+
+	Out.Attributes.Reserve(Entries.Num());
+	for (const FAttributeEntry& E : Entries)
+	{
+		FCombatCoreAttribute& A = Out.Attributes.AddDefaulted_GetRef();
+		A.Tag = E.AttributeTag;
+		A.Current = E.CurrentValue;
+		A.Final = Attr->GetFinalValue(E.AttributeTag);
+	}
+
+	AppendResourcePairs(Attr->AttributeSet, Out);
+
+	for (const FPeriodicTurnEffect& E : Attr->GetTurnEffects())
+	{
+		Out.TurnEffects.Add({ E.EffectTag, E.AttributeTag, E.DeltaPerTurn, E.TurnsRemaining });
+	}
+
+	for (const UActionDefinition* Def : AC->KnownActions)
+	{
+		const int32 LibIndex = AddActionToLibrary(Library, IndexByDef, Def);
+		if (LibIndex == INDEX_NONE) continue;
+
+		Out.ActionIndices.Add(LibIndex);
+		Out.CooldownTurns.Add(AC->GetCooldownTurnsRemaining(Def->ActionTag));
+	}
+
+	if (const UStatusComponent* Status = Actor->FindComponentByClass<UStatusComponent>())
+	{
+		for (const FStatusEntry& S : Status->Statuses)
+		{
+			Out.Statuses.Add({ S.Tag, S.TurnsRemaining });
+		}
+	}
+
+	return true;
+}
+
+bool ProdigyCombatCore::MakeCombatantFromSnapshot(const FCombatantSnapshot& Snapshot, TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, FCombatCoreCombatant& Out)
+{
+	if (!Snapshot.Attributes.IsValid() || !Snapshot.Actions.IsValid()) return false;
+
+	Out = FCombatCoreCombatant();
+	Out.DebugName = Snapshot.DebugName;
+	Out.Team = Snapshot.Team;
+	Out.Location = Snapshot.Transform.GetLocation();
+	Out.Forward = Snapshot.Transform.GetUnitAxis(EAxis::X);
+	Out.Radius = Snapshot.CollisionRadius;
+	Out.bHasLocation = true;
+
+	Out.Attributes.Reserve(Snapshot.Attributes->Num());
+	for (const FAttributeEntry& E : *Snapshot.Attributes)
+	{
+		FCombatCoreAttribute& A = Out.Attributes.AddDefaulted_GetRef();
+		A.Tag = E.AttributeTag;
+		A.Current = E.CurrentValue;
+		A.Final = Snapshot.GetFinalValue(E.AttributeTag);
+	}
+
+	AppendResourcePairs(Snapshot.AttributeSet.Get(), Out);
+
+	if (Snapshot.TurnEffects.IsValid())
+	{
+		for (const FPeriodicTurnEffect& E : *Snapshot.TurnEffects)
+		{
+			Out.TurnEffects.Add({ E.EffectTag, E.AttributeTag, E.DeltaPerTurn, E.TurnsRemaining });
+		}
+	}
+
+	for (const UActionDefinition* Def : *Snapshot.Actions)
+	{
+		const int32 LibIndex = AddActionToLibrary(Library, IndexByDef, Def);
+		if (LibIndex == INDEX_NONE) continue;
+
+		Out.ActionIndices.Add(LibIndex);
+		Out.CooldownTurns.Add(Snapshot.GetCooldownTurnsRemaining(Def->ActionTag));
+	}
+
+	if (Snapshot.Statuses.IsValid())
+	{
+		for (const FStatusEntry& S : *Snapshot.Statuses)
+		{
+			Out.Statuses.Add({ S.Tag, S.TurnsRemaining });
+		}
+	}
+
+	return true;
+}
+
+bool ProdigyCombatCore::MakeCombatantFromAssets(
+	FName DebugName,
+	int32 Team,
+	const UAttributeSetDataAsset* AttributeSet,
+	TConstArrayView<TObjectPtr<UActionDefinition>> Actions,
+	TArray<FCombatCoreAction>& Library,
+	TMap<const UActionDefinition*, int32>& IndexByDef,
+	FCombatCoreCombatant& Out)
+{
+	if (!IsValid(AttributeSet))
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatCore] %s skipped: AttributeSet is null"), *DebugName.ToString());
+		return false;
+	}
+
+	Out = FCombatCoreCombatant();
+	Out.DebugName = DebugName;
+	Out.Team = Team;
+
+	for (const FAttributeEntry& E : AttributeSet->DefaultAttributes)
+	{
+		if (!E.AttributeTag.IsValid()) continue;
+
+		// Last wins, same as UAttributesComponent::AppendDefaultsToMap
+		FCombatCoreAttribute* A = Out.FindAttribute(E.AttributeTag);
+		if (!A)
+		{
+			A = &Out.Attributes.AddDefaulted_GetRef();
+			A->Tag = E.AttributeTag;
+		}
+		A->Current = E.BaseValue;
+		A->Final = E.BaseValue;
+	}
+
+	AppendResourcePairs(AttributeSet, Out);
+
+	for (const UActionDefinition* Def : Actions)
+	{
+		const int32 LibIndex = AddActionToLibrary(Library, IndexByDef, Def);
+		if (LibIndex == INDEX_NONE) continue;
+
+		Out.ActionIndices.Add(LibIndex);
+		Out.CooldownTurns.Add(0);
+	}
+
+	return true;
+}
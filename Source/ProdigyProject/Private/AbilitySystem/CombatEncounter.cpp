@@ -0,0 +1,1774 @@
+﻿#include "AbilitySystem/CombatEncounter.h"
+
+#include "AbilitySystem/ActionAgentInterface.h"
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionCueSubsystem.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatAIUtility.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatMovementComponent.h"
+#include "AbilitySystem/CombatProjectileSubsystem.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/StatusComponent.h"
+#include "AbilitySystem/WorldCombatEvents.h"
+
+UWorld* UCombatEncounter::GetWorld() const
+{
+	return World.Get();
+}
+
+UCombatSubsystem* UCombatEncounter::GetCombatSubsystem() const
+{
+	return Cast<UCombatSubsystem>(GetOuter());
+}
+
+void UCombatEncounter::End()
+{
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d: End Started"), Handle.Id);
+
+	if (!bActive) return;
+
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+
+	// Stop any scheduled work first
+	bTurnBeginScheduled = false;
+	if (Combat)
+	{
+		Combat->CancelEncounterEvents(this);
+	}
+	CancelAIPlan();
+
+	// AI actions in progress don't get to land their remaining impacts
+	if (UActionExecutionSubsystem* Executor = GetWorld() ? GetWorld()->GetSubsystem<UActionExecutionSubsystem>() : nullptr)
+	{
+		Executor->OnExecutionCompletedNative.RemoveAll(this);
+		Executor->Cancel(PendingActionHandle);
+
+		for (const FActionExecutionHandle TeamHandle : TeamPhaseHandles)
+		{
+			Executor->Cancel(TeamHandle);
+		}
+	}
+	PendingActionHandle = FActionExecutionHandle();
+	TeamPhaseHandles.Reset();
+
+	// Close the replay / log while the roster still reflects the outcome
+	{
+		TArray<FCombatCoreRosterEntry> Roster;
+		BuildRoster(Roster);
+		const int32 WinningTeam = ProdigyCombatCore::GetWinningTeam(Roster);
+
+		AddLog(ECombatLogKind::EncounterEnd, nullptr, nullptr, NAME_None, static_cast<float>(WinningTeam));
+
+		if (Recorder.IsRecording())
+		{
+			Recorder.RecordEnd(WinningTeam);
+
+			if (Combat)
+			{
+				Recorder.BuildLog(Combat->LastEndedReplay);
+			}
+		}
+	}
+
+	// Unbind + reset combat flags on everyone who took part (incl. slots already removed on death)
+	// (use the current array before we clear it)
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (Combat)
+		{
+			Combat->UnregisterEncounterActor(Combatants.Actors[Slot], Handle);
+		}
+
+		if (UActionComponent* AC = Combatants.ActionComponents[Slot].Get())
+		{
+			AC->SetInCombat(false);
+			AC->OnActionExecuted.RemoveDynamic(this, &UCombatEncounter::HandleActionExecuted);
+		}
+
+		if (UAttributesComponent* Attr = Combatants.AttributeComponents[Slot].Get())
+		{
+			Attr->OnAttributeChangedNative.RemoveAll(this);
+			Attr->OnDiedNative.RemoveAll(this);
+		}
+
+		if (UStatusComponent* Status = Combatants.StatusComponents[Slot].Get())
+		{
+			Status->OnStatusChangedNative.RemoveAll(this);
+		}
+
+		if (UCombatMovementComponent* Move = Combatants.MovementComponents[Slot].Get())
+		{
+			Move->OnMoveStartedNative.RemoveAll(this);
+		}
+
+		if (AActor* A = Combatants.Actors[Slot].Get())
+		{
+			A->OnDestroyed.RemoveDynamic(this, &UCombatEncounter::HandleParticipantDestroyed);
+		}
+	}
+
+	// ---- IMPORTANT: update state BEFORE notifying ----
+	Participants.Reset();
+	ParticipantSlots.Reset();
+	Combatants.Reset();
+	SlotByActor.Reset();
+	TurnQueue.Reset();
+	Timeline.Reset();
+	ReplayIndexBySlot.Reset();
+	CurrentSlot = INDEX_NONE;
+	TurnClock = 0.0;
+	TeamPhaseSlots.Reset();
+	TeamPhaseNext = 0;
+	TurnSnapshots.Reset();
+	TurnsBegun = 0;
+	VisibilityBuilder.Reset();
+	VisibilityGrid.Reset();
+	bEndPending = false;
+	bActive = false;
+
+	// Subsystem drops us from its maps and notifies listeners with correct, final state
+	if (Combat)
+	{
+		Combat->HandleEncounterEnded(this);
+	}
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d: End Completed"), Handle.Id);
+}
+
+bool UCombatEncounter::Start(FCombatEncounterHandle InHandle, UWorld* InWorld, const TArray<AActor*>& InParticipants, AActor* FirstToAct)
+{
+	// If we're already running, ignore
+	if (bActive) return false;
+
+	Handle = InHandle;
+	World = InWorld;
+
+	// Subsystem already filtered with IsValidCombatant + "not in another encounter"
+	if (InParticipants.Num() < 2)
+	{
+		UE_LOG(LogActionExec, Warning,
+		       TEXT("[Combat] Encounter %d: Start ABORTED: ValidParticipants=%d (need >= 2). FirstToAct=%s"),
+		       Handle.Id, InParticipants.Num(), *GetNameSafe(FirstToAct));
+		return false;
+	}
+
+	// Now we can enter combat
+	bActive = true;
+	bEndPending = false;
+
+	Combatants.Reset();
+	SlotByActor.Reset();
+	Participants.Reset();
+	ParticipantSlots.Reset();
+	TurnQueue.Reset();
+	Timeline.Reset();
+	TurnClock = 0.0;
+	TeamPhaseSlots.Reset();
+	TeamPhaseNext = 0;
+	TeamPhaseHandles.Reset();
+	PendingActionHandle = FActionExecutionHandle();
+	TurnSnapshots.Reset();
+	TurnsBegun = 0;
+
+	if (UActionExecutionSubsystem* Executor = InWorld ? InWorld->GetSubsystem<UActionExecutionSubsystem>() : nullptr)
+	{
+		Executor->OnExecutionCompletedNative.RemoveAll(this);
+		Executor->OnExecutionCompletedNative.AddUObject(this, &UCombatEncounter::HandleExecutionCompletedNative);
+	}
+
+	// Components, team and liveness are resolved once here (see FCombatantTable)
+	for (AActor* A : InParticipants)
+	{
+		if (!IsValid(A) || SlotByActor.Contains(A)) continue;
+
+		BindParticipant(AddSlot(A));
+	}
+
+	BuildVisibilityGrid();
+
+	// Initiative: FirstToAct at clock 0, everyone else after their own turn delay (slot order breaks ties)
+	const int32* FirstSlotPtr = SlotByActor.Find(FirstToAct);
+	CurrentSlot = FirstSlotPtr ? *FirstSlotPtr : 0;
+
+	TurnQueue.Insert(CurrentSlot, 0.0);
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (Slot == CurrentSlot) continue;
+		TurnQueue.Insert(Slot, GetTurnDelayForSlot(Slot));
+	}
+
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+
+	Rng.Initialize(static_cast<int32>(FPlatformTime::Cycles()));
+
+	// Snapshot the starting state before anything else can change it
+	ReplayIndexBySlot.Reset();
+	if (Combat && Combat->bRecordReplays)
+	{
+		FCombatCoreState Snapshot;
+		BuildCoreState(Snapshot, &ReplayIndexBySlot);
+		Recorder.Begin(Snapshot, static_cast<uint32>(Rng.GetInitialSeed()), Handle.Id, Combat->ReplayRingCapacityBytes);
+	}
+
+	AddLog(ECombatLogKind::EncounterStart, FirstToAct, nullptr);
+
+	if (Combat)
+	{
+		Combat->HandleEncounterStarted(this);
+	}
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d: Start: Participants=%d FirstToAct=%s FirstSlot=%d"),
+	       Handle.Id, Participants.Num(), *GetNameSafe(FirstToAct), CurrentSlot);
+
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat]  Slot[%d]=%s Team=%d Ready=%.2f HasActionComp=%d"),
+		       Slot,
+		       *GetNameSafe(Combatants.Actors[Slot].Get()),
+		       Combatants.Teams[Slot],
+		       TurnQueue.GetReadyTime(Slot),
+		       Combatants.ActionComponents[Slot].IsValid());
+	}
+
+
+	// Always a scheduled event when we can: turns never run inside Start (instant playback could finish the fight here)
+	if (Combat)
+	{
+		bTurnBeginScheduled = true;
+		Combat->ScheduleEncounterEvent(this, ECombatEventType::BeginTurn, Combat->ScaleDelay(Combat->EnterCombatDelaySeconds));
+	}
+	else
+	{
+		ScheduleNextTurn(0.f);
+	}
+
+	UWorld* W = GetWorld();
+	if (UActionCueSubsystem* Cues = W ? W->GetSubsystem<UActionCueSubsystem>() : nullptr)
+	{
+		FActionCueContext Ctx;
+		Ctx.InstigatorActor = FirstToAct;
+		Ctx.TargetActor = nullptr;
+		Cues->PlayCue(ActionCueTags::Cue_Combat_Enter, Ctx);
+	}
+
+	return true;
+}
+
+void UCombatEncounter::BeginTurnForSlot(int32 Slot)
+{
+	if (!bActive || bEndPending) return;
+
+	if (Participants.Num() == 0) return;
+	if (!IsSlotAlive(Slot)) return;
+
+	AActor* TurnActor = Combatants.Actors[Slot].Get();
+	if (!IsValid(TurnActor)) return;
+
+	UE_LOG(LogActionExec, Verbose, TEXT("[Combat] BeginTurn: Slot=%d Actor=%s Clock=%.2f"),
+	       Slot, *GetNameSafe(TurnActor), TurnClock);
+
+	if (Recorder.WantsKeyframe())
+	{
+		RecordReplayKeyframe();
+	}
+
+	Recorder.RecordTurnBegin(GetReplayIndex(Slot), TurnClock);
+	AddLog(ECombatLogKind::TurnBegin, TurnActor, nullptr, NAME_None, static_cast<float>(TurnClock));
+
+	// ✅ only begin-turn work now (AP refresh etc.)
+	if (UActionComponent* AC = Combatants.ActionComponents[Slot].Get())
+	{
+		AC->OnTurnBegan();
+	}
+
+	// Turn-start effects (DoTs) can kill; the death event already dropped the slot and moved the turn on
+	if (!bActive || bEndPending || !IsSlotAlive(Slot)) return;
+
+	// Cooldowns ticked without an event; the turn just popped off the queue
+	Timeline.MarkSlotDirty(Slot);
+
+	CaptureTurnSnapshot(Slot);
+
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->HandleEncounterTurnActorChanged(this, TurnActor);
+	}
+
+	// Player waits
+	if (Combatants.IsPlayer(Slot))
+	{
+		// Reachable area now, so hovering only reads the cached field
+		if (UCombatMovementComponent* Move = Combatants.MovementComponents[Slot].Get())
+		{
+			Move->InvalidateReachable();
+			Move->EnsureReachable();
+		}
+
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] Player turn: waiting for input"));
+		return;
+	}
+
+	// ---- AI TURN ----
+
+	if (const UCombatSubsystem* Combat = GetCombatSubsystem(); Combat && Combat->bTeamPhaseAI)
+	{
+		BeginTeamPhase(Slot);
+		return;
+	}
+
+	// Choose target (shared rule with the headless core)
+	TArray<FCombatCoreRosterEntry> Roster;
+	BuildRoster(Roster);
+
+	const int32 TargetSlot = ProdigyCombatCore::SelectAITarget(Roster, Slot);
+	AActor* Target = Combatants.IsValidIndex(TargetSlot) ? Combatants.Actors[TargetSlot].Get() : nullptr;
+	if (!IsValid(Target))
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI turn: no valid target -> passing"));
+		AdvanceTurn();
+		return;
+	}
+
+	if (!Combatants.ActionComponents[Slot].IsValid())
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI turn: no ActionComponent -> passing"));
+		AdvanceTurn();
+		return;
+	}
+
+	// Act after an optional AI delay (0 = next pump, still avoids re-entrancy); instant playback acts right away
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	if (Combat && !Combat->IsInstantPlayback())
+	{
+		const float Delay = Combat->ScaleDelay(Combat->AITakeActionDelaySeconds);
+
+		// Search while the delay runs; keep some slack so the plan is ready when the event pumps.
+		// Utility-driven actors score at act time instead (microseconds, sees the latest state).
+		if (!Combatants.ActionComponents[Slot]->AIUtilityProfile)
+		{
+			RequestAIPlan(Slot, FMath::Min(Combat->AIPlanningBudgetSeconds, Delay * 0.8f));
+		}
+
+		Combat->ScheduleEncounterEvent(this, ECombatEventType::AITakeAction, Delay, Slot, TargetSlot);
+
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI scheduled: Actor=%s Target=%s Delay=%.2f"),
+		       *GetNameSafe(TurnActor), *GetNameSafe(Target), Delay);
+	}
+	else
+	{
+		// Instant playback (or no subsystem): execute now, still pass if it fails
+		TakeAIAction(Slot, TargetSlot);
+	}
+}
+
+void UCombatEncounter::TakeAIAction(int32 Slot, int32 TargetSlot)
+{
+	if (!bActive || bEndPending) return;
+
+	// Still must be the current actor when we act
+	if (Slot != CurrentSlot) return;
+
+	AActor* TurnActor = Combatants.IsValidIndex(Slot) ? Combatants.Actors[Slot].Get() : nullptr;
+	UActionComponent* AC = IsValid(TurnActor) ? Combatants.ActionComponents[Slot].Get() : nullptr;
+
+	if (!IsValid(AC) || !IsSlotAlive(Slot))
+	{
+		CancelAIPlan();
+		AdvanceTurn();
+		return;
+	}
+
+	// Utility profile if the actor has one, else the lookahead plan if the worker finished in time,
+	// else the default attack on TargetSlot
+	FGameplayTag ActionTag = ProdigyCombatCore::GetDefaultAIActionTag();
+
+	FCombatAIPlan Plan;
+	int32 PlannedTargetSlot = INDEX_NONE;
+	if (ChooseUtilityAction(Slot, ActionTag, PlannedTargetSlot))
+	{
+		CancelAIPlan();
+		TargetSlot = PlannedTargetSlot;
+	}
+	else if (ConsumeAIPlan(Slot, Plan, PlannedTargetSlot))
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI plan: Actor=%s Action=%s Target=%s Score=%.2f Depth=%d Nodes=%d (%.1fms)"),
+		       *GetNameSafe(TurnActor),
+		       Plan.bPass ? TEXT("Pass") : *Plan.ActionTag.ToString(),
+		       *GetNameSafe(Combatants.IsValidIndex(PlannedTargetSlot) ? Combatants.Actors[PlannedTargetSlot].Get() : nullptr),
+		       Plan.Score, Plan.Depth, Plan.Nodes, Plan.Seconds * 1000.0);
+
+		if (Plan.bPass)
+		{
+			AdvanceTurn();
+			return;
+		}
+
+		if (IsSlotAlive(PlannedTargetSlot))
+		{
+			ActionTag = Plan.ActionTag;
+			TargetSlot = PlannedTargetSlot;
+		}
+	}
+
+	if (!IsSlotAlive(TargetSlot))
+	{
+		AdvanceTurn();
+		return;
+	}
+
+	FActionContext Ctx;
+	Ctx.Instigator = TurnActor;
+	Ctx.TargetActor = Combatants.Actors[TargetSlot].Get();
+
+	FActionExecutionHandle ActionHandle;
+	const bool bOk = AC->ExecuteActionTracked(ActionTag, Ctx, ActionHandle);
+
+	// If blocked (cooldown / AP / invalid), PASS TURN so combat never stalls.
+	if (!bOk)
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI action failed -> passing turn (%s)"), *GetNameSafe(TurnActor));
+		AdvanceTurn();
+		return;
+	}
+
+	// If succeeded, HandleActionExecuted will AdvanceTurn() once it completes (already did, if it had no phases)
+	PendingActionHandle = ActionHandle;
+}
+
+bool UCombatEncounter::ChooseUtilityAction(int32 Slot, FGameplayTag& OutActionTag, int32& OutTargetSlot) const
+{
+	const UActionComponent* AC = Combatants.IsValidIndex(Slot) ? Combatants.ActionComponents[Slot].Get() : nullptr;
+	const UCombatAIUtilityProfile* Profile = AC ? AC->AIUtilityProfile.Get() : nullptr;
+	if (!Profile) return false;
+
+	const AActor* Self = Combatants.Actors[Slot].Get();
+	if (!IsValid(Self)) return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Gather once into flat arrays (the scoring pass never touches actors or components)
+	FCombatAIUtilityInputs In;
+	In.Team = Combatants.Teams[Slot];
+
+	auto HealthFraction = [](const UAttributesComponent* Attr)
+	{
+		if (!Attr) return 1.f;
+		const float MaxHealth = Attr->GetFinalValue(ProdigyTags::Attr::MaxHealth);
+		return MaxHealth > 0.f ? FMath::Clamp(Attr->GetCurrentValue(ProdigyTags::Attr::Health) / MaxHealth, 0.f, 1.f) : 1.f;
+	};
+
+	if (const UAttributesComponent* Attr = Combatants.AttributeComponents[Slot].Get())
+	{
+		In.HealthFraction = HealthFraction(Attr);
+		In.AP = Attr->GetCurrentValue(ProdigyTags::Attr::AP);
+	}
+	if (const UStatusComponent* Status = Combatants.StatusComponents[Slot].Get())
+	{
+		In.OwnedTags = Status->OwnedTags;
+	}
+	const TConstArrayView<int32> CooldownTurns = AC->GetCooldownTurnsBySlot();
+	for (int32 CooldownSlot = 0; CooldownSlot < CooldownTurns.Num(); ++CooldownSlot)
+	{
+		if (CooldownTurns[CooldownSlot] > 0)
+		{
+			In.CooldownTurns.Add(AC->GetActionTagForSlot(CooldownSlot), CooldownTurns[CooldownSlot]);
+		}
+	}
+
+	TArray<int32, TInlineAllocator<16>> TargetSlots;
+	const FVector SelfLocation = Self->GetActorLocation();
+	for (const int32 S : ParticipantSlots)
+	{
+		if (!Combatants.IsInFight(S)) continue;
+
+		const AActor* A = Combatants.Actors[S].Get();
+		const UStatusComponent* Status = Combatants.StatusComponents[S].Get();
+
+		// Grid lookup; only a pair the grid doesn't cover pays for a trace
+		const bool bInSight = S == Slot || ProdigyCombatVisibility::HasLineOfSight(GetWorld(), VisibilityGrid.Get(), SelfLocation, A->GetActorLocation());
+
+		const int32 Index = In.AddTarget(A->GetFName(), Combatants.Teams[S], HealthFraction(Combatants.AttributeComponents[S].Get()),
+		                                 FVector::Dist2D(SelfLocation, A->GetActorLocation()),
+		                                 Status ? Status->OwnedTags : FGameplayTagContainer::EmptyContainer, bInSight);
+		TargetSlots.Add(S);
+
+		if (S == Slot)
+		{
+			In.SelfTarget = Index;
+		}
+	}
+
+	// Same verdict ExecuteAction will give, per pair: one batched query per target
+	TArray<FGameplayTag, TInlineAllocator<16>> ProfileTags;
+	for (const FCombatAIActionUtility& U : Profile->Actions)
+	{
+		ProfileTags.Add(IsValid(U.Action) ? U.Action->ActionTag : FGameplayTag());
+	}
+
+	const int32 NumTargets = TargetSlots.Num();
+	In.Usable.Init(false, ProfileTags.Num() * NumTargets);
+
+	TArray<FActionQueryResult, TInlineAllocator<16>> Queries;
+	Queries.SetNum(ProfileTags.Num());
+
+	FActionContext QueryCtx;
+	QueryCtx.Instigator = Combatants.Actors[Slot].Get();
+	for (int32 t = 0; t < NumTargets; ++t)
+	{
+		QueryCtx.TargetActor = Combatants.Actors[TargetSlots[t]].Get();
+		AC->QueryActions(ProfileTags, QueryCtx, Queries);
+
+		for (int32 a = 0; a < ProfileTags.Num(); ++a)
+		{
+			In.Usable[a * NumTargets + t] = Queries[a].bCanExecute;
+		}
+	}
+
+	FCombatAIUtilityMatrix Matrix;
+	ProdigyCombatAIUtility::Score(*Profile, In, Matrix);
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+	if (ProdigyCombatAIUtility::ShouldLogMatrix())
+	{
+		TArray<FString> Lines;
+		Matrix.Dump(Lines);
+
+		UE_LOG(LogActionExec, Display, TEXT("[Combat] AI utility matrix for %s (%s, %.1fus):"),
+		       *GetNameSafe(Self), *GetNameSafe(Profile), Seconds * 1000000.0);
+		for (const FString& Line : Lines)
+		{
+			UE_LOG(LogActionExec, Display, TEXT("[Combat]   %s"), *Line);
+		}
+	}
+
+	if (!Matrix.HasDecision())
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI utility: nothing worth doing for %s -> default action"), *GetNameSafe(Self));
+		return false;
+	}
+
+	OutActionTag = Matrix.ActionTags[Matrix.BestAction];
+	OutTargetSlot = TargetSlots[Matrix.BestTarget];
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI utility: Actor=%s Action=%s Target=%s Score=%.3f (%dx%d in %.1fus)"),
+	       *GetNameSafe(Self), *OutActionTag.ToString(), *Matrix.TargetNames[Matrix.BestTarget].ToString(),
+	       Matrix.BestScore, Matrix.NumActions, Matrix.NumTargets, Seconds * 1000000.0);
+	return true;
+}
+
+void UCombatEncounter::BeginTeamPhase(int32 Slot)
+{
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	if (!Combat) return;
+
+	const int32 Team = Combatants.Teams[Slot];
+
+	// Slot's turn already began; queued AI teammates join in initiative order
+	TeamPhaseSlots.Reset();
+	TeamPhaseSlots.Add(Slot);
+	TeamPhaseNext = 0;
+
+	TArray<FCombatTurnQueueEntry> Ordered;
+	TurnQueue.GetOrderedEntries(TurnQueue.Num(), Ordered);
+
+	for (const FCombatTurnQueueEntry& E : Ordered)
+	{
+		if (Combatants.Teams[E.Id] != Team || Combatants.IsPlayer(E.Id)) continue;
+		if (!IsSlotAlive(E.Id) || !Combatants.ActionComponents[E.Id].IsValid()) continue;
+
+		TeamPhaseSlots.Add(E.Id);
+	}
+
+	for (int32 i = 1; i < TeamPhaseSlots.Num(); ++i)
+	{
+		const int32 S = TeamPhaseSlots[i];
+		TurnQueue.Remove(S);
+
+		Recorder.RecordTurnBegin(GetReplayIndex(S), TurnClock);
+		AddLog(ECombatLogKind::TurnBegin, Combatants.Actors[S].Get(), nullptr, NAME_None, static_cast<float>(TurnClock));
+
+		if (UActionComponent* AC = Combatants.ActionComponents[S].Get())
+		{
+			AC->OnTurnBegan();
+		}
+
+		// Turn-start effects can decide the fight; a dead member is skipped when its act comes up
+		if (!bActive || bEndPending) return;
+
+		Timeline.MarkSlotDirty(S);
+	}
+	Timeline.MarkOrderDirty();
+
+	// Spread is capped: more members = tighter stagger, so round time stays about flat
+	const int32 Gaps = TeamPhaseSlots.Num() - 1;
+	TeamPhaseStagger = Gaps > 0
+		? Combat->ScaleDelay(FMath::Min(FMath::Max(0.f, Combat->TeamPhaseStaggerSeconds), FMath::Max(0.f, Combat->TeamPhaseMaxSpreadSeconds) / Gaps))
+		: 0.f;
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Team phase: Team=%d Members=%d Stagger=%.2f"),
+	       Team, TeamPhaseSlots.Num(), TeamPhaseStagger);
+
+	// Instant playback: the whole phase resolves now (anything still playing out ends it on completion)
+	if (Combat->IsInstantPlayback())
+	{
+		while (bActive && !bEndPending && TeamPhaseSlots.IsValidIndex(TeamPhaseNext))
+		{
+			TakeTeamPhaseAction(TeamPhaseSlots[TeamPhaseNext++]);
+		}
+
+		if (bActive && !bEndPending && IsTeamPhaseDone())
+		{
+			EndTeamPhase();
+		}
+		return;
+	}
+
+	Combat->ScheduleEncounterEvent(this, ECombatEventType::TeamPhaseAct, Combat->ScaleDelay(Combat->AITakeActionDelaySeconds));
+}
+
+void UCombatEncounter::HandleTeamPhaseAct()
+{
+	if (!bActive || bEndPending || !IsInTeamPhase()) return;
+
+	if (TeamPhaseSlots.IsValidIndex(TeamPhaseNext))
+	{
+		TakeTeamPhaseAction(TeamPhaseSlots[TeamPhaseNext++]);
+	}
+
+	// The action may have decided the fight
+	if (!bActive || bEndPending) return;
+
+	if (TeamPhaseSlots.IsValidIndex(TeamPhaseNext))
+	{
+		if (UCombatSubsystem* Combat = GetCombatSubsystem())
+		{
+			Combat->ScheduleEncounterEvent(this, ECombatEventType::TeamPhaseAct, TeamPhaseStagger);
+			return;
+		}
+	}
+
+	// Last member acted; HandleExecutionCompletedNative ends the phase once the actions played out
+	if (IsTeamPhaseDone())
+	{
+		EndTeamPhase();
+	}
+}
+
+void UCombatEncounter::TakeTeamPhaseAction(int32 Slot)
+{
+	if (!IsSlotAlive(Slot)) return;
+
+	AActor* TurnActor = Combatants.Actors[Slot].Get();
+	UActionComponent* AC = Combatants.ActionComponents[Slot].Get();
+	if (!IsValid(TurnActor) || !IsValid(AC)) return;
+
+	// Current actor follows whoever is acting (HUD / timeline)
+	CurrentSlot = Slot;
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->HandleEncounterTurnActorChanged(this, TurnActor);
+	}
+
+	// Decided against the state as it is now (earlier members already committed); no lookahead in phases
+	FGameplayTag ActionTag = ProdigyCombatCore::GetDefaultAIActionTag();
+	int32 TargetSlot = INDEX_NONE;
+	if (!ChooseUtilityAction(Slot, ActionTag, TargetSlot))
+	{
+		TArray<FCombatCoreRosterEntry> Roster;
+		BuildRoster(Roster);
+		TargetSlot = ProdigyCombatCore::SelectAITarget(Roster, Slot);
+	}
+
+	if (!IsSlotAlive(TargetSlot))
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] Team phase: %s has no valid target -> skipped"), *GetNameSafe(TurnActor));
+		return;
+	}
+
+	FActionContext Ctx;
+	Ctx.Instigator = TurnActor;
+	Ctx.TargetActor = Combatants.Actors[TargetSlot].Get();
+
+	FActionExecutionHandle ActionHandle;
+	if (!AC->ExecuteActionTracked(ActionTag, Ctx, ActionHandle))
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] Team phase: %s action failed -> skipped"), *GetNameSafe(TurnActor));
+		return;
+	}
+
+	// Invalid = already completed inside Execute
+	if (ActionHandle.IsValid())
+	{
+		TeamPhaseHandles.Add(ActionHandle);
+	}
+}
+
+void UCombatEncounter::EndTeamPhase()
+{
+	// Same as AdvanceTurn for each member: back in the queue one turn delay after the phase clock
+	for (const int32 S : TeamPhaseSlots)
+	{
+		if (IsSlotAlive(S) && !TurnQueue.Contains(S))
+		{
+			TurnQueue.Insert(S, TurnClock + GetTurnDelayForSlot(S));
+		}
+	}
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Team phase done: Members=%d"), TeamPhaseSlots.Num());
+
+	TeamPhaseSlots.Reset();
+	TeamPhaseNext = 0;
+	TeamPhaseHandles.Reset();
+	Timeline.MarkOrderDirty();
+
+	const UCombatSubsystem* Combat = GetCombatSubsystem();
+	ScheduleNextTurn(Combat ? Combat->ScaleDelay(Combat->BetweenTurnsDelaySeconds) : 0.f);
+}
+
+void UCombatEncounter::RequestAIPlan(int32 Slot, float BudgetSeconds)
+{
+	CancelAIPlan();
+
+	const UCombatSubsystem* Combat = GetCombatSubsystem();
+	if (!Combat || !Combat->bUseAIPlanner || BudgetSeconds <= 0.f) return;
+
+	// The snapshot is the only game-thread cost; the search itself runs on a worker.
+	// Right after BeginTurn the turn snapshot is the live state, so no component is read again.
+	FCombatCoreState State;
+	TArray<int32> CoreIndexBySlot;
+	const TSharedPtr<const FCombatSnapshot, ESPMode::ThreadSafe> TurnSnapshot = GetTurnSnapshot();
+	const bool bFromSnapshot = TurnSnapshot.IsValid() && TurnSnapshot->CurrentSlot == Slot && TurnSnapshot->TurnNumber == TurnsBegun;
+	if (!(bFromSnapshot ? ProdigyCombatSnapshot::BuildCoreState(*TurnSnapshot, State, &CoreIndexBySlot) : BuildCoreState(State, &CoreIndexBySlot))) return;
+	State.Visibility = VisibilityGrid;
+
+	const int32 CoreIndex = CoreIndexBySlot.IsValidIndex(Slot) ? CoreIndexBySlot[Slot] : INDEX_NONE;
+	if (CoreIndex == INDEX_NONE) return;
+
+	PendingAIPlanSlotByCore.Init(INDEX_NONE, State.Combatants.Num());
+	for (int32 S = 0; S < CoreIndexBySlot.Num(); ++S)
+	{
+		if (CoreIndexBySlot[S] != INDEX_NONE)
+		{
+			PendingAIPlanSlotByCore[CoreIndexBySlot[S]] = S;
+		}
+	}
+
+	FCombatAIPlannerSettings Settings;
+	Settings.MaxDepth = Combat->AIPlanningMaxDepth;
+	Settings.TimeBudgetSeconds = BudgetSeconds;
+
+	PendingAIPlanSlot = Slot;
+	PendingAIPlanCancel = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+
+	PendingAIPlan = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[State = MoveTemp(State), CoreIndex, Settings, Cancel = PendingAIPlanCancel]()
+		{
+			return FCombatAIPlanner::Plan(State, CoreIndex, Settings, Cancel.Get());
+		});
+}
+
+bool UCombatEncounter::ConsumeAIPlan(int32 Slot, FCombatAIPlan& OutPlan, int32& OutTargetSlot)
+{
+	OutTargetSlot = INDEX_NONE;
+
+	if (!PendingAIPlan.IsValid() || PendingAIPlanSlot != Slot)
+	{
+		CancelAIPlan();
+		return false;
+	}
+
+	// Never block the game thread on the search
+	if (!PendingAIPlan.IsCompleted())
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI plan not ready for Slot=%d -> default action"), Slot);
+		CancelAIPlan();
+		return false;
+	}
+
+	OutPlan = PendingAIPlan.GetResult();
+	if (PendingAIPlanSlotByCore.IsValidIndex(OutPlan.TargetIndex))
+	{
+		OutTargetSlot = PendingAIPlanSlotByCore[OutPlan.TargetIndex];
+	}
+
+	CancelAIPlan();
+	return OutPlan.IsValid();
+}
+
+void UCombatEncounter::CancelAIPlan()
+{
+	if (PendingAIPlanCancel.IsValid())
+	{
+		PendingAIPlanCancel->store(true);
+	}
+
+	// The task owns its snapshot; dropping the handle lets it finish and free on its own
+	PendingAIPlan = UE::Tasks::TTask<FCombatAIPlan>();
+	PendingAIPlanCancel.Reset();
+	PendingAIPlanSlot = INDEX_NONE;
+	PendingAIPlanSlotByCore.Reset();
+}
+
+AActor* UCombatEncounter::GetCurrentTurnActor() const
+{
+	return Combatants.IsValidIndex(CurrentSlot) ? Combatants.Actors[CurrentSlot].Get() : nullptr;
+}
+
+bool UCombatEncounter::ContainsPlayer() const
+{
+	for (const int32 Slot : ParticipantSlots)
+	{
+		if (Combatants.IsPlayer(Slot))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 UCombatEncounter::QueryArea(const FActionAreaQuery& Query, const FActionAreaOfEffect& Area, AActor* Instigator, TArray<AActor*>& Out) const
+{
+	const int32* InstigatorSlot = SlotByActor.Find(Instigator);
+	const int32 InstigatorTeam = InstigatorSlot ? Combatants.Teams[*InstigatorSlot] : ProdigyCombatCore::ResolveTeamForActor(Instigator);
+
+	// Roster is a handful of cached slots: a straight scan beats any physics query
+	TArray<FActionAreaHit, TInlineAllocator<16>> Hits;
+	for (const int32 Slot : ParticipantSlots)
+	{
+		if (!Combatants.IsInFight(Slot)) continue;
+
+		AActor* A = Combatants.Actors[Slot].Get();
+		if (A == Instigator)
+		{
+			if (!Area.bAffectsInstigator) continue;
+		}
+		else if (!Area.AffectsTeam(InstigatorTeam, Combatants.Teams[Slot]))
+		{
+			continue;
+		}
+
+		float Distance = 0.f;
+		if (Query.Contains(A->GetActorLocation(), A->GetSimpleCollisionRadius(), Distance))
+		{
+			Hits.Add({ A, Distance });
+		}
+	}
+
+	const int32 Before = Out.Num();
+	ActionArea::FinishHits(Hits, Area.MaxTargets, Out);
+	return Out.Num() - Before;
+}
+
+void UCombatEncounter::AdvanceTurn()
+{
+	const UCombatSubsystem* Combat = GetCombatSubsystem();
+	AdvanceTurnAfter(Combat ? Combat->ScaleDelay(Combat->BetweenTurnsDelaySeconds) : 0.f);
+}
+
+void UCombatEncounter::AdvanceTurnAfter(float GapSeconds)
+{
+	if (!bActive || bEndPending) return;
+	if (Participants.Num() == 0) return;
+
+	// The phase moves on by itself once its last member acted
+	if (IsInTeamPhase()) return;
+
+	// Guard: don't schedule another begin-turn if one is already queued
+	if (bTurnBeginScheduled)
+	{
+		UE_LOG(LogActionExec, Verbose, TEXT("[Combat] AdvanceTurn ignored (begin turn already scheduled)"));
+		return;
+	}
+
+	AActor* CurrentActor = GetCurrentTurnActor();
+
+	// Re-queue the actor that just finished, one turn delay after its own turn
+	if (IsSlotAlive(CurrentSlot) && !TurnQueue.Contains(CurrentSlot))
+	{
+		TurnQueue.Insert(CurrentSlot, TurnClock + GetTurnDelayForSlot(CurrentSlot));
+		Timeline.MarkOrderDirty();
+	}
+
+	const int32 NextSlot = TurnQueue.Peek();
+	if (NextSlot == INDEX_NONE) return;
+
+	UE_LOG(LogActionExec, Warning,
+		TEXT("[Combat] AdvanceTurn: CurrentSlot=%d Current=%s NextSlot=%d Next=%s NextReady=%.2f"),
+		CurrentSlot,
+		*GetNameSafe(CurrentActor),
+		NextSlot,
+		*GetNameSafe(Combatants.Actors[NextSlot].Get()),
+		TurnQueue.GetReadyTime(NextSlot));
+
+	ScheduleNextTurn(GapSeconds);
+}
+
+void UCombatEncounter::HandleActionExecuted(FGameplayTag ActionTag, const FActionContext& Context)
+{
+	if (!bActive) return;
+
+	// Record every action by a combatant (off-turn ones too, so replays see the same attribute changes)
+	if (Recorder.IsRecording())
+	{
+		const int32* InstSlot = SlotByActor.Find(Context.Instigator);
+		const int32* TargetSlot = SlotByActor.Find(Context.TargetActor);
+
+		// Area casts keep the hits they resolved: the replay has no positions to aim them again
+		UActionDefinition* Def = nullptr;
+		const UActionComponent* AC = InstSlot ? Combatants.ActionComponents[*InstSlot].Get() : nullptr;
+		const bool bArea = AC && AC->TryGetActionDefinition(ActionTag, Def) && Def->Area.IsArea();
+
+		TArray<int32> AreaTargets;
+		if (bArea)
+		{
+			for (AActor* Hit : Context.AreaTargets)
+			{
+				const int32* HitSlot = SlotByActor.Find(Hit);
+				const int32 Index = HitSlot ? GetReplayIndex(*HitSlot) : INDEX_NONE;
+				if (Index != INDEX_NONE)
+				{
+					AreaTargets.Add(Index);
+				}
+			}
+		}
+
+		Recorder.RecordAction(
+			InstSlot ? GetReplayIndex(*InstSlot) : INDEX_NONE,
+			ActionTag,
+			TargetSlot ? GetReplayIndex(*TargetSlot) : INDEX_NONE,
+			Context.TargetLocation,
+			bArea ? &AreaTargets : nullptr);
+	}
+
+	AddLog(ECombatLogKind::Action, Context.Instigator, Context.TargetActor, ActionTag.GetTagName());
+
+	// Cooldowns / turn effects don't broadcast; refresh both ends of the action
+	MarkTimelineDirty(Context.Instigator);
+	MarkTimelineDirty(Context.TargetActor);
+
+	AActor* Current = GetCurrentTurnActor();
+	if (!IsValid(Current)) return;
+
+	if (Context.Instigator != Current)
+	{
+		UE_LOG(LogActionExec, Verbose,
+			   TEXT("[Combat] Ignoring ActionExecuted (not current turn): Inst=%s Current=%s"),
+			   *GetNameSafe(Context.Instigator), *GetNameSafe(Current));
+		return;
+	}
+
+	// Team phase members act on the phase's own schedule
+	if (IsInTeamPhase())
+	{
+		return;
+	}
+
+	// ✅ Player can act multiple times per turn; only EndTurn should advance.
+	if (Combatants.IsPlayer(CurrentSlot))
+	{
+		UE_LOG(LogActionExec, Verbose,
+			   TEXT("[Combat] ActionExecuted by player: staying on same turn (wait for EndTurn)"));
+		return;
+	}
+
+	PendingActionHandle = FActionExecutionHandle();
+
+	// ✅ AI still advances automatically after a successful action
+	// (an action with its own recovery already paused for it; no extra between-turns guess on top)
+	UActionDefinition* Def = nullptr;
+	const UActionComponent* AC = Combatants.ActionComponents[CurrentSlot].Get();
+	if (AC && AC->TryGetActionDefinition(ActionTag, Def) && Def && Def->Timing.HasPhases())
+	{
+		AdvanceTurnAfter(0.f);
+		return;
+	}
+
+	AdvanceTurn();
+}
+
+bool UCombatEncounter::EndCurrentTurn(AActor* Instigator)
+{
+	if (!bActive) return false;
+	if (!IsValid(Instigator)) return false;
+
+	AActor* Current = GetCurrentTurnActor();
+	if (Current != Instigator) return false;
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] EndCurrentTurn: %s"), *GetNameSafe(Instigator));
+
+	AdvanceTurn();
+
+	return true;
+}
+
+void UCombatEncounter::RemoveFromFight(int32 Slot)
+{
+	if (!bActive || !Combatants.IsValidIndex(Slot)) return;
+	if (Combatants.ParticipantIndices[Slot] == INDEX_NONE) return;
+
+	Combatants.Alive[Slot] = false;
+	RemoveSlot(Slot);
+
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	if (Combat)
+	{
+		Combat->HandleEncounterParticipantsChanged(this);
+	}
+
+	TArray<FCombatCoreRosterEntry> Roster;
+	BuildRoster(Roster);
+
+	if (Participants.Num() <= 1 || ProdigyCombatCore::IsCombatOver(Roster))
+	{
+		// Stop turns now, End after the cue window so killing-blow cues can spawn before End clears state / gates cues
+		bEndPending = true;
+		CancelScheduledBeginTurn();
+
+		CancelAIPlan();
+
+		if (Combat)
+		{
+			Combat->CancelEncounterEvent(this, ECombatEventType::AITakeAction);
+			Combat->CancelEncounterEvent(this, ECombatEventType::TeamPhaseAct);
+			Combat->ScheduleEncounterEvent(this, ECombatEventType::EndCombat, Combat->ScaleDelay(Combat->CueWindowSeconds));
+		}
+		else
+		{
+			End();
+		}
+		return;
+	}
+
+	// Died on its own turn (reflect, counters, mid-action...): nobody else will end it, player or AI
+	if (Slot == CurrentSlot)
+	{
+		CancelAIPlan();
+		if (Combat)
+		{
+			Combat->CancelEncounterEvent(this, ECombatEventType::AITakeAction);
+		}
+
+		// Its action may still play out; the turn doesn't wait for it any more
+		PendingActionHandle = FActionExecutionHandle();
+
+		AdvanceTurn();
+	}
+}
+
+void UCombatEncounter::HandleExecutionCompletedNative(FActionExecutionHandle ExecutionHandle, bool bFinished)
+{
+	if (!bActive) return;
+
+	if (TeamPhaseHandles.Remove(ExecutionHandle) > 0)
+	{
+		if (!bEndPending && IsInTeamPhase() && IsTeamPhaseDone())
+		{
+			EndTeamPhase();
+		}
+		return;
+	}
+
+	if (!ExecutionHandle.IsValid() || !(ExecutionHandle == PendingActionHandle)) return;
+
+	PendingActionHandle = FActionExecutionHandle();
+
+	// OnActionExecuted already moved the turn on (or had a reason not to)
+	if (bFinished) return;
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI action ended without OnActionExecuted -> passing turn"));
+	AdvanceTurn();
+}
+
+bool UCombatEncounter::AddCombatant(AActor* Actor)
+{
+	if (!bActive) return false;
+	if (!IsValid(Actor) || SlotByActor.Contains(Actor)) return false;
+
+	const int32 Slot = AddSlot(Actor);
+	BindParticipant(Slot);
+
+	TurnQueue.Insert(Slot, TurnClock + GetTurnDelayForSlot(Slot));
+	Timeline.MarkOrderDirty();
+
+	// The start snapshot doesn't know this combatant
+	Recorder.MarkIncomplete();
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d: Join %s Slot=%d Ready=%.2f"),
+	       Handle.Id, *GetNameSafe(Actor), Slot, TurnQueue.GetReadyTime(Slot));
+
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->HandleEncounterParticipantsChanged(this);
+	}
+	return true;
+}
+
+bool UCombatEncounter::DelayTurn(AActor* Actor, float TurnTime)
+{
+	if (!bActive) return false;
+
+	const int32* Slot = SlotByActor.Find(Actor);
+	if (!Slot) return false;
+
+	// Current actor isn't queued while acting; it picks up its normal delay on AdvanceTurn
+	if (!TurnQueue.Delay(*Slot, TurnTime)) return false;
+	Timeline.MarkOrderDirty();
+
+	UE_LOG(LogActionExec, Verbose, TEXT("[Combat] DelayTurn: %s +%.2f -> Ready=%.2f"),
+	       *GetNameSafe(Actor), TurnTime, TurnQueue.GetReadyTime(*Slot));
+	return true;
+}
+
+double UCombatEncounter::GetTurnDelayForActor(AActor* Actor) const
+{
+	if (!IsValid(Actor) || !Actor->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass()))
+	{
+		return ProdigyCombatCore::ComputeTurnDelay(ProdigyCombatCore::DefaultSpeed, false, false);
+	}
+
+	const float Speed = IActionAgentInterface::Execute_HasAttribute(Actor, ProdigyTags::Attr::Speed)
+		? IActionAgentInterface::Execute_GetAttributeFinalValue(Actor, ProdigyTags::Attr::Speed)
+		: ProdigyCombatCore::DefaultSpeed;
+
+	FGameplayTagContainer Owned;
+	IActionAgentInterface::Execute_GetOwnedGameplayTags(Actor, Owned);
+
+	return ProdigyCombatCore::ComputeTurnDelay(
+		Speed,
+		Owned.HasTagExact(ProdigyTags::Status::Hasted),
+		Owned.HasTagExact(ProdigyTags::Status::Slowed));
+}
+
+double UCombatEncounter::GetTurnDelayForSlot(int32 Slot) const
+{
+	if (!Combatants.IsValidIndex(Slot)) return ProdigyCombatCore::ComputeTurnDelay(ProdigyCombatCore::DefaultSpeed, false, false);
+
+	// Cached components when the actor has them, otherwise the interface path
+	const UAttributesComponent* Attr = Combatants.AttributeComponents[Slot].Get();
+	const UStatusComponent* Status = Combatants.StatusComponents[Slot].Get();
+	if (!Attr || !Status)
+	{
+		return GetTurnDelayForActor(Combatants.Actors[Slot].Get());
+	}
+
+	const float Speed = Attr->HasAttribute(ProdigyTags::Attr::Speed)
+		? Attr->GetFinalValue(ProdigyTags::Attr::Speed)
+		: ProdigyCombatCore::DefaultSpeed;
+
+	return ProdigyCombatCore::ComputeTurnDelay(
+		Speed,
+		Status->HasTag(ProdigyTags::Status::Hasted),
+		Status->HasTag(ProdigyTags::Status::Slowed));
+}
+
+void UCombatEncounter::CancelScheduledBeginTurn()
+{
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->CancelEncounterEvent(this, ECombatEventType::BeginTurn);
+	}
+	bTurnBeginScheduled = false;
+}
+
+void UCombatEncounter::ScheduleNextTurn(float DelaySeconds)
+{
+	if (!bActive || bEndPending) return;
+	if (Participants.Num() == 0) return;
+
+	CancelScheduledBeginTurn();
+
+	bTurnBeginScheduled = true;
+
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	const float Delay = FMath::Max(0.f, DelaySeconds);
+
+	if (Delay <= 0.f || !Combat)
+	{
+		RunTurnsNow();
+		return;
+	}
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] ScheduleNextTurn: NextSlot=%d Delay=%.2f"), TurnQueue.Peek(), Delay);
+
+	Combat->ScheduleEncounterEvent(this, ECombatEventType::BeginTurn, Delay);
+}
+
+void UCombatEncounter::RunTurnsNow()
+{
+	// Chained zero-delay turns (AI acts -> AdvanceTurn -> next turn) run in this loop instead of recursing
+	if (bRunningTurnsNow)
+	{
+		bMoreTurnsNow = true;
+		return;
+	}
+
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	const bool bInstant = Combat && Combat->IsInstantPlayback();
+
+	// Instant playback: presentation collapses into one merged cue / damage-number pass at the end
+	UWorld* W = GetWorld();
+	UActionCueSubsystem* Cues = (bInstant && W) ? W->GetSubsystem<UActionCueSubsystem>() : nullptr;
+	UWorldCombatEvents* Events = (bInstant && W) ? W->GetSubsystem<UWorldCombatEvents>() : nullptr;
+	if (Cues) Cues->BeginCoalesce();
+	if (Events) Events->BeginCoalesce();
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 Turns = 0;
+
+	bRunningTurnsNow = true;
+	do
+	{
+		bMoreTurnsNow = false;
+		HandleScheduledBeginTurn();
+		++Turns;
+	}
+	while (bMoreTurnsNow && bActive && !bEndPending && Turns < MaxTurnsPerFrame);
+	bRunningTurnsNow = false;
+
+	// AI-only fight still going: carry on next pump (the begin-turn flag is still set)
+	if (bMoreTurnsNow && bActive && !bEndPending && Combat)
+	{
+		Combat->ScheduleEncounterEvent(this, ECombatEventType::BeginTurn, 0.f);
+	}
+	bMoreTurnsNow = false;
+
+	if (Events) Events->EndCoalesce();
+	if (Cues) Cues->EndCoalesce();
+
+	if (bInstant)
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] Instant playback: %d turns in %.2fms (Participants=%d)"),
+		       Turns, (FPlatformTime::Seconds() - StartTime) * 1000.0, Participants.Num());
+	}
+}
+
+void UCombatEncounter::HandleScheduledEvent(const FCombatScheduledEvent& Event)
+{
+	if (!bActive) return;
+
+	switch (Event.Type)
+	{
+	case ECombatEventType::BeginTurn:
+		HandleScheduledBeginTurn();
+		break;
+
+	case ECombatEventType::AITakeAction:
+		TakeAIAction(Event.Slot, Event.TargetSlot);
+		break;
+
+	case ECombatEventType::TeamPhaseAct:
+		HandleTeamPhaseAct();
+		break;
+
+	case ECombatEventType::EndCombat:
+		End();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UCombatEncounter::HandleScheduledBeginTurn()
+{
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] HandleScheduledBeginTurn: Next=%d"), TurnQueue.Peek());
+
+	bTurnBeginScheduled = false;
+
+	if (!bActive || bEndPending) return;
+	if (Participants.Num() == 0) return;
+
+	// Dead slots leave the queue on their death event, so the front is normally alive
+	double ReadyTime = TurnClock;
+	int32 NextSlot = TurnQueue.Pop(&ReadyTime);
+	while (NextSlot != INDEX_NONE && !IsSlotAlive(NextSlot))
+	{
+		NextSlot = TurnQueue.Pop(&ReadyTime);
+	}
+
+	if (NextSlot == INDEX_NONE)
+	{
+		// Fallback – keep current
+		NextSlot = CurrentSlot;
+		ReadyTime = TurnClock;
+	}
+
+	CurrentSlot = NextSlot;
+	TurnClock = ReadyTime;
+	Timeline.MarkOrderDirty();
+
+	BeginTurnForSlot(CurrentSlot);
+}
+
+bool UCombatEncounter::IsSlotAlive(int32 Slot) const
+{
+	// Cached liveness (refreshed on Health changes), no interface calls
+	return Combatants.IsInFight(Slot);
+}
+
+int32 UCombatEncounter::AddSlot(AActor* Actor)
+{
+	const int32 Slot = Combatants.Add(Actor, Participants.Add(Actor));
+
+	ParticipantSlots.Add(Slot);
+	SlotByActor.Add(Actor, Slot);
+
+	return Slot;
+}
+
+void UCombatEncounter::RemoveSlot(int32 Slot)
+{
+	if (!Combatants.IsValidIndex(Slot)) return;
+
+	const int32 PIndex = Combatants.ParticipantIndices[Slot];
+	if (PIndex == INDEX_NONE) return;
+
+	TurnQueue.Remove(Slot);
+	Timeline.MarkOrderDirty();
+
+	// O(1) swap-remove; fix the back-pointer of whoever moved into PIndex
+	Participants.RemoveAtSwap(PIndex, EAllowShrinking::No);
+	ParticipantSlots.RemoveAtSwap(PIndex, EAllowShrinking::No);
+	if (ParticipantSlots.IsValidIndex(PIndex))
+	{
+		Combatants.ParticipantIndices[ParticipantSlots[PIndex]] = PIndex;
+	}
+
+	Combatants.ParticipantIndices[Slot] = INDEX_NONE;
+
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->UnregisterEncounterActor(Combatants.Actors[Slot], Handle);
+	}
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Removed Slot=%d Actor=%s"), Slot, *GetNameSafe(Combatants.Actors[Slot].Get()));
+}
+
+void UCombatEncounter::BindParticipant(int32 Slot)
+{
+	if (UActionComponent* AC = Combatants.ActionComponents[Slot].Get())
+	{
+		AC->SetInCombat(true);
+
+		AC->OnActionExecuted.RemoveDynamic(this, &UCombatEncounter::HandleActionExecuted);
+		AC->OnActionExecuted.AddDynamic(this, &UCombatEncounter::HandleActionExecuted);
+	}
+
+	// Replay recording and timeline invalidation; death drops the slot right away
+	if (UAttributesComponent* Attr = Combatants.AttributeComponents[Slot].Get())
+	{
+		Attr->OnAttributeChangedNative.RemoveAll(this);
+		Attr->OnAttributeChangedNative.AddUObject(this, &UCombatEncounter::HandleAttributeChangedNative);
+
+		Attr->OnDiedNative.RemoveAll(this);
+		Attr->OnDiedNative.AddUObject(this, &UCombatEncounter::HandleDiedNative);
+	}
+
+	if (AActor* A = Combatants.Actors[Slot].Get())
+	{
+		A->OnDestroyed.RemoveDynamic(this, &UCombatEncounter::HandleParticipantDestroyed);
+		A->OnDestroyed.AddDynamic(this, &UCombatEncounter::HandleParticipantDestroyed);
+	}
+
+	if (UStatusComponent* Status = Combatants.StatusComponents[Slot].Get())
+	{
+		Status->OnStatusChangedNative.RemoveAll(this);
+		Status->OnStatusChangedNative.AddUObject(this, &UCombatEncounter::HandleStatusChangedNative);
+	}
+
+	if (UCombatMovementComponent* Move = Combatants.MovementComponents[Slot].Get())
+	{
+		Move->OnMoveStartedNative.RemoveAll(this);
+		Move->OnMoveStartedNative.AddUObject(this, &UCombatEncounter::HandleMoveStartedNative);
+	}
+}
+
+void UCombatEncounter::HandleMoveStartedNative(UCombatMovementComponent* Mover, int32 APCost)
+{
+	if (!bActive || !Mover) return;
+
+	// The AP change itself is already recorded; the move tells the replay where it came from
+	if (const int32* Slot = SlotByActor.Find(Mover->GetOwner()))
+	{
+		Recorder.RecordMove(GetReplayIndex(*Slot), APCost);
+	}
+}
+
+void UCombatEncounter::HandleAttributeChangedNative(UAttributesComponent* Attributes, FGameplayTag Tag, float NewValue, float Delta, AActor* Instigator)
+{
+	if (!bActive || !Attributes) return;
+
+	const int32* Slot = SlotByActor.Find(Attributes->GetOwner());
+	if (!Slot) return;
+
+	Recorder.RecordAttributeChanged(GetReplayIndex(*Slot), Tag, NewValue);
+	Timeline.MarkSlotDirty(*Slot);
+
+	if (Tag == ProdigyTags::Attr::Health && !FMath::IsNearlyZero(Delta))
+	{
+		AddLog(Delta < 0.f ? ECombatLogKind::Damage : ECombatLogKind::Heal, Instigator, Attributes->GetOwner(), NAME_None, FMath::Abs(Delta));
+	}
+}
+
+void UCombatEncounter::HandleDiedNative(UAttributesComponent* Attributes, AActor* Killer, FGameplayTag ResourceTag)
+{
+	if (!bActive || !Attributes) return;
+
+	const int32* Slot = SlotByActor.Find(Attributes->GetOwner());
+	if (!Slot) return;
+
+	UE_LOG(LogActionExec, Log, TEXT("[Combat] Died: Slot=%d Actor=%s Killer=%s (%s)"),
+		*Slot, *GetNameSafe(Attributes->GetOwner()), *GetNameSafe(Killer), *ResourceTag.ToString());
+
+	AddLog(ECombatLogKind::Death, Killer, Attributes->GetOwner(), ResourceTag.GetTagName());
+
+	RemoveFromFight(*Slot);
+}
+
+void UCombatEncounter::HandleParticipantDestroyed(AActor* DestroyedActor)
+{
+	if (!bActive) return;
+
+	if (const int32* Slot = SlotByActor.Find(DestroyedActor))
+	{
+		RemoveFromFight(*Slot);
+	}
+}
+
+void UCombatEncounter::HandleStatusChangedNative(UStatusComponent* Status, FGameplayTag Tag, bool bAdded)
+{
+	if (!bActive || !Status) return;
+
+	AddLog(bAdded ? ECombatLogKind::StatusApplied : ECombatLogKind::StatusRemoved, nullptr, Status->GetOwner(), Tag.GetTagName());
+	MarkTimelineDirty(Status->GetOwner());
+}
+
+void UCombatEncounter::AddLog(ECombatLogKind Kind, const AActor* Source, const AActor* Target, FName Tag, float Value) const
+{
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->AddCombatLog(Kind, Handle.Id, Source, Target, Tag, Value);
+	}
+}
+
+void UCombatEncounter::MarkTimelineDirty(AActor* Actor)
+{
+	if (const int32* Slot = Actor ? SlotByActor.Find(Actor) : nullptr)
+	{
+		Timeline.MarkSlotDirty(*Slot);
+	}
+}
+
+const TArray<FCombatTimelineEntry>& UCombatEncounter::GetTurnTimeline(int32 NumTurns)
+{
+	NumTurns = FMath::Max(0, NumTurns);
+
+	if (!bActive || Timeline.IsUpToDate(NumTurns))
+	{
+		return Timeline.GetEntries();
+	}
+
+	// Only dirty (or too shallow) projections are rebuilt; a combatant can show up at most NumTurns times
+	for (const int32 Slot : ParticipantSlots)
+	{
+		if (Timeline.NeedsProjection(Slot, NumTurns))
+		{
+			FCombatTimelineProjection Projection;
+			ProdigyCombatTimeline::ProjectActor(Combatants.Actors[Slot].Get(), NumTurns, Projection);
+			Timeline.SetProjection(Slot, MoveTemp(Projection));
+		}
+	}
+
+	Timeline.Build(NumTurns, CurrentSlot, TurnClock, TurnQueue, [this](int32 Slot) -> AActor*
+	{
+		return IsSlotAlive(Slot) ? Combatants.Actors[Slot].Get() : nullptr;
+	});
+
+	return Timeline.GetEntries();
+}
+
+void UCombatEncounter::CaptureTurnSnapshot(int32 Slot)
+{
+	++TurnsBegun;
+
+	const UCombatSubsystem* Combat = GetCombatSubsystem();
+	const int32 MaxHistory = Combat ? Combat->TurnSnapshotHistory : 1;
+	if (MaxHistory <= 0) return;
+
+	const FCombatSnapshot* Prev = TurnSnapshots.Num() > 0 ? TurnSnapshots.Last().Get() : nullptr;
+
+	TSharedRef<FCombatSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FCombatSnapshot, ESPMode::ThreadSafe>();
+	Snapshot->TurnNumber = TurnsBegun;
+	Snapshot->CurrentSlot = Slot;
+	Snapshot->TurnClock = TurnClock;
+	Snapshot->TurnQueue = TurnQueue;
+	Snapshot->Rng = Rng;
+
+	Snapshot->Combatants.SetNum(Combatants.Num());
+	for (int32 S = 0; S < Combatants.Num(); ++S)
+	{
+		const FCombatantSnapshot* PrevCombatant = Prev && Prev->Combatants.IsValidIndex(S) ? &Prev->Combatants[S] : nullptr;
+		ProdigyCombatSnapshot::CaptureCombatant(Combatants, S, IsSlotAlive(S), PrevCombatant,
+			Snapshot->Combatants[S], Snapshot->NumCopiedBlocks, Snapshot->NumSharedBlocks);
+	}
+
+	UE_LOG(LogActionExec, Verbose, TEXT("[Combat] Snapshot turn %d: copied %d blocks, shared %d"),
+	       TurnsBegun, Snapshot->NumCopiedBlocks, Snapshot->NumSharedBlocks);
+
+	if (TurnSnapshots.Num() >= MaxHistory)
+	{
+		TurnSnapshots.RemoveAt(0, TurnSnapshots.Num() - MaxHistory + 1);
+	}
+	TurnSnapshots.Add(Snapshot);
+}
+
+TSharedPtr<const FCombatSnapshot, ESPMode::ThreadSafe> UCombatEncounter::GetTurnSnapshot(int32 TurnsAgo) const
+{
+	const int32 Index = TurnSnapshots.Num() - 1 - TurnsAgo;
+	return TurnSnapshots.IsValidIndex(Index) ? TurnSnapshots[Index] : nullptr;
+}
+
+bool UCombatEncounter::CanRewindTurn() const
+{
+	if (!bActive || bEndPending || bTurnBeginScheduled || IsInTeamPhase()) return false;
+	if (!Combatants.IsPlayer(CurrentSlot)) return false;
+
+	// Effects still in the air (or still winding up) would land after the rewind
+	const UWorld* W = GetWorld();
+	const UCombatProjectileSubsystem* Projectiles = W ? W->GetSubsystem<UCombatProjectileSubsystem>() : nullptr;
+	if (Projectiles && Projectiles->NumInFlight() > 0) return false;
+
+	const UActionExecutionSubsystem* Executor = W ? W->GetSubsystem<UActionExecutionSubsystem>() : nullptr;
+	if (Executor && Executor->NumRunning() > 0) return false;
+
+	const FCombatSnapshot* Snapshot = TurnSnapshots.Num() > 0 ? TurnSnapshots.Last().Get() : nullptr;
+	if (!Snapshot || Snapshot->TurnNumber != TurnsBegun || Snapshot->CurrentSlot != CurrentSlot) return false;
+
+	// Deaths (ragdolls, removal) and joins can't be undone: same roster or nothing
+	if (Snapshot->Combatants.Num() != Combatants.Num()) return false;
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (Snapshot->Combatants[Slot].bInFight != IsSlotAlive(Slot)) return false;
+
+		const UCombatMovementComponent* Move = Combatants.MovementComponents[Slot].Get();
+		if (Move && Move->IsMoving()) return false;
+	}
+
+	return true;
+}
+
+bool UCombatEncounter::RewindTurn()
+{
+	if (!CanRewindTurn())
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Combat] RewindTurn refused (not a rewindable player turn)"));
+		return false;
+	}
+
+	const TSharedPtr<const FCombatSnapshot, ESPMode::ThreadSafe> Snapshot = TurnSnapshots.Last();
+	AActor* TurnActor = Combatants.Actors[CurrentSlot].Get();
+
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (!Snapshot->Combatants[Slot].bInFight) continue;
+
+		if (!ProdigyCombatSnapshot::RestoreCombatant(Combatants, Slot, Snapshot->Combatants[Slot], TurnActor))
+		{
+			UE_LOG(LogActionExec, Warning, TEXT("[Combat] RewindTurn: %s lost a component, restored partially"),
+			       *GetNameSafe(Combatants.Actors[Slot].Get()));
+		}
+		Timeline.MarkSlotDirty(Slot);
+
+		AActor* A = Combatants.Actors[Slot].Get();
+		if (A && !A->GetActorTransform().Equals(Snapshot->Combatants[Slot].Transform))
+		{
+			A->SetActorTransform(Snapshot->Combatants[Slot].Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+
+	TurnQueue = Snapshot->TurnQueue;
+	TurnClock = Snapshot->TurnClock;
+	Rng = Snapshot->Rng;
+	Timeline.MarkOrderDirty();
+
+	// The log can't express an undo
+	Recorder.MarkIncomplete();
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] RewindTurn: %s back to the start of turn %d"),
+	       *GetNameSafe(TurnActor), Snapshot->TurnNumber);
+
+	if (UCombatMovementComponent* Move = Combatants.MovementComponents[CurrentSlot].Get())
+	{
+		Move->EnsureReachable();
+	}
+
+	if (UCombatSubsystem* Combat = GetCombatSubsystem())
+	{
+		Combat->HandleEncounterTurnActorChanged(this, TurnActor);
+	}
+
+	return true;
+}
+
+void UCombatEncounter::BuildVisibilityGrid()
+{
+	VisibilityBuilder.Reset();
+	VisibilityGrid.Reset();
+
+	const UCombatSubsystem* Combat = GetCombatSubsystem();
+	UWorld* W = GetWorld();
+	if (!Combat || !Combat->bBuildVisibilityGrid || !W) return;
+
+	FBox Area(ForceInit);
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (const AActor* A = Combatants.Actors[Slot].Get())
+		{
+			Area += A->GetActorLocation();
+		}
+	}
+	if (!Area.IsValid) return;
+
+	FCombatVisibilitySettings Settings;
+	Settings.CellSize = Combat->VisibilityCellSize;
+	Settings.MaxCells = Combat->VisibilityMaxCells;
+	Settings.Margin = Combat->VisibilityMargin;
+	Settings.MaxPairDistance = Combat->VisibilityMaxPairDistance;
+	Settings.EyeHeight = Combat->VisibilityEyeHeight;
+	Settings.TracesPerBatch = Combat->VisibilityTracesPerBatch;
+
+	// Until it lands every sight check falls back to a single trace
+	VisibilityBuilder = MakeShared<FCombatVisibilityGridBuilder>();
+	VisibilityBuilder->Start(W, Area, Settings,
+		FCombatVisibilityGridBuilder::FOnBuilt::CreateUObject(this, &UCombatEncounter::HandleVisibilityGridBuilt));
+}
+
+void UCombatEncounter::HandleVisibilityGridBuilt(TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe> Grid)
+{
+	if (!bActive) return;
+
+	VisibilityGrid = MoveTemp(Grid);
+}
+
+void UCombatEncounter::BuildRoster(TArray<FCombatCoreRosterEntry>& OutRoster) const
+{
+	OutRoster.Reset(Combatants.Num());
+
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		FCombatCoreRosterEntry& R = OutRoster.AddDefaulted_GetRef();
+		R.Team = Combatants.Teams[Slot];
+		R.bAlive = IsSlotAlive(Slot);
+	}
+}
+
+void UCombatEncounter::RecordReplayKeyframe()
+{
+	// Same combatant indices as the starting snapshot, dead ones included (the replay never removes anyone)
+	FCombatCoreState State;
+	TArray<FCombatCoreAction> Library;
+	TMap<const UActionDefinition*, int32> IndexByDef;
+
+	int32 NumReplayed = 0;
+	for (const int32 Index : ReplayIndexBySlot)
+	{
+		NumReplayed = FMath::Max(NumReplayed, Index + 1);
+	}
+	State.Combatants.SetNum(NumReplayed);
+
+	for (int32 Slot = 0; Slot < ReplayIndexBySlot.Num(); ++Slot)
+	{
+		const int32 Index = ReplayIndexBySlot[Slot];
+		if (Index == INDEX_NONE) continue;
+
+		AActor* Actor = Combatants.IsValidIndex(Slot) ? Combatants.Actors[Slot].Get() : nullptr;
+
+		FCombatCoreCombatant& C = State.Combatants[Index];
+		if (ProdigyCombatCore::MakeCombatantFromActor(Actor, Library, IndexByDef, C)) continue;
+
+		// Gone from the world: keep the index, as a dead body
+		C = FCombatCoreCombatant();
+		C.DebugName = Actor ? Actor->GetFName() : NAME_None;
+		C.Team = Combatants.IsValidIndex(Slot) ? Combatants.Teams[Slot] : INDEX_NONE;
+		C.Attributes.AddDefaulted_GetRef().Tag = ProdigyTags::Attr::Health;
+	}
+
+	State.Actions = MakeShared<TArray<FCombatCoreAction>, ESPMode::ThreadSafe>(MoveTemp(Library));
+	State.TurnClock = TurnClock;
+	State.CurrentIndex = GetReplayIndex(CurrentSlot);
+
+	TArray<FCombatTurnQueueEntry> Ordered;
+	TurnQueue.GetOrderedEntries(TurnQueue.Num(), Ordered);
+
+	for (const FCombatTurnQueueEntry& E : Ordered)
+	{
+		const int32 Index = GetReplayIndex(E.Id);
+		if (Index != INDEX_NONE)
+		{
+			State.TurnQueue.Insert(Index, E.ReadyTime);
+		}
+	}
+
+	Recorder.RecordKeyframe(State);
+}
+
+bool UCombatEncounter::BuildCoreState(FCombatCoreState& OutState, TArray<int32>* OutCoreIndexBySlot) const
+{
+	if (!bActive) return false;
+
+	TArray<FCombatCoreAction> Library;
+	TMap<const UActionDefinition*, int32> IndexByDef;
+
+	OutState = FCombatCoreState();
+	OutState.CurrentIndex = INDEX_NONE;
+
+	TArray<int32> CoreIndexBySlot;
+	CoreIndexBySlot.Init(INDEX_NONE, Combatants.Num());
+
+	for (int32 Slot = 0; Slot < Combatants.Num(); ++Slot)
+	{
+		if (!IsSlotAlive(Slot)) continue;
+
+		FCombatCoreCombatant C;
+		if (!ProdigyCombatCore::MakeCombatantFromActor(Combatants.Actors[Slot].Get(), Library, IndexByDef, C)) continue;
+
+		CoreIndexBySlot[Slot] = OutState.Combatants.Add(MoveTemp(C));
+	}
+
+	OutState.Actions = MakeShared<TArray<FCombatCoreAction>, ESPMode::ThreadSafe>(MoveTemp(Library));
+	OutState.TurnClock = TurnClock;
+	OutState.Rng = Rng;
+	OutState.Visibility = VisibilityGrid;
+
+	// Current actor replays its turn first, then the live queue in acting order
+	if (CoreIndexBySlot.IsValidIndex(CurrentSlot))
+	{
+		OutState.CurrentIndex = CoreIndexBySlot[CurrentSlot];
+		if (OutState.CurrentIndex != INDEX_NONE && !TurnQueue.Contains(CurrentSlot))
+		{
+			OutState.TurnQueue.Insert(OutState.CurrentIndex, TurnClock);
+		}
+	}
+
+	TArray<FCombatTurnQueueEntry> Ordered;
+	TurnQueue.GetOrderedEntries(TurnQueue.Num(), Ordered);
+
+	for (const FCombatTurnQueueEntry& E : Ordered)
+	{
+		const int32 CoreIndex = CoreIndexBySlot.IsValidIndex(E.Id) ? CoreIndexBySlot[E.Id] : INDEX_NONE;
+		if (CoreIndex == INDEX_NONE) continue;
+
+		OutState.TurnQueue.Insert(CoreIndex, E.ReadyTime);
+	}
+
+	if (OutCoreIndexBySlot)
+	{
+		*OutCoreIndexBySlot = MoveTemp(CoreIndexBySlot);
+	}
+
+	return OutState.Combatants.Num() >= 2;
+}
@@ -0,0 +1,493 @@
+﻿#include "AbilitySystem/CombatFormula.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionEffectBatch.h"
+#include "AbilitySystem/CombatCore.h"
+#include "HAL/IConsoleManager.h"
+
+// =======================
+// VM
+// =======================
+
+namespace
+{
+	float ApplyOp(ECombatFormulaOp Op, float X, float Y, float Z)
+	{
+		switch (Op)
+		{
+		case ECombatFormulaOp::Add:   return X + Y;
+		case ECombatFormulaOp::Sub:   return X - Y;
+		case ECombatFormulaOp::Mul:   return X * Y;
+		case ECombatFormulaOp::Div:   return FMath::IsNearlyZero(Y) ? 0.f : X / Y;
+		case ECombatFormulaOp::Min:   return FMath::Min(X, Y);
+		case ECombatFormulaOp::Max:   return FMath::Max(X, Y);
+		case ECombatFormulaOp::Clamp: return FMath::Clamp(X, Y, FMath::Max(Y, Z));
+		case ECombatFormulaOp::Neg:   return -X;
+		case ECombatFormulaOp::Abs:   return FMath::Abs(X);
+		case ECombatFormulaOp::Floor: return FMath::FloorToFloat(X);
+		default:                      return 0.f;
+		}
+	}
+}
+
+float FCombatFormulaProgram::Evaluate(TConstArrayView<float> SlotValues) const
+{
+	if (Code.Num() == 0 || SlotValues.Num() < Slots.Num()) return 0.f;
+
+	float R[MaxRegisters];
+
+	for (const FCombatFormulaInstr& I : Code)
+	{
+		switch (I.Op)
+		{
+		case ECombatFormulaOp::Const: R[I.Dst] = Constants[I.Index]; break;
+		case ECombatFormulaOp::Load:  R[I.Dst] = SlotValues[I.Index]; break;
+		case ECombatFormulaOp::Add:   R[I.Dst] = R[I.A] + R[I.B]; break;
+		case ECombatFormulaOp::Sub:   R[I.Dst] = R[I.A] - R[I.B]; break;
+		case ECombatFormulaOp::Mul:   R[I.Dst] = R[I.A] * R[I.B]; break;
+		case ECombatFormulaOp::Clamp: R[I.Dst] = ApplyOp(I.Op, R[I.Dst], R[I.A], R[I.B]); break;
+		default:                      R[I.Dst] = ApplyOp(I.Op, R[I.A], R[I.B], 0.f); break;
+		}
+	}
+
+	return R[0];
+}
+
+float FCombatFormulaProgram::EvaluateCore(const FCombatCoreCombatant& Source, const FCombatCoreCombatant* Target) const
+{
+	TArray<float, TInlineAllocator<16>> Values;
+	Values.SetNumUninitialized(Slots.Num());
+
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		const FCombatFormulaSlot& S = Slots[i];
+		const FCombatCoreCombatant* C = S.bTarget ? Target : &Source;
+		const FCombatCoreAttribute* A = C ? C->FindAttribute(S.Tag) : nullptr;
+
+		Values[i] = A ? (S.bCurrent ? A->Current : A->Final) : 0.f;
+	}
+
+	return Evaluate(Values);
+}
+
+// =======================
+// Compiler
+// =======================
+
+namespace
+{
+	struct FNode
+	{
+		enum class EKind : uint8 { Const, Slot, Op };
+
+		EKind Kind = EKind::Const;
+		ECombatFormulaOp Op = ECombatFormulaOp::Const;
+		float Value = 0.f;
+		int32 Slot = INDEX_NONE;
+		int32 Args[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+		int32 NumArgs = 0;
+	};
+
+	// Recursive descent straight into a node list; constant subtrees are folded as they're built
+	struct FParser
+	{
+		const FString& Text;
+		int32 Pos = 0;
+		FString Error;
+
+		TArray<FNode> Nodes;
+		TArray<FCombatFormulaSlot> Slots;
+
+		explicit FParser(const FString& InText) : Text(InText) {}
+
+		bool Failed() const { return !Error.IsEmpty(); }
+
+		int32 Fail(const FString& Message)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("%s (at %d)"), *Message, Pos);
+			}
+			return INDEX_NONE;
+		}
+
+		void SkipSpace()
+		{
+			while (Pos < Text.Len() && FChar::IsWhitespace(Text[Pos])) ++Pos;
+		}
+
+		bool Accept(TCHAR C)
+		{
+			SkipSpace();
+			if (Pos < Text.Len() && Text[Pos] == C)
+			{
+				++Pos;
+				return true;
+			}
+			return false;
+		}
+
+		static bool IsIdentChar(TCHAR C) { return FChar::IsAlnum(C) || C == TEXT('_') || C == TEXT('.'); }
+
+		FString ReadIdent()
+		{
+			SkipSpace();
+			const int32 Start = Pos;
+			while (Pos < Text.Len() && IsIdentChar(Text[Pos])) ++Pos;
+			return Text.Mid(Start, Pos - Start);
+		}
+
+		int32 AddConst(float Value)
+		{
+			FNode N;
+			N.Kind = FNode::EKind::Const;
+			N.Value = Value;
+			return Nodes.Add(N);
+		}
+
+		int32 AddOp(ECombatFormulaOp Op, int32 A, int32 B = INDEX_NONE, int32 C = INDEX_NONE)
+		{
+			if (A == INDEX_NONE || Failed()) return INDEX_NONE;
+
+			FNode N;
+			N.Kind = FNode::EKind::Op;
+			N.Op = Op;
+			N.Args[0] = A;
+			N.Args[1] = B;
+			N.Args[2] = C;
+			N.NumArgs = (C != INDEX_NONE) ? 3 : (B != INDEX_NONE) ? 2 : 1;
+
+			bool bAllConst = true;
+			float V[3] = { 0.f, 0.f, 0.f };
+			for (int32 i = 0; i < N.NumArgs; ++i)
+			{
+				bAllConst &= Nodes[N.Args[i]].Kind == FNode::EKind::Const;
+				V[i] = Nodes[N.Args[i]].Value;
+			}
+
+			if (bAllConst)
+			{
+				return AddConst(ApplyOp(Op, V[0], V[1], V[2]));
+			}
+			return Nodes.Add(N);
+		}
+
+		int32 ParseAttribute(FString Name, bool bCurrent)
+		{
+			bool bTarget = false;
+			if (Name.RemoveFromStart(TEXT("Target.")))
+			{
+				bTarget = true;
+			}
+			else
+			{
+				Name.RemoveFromStart(TEXT("Source."));
+			}
+
+			const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName(*Name), false);
+			if (!Tag.IsValid())
+			{
+				return Fail(FString::Printf(TEXT("unknown attribute tag '%s'"), *Name));
+			}
+
+			FCombatFormulaSlot S;
+			S.Tag = Tag;
+			S.bTarget = bTarget;
+			S.bCurrent = bCurrent;
+
+			FNode N;
+			N.Kind = FNode::EKind::Slot;
+			N.Slot = Slots.AddUnique(S);
+			return Nodes.Add(N);
+		}
+
+		int32 ParsePrimary()
+		{
+			SkipSpace();
+			if (Pos >= Text.Len()) return Fail(TEXT("unexpected end"));
+
+			const TCHAR C = Text[Pos];
+
+			if (FChar::IsDigit(C) || C == TEXT('.'))
+			{
+				const int32 Start = Pos;
+				while (Pos < Text.Len() && (FChar::IsDigit(Text[Pos]) || Text[Pos] == TEXT('.'))) ++Pos;
+				return AddConst(FCString::Atof(*Text.Mid(Start, Pos - Start)));
+			}
+
+			if (Accept(TEXT('(')))
+			{
+				const int32 Inner = ParseExpr();
+				if (!Accept(TEXT(')'))) return Fail(TEXT("expected ')'"));
+				return Inner;
+			}
+
+			const FString Ident = ReadIdent();
+			if (Ident.IsEmpty()) return Fail(FString::Printf(TEXT("unexpected '%c'"), C));
+
+			if (!Accept(TEXT('(')))
+			{
+				return ParseAttribute(Ident, false);
+			}
+
+			const FString Func = Ident.ToLower();
+
+			if (Func == TEXT("current"))
+			{
+				const int32 Node = ParseAttribute(ReadIdent(), true);
+				if (!Accept(TEXT(')'))) return Fail(TEXT("current() takes one attribute"));
+				return Node;
+			}
+
+			TArray<int32, TInlineAllocator<3>> Args;
+			if (!Accept(TEXT(')')))
+			{
+				do
+				{
+					Args.Add(ParseExpr());
+					if (Failed()) return INDEX_NONE;
+				}
+				while (Accept(TEXT(',')));
+
+				if (!Accept(TEXT(')'))) return Fail(TEXT("expected ')' after arguments"));
+			}
+
+			struct FFunc { const TCHAR* Name; ECombatFormulaOp Op; int32 NumArgs; };
+			static const FFunc Funcs[] =
+			{
+				{ TEXT("min"),   ECombatFormulaOp::Min,   2 },
+				{ TEXT("max"),   ECombatFormulaOp::Max,   2 },
+				{ TEXT("clamp"), ECombatFormulaOp::Clamp, 3 },
+				{ TEXT("abs"),   ECombatFormulaOp::Abs,   1 },
+				{ TEXT("floor"), ECombatFormulaOp::Floor, 1 },
+			};
+
+			for (const FFunc& F : Funcs)
+			{
+				if (Func != F.Name) continue;
+
+				if (Args.Num() != F.NumArgs)
+				{
+					return Fail(FString::Printf(TEXT("%s() takes %d argument(s)"), F.Name, F.NumArgs));
+				}
+				return AddOp(F.Op, Args[0], Args.IsValidIndex(1) ? Args[1] : INDEX_NONE, Args.IsValidIndex(2) ? Args[2] : INDEX_NONE);
+			}
+
+			return Fail(FString::Printf(TEXT("unknown function '%s'"), *Ident));
+		}
+
+		int32 ParseUnary()
+		{
+			if (Accept(TEXT('-'))) return AddOp(ECombatFormulaOp::Neg, ParseUnary());
+			if (Accept(TEXT('+'))) return ParseUnary();
+			return ParsePrimary();
+		}
+
+		int32 ParseTerm()
+		{
+			int32 L = ParseUnary();
+			while (!Failed())
+			{
+				if (Accept(TEXT('*')))      L = AddOp(ECombatFormulaOp::Mul, L, ParseUnary());
+				else if (Accept(TEXT('/'))) L = AddOp(ECombatFormulaOp::Div, L, ParseUnary());
+				else break;
+			}
+			return L;
+		}
+
+		int32 ParseExpr()
+		{
+			int32 L = ParseTerm();
+			while (!Failed())
+			{
+				if (Accept(TEXT('+')))      L = AddOp(ECombatFormulaOp::Add, L, ParseTerm());
+				else if (Accept(TEXT('-'))) L = AddOp(ECombatFormulaOp::Sub, L, ParseTerm());
+				else break;
+			}
+			return L;
+		}
+	};
+
+	// Node -> code writing register Depth; operands go to the registers right above it
+	bool Emit(const TArray<FNode>& Nodes, int32 Index, int32 Depth, FCombatFormulaProgram& Out)
+	{
+		if (Depth >= FCombatFormulaProgram::MaxRegisters) return false;
+		Out.NumRegisters = FMath::Max(Out.NumRegisters, Depth + 1);
+
+		const FNode& N = Nodes[Index];
+
+		FCombatFormulaInstr I;
+		I.Dst = static_cast<uint8>(Depth);
+
+		switch (N.Kind)
+		{
+		case FNode::EKind::Const:
+			I.Op = ECombatFormulaOp::Const;
+			I.Index = static_cast<uint16>(Out.Constants.AddUnique(N.Value));
+			break;
+
+		case FNode::EKind::Slot:
+			I.Op = ECombatFormulaOp::Load;
+			I.Index = static_cast<uint16>(N.Slot);
+			break;
+
+		case FNode::EKind::Op:
+			for (int32 Arg = 0; Arg < N.NumArgs; ++Arg)
+			{
+				if (!Emit(Nodes, N.Args[Arg], Depth + Arg, Out)) return false;
+			}
+
+			I.Op = N.Op;
+			if (N.Op == ECombatFormulaOp::Clamp)
+			{
+				I.A = static_cast<uint8>(Depth + 1);
+				I.B = static_cast<uint8>(Depth + 2);
+			}
+			else
+			{
+				I.A = static_cast<uint8>(Depth);
+				I.B = static_cast<uint8>(N.NumArgs > 1 ? Depth + 1 : Depth);
+			}
+			break;
+		}
+
+		Out.Code.Add(I);
+		return true;
+	}
+}
+
+bool ProdigyCombatFormula::Compile(const FString& Expression, FCombatFormulaProgram& OutProgram, FString& OutError)
+{
+	OutProgram = FCombatFormulaProgram();
+	OutError.Reset();
+
+	FParser Parser(Expression);
+	const int32 Root = Parser.ParseExpr();
+
+	Parser.SkipSpace();
+	if (!Parser.Failed() && Parser.Pos < Expression.Len())
+	{
+		Parser.Fail(TEXT("unexpected trailing text"));
+	}
+
+	if (Parser.Failed() || Root == INDEX_NONE)
+	{
+		OutError = Parser.Failed() ? Parser.Error : TEXT("empty expression");
+		return false;
+	}
+
+	OutProgram.Slots = MoveTemp(Parser.Slots);
+
+	if (!Emit(Parser.Nodes, Root, 0, OutProgram))
+	{
+		OutProgram = FCombatFormulaProgram();
+		OutError = FString::Printf(TEXT("too deeply nested (max %d registers)"), FCombatFormulaProgram::MaxRegisters);
+		return false;
+	}
+
+	return true;
+}
+
+// =======================
+// Authored formula
+// =======================
+
+void FCombatFormula::Compile(const UObject* Owner) const
+{
+	bCompiled = true;
+	CompiledExpression = Expression;
+	Program = FCombatFormulaProgram();
+
+	if (Expression.IsEmpty()) return;
+
+	FString Error;
+	if (!ProdigyCombatFormula::Compile(Expression, Program, Error))
+	{
+		UE_LOG(LogActionExec, Error, TEXT("[Formula] %s: '%s' does not compile: %s"), *GetPathNameSafe(Owner), *Expression, *Error);
+	}
+}
+
+const FCombatFormulaProgram& FCombatFormula::GetProgram(const UObject* Owner) const
+{
+	if (!bCompiled || CompiledExpression != Expression)
+	{
+		Compile(Owner);
+	}
+	return Program;
+}
+
+void FCombatFormula::EvaluateLive(const UObject* Owner, AActor* Source, TConstArrayView<AActor*> Targets, const FActionEffectBatch& Batch, TArrayView<float> OutValues) const
+{
+	check(OutValues.Num() == Targets.Num());
+
+	const FCombatFormulaProgram& P = GetProgram(Owner);
+	if (!P.IsValid())
+	{
+		for (float& V : OutValues) V = 0.f;
+		return;
+	}
+
+	auto Read = [&Batch](AActor* A, const FCombatFormulaSlot& S) -> float
+	{
+		float V = 0.f;
+		const bool bFound = S.bCurrent ? Batch.GetValue(A, S.Tag, V) : Batch.GetFinalValue(A, S.Tag, V);
+		return bFound ? V : 0.f;
+	};
+
+	TArray<float, TInlineAllocator<16>> Values;
+	Values.SetNumZeroed(P.Slots.Num());
+
+	for (int32 s = 0; s < P.Slots.Num(); ++s)
+	{
+		if (!P.Slots[s].bTarget)
+		{
+			Values[s] = Read(Source, P.Slots[s]);
+		}
+	}
+
+	for (int32 t = 0; t < Targets.Num(); ++t)
+	{
+		for (int32 s = 0; s < P.Slots.Num(); ++s)
+		{
+			if (P.Slots[s].bTarget)
+			{
+				Values[s] = Read(Targets[t], P.Slots[s]);
+			}
+		}
+
+		OutValues[t] = P.Evaluate(Values);
+	}
+}
+
+static FAutoConsoleCommand GCombatFormulaCompileCmd(
+	TEXT("Prodigy.Combat.Formula.Compile"),
+	TEXT("Compiles a damage / heal formula and prints its bytecode.\n")
+	TEXT("Usage: Prodigy.Combat.Formula.Compile <Expression>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Expression = FString::Join(Args, TEXT(" "));
+
+		FCombatFormulaProgram Program;
+		FString Error;
+		if (!ProdigyCombatFormula::Compile(Expression, Program, Error))
+		{
+			UE_LOG(LogActionExec, Warning, TEXT("[Formula] '%s': %s"), *Expression, *Error);
+			return;
+		}
+
+		UE_LOG(LogActionExec, Log, TEXT("[Formula] '%s': %d ops, %d registers, %d constants, %d slots"),
+		       *Expression, Program.Code.Num(), Program.NumRegisters, Program.Constants.Num(), Program.Slots.Num());
+
+		for (int32 i = 0; i < Program.Slots.Num(); ++i)
+		{
+			const FCombatFormulaSlot& S = Program.Slots[i];
+			UE_LOG(LogActionExec, Log, TEXT("[Formula]  slot %d: %s%s%s"), i,
+			       S.bTarget ? TEXT("Target.") : TEXT(""), *S.Tag.ToString(), S.bCurrent ? TEXT(" (current)") : TEXT(""));
+		}
+
+		for (const FCombatFormulaInstr& I : Program.Code)
+		{
+			UE_LOG(LogActionExec, Log, TEXT("[Formula]  op=%d r%d <- r%d r%d #%d"),
+			       static_cast<int32>(I.Op), I.Dst, I.A, I.B, I.Index);
+		}
+	}));
@@ -0,0 +1,168 @@
+﻿#include "AbilitySystem/CombatLog.h"
+
+#include "GameFramework/Actor.h"
+
+void FCombatLog::SetMaxEntries(int32 InMaxEntries)
+{
+	InMaxEntries = FMath::Max(256, InMaxEntries);
+	if (InMaxEntries == MaxEntries) return;
+
+	// Shrinking below what's held would need a re-pack; a settings change mid-session just starts over
+	if (InMaxEntries < Entries.Num())
+	{
+		Reset();
+	}
+	MaxEntries = InMaxEntries;
+}
+
+void FCombatLog::Reset()
+{
+	Entries.Empty();
+	Head = 0;
+	Count = 0;
+	TotalAdded = 0;
+	Names.Reset();
+	NameIndex.Reset();
+}
+
+int32 FCombatLog::GetNameIndex(FName Name)
+{
+	if (Name.IsNone()) return INDEX_NONE;
+
+	if (const int32* Found = NameIndex.Find(Name))
+	{
+		return *Found;
+	}
+	const int32 Index = Names.Add(Name);
+	NameIndex.Add(Name, Index);
+	return Index;
+}
+
+void FCombatLog::Add(ECombatLogKind Kind, int32 EncounterId, const AActor* Source, const AActor* Target, FName Tag, float Value)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (TotalAdded == 0)
+	{
+		StartSeconds = Now;
+	}
+
+	auto ActorName = [](const AActor* A) -> FName
+	{
+		if (!A) return NAME_None;
+#if WITH_EDITOR
+		return FName(*A->GetActorLabel());
+#else
+		return A->GetFName();
+#endif
+	};
+
+	FCombatLogEntry E;
+	E.Time = static_cast<float>(Now - StartSeconds);
+	E.EncounterId = EncounterId;
+	E.Source = GetNameIndex(ActorName(Source));
+	E.Target = GetNameIndex(ActorName(Target));
+	E.Tag = GetNameIndex(Tag);
+	E.Value = Value;
+	E.Kind = Kind;
+
+	if (Count == Entries.Num())
+	{
+		if (Entries.Num() < MaxEntries)
+		{
+			// Grow by doubling, oldest first again
+			TArray<FCombatLogEntry> Grown;
+			Grown.SetNum(FMath::Min(FMath::Max(256, Entries.Num() * 2), MaxEntries));
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Grown[i] = Entries[(Head + i) % Entries.Num()];
+			}
+
+			Entries = MoveTemp(Grown);
+			Head = 0;
+		}
+		else
+		{
+			// Full: the oldest goes
+			Entries[Head] = E;
+			Head = (Head + 1) % Entries.Num();
+			++TotalAdded;
+			return;
+		}
+	}
+
+	Entries[(Head + Count) % Entries.Num()] = E;
+	++Count;
+	++TotalAdded;
+}
+
+const FCombatLogEntry* FCombatLog::FindBySequence(uint64 Sequence) const
+{
+	if (Sequence < GetFirstSequence() || Sequence >= GetEndSequence()) return nullptr;
+
+	const int32 Offset = static_cast<int32>(Sequence - GetFirstSequence());
+	return &Entries[(Head + Offset) % Entries.Num()];
+}
+
+FString FCombatLog::GetName(int32 Index) const
+{
+	return Names.IsValidIndex(Index) ? Names[Index].ToString() : FString(TEXT("?"));
+}
+
+FString FCombatLog::FormatEntry(const FCombatLogEntry& Entry) const
+{
+	const int32 Seconds = FMath::FloorToInt32(Entry.Time);
+	const FString Stamp = FString::Printf(TEXT("[%02d:%02d:%02d]"), Seconds / 3600, (Seconds / 60) % 60, Seconds % 60);
+
+	// Tags read better without their category ("Action.Fire.Bolt" -> "Bolt")
+	FString Tag = GetName(Entry.Tag);
+	int32 Dot = INDEX_NONE;
+	if (Tag.FindLastChar(TEXT('.'), Dot))
+	{
+		Tag.RightChopInline(Dot + 1);
+	}
+
+	switch (Entry.Kind)
+	{
+	case ECombatLogKind::EncounterStart:
+		return FString::Printf(TEXT("%s Combat started"), *Stamp);
+
+	case ECombatLogKind::EncounterEnd:
+		return Entry.Value >= 0.f
+			? FString::Printf(TEXT("%s Combat over, team %d wins"), *Stamp, FMath::RoundToInt32(Entry.Value))
+			: FString::Printf(TEXT("%s Combat over"), *Stamp);
+
+	case ECombatLogKind::TurnBegin:
+		return FString::Printf(TEXT("%s %s's turn"), *Stamp, *GetName(Entry.Source));
+
+	case ECombatLogKind::Action:
+		return Entry.Target != INDEX_NONE && Entry.Target != Entry.Source
+			? FString::Printf(TEXT("%s %s uses %s on %s"), *Stamp, *GetName(Entry.Source), *Tag, *GetName(Entry.Target))
+			: FString::Printf(TEXT("%s %s uses %s"), *Stamp, *GetName(Entry.Source), *Tag);
+
+	case ECombatLogKind::Damage:
+		return Entry.Source != INDEX_NONE
+			? FString::Printf(TEXT("%s %s hits %s for %.0f"), *Stamp, *GetName(Entry.Source), *GetName(Entry.Target), Entry.Value)
+			: FString::Printf(TEXT("%s %s takes %.0f damage"), *Stamp, *GetName(Entry.Target), Entry.Value);
+
+	case ECombatLogKind::Heal:
+		return FString::Printf(TEXT("%s %s recovers %.0f"), *Stamp, *GetName(Entry.Target), Entry.Value);
+
+	case ECombatLogKind::StatusApplied:
+		return FString::Printf(TEXT("%s %s is affected by %s"), *Stamp, *GetName(Entry.Target), *Tag);
+
+	case ECombatLogKind::StatusRemoved:
+		return FString::Printf(TEXT("%s %s is no longer affected by %s"), *Stamp, *GetName(Entry.Target), *Tag);
+
+	case ECombatLogKind::Death:
+		return Entry.Source != INDEX_NONE && Entry.Source != Entry.Target
+			? FString::Printf(TEXT("%s %s was slain by %s"), *Stamp, *GetName(Entry.Target), *GetName(Entry.Source))
+			: FString::Printf(TEXT("%s %s died"), *Stamp, *GetName(Entry.Target));
+	}
+
+	return Stamp;
+}
+
+int32 FCombatLog::GetAllocatedBytes() const
+{
+	return static_cast<int32>(Entries.GetAllocatedSize() + Names.GetAllocatedSize() + NameIndex.GetAllocatedSize());
+}
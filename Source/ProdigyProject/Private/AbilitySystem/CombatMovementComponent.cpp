@@ -0,0 +1,372 @@
+﻿#include "AbilitySystem/CombatMovementComponent.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatEncounter.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "AbilitySystem/ProdigyAbilityUtils.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "Algo/Reverse.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+
+// ---- Field ----
+
+int32 FCombatMoveField::ToIndex(const FVector& Location) const
+{
+	if (!IsValid()) return INDEX_NONE;
+
+	const int32 X = FMath::RoundToInt32((Location.X - Center.X) / CellSize) + HalfCells;
+	const int32 Y = FMath::RoundToInt32((Location.Y - Center.Y) / CellSize) + HalfCells;
+	if (X < 0 || Y < 0 || X >= Side() || Y >= Side()) return INDEX_NONE;
+
+	return Y * Side() + X;
+}
+
+FVector FCombatMoveField::ToLocation(int32 Index) const
+{
+	const int32 X = Index % Side();
+	const int32 Y = Index / Side();
+	return FVector(Center.X + (X - HalfCells) * CellSize, Center.Y + (Y - HalfCells) * CellSize, FloorZ[Index]);
+}
+
+float FCombatMoveField::GetCostTo(const FVector& Location) const
+{
+	const int32 Index = ToIndex(Location);
+	if (Index == INDEX_NONE || State[Index] != ECell::Walkable || Cost[Index] > Budget) return -1.f;
+	return Cost[Index];
+}
+
+bool FCombatMoveField::ExtractPath(const FVector& Location, TArray<FVector>& OutPoints) const
+{
+	OutPoints.Reset();
+	if (GetCostTo(Location) < 0.f) return false;
+
+	for (int32 Index = ToIndex(Location); Index != StartIndex && Index != INDEX_NONE; Index = Parent[Index])
+	{
+		OutPoints.Add(ToLocation(Index));
+	}
+	Algo::Reverse(OutPoints);
+
+	// Straight runs collapse to their ends (same XY step in a row)
+	for (int32 i = OutPoints.Num() - 2; i >= 1; --i)
+	{
+		const FVector2D In = FVector2D(OutPoints[i] - OutPoints[i - 1]);
+		const FVector2D Out = FVector2D(OutPoints[i + 1] - OutPoints[i]);
+		if (In.Equals(Out, 1.f))
+		{
+			OutPoints.RemoveAt(i, EAllowShrinking::No);
+		}
+	}
+
+	return true;
+}
+
+void FCombatMoveField::Init(const FVector& Start, float StartFloorZ, float InBudget, float InCellSize)
+{
+	Center = Start;
+	CellSize = InCellSize;
+	Budget = InBudget;
+	HalfCells = FMath::CeilToInt32(Budget / CellSize) + 1;
+
+	const int32 N = Side() * Side();
+	State.Init(ECell::Unknown, N);
+	FloorZ.Init(StartFloorZ, N);
+	Cost.Init(TNumericLimits<float>::Max(), N);
+	Parent.Init(INDEX_NONE, N);
+
+	StartIndex = HalfCells * Side() + HalfCells;
+	State[StartIndex] = ECell::Walkable;
+	Cost[StartIndex] = 0.f;
+}
+
+void FCombatMoveField::MarkBlocked(const FVector& Location, float Radius)
+{
+	const int32 Cells = FMath::CeilToInt32(Radius / CellSize);
+	const float RadiusSq = Radius * Radius;
+
+	for (int32 DY = -Cells; DY <= Cells; ++DY)
+	{
+		for (int32 DX = -Cells; DX <= Cells; ++DX)
+		{
+			const FVector P = Location + FVector(DX * CellSize, DY * CellSize, 0.f);
+			if (FVector2D::DistSquared(FVector2D(P), FVector2D(Location)) > RadiusSq) continue;
+
+			const int32 Index = ToIndex(P);
+			if (Index != INDEX_NONE && Index != StartIndex)
+			{
+				State[Index] = ECell::Blocked;
+			}
+		}
+	}
+}
+
+void FCombatMoveField::Search(float MaxStepHeight, TFunctionRef<bool(const FVector&, float&)> SampleFloor)
+{
+	if (!IsValid()) return;
+
+	const int32 S = Side();
+	const float Diagonal = CellSize * UE_SQRT_2;
+
+	// Sample a cell once, near the height of the cell we reach it from
+	auto IsWalkable = [&](int32 Index, float NearZ)
+	{
+		if (State[Index] == ECell::Unknown)
+		{
+			FVector P = ToLocation(Index);
+			P.Z = NearZ;
+
+			float Z = NearZ;
+			const bool bOk = SampleFloor(P, Z);
+			State[Index] = bOk ? ECell::Walkable : ECell::Blocked;
+			FloorZ[Index] = Z;
+		}
+		return State[Index] == ECell::Walkable;
+	};
+
+	struct FOpen
+	{
+		float Cost;
+		int32 Index;
+	};
+	const auto Less = [](const FOpen& A, const FOpen& B) { return A.Cost < B.Cost; };
+
+	TArray<FOpen> Open;
+	Open.Reserve(S * 4);
+	Open.HeapPush({ 0.f, StartIndex }, Less);
+
+	static constexpr int32 DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static constexpr int32 DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	while (Open.Num() > 0)
+	{
+		FOpen Cur;
+		Open.HeapPop(Cur, Less, EAllowShrinking::No);
+		if (Cur.Cost > Cost[Cur.Index]) continue; // stale
+
+		const int32 X = Cur.Index % S;
+		const int32 Y = Cur.Index / S;
+		const float Z = FloorZ[Cur.Index];
+
+		for (int32 d = 0; d < 8; ++d)
+		{
+			const int32 NX = X + DX[d];
+			const int32 NY = Y + DY[d];
+			if (NX < 0 || NY < 0 || NX >= S || NY >= S) continue;
+
+			const bool bDiagonal = d >= 4;
+			const float NewCost = Cur.Cost + (bDiagonal ? Diagonal : CellSize);
+			const int32 Next = NY * S + NX;
+			if (NewCost > Budget || NewCost >= Cost[Next]) continue;
+
+			// No corner cutting: both sides of a diagonal step must be open
+			if (bDiagonal && (!IsWalkable(Y * S + NX, Z) || !IsWalkable(NY * S + X, Z))) continue;
+
+			if (!IsWalkable(Next, Z)) continue;
+			if (FMath::Abs(FloorZ[Next] - Z) > MaxStepHeight) continue;
+
+			Cost[Next] = NewCost;
+			Parent[Next] = Cur.Index;
+			Open.HeapPush({ NewCost, Next }, Less);
+		}
+	}
+}
+
+// ---- Component ----
+
+UCombatMovementComponent::UCombatMovementComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+float UCombatMovementComponent::GetCurrentAP() const
+{
+	const UAttributesComponent* Attr = GetOwner() ? GetOwner()->FindComponentByClass<UAttributesComponent>() : nullptr;
+	return Attr ? Attr->GetCurrentValue(ProdigyTags::Attr::AP) : 0.f;
+}
+
+int32 UCombatMovementComponent::ToAPCost(float Distance) const
+{
+	if (Distance <= 0.f) return 0;
+	return FMath::Max(1, FMath::CeilToInt32(Distance / DistancePerAP - KINDA_SMALL_NUMBER));
+}
+
+bool UCombatMovementComponent::CanMoveNow() const
+{
+	AActor* Owner = GetOwner();
+	if (!IsValid(Owner) || IsMoving()) return false;
+
+	const UWorld* World = GetWorld();
+	const UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	const UCombatEncounter* Encounter = Combat ? Combat->FindEncounterObjectForActor(Owner) : nullptr;
+
+	return Encounter && Encounter->GetCurrentTurnActor() == Owner;
+}
+
+void UCombatMovementComponent::MarkBlockers()
+{
+	AActor* Owner = GetOwner();
+	const UWorld* World = GetWorld();
+	const UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+	const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	const UCombatEncounter* Encounter = Combat ? Combat->FindEncounterObjectForActor(Owner) : nullptr;
+	if (!Encounter) return;
+
+	const float OwnRadius = Owner->GetSimpleCollisionRadius();
+
+	for (const TWeakObjectPtr<AActor>& P : Encounter->GetParticipants())
+	{
+		AActor* A = P.Get();
+		if (!IsValid(A) || A == Owner || ProdigyAbilityUtils::IsDeadByAttributes(A)) continue;
+
+		Field.MarkBlocked(A->GetActorLocation(), A->GetSimpleCollisionRadius() + OwnRadius);
+	}
+}
+
+void UCombatMovementComponent::EnsureReachable()
+{
+	if (!CanMoveNow()) return;
+
+	AActor* Owner = GetOwner();
+	const FVector Origin = Owner->GetActorLocation();
+	const float AP = GetCurrentAP();
+
+	if (Field.IsValid() && FieldAP == AP && FieldOrigin.Equals(Origin, 1.f)) return;
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys) return;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Vertical reach covers a step either way from the height we came from
+	const FVector Extent(CellSize * 0.5f, CellSize * 0.5f, MaxStepHeight * 2.f + 50.f);
+
+	FNavLocation StartNav;
+	if (!NavSys->ProjectPointToNavigation(Origin, StartNav, FVector(CellSize, CellSize, Owner->GetSimpleCollisionHalfHeight() * 2.f)))
+	{
+		UE_LOG(LogActionExec, Warning, TEXT("[Move] %s is off the navmesh, no reachable area"), *GetNameSafe(Owner));
+		InvalidateReachable();
+		return;
+	}
+
+	FieldOrigin = Origin;
+	FieldAP = AP;
+	FloorToActorZ = Origin.Z - StartNav.Location.Z;
+
+	Field.Init(Origin, StartNav.Location.Z, FMath::Max(0.f, AP) * DistancePerAP, CellSize);
+	MarkBlockers();
+
+	int32 Samples = 0;
+	Field.Search(MaxStepHeight, [&](const FVector& Point, float& OutZ)
+	{
+		++Samples;
+
+		FNavLocation NavLoc;
+		if (!NavSys->ProjectPointToNavigation(Point, NavLoc, Extent)) return false;
+
+		// Snapped to a different patch of navmesh than this cell
+		if (FVector2D::DistSquared(FVector2D(NavLoc.Location), FVector2D(Point)) > FMath::Square(CellSize * 0.5f)) return false;
+
+		OutZ = NavLoc.Location.Z;
+		return true;
+	});
+
+	UE_LOG(LogActionExec, Verbose, TEXT("[Move] %s reachable field: AP=%.0f Cells=%d Sampled=%d (%.2f ms)"),
+	       *GetNameSafe(Owner), AP, Field.State.Num(), Samples, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+bool UCombatMovementComponent::GetMovePreview(FVector Location, TArray<FVector>& OutPath, int32& OutAPCost)
+{
+	OutPath.Reset();
+	OutAPCost = 0;
+
+	EnsureReachable();
+	if (!Field.IsValid() || !CanMoveNow()) return false;
+
+	const float Distance = Field.GetCostTo(Location);
+	if (Distance <= 0.f) return false;
+
+	OutAPCost = ToAPCost(Distance);
+	if (OutAPCost > GetCurrentAP()) return false;
+
+	return Field.ExtractPath(Location, OutPath) && OutPath.Num() > 0;
+}
+
+bool UCombatMovementComponent::MoveTo(FVector Location)
+{
+	TArray<FVector> Path;
+	int32 APCost = 0;
+	if (!GetMovePreview(Location, Path, APCost)) return false;
+
+	AActor* Owner = GetOwner();
+	UAttributesComponent* Attr = Owner->FindComponentByClass<UAttributesComponent>();
+	if (!Attr || !Attr->ModifyCurrentValue(ProdigyTags::Attr::AP, -APCost, Owner)) return false;
+
+	UE_LOG(LogActionExec, Warning, TEXT("[Move] %s moves %d points for %d AP"), *GetNameSafe(Owner), Path.Num(), APCost);
+
+	MovePath = MoveTemp(Path);
+	for (FVector& P : MovePath)
+	{
+		P.Z += FloorToActorZ;
+	}
+	MovePathNext = 0;
+
+	InvalidateReachable();
+	SetComponentTickEnabled(true);
+
+	OnMoveStartedNative.Broadcast(this, APCost);
+	return true;
+}
+
+void UCombatMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	AActor* Owner = GetOwner();
+	if (!IsMoving() || !IsValid(Owner))
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Direct placement: combat freezes CharacterMovement, and the path is already nav-validated
+	float Step = MoveSpeed * DeltaTime;
+	FVector Location = Owner->GetActorLocation();
+
+	while (Step > 0.f && MovePathNext < MovePath.Num())
+	{
+		const FVector ToNext = MovePath[MovePathNext] - Location;
+		const float Dist = ToNext.Size();
+
+		if (!FVector2D(ToNext).IsNearlyZero())
+		{
+			Owner->SetActorRotation(FRotator(0.f, ToNext.Rotation().Yaw, 0.f));
+		}
+
+		if (Dist <= Step)
+		{
+			Location = MovePath[MovePathNext++];
+			Step -= Dist;
+			continue;
+		}
+
+		Location += ToNext / Dist * Step;
+		Step = 0.f;
+	}
+
+	Owner->SetActorLocation(Location);
+
+	if (MovePathNext < MovePath.Num()) return;
+
+	MovePath.Reset();
+	MovePathNext = 0;
+	SetComponentTickEnabled(false);
+
+	OnCombatMoveFinished.Broadcast(Owner);
+
+	// Next hover is on the new spot with the AP left
+	EnsureReachable();
+}
@@ -0,0 +1,275 @@
+﻿#include "AbilitySystem/CombatProjectileSubsystem.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+
+void UCombatProjectileSubsystem::Deinitialize()
+{
+	Projectiles.Reset();
+
+	for (UNiagaraComponent* Visual : VisualPool)
+	{
+		if (IsValid(Visual))
+		{
+			Visual->DestroyComponent();
+		}
+	}
+	VisualPool.Reset();
+	VisualInUse.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatProjectileSubsystem, STATGROUP_Tickables);
+}
+
+FVector UCombatProjectileSubsystem::EvaluateArc(const FProjectile& P, float Alpha)
+{
+	// Straight line plus a parabola that peaks at ArcHeight halfway
+	return FMath::Lerp(P.Start, P.End, Alpha) + FVector(0.f, 0.f, P.ArcHeight * 4.f * Alpha * (1.f - Alpha));
+}
+
+bool UCombatProjectileSubsystem::HasProjectilesFrom(const AActor* Instigator) const
+{
+	return Projectiles.ContainsByPredicate([Instigator](const FProjectile& P) { return P.Instigator.Get() == Instigator; });
+}
+
+int32 UCombatProjectileSubsystem::AcquireVisual(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	if (!System) return INDEX_NONE;
+
+	// Idle one of the same system first, then any idle one, then a new one while under the cap
+	int32 Index = INDEX_NONE;
+	for (int32 i = 0; i < VisualPool.Num(); ++i)
+	{
+		if (VisualInUse[i] || !IsValid(VisualPool[i])) continue;
+
+		Index = i;
+		if (VisualPool[i]->GetAsset() == System) break;
+	}
+
+	if (Index != INDEX_NONE)
+	{
+		UNiagaraComponent* Visual = VisualPool[Index];
+		if (Visual->GetAsset() != System)
+		{
+			Visual->SetAsset(System);
+		}
+		Visual->SetWorldLocationAndRotation(Location, Rotation);
+		Visual->Activate(true);
+	}
+	else if (VisualPool.Num() < MaxVisuals)
+	{
+		UNiagaraComponent* Visual = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+			GetWorld(), System, Location, Rotation, FVector(1.f), /*bAutoDestroy*/ false, /*bAutoActivate*/ true, ENCPoolMethod::None);
+		if (!Visual) return INDEX_NONE;
+
+		Index = VisualPool.Add(Visual);
+		VisualInUse.Add(false);
+	}
+	else
+	{
+		return INDEX_NONE;
+	}
+
+	VisualInUse[Index] = true;
+	return Index;
+}
+
+void UCombatProjectileSubsystem::ReleaseVisual(int32 Index)
+{
+	if (!VisualPool.IsValidIndex(Index)) return;
+
+	if (UNiagaraComponent* Visual = VisualPool[Index])
+	{
+		Visual->DeactivateImmediate();
+	}
+	VisualInUse[Index] = false;
+}
+
+void UCombatProjectileSubsystem::CancelForExecution(FActionExecutionHandle Execution)
+{
+	if (!Execution.IsValid()) return;
+
+	for (int32 i = Projectiles.Num() - 1; i >= 0; --i)
+	{
+		if (!(Projectiles[i].Execution == Execution)) continue;
+
+		UE_LOG(LogActionExec, Log, TEXT("[Projectile] %s dropped with its action"), *GetNameSafe(Projectiles[i].Def.Get()));
+		ReleaseVisual(Projectiles[i].Visual);
+		Projectiles.RemoveAtSwap(i, EAllowShrinking::No);
+	}
+}
+
+void UCombatProjectileSubsystem::NotifyExecution(FActionExecutionHandle Execution) const
+{
+	if (!Execution.IsValid()) return;
+
+	if (UActionExecutionSubsystem* Executor = GetWorld() ? GetWorld()->GetSubsystem<UActionExecutionSubsystem>() : nullptr)
+	{
+		Executor->NotifyProjectileResolved(Execution);
+	}
+}
+
+void UCombatProjectileSubsystem::Launch(UActionComponent* Source, const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets,
+                                        FActionExecutionHandle Execution)
+{
+	if (!Source || !Def)
+	{
+		NotifyExecution(Execution);
+		return;
+	}
+
+	AActor* Instigator = Context.Instigator;
+	if (!IsValid(Instigator))
+	{
+		Source->ApplyActionImpact(Def, Context, Targets);
+		NotifyExecution(Execution);
+		return;
+	}
+
+	const FActionProjectile& Spec = Def->Projectile;
+
+	FProjectile P;
+	P.Start = Instigator->GetActorTransform().TransformPosition(Spec.MuzzleOffset);
+	P.End = IsValid(Context.TargetActor) ? Context.TargetActor->GetActorLocation() : Context.TargetLocation;
+	P.ArcHeight = Spec.ArcHeight;
+	P.Radius = Spec.Radius;
+	P.Duration = FMath::Min(FVector::Dist2D(P.Start, P.End) / FMath::Max(1.f, Spec.Speed), MaxFlightSeconds);
+
+	// Flight time follows the combat playback speed (instant = lands now)
+	if (Source->IsInCombat())
+	{
+		const UGameInstance* GI = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+		if (const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr)
+		{
+			P.Duration = Combat->ScaleDelay(P.Duration);
+		}
+	}
+
+	if (P.Duration <= 0.f)
+	{
+		Source->ApplyActionImpact(Def, Context, Targets);
+		NotifyExecution(Execution);
+		return;
+	}
+
+	P.Source = Source;
+	P.Def = Def;
+	P.Execution = Execution;
+	P.Instigator = Instigator;
+	P.TargetActor = Context.TargetActor;
+	P.TargetLocation = Context.TargetLocation;
+	P.OptionalSubTarget = Context.OptionalSubTarget;
+	P.Targets.Reserve(Targets.Num());
+	for (AActor* A : Targets)
+	{
+		P.Targets.Add(A);
+	}
+
+	P.LastLocation = P.Start;
+	P.Visual = AcquireVisual(Spec.Visual, P.Start, (P.End - P.Start).Rotation());
+
+	Projectiles.Add(MoveTemp(P));
+}
+
+void UCombatProjectileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Projectiles.Num() == 0) return;
+
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	const FCollisionObjectQueryParams Blockers(ECC_WorldStatic);
+
+	// Resolved after the pass: impacts can launch new projectiles
+	TArray<TPair<FProjectile, bool>, TInlineAllocator<8>> Finished;
+
+	for (int32 i = Projectiles.Num() - 1; i >= 0; --i)
+	{
+		FProjectile& P = Projectiles[i];
+
+		P.Age += DeltaTime;
+		const float Alpha = FMath::Min(1.f, P.Age / P.Duration);
+		const FVector Location = EvaluateArc(P, Alpha);
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(CombatProjectile), false);
+		Params.AddIgnoredActor(P.Instigator.Get());
+
+		FHitResult Hit;
+		const bool bBlocked = P.Radius > 0.f
+			? World->SweepSingleByObjectType(Hit, P.LastLocation, Location, FQuat::Identity, Blockers, FCollisionShape::MakeSphere(P.Radius), Params)
+			: World->LineTraceSingleByObjectType(Hit, P.LastLocation, Location, Blockers, Params);
+
+		if (!bBlocked && Alpha < 1.f)
+		{
+			if (VisualPool.IsValidIndex(P.Visual) && VisualPool[P.Visual])
+			{
+				VisualPool[P.Visual]->SetWorldLocationAndRotation(Location, (Location - P.LastLocation).Rotation());
+			}
+			P.LastLocation = Location;
+			continue;
+		}
+
+		if (bBlocked)
+		{
+			UE_LOG(LogActionExec, Log, TEXT("[Projectile] %s blocked by %s"), *GetNameSafe(P.Def.Get()), *GetNameSafe(Hit.GetActor()));
+		}
+
+		ReleaseVisual(P.Visual);
+		Finished.Emplace(MoveTemp(P), !bBlocked);
+		Projectiles.RemoveAtSwap(i, EAllowShrinking::No);
+	}
+
+	for (const TPair<FProjectile, bool>& F : Finished)
+	{
+		Resolve(F.Key, F.Value);
+	}
+}
+
+void UCombatProjectileSubsystem::Resolve(const FProjectile& P, bool bHit)
+{
+	UActionComponent* Source = P.Source.Get();
+	const UActionDefinition* Def = P.Def.Get();
+	if (!Source || !Def)
+	{
+		NotifyExecution(P.Execution);
+		return;
+	}
+
+	FActionContext Ctx;
+	Ctx.Instigator = P.Instigator.Get();
+	Ctx.TargetActor = P.TargetActor.Get();
+	Ctx.TargetLocation = P.TargetLocation;
+	Ctx.OptionalSubTarget = P.OptionalSubTarget;
+
+	// A miss still lands (the action moves on to recovery), it just hits nobody
+	TArray<AActor*, TInlineAllocator<16>> Targets;
+	if (bHit)
+	{
+		for (const TWeakObjectPtr<AActor>& T : P.Targets)
+		{
+			if (AActor* A = T.Get())
+			{
+				Targets.Add(A);
+			}
+		}
+
+		if (Def->Area.IsArea())
+		{
+			Ctx.AreaTargets.Append(Targets);
+		}
+	}
+
+	Source->ApplyActionImpact(Def, Ctx, Targets);
+	NotifyExecution(P.Execution);
+}
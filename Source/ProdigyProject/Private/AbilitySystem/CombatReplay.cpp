@@ -0,0 +1,1093 @@
+﻿#include "AbilitySystem/CombatReplay.h"
+
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// =======================
+// Encoding
+// =======================
+
+void ProdigyCombatReplay::WriteVarUInt(TArray<uint8>& Out, uint64 Value)
+{
+	while (Value >= 0x80)
+	{
+		Out.Add(static_cast<uint8>(Value | 0x80));
+		Value >>= 7;
+	}
+	Out.Add(static_cast<uint8>(Value));
+}
+
+void ProdigyCombatReplay::WriteVarInt(TArray<uint8>& Out, int64 Value)
+{
+	// Zigzag: small negatives stay small
+	WriteVarUInt(Out, (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63));
+}
+
+void ProdigyCombatReplay::WriteFloat(TArray<uint8>& Out, float Value)
+{
+	uint32 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	for (int32 i = 0; i < 4; ++i)
+	{
+		Out.Add(static_cast<uint8>(Bits >> (8 * i)));
+	}
+}
+
+void ProdigyCombatReplay::WriteDouble(TArray<uint8>& Out, double Value)
+{
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	for (int32 i = 0; i < 8; ++i)
+	{
+		Out.Add(static_cast<uint8>(Bits >> (8 * i)));
+	}
+}
+
+uint8 FCombatReplayReader::ReadByte()
+{
+	if (Pos >= Data.Num())
+	{
+		bError = true;
+		return 0;
+	}
+	return Data[Pos++];
+}
+
+uint64 FCombatReplayReader::ReadVarUInt()
+{
+	uint64 Value = 0;
+
+	for (int32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		const uint8 Byte = ReadByte();
+		if (bError) return 0;
+
+		Value |= static_cast<uint64>(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return Value;
+		}
+	}
+
+	bError = true;
+	return 0;
+}
+
+int64 FCombatReplayReader::ReadVarInt()
+{
+	const uint64 Raw = ReadVarUInt();
+	return static_cast<int64>(Raw >> 1) ^ -static_cast<int64>(Raw & 1);
+}
+
+float FCombatReplayReader::ReadFloat()
+{
+	uint32 Bits = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		Bits |= static_cast<uint32>(ReadByte()) << (8 * i);
+	}
+
+	float Value;
+	FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+double FCombatReplayReader::ReadDouble()
+{
+	uint64 Bits = 0;
+	for (int32 i = 0; i < 8; ++i)
+	{
+		Bits |= static_cast<uint64>(ReadByte()) << (8 * i);
+	}
+
+	double Value;
+	FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+TConstArrayView<uint8> FCombatReplayReader::ReadBytes(uint64 Len)
+{
+	if (bError || Len > static_cast<uint64>(GetRemaining()))
+	{
+		bError = true;
+		return TConstArrayView<uint8>();
+	}
+
+	const TConstArrayView<uint8> Out = Data.Slice(Pos, static_cast<int32>(Len));
+	Pos += static_cast<int32>(Len);
+	return Out;
+}
+
+static int64 QuantizeValue(float Value)
+{
+	return FMath::RoundToInt64(static_cast<double>(Value) * ProdigyCombatReplay::ValueScale);
+}
+
+static uint64 MakeAttributeKey(int32 CombatantIndex, int32 NameIdx)
+{
+	return (static_cast<uint64>(static_cast<uint32>(CombatantIndex)) << 32) | static_cast<uint32>(NameIdx);
+}
+
+// =======================
+// Ring
+// =======================
+
+void FCombatReplayRing::Init(int32 InCapacityBytes)
+{
+	Buffer.SetNumUninitialized(FMath::Max(64, InCapacityBytes));
+	Head = 0;
+	Tail = 0;
+	Used = 0;
+	bDropped = false;
+}
+
+void FCombatReplayRing::WriteByte(uint8 Byte)
+{
+	Buffer[Head] = Byte;
+	Head = (Head + 1) % Buffer.Num();
+	++Used;
+}
+
+void FCombatReplayRing::DropOldest()
+{
+	if (Used == 0) return;
+
+	// Read the length prefix at Tail
+	uint32 Len = 0;
+	int32 PrefixBytes = 0;
+	for (int32 Shift = 0; Shift < 35; Shift += 7)
+	{
+		const uint8 Byte = ReadAt(Tail + PrefixBytes);
+		++PrefixBytes;
+		Len |= static_cast<uint32>(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0) break;
+	}
+
+	const int32 RecordBytes = PrefixBytes + static_cast<int32>(Len);
+	Tail = (Tail + RecordBytes) % Buffer.Num();
+	Used -= RecordBytes;
+	bDropped = true;
+}
+
+bool FCombatReplayRing::Push(TConstArrayView<uint8> Record)
+{
+	if (Buffer.Num() == 0) return false;
+
+	TArray<uint8, TInlineAllocator<8>> Prefix;
+	{
+		uint32 Len = static_cast<uint32>(Record.Num());
+		while (Len >= 0x80)
+		{
+			Prefix.Add(static_cast<uint8>(Len | 0x80));
+			Len >>= 7;
+		}
+		Prefix.Add(static_cast<uint8>(Len));
+	}
+
+	const int32 Total = Prefix.Num() + Record.Num();
+	if (Total > Buffer.Num())
+	{
+		bDropped = true;
+		return false;
+	}
+
+	while (Used + Total > Buffer.Num())
+	{
+		DropOldest();
+	}
+
+	for (const uint8 B : Prefix) WriteByte(B);
+	for (const uint8 B : Record) WriteByte(B);
+	return true;
+}
+
+void FCombatReplayRing::Linearize(TArray<uint8>& Out) const
+{
+	Out.Reset(Used);
+	for (int32 i = 0; i < Used; ++i)
+	{
+		Out.Add(ReadAt(Tail + i));
+	}
+}
+
+// =======================
+// Log (file format)
+// =======================
+
+int32 FCombatReplayLog::GetTotalBytes() const
+{
+	TArray<uint8> Bytes;
+	Serialize(Bytes);
+	return Bytes.Num();
+}
+
+void FCombatReplayLog::Serialize(TArray<uint8>& Out) const
+{
+	using namespace ProdigyCombatReplay;
+
+	Out.Reset();
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		Out.Add(static_cast<uint8>(Magic >> (8 * i)));
+	}
+
+	WriteVarUInt(Out, Version);
+	WriteVarInt(Out, EncounterId);
+	WriteVarUInt(Out, Seed);
+	Out.Add((bIncomplete ? 1 : 0) | (bTruncated ? 2 : 0));
+
+	WriteVarUInt(Out, Names.Num());
+	for (const FName& N : Names)
+	{
+		const FTCHARToUTF8 Utf8(*N.ToString());
+		WriteVarUInt(Out, Utf8.Length());
+		Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	WriteVarUInt(Out, Snapshot.Num());
+	Out.Append(Snapshot);
+
+	WriteVarUInt(Out, Events.Num());
+	Out.Append(Events);
+}
+
+bool FCombatReplayLog::Deserialize(TConstArrayView<uint8> In)
+{
+	FCombatReplayReader R(In);
+
+	uint32 FileMagic = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		FileMagic |= static_cast<uint32>(R.ReadByte()) << (8 * i);
+	}
+
+	if (FileMagic != ProdigyCombatReplay::Magic)
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Not a combat replay (bad magic)"));
+		return false;
+	}
+
+	// v1 had no keyframes: same layout, a truncated v1 log just can't be re-anchored
+	const uint64 FileVersion = R.ReadVarUInt();
+	if (FileVersion < 1 || FileVersion > ProdigyCombatReplay::Version)
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Unsupported version %llu"), FileVersion);
+		return false;
+	}
+
+	EncounterId = static_cast<int32>(R.ReadVarInt());
+	Seed = static_cast<uint32>(R.ReadVarUInt());
+
+	const uint8 Flags = R.ReadByte();
+	bIncomplete = (Flags & 1) != 0;
+	bTruncated = (Flags & 2) != 0;
+
+	// Every length below comes from the file: checked against what's left before anything is allocated
+	const uint64 NumNames = R.ReadVarUInt();
+	Names.Reset();
+	if (NumNames > static_cast<uint64>(R.GetRemaining()))
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Corrupt name table (%llu names)"), NumNames);
+		return false;
+	}
+	Names.Reserve(static_cast<int32>(NumNames));
+
+	for (uint64 i = 0; i < NumNames && !R.HasError(); ++i)
+	{
+		const TConstArrayView<uint8> Utf8 = R.ReadBytes(R.ReadVarUInt());
+		if (R.HasError()) break;
+
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const UTF8CHAR*>(Utf8.GetData()), Utf8.Num());
+		Names.Add(FName(Converted.Length(), Converted.Get()));
+	}
+
+	const auto ReadBlob = [&R](TArray<uint8>& Out)
+	{
+		const TConstArrayView<uint8> Blob = R.ReadBytes(R.ReadVarUInt());
+		Out.Reset(Blob.Num());
+		Out.Append(Blob.GetData(), Blob.Num());
+	};
+
+	ReadBlob(Snapshot);
+	ReadBlob(Events);
+
+	if (R.HasError())
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Truncated replay file"));
+		return false;
+	}
+	return true;
+}
+
+bool FCombatReplayLog::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	Serialize(Bytes);
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FCombatReplayLog::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Could not read '%s'"), *Path);
+		return false;
+	}
+	return Deserialize(Bytes);
+}
+
+// =======================
+// Recorder
+// =======================
+
+int32 FCombatReplayRecorder::GetNameIndex(FName Name)
+{
+	if (const int32* Found = NameIndex.Find(Name))
+	{
+		return *Found;
+	}
+
+	const int32 NewIndex = Names.Add(Name);
+	NameIndex.Add(Name, NewIndex);
+	return NewIndex;
+}
+
+void FCombatReplayRecorder::EncodeState(const FCombatCoreState& State, TArray<uint8>& Out, TMap<uint64, int64>& OutBases)
+{
+	using namespace ProdigyCombatReplay;
+
+	WriteDouble(Out, State.TurnClock);
+	WriteVarInt(Out, State.CurrentIndex);
+
+	const int32 NumActions = State.Actions.IsValid() ? State.Actions->Num() : 0;
+	WriteVarUInt(Out, NumActions);
+	for (int32 i = 0; i < NumActions; ++i)
+	{
+		WriteVarUInt(Out, GetNameIndex(FName(*(*State.Actions)[i].Definition.ToString())));
+	}
+
+	WriteVarUInt(Out, State.Combatants.Num());
+	for (int32 Index = 0; Index < State.Combatants.Num(); ++Index)
+	{
+		const FCombatCoreCombatant& C = State.Combatants[Index];
+
+		WriteVarUInt(Out, GetNameIndex(C.DebugName));
+		WriteVarInt(Out, C.Team);
+
+		WriteVarUInt(Out, C.Attributes.Num());
+		for (const FCombatCoreAttribute& A : C.Attributes)
+		{
+			const int32 TagIdx = GetNameIndex(A.Tag.GetTagName());
+			WriteVarUInt(Out, TagIdx);
+			WriteFloat(Out, A.Current);
+			WriteFloat(Out, A.Final);
+
+			// Base for the delta-encoded attribute events
+			OutBases.Add(MakeAttributeKey(Index, TagIdx), QuantizeValue(A.Current));
+		}
+
+		WriteVarUInt(Out, C.ResourcePairs.Num());
+		for (const TPair<FGameplayTag, FGameplayTag>& Pair : C.ResourcePairs)
+		{
+			WriteVarUInt(Out, GetNameIndex(Pair.Key.GetTagName()));
+			WriteVarUInt(Out, GetNameIndex(Pair.Value.GetTagName()));
+		}
+
+		WriteVarUInt(Out, C.ActionIndices.Num());
+		for (int32 Slot = 0; Slot < C.ActionIndices.Num(); ++Slot)
+		{
+			WriteVarUInt(Out, C.ActionIndices[Slot]);
+			WriteVarUInt(Out, C.CooldownTurns.IsValidIndex(Slot) ? FMath::Max(0, C.CooldownTurns[Slot]) : 0);
+		}
+
+		WriteVarUInt(Out, C.TurnEffects.Num());
+		for (const FCombatCoreTurnEffect& E : C.TurnEffects)
+		{
+			WriteVarUInt(Out, GetNameIndex(E.EffectTag.GetTagName()));
+			WriteVarUInt(Out, GetNameIndex(E.AttributeTag.GetTagName()));
+			WriteFloat(Out, E.DeltaPerTurn);
+			WriteVarInt(Out, E.TurnsRemaining);
+		}
+
+		WriteVarUInt(Out, C.Statuses.Num());
+		for (const FCombatCoreStatus& S : C.Statuses)
+		{
+			WriteVarUInt(Out, GetNameIndex(S.Tag.GetTagName()));
+			WriteVarInt(Out, S.TurnsRemaining);
+		}
+	}
+
+	// Queue in acting order so re-inserting keeps the tie-break
+	TArray<FCombatTurnQueueEntry> Ordered;
+	State.TurnQueue.GetOrderedEntries(State.TurnQueue.Num(), Ordered);
+
+	WriteVarUInt(Out, Ordered.Num());
+	for (const FCombatTurnQueueEntry& E : Ordered)
+	{
+		WriteVarUInt(Out, E.Id);
+		WriteDouble(Out, E.ReadyTime);
+	}
+}
+
+void FCombatReplayRecorder::PushScratch()
+{
+	Ring.Push(Scratch);
+	++RecordsSinceKeyframe;
+}
+
+void FCombatReplayRecorder::Begin(const FCombatCoreState& State, uint32 InSeed, int32 InEncounterId, int32 RingCapacityBytes)
+{
+	bRecording = true;
+	bIncomplete = false;
+
+	EncounterId = InEncounterId;
+	Seed = InSeed;
+
+	Names.Reset();
+	NameIndex.Reset();
+	LastValueByKey.Reset();
+	RecordsSinceKeyframe = 0;
+
+	// NAME_None is always index 0 (invalid tags / empty paths)
+	GetNameIndex(NAME_None);
+
+	LastClock = FMath::RoundToInt64(State.TurnClock * ProdigyCombatReplay::ClockScale);
+
+	Snapshot.Reset();
+	EncodeState(State, Snapshot, LastValueByKey);
+	Ring.Init(RingCapacityBytes);
+}
+
+void FCombatReplayRecorder::RecordKeyframe(const FCombatCoreState& State)
+{
+	if (!bRecording) return;
+
+	using namespace ProdigyCombatReplay;
+
+	const int64 Clock = FMath::RoundToInt64(State.TurnClock * ClockScale);
+
+	TArray<uint8> Blob;
+	TMap<uint64, int64> Bases;
+	EncodeState(State, Blob, Bases);
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::Keyframe));
+	WriteVarInt(Scratch, Clock);
+	WriteVarUInt(Scratch, Blob.Num());
+	Scratch.Append(Blob);
+
+	// Bases only move if the keyframe made it in; a ring too small for one keeps the old chain
+	RecordsSinceKeyframe = 0;
+	if (!Ring.Push(Scratch))
+	{
+		UE_LOG(LogCombatCore, Warning, TEXT("[CombatReplay] Keyframe (%d bytes) doesn't fit the ring"), Scratch.Num());
+		return;
+	}
+
+	LastClock = Clock;
+	LastValueByKey = MoveTemp(Bases);
+}
+
+void FCombatReplayRecorder::RecordTurnBegin(int32 CombatantIndex, double TurnClock)
+{
+	if (!bRecording || CombatantIndex < 0) return;
+
+	using namespace ProdigyCombatReplay;
+
+	const int64 Clock = FMath::RoundToInt64(TurnClock * ClockScale);
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::TurnBegin));
+	WriteVarUInt(Scratch, CombatantIndex);
+	WriteVarInt(Scratch, Clock - LastClock);
+	LastClock = Clock;
+
+	PushScratch();
+}
+
+void FCombatReplayRecorder::RecordAction(int32 InstigatorIndex, const FGameplayTag& ActionTag, int32 TargetIndex, const FVector& TargetLocation, const TArray<int32>* AreaTargets)
+{
+	if (!bRecording || InstigatorIndex < 0) return;
+
+	using namespace ProdigyCombatReplay;
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::Action));
+	WriteVarUInt(Scratch, InstigatorIndex);
+	WriteVarUInt(Scratch, GetNameIndex(ActionTag.GetTagName()));
+
+	// 0 = no unit target, else index + 1
+	WriteVarUInt(Scratch, TargetIndex >= 0 ? TargetIndex + 1 : 0);
+
+	// Flags: 1 = point target (whole cm), 2 = area hit list
+	const bool bHasLocation = !TargetLocation.IsNearlyZero();
+	Scratch.Add((bHasLocation ? 1 : 0) | (AreaTargets ? 2 : 0));
+	if (bHasLocation)
+	{
+		WriteVarInt(Scratch, FMath::RoundToInt64(TargetLocation.X));
+		WriteVarInt(Scratch, FMath::RoundToInt64(TargetLocation.Y));
+		WriteVarInt(Scratch, FMath::RoundToInt64(TargetLocation.Z));
+	}
+	if (AreaTargets)
+	{
+		WriteVarUInt(Scratch, AreaTargets->Num());
+		for (const int32 Index : *AreaTargets)
+		{
+			WriteVarUInt(Scratch, Index);
+		}
+	}
+
+	PushScratch();
+}
+
+void FCombatReplayRecorder::RecordAttributeChanged(int32 CombatantIndex, const FGameplayTag& AttributeTag, float NewValue)
+{
+	if (!bRecording || CombatantIndex < 0) return;
+
+	using namespace ProdigyCombatReplay;
+
+	const int32 TagIdx = GetNameIndex(AttributeTag.GetTagName());
+	const int64 Quantized = QuantizeValue(NewValue);
+
+	int64& Last = LastValueByKey.FindOrAdd(MakeAttributeKey(CombatantIndex, TagIdx));
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::AttributeChanged));
+	WriteVarUInt(Scratch, CombatantIndex);
+	WriteVarUInt(Scratch, TagIdx);
+	WriteVarInt(Scratch, Quantized - Last);
+	Last = Quantized;
+
+	PushScratch();
+}
+
+void FCombatReplayRecorder::RecordMove(int32 CombatantIndex, int32 APCost)
+{
+	if (!bRecording || CombatantIndex < 0) return;
+
+	using namespace ProdigyCombatReplay;
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::Move));
+	WriteVarUInt(Scratch, CombatantIndex);
+	WriteVarUInt(Scratch, FMath::Max(0, APCost));
+
+	PushScratch();
+}
+
+void FCombatReplayRecorder::RecordEnd(int32 WinningTeam)
+{
+	if (!bRecording) return;
+
+	Scratch.Reset();
+	Scratch.Add(static_cast<uint8>(ECombatReplayRecord::EncounterEnd));
+	ProdigyCombatReplay::WriteVarInt(Scratch, WinningTeam);
+
+	PushScratch();
+	bRecording = false;
+}
+
+void FCombatReplayRecorder::BuildLog(FCombatReplayLog& Out) const
+{
+	Out.EncounterId = EncounterId;
+	Out.Seed = Seed;
+	Out.bIncomplete = bIncomplete;
+	Out.bTruncated = Ring.HasDropped();
+	Out.Names = Names;
+	Out.Snapshot = Snapshot;
+	Ring.Linearize(Out.Events);
+}
+
+// =======================
+// Replay
+// =======================
+
+FString FCombatReplayResult::ToString() const
+{
+	return FString::Printf(
+		TEXT("Records=%d Turns=%d Actions=%d (Failed=%d) Checks=%d Divergences=%d Winner(rec/replay)=%d/%d Time=%.3fms%s%s"),
+		NumRecords, NumTurns, NumActions, NumFailedActions, NumChecks, NumDivergences,
+		RecordedWinningTeam, ReplayedWinningTeam, Seconds * 1000.0,
+		FirstDivergence.IsEmpty() ? TEXT("") : TEXT(" First: "), *FirstDivergence);
+}
+
+static FGameplayTag TagFromName(const FName& Name)
+{
+	return Name.IsNone() ? FGameplayTag() : FGameplayTag::RequestGameplayTag(Name, /*ErrorIfNotFound*/ false);
+}
+
+// Walks the event stream (by length prefix) to the first keyframe record
+static bool FindFirstKeyframe(const FCombatReplayLog& Log, int64& OutClock, TConstArrayView<uint8>& OutBlob)
+{
+	FCombatReplayReader Stream(Log.Events);
+	while (!Stream.IsAtEnd() && !Stream.HasError())
+	{
+		const TConstArrayView<uint8> Record = Stream.ReadBytes(Stream.ReadVarUInt());
+		if (Stream.HasError() || Record.Num() == 0) break;
+
+		if (static_cast<ECombatReplayRecord>(Record[0]) == ECombatReplayRecord::Keyframe)
+		{
+			FCombatReplayReader R(Record.RightChop(1));
+			OutClock = R.ReadVarInt();
+			OutBlob = R.ReadBytes(R.ReadVarUInt());
+			return !R.HasError();
+		}
+	}
+	return false;
+}
+
+// Snapshot and keyframe blobs share a layout; ReplayFrom only reads a keyframe's values, not its actions
+static bool DecodeState(const FCombatReplayLog& Log, TConstArrayView<uint8> Blob, FCombatCoreState& OutState, bool bLoadActions)
+{
+	const auto NameAt = [&Log](uint64 Idx) { return Log.Names.IsValidIndex((int32)Idx) ? Log.Names[(int32)Idx] : NAME_None; };
+	const auto TagAt = [&NameAt](uint64 Idx) { return TagFromName(NameAt(Idx)); };
+
+	FCombatReplayReader R(Blob);
+
+	OutState = FCombatCoreState();
+	OutState.Rng.Initialize(static_cast<int32>(Log.Seed));
+	OutState.TurnClock = R.ReadDouble();
+	OutState.CurrentIndex = static_cast<int32>(R.ReadVarInt());
+
+	TArray<FCombatCoreAction> Library;
+	const uint64 NumActions = R.ReadVarUInt();
+	for (uint64 i = 0; i < NumActions && !R.HasError(); ++i)
+	{
+		const FName Path = NameAt(R.ReadVarUInt());
+		if (!bLoadActions) continue;
+
+		const UActionDefinition* Def = LoadObject<UActionDefinition>(nullptr, *Path.ToString());
+		if (!Def)
+		{
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Missing action definition '%s'"), *Path.ToString());
+			return false;
+		}
+		Library.Add(FCombatCoreAction::FromDefinition(*Def));
+	}
+	OutState.Actions = MakeShared<TArray<FCombatCoreAction>, ESPMode::ThreadSafe>(MoveTemp(Library));
+
+	const uint64 NumCombatants = R.ReadVarUInt();
+	for (uint64 c = 0; c < NumCombatants && !R.HasError(); ++c)
+	{
+		FCombatCoreCombatant& C = OutState.Combatants.AddDefaulted_GetRef();
+		C.DebugName = NameAt(R.ReadVarUInt());
+		C.Team = static_cast<int32>(R.ReadVarInt());
+
+		const uint64 NumAttrs = R.ReadVarUInt();
+		for (uint64 i = 0; i < NumAttrs && !R.HasError(); ++i)
+		{
+			FCombatCoreAttribute& A = C.Attributes.AddDefaulted_GetRef();
+			A.Tag = TagAt(R.ReadVarUInt());
+			A.Current = R.ReadFloat();
+			A.Final = R.ReadFloat();
+		}
+
+		const uint64 NumPairs = R.ReadVarUInt();
+		for (uint64 i = 0; i < NumPairs && !R.HasError(); ++i)
+		{
+			const FGameplayTag Cur = TagAt(R.ReadVarUInt());
+			const FGameplayTag Max = TagAt(R.ReadVarUInt());
+			C.ResourcePairs.Emplace(Cur, Max);
+		}
+
+		const uint64 NumSlots = R.ReadVarUInt();
+		for (uint64 i = 0; i < NumSlots && !R.HasError(); ++i)
+		{
+			C.ActionIndices.Add(static_cast<int32>(R.ReadVarUInt()));
+			C.CooldownTurns.Add(static_cast<int32>(R.ReadVarUInt()));
+		}
+
+		const uint64 NumEffects = R.ReadVarUInt();
+		for (uint64 i = 0; i < NumEffects && !R.HasError(); ++i)
+		{
+			FCombatCoreTurnEffect& E = C.TurnEffects.AddDefaulted_GetRef();
+			E.EffectTag = TagAt(R.ReadVarUInt());
+			E.AttributeTag = TagAt(R.ReadVarUInt());
+			E.DeltaPerTurn = R.ReadFloat();
+			E.TurnsRemaining = static_cast<int32>(R.ReadVarInt());
+		}
+
+		const uint64 NumStatuses = R.ReadVarUInt();
+		for (uint64 i = 0; i < NumStatuses && !R.HasError(); ++i)
+		{
+			FCombatCoreStatus& S = C.Statuses.AddDefaulted_GetRef();
+			S.Tag = TagAt(R.ReadVarUInt());
+			S.TurnsRemaining = static_cast<int32>(R.ReadVarInt());
+		}
+	}
+
+	const uint64 NumQueued = R.ReadVarUInt();
+	for (uint64 i = 0; i < NumQueued && !R.HasError(); ++i)
+	{
+		const uint64 Id = R.ReadVarUInt();
+		const double Ready = R.ReadDouble();
+		if (Id >= static_cast<uint64>(OutState.Combatants.Num()))
+		{
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Corrupt snapshot (queued id %llu of %d combatants)"),
+			       Id, OutState.Combatants.Num());
+			return false;
+		}
+		OutState.TurnQueue.Insert(static_cast<int32>(Id), Ready);
+	}
+
+	if (R.HasError())
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Corrupt snapshot"));
+		return false;
+	}
+	return true;
+}
+
+bool ProdigyCombatReplay::DecodeSnapshot(const FCombatReplayLog& Log, FCombatCoreState& OutState)
+{
+	if (!Log.bTruncated)
+	{
+		return DecodeState(Log, Log.Snapshot, OutState, /*bLoadActions*/ true);
+	}
+
+	// The ring lost the records between the snapshot and the first survivor: start from the first keyframe
+	int64 Clock = 0;
+	TConstArrayView<uint8> Blob;
+	if (!FindFirstKeyframe(Log, Clock, Blob))
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Encounter %d log is truncated and no keyframe survived"), Log.EncounterId);
+		return false;
+	}
+	return DecodeState(Log, Blob, OutState, /*bLoadActions*/ true);
+}
+
+FCombatReplayResult ProdigyCombatReplay::Replay(const FCombatReplayLog& Log)
+{
+	FCombatCoreState Start;
+	if (!DecodeSnapshot(Log, Start))
+	{
+		return FCombatReplayResult();
+	}
+	return ReplayFrom(Log, MoveTemp(Start));
+}
+
+FCombatReplayResult ProdigyCombatReplay::ReplayFrom(const FCombatReplayLog& Log, FCombatCoreState State)
+{
+	FCombatReplayResult Result;
+	Result.bLoaded = true;
+
+	if (Log.bIncomplete)
+	{
+		UE_LOG(LogCombatCore, Warning, TEXT("[CombatReplay] Encounter %d log is incomplete (mid-fight join): results are partial"),
+		       Log.EncounterId);
+	}
+	if (Log.bTruncated)
+	{
+		UE_LOG(LogCombatCore, Display, TEXT("[CombatReplay] Encounter %d log wrapped the ring: replaying from the first surviving keyframe"),
+		       Log.EncounterId);
+	}
+
+	// Resolve every name once
+	TArray<FGameplayTag> Tags;
+	Tags.Reserve(Log.Names.Num());
+	for (const FName& N : Log.Names)
+	{
+		Tags.Add(TagFromName(N));
+	}
+	const auto TagAt = [&Tags](uint64 Idx) { return Tags.IsValidIndex((int32)Idx) ? Tags[(int32)Idx] : FGameplayTag(); };
+
+	// Running recorded values (quantized) + keys touched since the last check
+	TMap<uint64, int64> Recorded;
+	for (int32 c = 0; c < State.Combatants.Num(); ++c)
+	{
+		for (const FCombatCoreAttribute& A : State.Combatants[c].Attributes)
+		{
+			const int32 TagIdx = Log.Names.IndexOfByKey(A.Tag.GetTagName());
+			if (TagIdx != INDEX_NONE)
+			{
+				Recorded.Add(MakeAttributeKey(c, TagIdx), QuantizeValue(A.Current));
+			}
+		}
+	}
+
+	TArray<uint64> Pending;
+
+	const auto Check = [&]()
+	{
+		for (const uint64 Key : Pending)
+		{
+			const int32 CombatantIndex = static_cast<int32>(Key >> 32);
+			const int32 TagIdx = static_cast<int32>(Key & 0xFFFFFFFF);
+			if (!State.Combatants.IsValidIndex(CombatantIndex)) continue;
+
+			const int64 Expected = Recorded.FindRef(Key);
+			const int64 Actual = QuantizeValue(State.Combatants[CombatantIndex].GetCurrent(TagAt(TagIdx)));
+
+			++Result.NumChecks;
+			if (FMath::Abs(Expected - Actual) > 1)
+			{
+				++Result.NumDivergences;
+				if (Result.FirstDivergence.IsEmpty())
+				{
+					Result.FirstDivergence = FString::Printf(TEXT("Turn %d %s %s: recorded %.2f, replayed %.2f"),
+						Result.NumTurns,
+						*State.Combatants[CombatantIndex].DebugName.ToString(),
+						*TagAt(TagIdx).ToString(),
+						Expected / ValueScale, Actual / ValueScale);
+				}
+			}
+		}
+		Pending.Reset();
+	};
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FCombatReplayReader Stream(Log.Events);
+	TArray<FCombatCoreRosterEntry> Roster;
+
+	// A truncated log's start state was decoded from its first keyframe: everything up to it is skipped
+	bool bSkipToKeyframe = Log.bTruncated;
+
+	while (!Stream.IsAtEnd() && !Stream.HasError())
+	{
+		// Length prefix (records are self-delimiting, the length is only needed by the ring and to skip)
+		const uint64 Len = Stream.ReadVarUInt();
+
+		if (bSkipToKeyframe)
+		{
+			const TConstArrayView<uint8> Record = Stream.ReadBytes(Len);
+			bSkipToKeyframe = Record.Num() == 0 || static_cast<ECombatReplayRecord>(Record[0]) != ECombatReplayRecord::Keyframe;
+			continue;
+		}
+
+		const ECombatReplayRecord Type = static_cast<ECombatReplayRecord>(Stream.ReadByte());
+		++Result.NumRecords;
+
+		switch (Type)
+		{
+		case ECombatReplayRecord::TurnBegin:
+		{
+			Check();
+
+			const int32 Index = static_cast<int32>(Stream.ReadVarUInt());
+			State.TurnClock += Stream.ReadVarInt() / ClockScale;
+			State.CurrentIndex = Index;
+
+			ProdigyCombatCore::BeginTurn(State, Index);
+			++State.TurnNumber;
+			++Result.NumTurns;
+			break;
+		}
+
+		case ECombatReplayRecord::Action:
+		{
+			const int32 Instigator = static_cast<int32>(Stream.ReadVarUInt());
+			const FGameplayTag ActionTag = TagAt(Stream.ReadVarUInt());
+			const int32 Target = static_cast<int32>(Stream.ReadVarUInt()) - 1;
+
+			const uint8 Flags = Stream.ReadByte();
+			if (Flags & 1)
+			{
+				// Location is carried for repro context; headless rules have no world positions
+				Stream.ReadVarInt();
+				Stream.ReadVarInt();
+				Stream.ReadVarInt();
+			}
+
+			// Area casts bring the hits the live fight resolved
+			TArray<int32> AreaTargets;
+			if (Flags & 2)
+			{
+				const uint64 NumHits = Stream.ReadVarUInt();
+				for (uint64 i = 0; i < NumHits && !Stream.HasError(); ++i)
+				{
+					AreaTargets.Add(static_cast<int32>(Stream.ReadVarUInt()));
+				}
+			}
+
+			++Result.NumActions;
+
+			const int32 Slot = State.FindActionSlot(Instigator, ActionTag);
+			if (!ProdigyCombatCore::ExecuteAction(State, Instigator, Slot, Target, (Flags & 2) ? &AreaTargets : nullptr))
+			{
+				++Result.NumFailedActions;
+			}
+
+			// Attribute records for this action were written before it (effects fire before OnActionExecuted)
+			Check();
+			break;
+		}
+
+		case ECombatReplayRecord::AttributeChanged:
+		{
+			const int32 Index = static_cast<int32>(Stream.ReadVarUInt());
+			const int32 TagIdx = static_cast<int32>(Stream.ReadVarUInt());
+			const int64 Delta = Stream.ReadVarInt();
+
+			const uint64 Key = MakeAttributeKey(Index, TagIdx);
+			Recorded.FindOrAdd(Key) += Delta;
+			Pending.AddUnique(Key);
+			break;
+		}
+
+		case ECombatReplayRecord::Move:
+		{
+			const int32 Index = static_cast<int32>(Stream.ReadVarUInt());
+			const int64 APCost = static_cast<int64>(Stream.ReadVarUInt());
+
+			// Same spend as UCombatMovementComponent::MoveTo; its AttributeChanged record comes just before
+			if (State.Combatants.IsValidIndex(Index))
+			{
+				if (FCombatCoreAttribute* AP = State.Combatants[Index].FindAttribute(ProdigyTags::Attr::AP))
+				{
+					AP->Current -= static_cast<float>(APCost);
+				}
+			}
+			Check();
+			break;
+		}
+
+		case ECombatReplayRecord::Keyframe:
+		{
+			Check();
+
+			const int64 Clock = Stream.ReadVarInt();
+
+			FCombatCoreState Keyframe;
+			if (!DecodeState(Log, Stream.ReadBytes(Stream.ReadVarUInt()), Keyframe, /*bLoadActions*/ false))
+			{
+				Stream = FCombatReplayReader(TConstArrayView<uint8>());
+				break;
+			}
+
+			++Result.NumChecks;
+			if (Keyframe.Combatants.Num() != State.Combatants.Num())
+			{
+				++Result.NumDivergences;
+				if (Result.FirstDivergence.IsEmpty())
+				{
+					Result.FirstDivergence = FString::Printf(TEXT("Turn %d keyframe: recorded %d combatants, replayed %d"),
+						Result.NumTurns, Keyframe.Combatants.Num(), State.Combatants.Num());
+				}
+			}
+
+			// The recorder restarted its delta chain here: check the full state, then re-anchor on it
+			Recorded.Reset();
+			for (int32 c = 0; c < Keyframe.Combatants.Num(); ++c)
+			{
+				for (const FCombatCoreAttribute& A : Keyframe.Combatants[c].Attributes)
+				{
+					const int32 TagIdx = Log.Names.IndexOfByKey(A.Tag.GetTagName());
+					if (TagIdx == INDEX_NONE) continue;
+
+					const uint64 Key = MakeAttributeKey(c, TagIdx);
+					Recorded.Add(Key, QuantizeValue(A.Current));
+					Pending.AddUnique(Key);
+				}
+			}
+			Check();
+
+			State.TurnClock = Clock / ClockScale;
+			break;
+		}
+
+		case ECombatReplayRecord::EncounterEnd:
+		{
+			Check();
+			Result.RecordedWinningTeam = static_cast<int32>(Stream.ReadVarInt());
+			break;
+		}
+
+		default:
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Unknown record type %d"), (int32)Type);
+			Stream = FCombatReplayReader(TConstArrayView<uint8>());
+			break;
+		}
+	}
+
+	Check();
+
+	State.BuildRoster(Roster);
+	Result.ReplayedWinningTeam = ProdigyCombatCore::IsCombatOver(Roster) ? ProdigyCombatCore::GetWinningTeam(Roster) : INDEX_NONE;
+
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+FString ProdigyCombatReplay::GetDefaultReplayDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("CombatReplays");
+}
+
+// =======================
+// Console entry points
+// =======================
+
+static FAutoConsoleCommandWithWorldAndArgs GCombatReplaySaveCmd(
+	TEXT("Prodigy.Combat.Replay.Save"),
+	TEXT("Writes the current (or last finished) player encounter as a repro file.\n")
+	TEXT("Usage: Prodigy.Combat.Replay.Save [File=Saved/CombatReplays/Encounter_<Id>_<Time>.pcr]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+
+		FCombatReplayLog Log;
+		if (!Combat || !Combat->GetLatestReplay(Log))
+		{
+			UE_LOG(LogCombatCore, Warning, TEXT("[CombatReplay] Nothing recorded yet"));
+			return;
+		}
+
+		const FString Path = Args.IsValidIndex(0)
+			? Args[0]
+			: ProdigyCombatReplay::GetDefaultReplayDir() / FString::Printf(TEXT("Encounter_%d_%s.pcr"),
+				Log.EncounterId, *FDateTime::Now().ToString());
+
+		if (Log.SaveToFile(Path))
+		{
+			UE_LOG(LogCombatCore, Display, TEXT("[CombatReplay] Saved %s (%d bytes, incomplete=%d)"),
+			       *Path, Log.GetTotalBytes(), Log.bIncomplete);
+		}
+		else
+		{
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatReplay] Could not write %s"), *Path);
+		}
+	}));
+
+static FAutoConsoleCommand GCombatReplayRunCmd(
+	TEXT("Prodigy.Combat.Replay.Run"),
+	TEXT("Re-runs a repro file headless at full speed and reports divergences + timing.\n")
+	TEXT("Usage: Prodigy.Combat.Replay.Run <File> [Iterations=1]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogCombatCore, Warning, TEXT("[CombatReplay] Usage: Prodigy.Combat.Replay.Run <File> [Iterations]"));
+			return;
+		}
+
+		FCombatReplayLog Log;
+		if (!Log.LoadFromFile(Args[0])) return;
+
+		FCombatCoreState Start;
+		if (!ProdigyCombatReplay::DecodeSnapshot(Log, Start)) return;
+
+		const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1;
+
+		FCombatReplayResult Result;
+		double TotalSeconds = 0.0;
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Result = ProdigyCombatReplay::ReplayFrom(Log, Start);
+			TotalSeconds += Result.Seconds;
+		}
+
+		UE_LOG(LogCombatCore, Display, TEXT("[CombatReplay] %s Encounter=%d %s"), *Args[0], Log.EncounterId, *Result.ToString());
+		UE_LOG(LogCombatCore, Display, TEXT("[CombatReplay] Iterations=%d Avg=%.1fus"), Iterations, 1e6 * TotalSeconds / Iterations);
+	}));
@@ -0,0 +1,164 @@
+﻿#include "AbilitySystem/CombatScheduler.h"
+
+namespace
+{
+	struct FCombatEventLess
+	{
+		bool operator()(const FCombatScheduledEvent& A, const FCombatScheduledEvent& B) const
+		{
+			return (A.Time < B.Time) || (A.Time == B.Time && A.Sequence < B.Sequence);
+		}
+	};
+}
+
+const TCHAR* LexToString(ECombatEventType Type)
+{
+	switch (Type)
+	{
+	case ECombatEventType::BeginTurn:    return TEXT("BeginTurn");
+	case ECombatEventType::AITakeAction: return TEXT("AITakeAction");
+	case ECombatEventType::TeamPhaseAct: return TEXT("TeamPhaseAct");
+	case ECombatEventType::EndCombat:    return TEXT("EndCombat");
+	default:                             return TEXT("?");
+	}
+}
+
+void FCombatScheduler::Reset()
+{
+	Heap.Reset();
+	LiveByKey.Reset();
+	NextSequence = 0;
+	PumpSequenceLimit = 0;
+	History.Reset();
+	HistoryHead = 0;
+}
+
+void FCombatScheduler::Schedule(int32 EncounterId, ECombatEventType Type, double Now, double DelaySeconds, int32 Slot, int32 TargetSlot)
+{
+	FCombatScheduledEvent E;
+	E.Time = Now + FMath::Max(0.0, DelaySeconds);
+	E.Sequence = NextSequence++;
+	E.EncounterId = EncounterId;
+	E.Type = Type;
+	E.Slot = Slot;
+	E.TargetSlot = TargetSlot;
+	E.ScheduledAt = Now;
+
+	// Replaces any pending event for this key (the old heap entry goes stale)
+	LiveByKey.Add(MakeKey(EncounterId, Type), E.Sequence);
+
+	Heap.HeapPush(E, FCombatEventLess());
+}
+
+bool FCombatScheduler::Cancel(int32 EncounterId, ECombatEventType Type)
+{
+	return LiveByKey.Remove(MakeKey(EncounterId, Type)) > 0;
+}
+
+void FCombatScheduler::CancelEncounter(int32 EncounterId)
+{
+	for (uint8 T = 0; T < static_cast<uint8>(ECombatEventType::Count); ++T)
+	{
+		Cancel(EncounterId, static_cast<ECombatEventType>(T));
+	}
+}
+
+bool FCombatScheduler::IsScheduled(int32 EncounterId, ECombatEventType Type) const
+{
+	return LiveByKey.Contains(MakeKey(EncounterId, Type));
+}
+
+bool FCombatScheduler::IsLive(const FCombatScheduledEvent& E) const
+{
+	const uint32* Live = LiveByKey.Find(MakeKey(E.EncounterId, E.Type));
+	return Live && *Live == E.Sequence;
+}
+
+bool FCombatScheduler::PopDue(double Now, FCombatScheduledEvent& OutEvent)
+{
+	while (Heap.Num() > 0)
+	{
+		const FCombatScheduledEvent& Top = Heap.HeapTop();
+
+		if (!IsLive(Top))
+		{
+			Heap.HeapPopDiscard(FCombatEventLess(), EAllowShrinking::No);
+			continue;
+		}
+
+		// New events have Time >= their schedule time, so anything behind a fresh one isn't due either
+		if (Top.Time > Now || Top.Sequence >= PumpSequenceLimit)
+		{
+			return false;
+		}
+
+		Heap.HeapPop(OutEvent, FCombatEventLess(), EAllowShrinking::No);
+		LiveByKey.Remove(MakeKey(OutEvent.EncounterId, OutEvent.Type));
+
+		if (History.Num() < HistorySize)
+		{
+			History.Emplace(OutEvent, Now);
+		}
+		else
+		{
+			History[HistoryHead] = TPair<FCombatScheduledEvent, double>(OutEvent, Now);
+		}
+		HistoryHead = (HistoryHead + 1) % HistorySize;
+
+		return true;
+	}
+
+	return false;
+}
+
+void FCombatScheduler::GetPendingEvents(TArray<FCombatScheduledEvent>& OutEvents) const
+{
+	OutEvents.Reset(LiveByKey.Num());
+
+	for (const FCombatScheduledEvent& E : Heap)
+	{
+		if (IsLive(E))
+		{
+			OutEvents.Add(E);
+		}
+	}
+
+	OutEvents.Sort(FCombatEventLess());
+}
+
+void FCombatScheduler::GetRecentEvents(TArray<TPair<FCombatScheduledEvent, double>>& OutEvents) const
+{
+	OutEvents.Reset(History.Num());
+
+	// Before the ring wraps HistoryHead == Num, so this starts at 0
+	const int32 Start = History.Num() < HistorySize ? 0 : HistoryHead;
+	for (int32 i = 0; i < History.Num(); ++i)
+	{
+		OutEvents.Add(History[(Start + i) % History.Num()]);
+	}
+}
+
+void FCombatScheduler::DumpTrace(double Now, TArray<FString>& OutLines) const
+{
+	TArray<TPair<FCombatScheduledEvent, double>> Recent;
+	GetRecentEvents(Recent);
+
+	OutLines.Add(FString::Printf(TEXT("Fired (last %d):"), Recent.Num()));
+	for (const TPair<FCombatScheduledEvent, double>& R : Recent)
+	{
+		const FCombatScheduledEvent& E = R.Key;
+		OutLines.Add(FString::Printf(TEXT("  %+8.3fs  Enc=%d %-12s Slot=%d Target=%d (due %+.3fs, late %.1fms)"),
+			R.Value - Now, E.EncounterId, LexToString(E.Type), E.Slot, E.TargetSlot,
+			E.Time - Now, (R.Value - E.Time) * 1000.0));
+	}
+
+	TArray<FCombatScheduledEvent> Pending;
+	GetPendingEvents(Pending);
+
+	OutLines.Add(FString::Printf(TEXT("Pending (%d):"), Pending.Num()));
+	for (const FCombatScheduledEvent& E : Pending)
+	{
+		OutLines.Add(FString::Printf(TEXT("  %+8.3fs  Enc=%d %-12s Slot=%d Target=%d (scheduled %+.3fs)"),
+			E.Time - Now, E.EncounterId, LexToString(E.Type), E.Slot, E.TargetSlot, E.ScheduledAt - Now));
+	}
+}
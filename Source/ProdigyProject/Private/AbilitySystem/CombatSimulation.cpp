@@ -0,0 +1,257 @@
+﻿#include "AbilitySystem/CombatSimulation.h"
+
+#include "Async/ParallelFor.h"
+#include "AbilitySystem/ActionDefinition.h"
+#include "AbilitySystem/AttributeSetDataAsset.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+bool UCombatSimulationEncounter::BuildTemplateState(FCombatCoreState& OutState) const
+{
+	TArray<FCombatCoreAction> Library;
+	TMap<const UActionDefinition*, int32> IndexByDef;
+
+	OutState = FCombatCoreState();
+
+	for (const FCombatSimulationCombatantSpec& Spec : Combatants)
+	{
+		for (int32 Copy = 0; Copy < FMath::Max(1, Spec.Count); ++Copy)
+		{
+			const FName DebugName = Spec.Count > 1
+				? FName(*FString::Printf(TEXT("%s_%d"), *Spec.Name.ToString(), Copy))
+				: Spec.Name;
+
+			FCombatCoreCombatant C;
+			if (!ProdigyCombatCore::MakeCombatantFromAssets(DebugName, Spec.Team, Spec.AttributeSet, Spec.Actions, Library, IndexByDef, C))
+			{
+				continue;
+			}
+			OutState.Combatants.Add(MoveTemp(C));
+		}
+	}
+
+	OutState.Actions = MakeShared<TArray<FCombatCoreAction>, ESPMode::ThreadSafe>(MoveTemp(Library));
+	OutState.CurrentIndex = 0;
+
+	if (OutState.Combatants.Num() < 2)
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatSim] %s: need >= 2 valid combatants (got %d)"),
+		       *GetNameSafe(this), OutState.Combatants.Num());
+		return false;
+	}
+
+	return true;
+}
+
+double FCombatSimulationReport::GetWinRate(int32 Team) const
+{
+	const int32* Wins = WinsByTeam.Find(Team);
+	return (Wins && NumRuns > 0) ? (double)*Wins / NumRuns : 0.0;
+}
+
+FString FCombatSimulationReport::ToTable() const
+{
+	FString Out;
+
+	const double FightsPerSecond = WallSeconds > 0.0 ? NumRuns / WallSeconds : 0.0;
+
+	Out += FString::Printf(TEXT("Runs=%d Wall=%.3fs (%.0f fights/s) AvgTurns=%.2f Min=%d Max=%d Draws=%d (%.1f%%)\n"),
+	                       NumRuns, WallSeconds, FightsPerSecond, GetAverageTurns(), MinTurns, MaxTurns,
+	                       Draws, NumRuns > 0 ? 100.0 * Draws / NumRuns : 0.0);
+
+	Out += TEXT("Team |   Wins | WinRate | AvgTurnsToWin\n");
+
+	TArray<int32> Teams;
+	WinsByTeam.GetKeys(Teams);
+	Teams.Sort();
+
+	for (const int32 Team : Teams)
+	{
+		const int32 Wins = WinsByTeam.FindRef(Team);
+		const double Turns = TurnsByWinningTeam.FindRef(Team);
+
+		Out += FString::Printf(TEXT("%4d | %6d | %6.1f%% | %.2f\n"),
+		                       Team, Wins, 100.0 * GetWinRate(Team), Wins > 0 ? Turns / Wins : 0.0);
+	}
+
+	Out += TEXT("Turns     |  Count\n");
+
+	const int32 Peak = TurnHistogram.Num() > 0 ? FMath::Max(TurnHistogram) : 0;
+
+	for (int32 Bucket = 0; Bucket < TurnHistogram.Num(); ++Bucket)
+	{
+		const int32 Count = TurnHistogram[Bucket];
+		if (Count == 0) continue;
+
+		const int32 Lo = Bucket * TurnBucketSize;
+		const int32 Hi = Lo + TurnBucketSize - 1;
+		const int32 BarLen = Peak > 0 ? FMath::Max(1, (Count * 40) / Peak) : 0;
+
+		Out += FString::Printf(TEXT("%4d-%-4d | %6d %s\n"), Lo, Hi, Count, *FString::ChrN(BarLen, TEXT('#')));
+	}
+
+	return Out;
+}
+
+void FCombatSimulationReport::LogTable() const
+{
+	TArray<FString> Lines;
+	ToTable().ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines)
+	{
+		UE_LOG(LogCombatCore, Display, TEXT("[CombatSim] %s"), *Line);
+	}
+}
+
+FCombatSimulationReport FCombatSimulator::Run(const FCombatCoreState& Template, const FCombatSimulationSettings& Settings)
+{
+	FCombatSimulationReport Report;
+	Report.NumRuns = FMath::Max(0, Settings.NumRuns);
+
+	const int32 NumCombatants = Template.Combatants.Num();
+	if (Report.NumRuns == 0 || NumCombatants < 2 || !Template.Actions.IsValid())
+	{
+		return Report;
+	}
+
+	const int32 NumRuns = Report.NumRuns;
+	const int32 BatchSize = FMath::Max(1, Settings.BatchSize);
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumRuns, BatchSize);
+
+	TArray<FCombatCoreOutcome> Outcomes;
+	Outcomes.SetNum(NumRuns);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	ParallelFor(NumBatches, [&Template, &Settings, &Outcomes, NumRuns, BatchSize, NumCombatants](int32 BatchIndex)
+	{
+		const int32 First = BatchIndex * BatchSize;
+		const int32 Last = FMath::Min(NumRuns, First + BatchSize);
+
+		for (int32 RunIndex = First; RunIndex < Last; ++RunIndex)
+		{
+			// Copy is cheap: the action library is shared, only per-combatant state is duplicated
+			FCombatCoreState State = Template;
+			State.Rng.Initialize(Settings.BaseSeed + RunIndex);
+			State.TurnNumber = 0;
+			if (Settings.bRandomizeFirstToAct)
+			{
+				State.CurrentIndex = State.Rng.RandRange(0, NumCombatants - 1);
+				State.TurnQueue.Reset();
+			}
+			else if (!State.Combatants.IsValidIndex(State.CurrentIndex))
+			{
+				State.CurrentIndex = 0;
+			}
+
+			Outcomes[RunIndex] = ProdigyCombatCore::RunToCompletion(State, Settings.MaxTurns);
+		}
+	});
+
+	Report.WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	Report.MinTurns = MAX_int32;
+	for (const FCombatCoreOutcome& O : Outcomes)
+	{
+		Report.TotalTurns += O.Turns;
+		Report.MinTurns = FMath::Min(Report.MinTurns, O.Turns);
+		Report.MaxTurns = FMath::Max(Report.MaxTurns, O.Turns);
+
+		if (O.WinningTeam == INDEX_NONE)
+		{
+			++Report.Draws;
+		}
+		else
+		{
+			Report.WinsByTeam.FindOrAdd(O.WinningTeam) += 1;
+			Report.TurnsByWinningTeam.FindOrAdd(O.WinningTeam) += O.Turns;
+		}
+
+		const int32 Bucket = O.Turns / Report.TurnBucketSize;
+		if (Bucket >= Report.TurnHistogram.Num())
+		{
+			Report.TurnHistogram.SetNumZeroed(Bucket + 1);
+		}
+		++Report.TurnHistogram[Bucket];
+	}
+
+	return Report;
+}
+
+bool FCombatSimulator::RunEncounter(const UCombatSimulationEncounter* Encounter, int32 NumRuns, int32 BaseSeed, FCombatSimulationReport& OutReport)
+{
+	if (!IsValid(Encounter)) return false;
+
+	FCombatCoreState Template;
+	if (!Encounter->BuildTemplateState(Template)) return false;
+
+	FCombatSimulationSettings Settings;
+	Settings.NumRuns = NumRuns;
+	Settings.BaseSeed = BaseSeed;
+	Settings.MaxTurns = Encounter->MaxTurns;
+	Settings.bRandomizeFirstToAct = Encounter->bRandomizeFirstToAct;
+
+	OutReport = Run(Template, Settings);
+	return true;
+}
+
+// =======================
+// Console entry points
+// =======================
+
+static FAutoConsoleCommand GCombatSimulateEncounterCmd(
+	TEXT("Prodigy.Combat.Simulate"),
+	TEXT("Headless batch simulation of a UCombatSimulationEncounter asset.\n")
+	TEXT("Usage: Prodigy.Combat.Simulate <AssetPath> [Runs=1000] [Seed=1]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogCombatCore, Warning, TEXT("[CombatSim] Usage: Prodigy.Combat.Simulate <AssetPath> [Runs] [Seed]"));
+			return;
+		}
+
+		const UCombatSimulationEncounter* Encounter = LoadObject<UCombatSimulationEncounter>(nullptr, *Args[0]);
+		if (!Encounter)
+		{
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatSim] Could not load encounter '%s'"), *Args[0]);
+			return;
+		}
+
+		const int32 Runs = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1000;
+		const int32 Seed = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 1;
+
+		FCombatSimulationReport Report;
+		if (FCombatSimulator::RunEncounter(Encounter, Runs, Seed, Report))
+		{
+			UE_LOG(LogCombatCore, Display, TEXT("[CombatSim] Encounter=%s"), *GetNameSafe(Encounter));
+			Report.LogTable();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GCombatSimulateLiveCmd(
+	TEXT("Prodigy.Combat.SimulateLive"),
+	TEXT("Snapshots the running fight and batch-simulates it from the current state.\n")
+	TEXT("Usage: Prodigy.Combat.SimulateLive [Runs=1000] [Seed=1]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+
+		FCombatCoreState Template;
+		if (!Combat || !Combat->BuildCoreState(Template))
+		{
+			UE_LOG(LogCombatCore, Warning, TEXT("[CombatSim] SimulateLive: no running fight to snapshot"));
+			return;
+		}
+
+		FCombatSimulationSettings Settings;
+		Settings.NumRuns = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 1000;
+		Settings.BaseSeed = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1;
+		Settings.bRandomizeFirstToAct = false;
+
+		FCombatSimulator::Run(Template, Settings).LogTable();
+	}));
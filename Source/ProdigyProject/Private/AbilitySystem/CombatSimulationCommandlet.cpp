@@ -0,0 +1,55 @@
+﻿#include "AbilitySystem/CombatSimulationCommandlet.h"
+
+#include "AbilitySystem/CombatSimulation.h"
+
+UCombatSimulationCommandlet::UCombatSimulationCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UCombatSimulationCommandlet::Main(const FString& Params)
+{
+	FString EncounterList;
+	if (!FParse::Value(*Params, TEXT("Encounter="), EncounterList, /*bShouldStopOnSeparator*/ false))
+	{
+		UE_LOG(LogCombatCore, Error, TEXT("[CombatSim] Missing -Encounter=/Game/Path/Asset[+/Game/Other]"));
+		return 1;
+	}
+
+	int32 Runs = 1000;
+	int32 Seed = 1;
+	FParse::Value(*Params, TEXT("Runs="), Runs);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	TArray<FString> Paths;
+	EncounterList.ParseIntoArray(Paths, TEXT("+"), /*InCullEmpty*/ true);
+
+	int32 Failures = 0;
+
+	for (const FString& Path : Paths)
+	{
+		const UCombatSimulationEncounter* Encounter = LoadObject<UCombatSimulationEncounter>(nullptr, *Path);
+		if (!Encounter)
+		{
+			UE_LOG(LogCombatCore, Error, TEXT("[CombatSim] Could not load encounter '%s'"), *Path);
+			++Failures;
+			continue;
+		}
+
+		FCombatSimulationReport Report;
+		if (!FCombatSimulator::RunEncounter(Encounter, Runs, Seed, Report))
+		{
+			++Failures;
+			continue;
+		}
+
+		UE_LOG(LogCombatCore, Display, TEXT("[CombatSim] Encounter=%s"), *Path);
+		Report.LogTable();
+	}
+
+	return Failures > 0 ? 1 : 0;
+}
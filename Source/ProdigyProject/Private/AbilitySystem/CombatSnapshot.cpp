@@ -0,0 +1,233 @@
+﻿#include "AbilitySystem/CombatSnapshot.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/CombatantTable.h"
+#include "AbilitySystem/CombatCore.h"
+
+const FAttributeEntry* FCombatantSnapshot::FindAttribute(const FGameplayTag& Tag) const
+{
+	if (!Attributes.IsValid()) return nullptr;
+	return Attributes->FindByPredicate([&](const FAttributeEntry& E){ return E.AttributeTag == Tag; });
+}
+
+float FCombatantSnapshot::GetCurrentValue(const FGameplayTag& Tag) const
+{
+	const FAttributeEntry* E = FindAttribute(Tag);
+	return E ? E->CurrentValue : 0.f;
+}
+
+float FCombatantSnapshot::GetFinalValue(const FGameplayTag& Tag) const
+{
+	const FAttributeEntry* E = FindAttribute(Tag);
+	if (!E) return 0.f;
+
+	if (!ModSources.IsValid()) return E->BaseValue;
+	return UAttributesComponent::ComputeFinalValue(*E, *ModSources);
+}
+
+bool FCombatantSnapshot::HasStatus(const FGameplayTag& Tag) const
+{
+	return Tag.IsValid() && Statuses.IsValid()
+		&& Statuses->ContainsByPredicate([&](const FStatusEntry& S){ return S.Tag == Tag; });
+}
+
+int32 FCombatantSnapshot::GetCooldownTurnsRemaining(const FGameplayTag& ActionTag) const
+{
+	const FActionCooldownState* S = Cooldowns.IsValid() ? Cooldowns->Find(ActionTag) : nullptr;
+	return S ? FMath::Max(0, S->TurnsRemaining) : 0;
+}
+
+const FCombatantSnapshot* FCombatSnapshot::FindCombatant(const AActor* Actor) const
+{
+	if (!Actor) return nullptr;
+	return Combatants.FindByPredicate([&](const FCombatantSnapshot& C){ return C.Actor.Get() == Actor; });
+}
+
+namespace
+{
+	// Previous block while its section hasn't been written since, else a fresh copy
+	template<typename T, typename FCopyLive>
+	TCombatSnapshotBlock<T> ShareOrCopy(const TCombatSnapshotBlock<T>* PrevBlock, uint32 PrevRevision, uint32 LiveRevision,
+	                                    FCopyLive&& CopyLive, int32& InOutCopied, int32& InOutShared)
+	{
+		if (PrevBlock && PrevBlock->IsValid() && PrevRevision == LiveRevision)
+		{
+			++InOutShared;
+			return *PrevBlock;
+		}
+
+		++InOutCopied;
+		return MakeShared<T, ESPMode::ThreadSafe>(CopyLive());
+	}
+}
+
+void ProdigyCombatSnapshot::CaptureCombatant(const FCombatantTable& Table, int32 Slot, bool bInFight, const FCombatantSnapshot* Prev,
+                                             FCombatantSnapshot& Out, int32& InOutCopied, int32& InOutShared)
+{
+	// Out of the fight: nothing reads it any more, keep whatever it had
+	if (!bInFight && Prev)
+	{
+		Out = *Prev;
+		Out.bInFight = false;
+		return;
+	}
+
+	AActor* Actor = Table.Actors[Slot].Get();
+	const UAttributesComponent* Attr = Table.AttributeComponents[Slot].Get();
+	const UStatusComponent* Status = Table.StatusComponents[Slot].Get();
+	const UActionComponent* AC = Table.ActionComponents[Slot].Get();
+
+	Out.Actor = Actor;
+	Out.DebugName = Actor ? Actor->GetFName() : NAME_None;
+	Out.Team = Table.Teams[Slot];
+	Out.bInFight = bInFight;
+	Out.Transform = Actor ? Actor->GetActorTransform() : FTransform::Identity;
+	Out.CollisionRadius = Actor ? Actor->GetSimpleCollisionRadius() : 0.f;
+
+	FCombatantSnapshotRevisions& Rev = Out.Revisions;
+	const FCombatantSnapshotRevisions* PrevRev = Prev ? &Prev->Revisions : nullptr;
+
+	if (Attr)
+	{
+		Rev.Values = Attr->GetValuesRevision();
+		Rev.Mods = Attr->GetModsRevision();
+		Rev.TurnEffects = Attr->GetTurnEffectsRevision();
+
+		Out.Attributes = ShareOrCopy<TArray<FAttributeEntry>>(Prev ? &Prev->Attributes : nullptr, PrevRev ? PrevRev->Values : 0, Rev.Values,
+			[Attr]{ TArray<FAttributeEntry> E; Attr->GetAttributeEntries(E); return E; }, InOutCopied, InOutShared);
+
+		Out.ModSources = ShareOrCopy<TMap<TWeakObjectPtr<UObject>, FAttrModSource>>(Prev ? &Prev->ModSources : nullptr, PrevRev ? PrevRev->Mods : 0, Rev.Mods,
+			[Attr]{ return Attr->GetModSources(); }, InOutCopied, InOutShared);
+
+		Out.TurnEffects = ShareOrCopy<TArray<FPeriodicTurnEffect>>(Prev ? &Prev->TurnEffects : nullptr, PrevRev ? PrevRev->TurnEffects : 0, Rev.TurnEffects,
+			[Attr]{ return Attr->GetTurnEffects(); }, InOutCopied, InOutShared);
+
+		Out.AttributeSet = Attr->AttributeSet;
+	}
+
+	if (Status)
+	{
+		Rev.Statuses = Status->GetRevision();
+		Out.Statuses = ShareOrCopy<TArray<FStatusEntry>>(Prev ? &Prev->Statuses : nullptr, PrevRev ? PrevRev->Statuses : 0, Rev.Statuses,
+			[Status]{ return Status->Statuses; }, InOutCopied, InOutShared);
+	}
+
+	if (AC)
+	{
+		Rev.Cooldowns = AC->GetCooldownsRevision();
+		Out.Cooldowns = ShareOrCopy<TMap<FGameplayTag, FActionCooldownState>>(Prev ? &Prev->Cooldowns : nullptr, PrevRev ? PrevRev->Cooldowns : 0, Rev.Cooldowns,
+			[AC]{ return AC->GetCooldowns(); }, InOutCopied, InOutShared);
+
+		if (Prev && Prev->Actions.IsValid())
+		{
+			Out.Actions = Prev->Actions;
+		}
+		else
+		{
+			TArray<const UActionDefinition*> Defs;
+			for (const UActionDefinition* Def : AC->KnownActions)
+			{
+				Defs.Add(Def);
+			}
+			Out.Actions = MakeShared<TArray<const UActionDefinition*>, ESPMode::ThreadSafe>(MoveTemp(Defs));
+		}
+	}
+}
+
+bool ProdigyCombatSnapshot::RestoreCombatant(const FCombatantTable& Table, int32 Slot, const FCombatantSnapshot& In, AActor* InstigatorActor)
+{
+	if (!Table.IsValidIndex(Slot)) return false;
+
+	UAttributesComponent* Attr = Table.AttributeComponents[Slot].Get();
+	UStatusComponent* Status = Table.StatusComponents[Slot].Get();
+	UActionComponent* AC = Table.ActionComponents[Slot].Get();
+
+	if (In.Attributes.IsValid() && !Attr) return false;
+	if (In.Statuses.IsValid() && !Status) return false;
+	if (In.Cooldowns.IsValid() && !AC) return false;
+
+	// Untouched sections are skipped, so undoing one action only writes what it changed.
+	// Statuses go first: attribute broadcasts below may be read by listeners that also check statuses.
+	if (Status && In.Statuses.IsValid() && Status->GetRevision() != In.Revisions.Statuses)
+	{
+		Status->RestoreStatuses(*In.Statuses);
+	}
+
+	if (AC && In.Cooldowns.IsValid() && AC->GetCooldownsRevision() != In.Revisions.Cooldowns)
+	{
+		AC->RestoreCooldowns(*In.Cooldowns);
+	}
+
+	if (Attr)
+	{
+		const bool bValues = In.Attributes.IsValid() && Attr->GetValuesRevision() != In.Revisions.Values;
+		const bool bMods = In.ModSources.IsValid() && Attr->GetModsRevision() != In.Revisions.Mods;
+		const bool bEffects = In.TurnEffects.IsValid() && Attr->GetTurnEffectsRevision() != In.Revisions.TurnEffects;
+
+		if (bValues || bMods || bEffects)
+		{
+			Attr->RestoreState(
+				bValues ? In.Attributes.Get() : nullptr,
+				bMods ? In.ModSources.Get() : nullptr,
+				bEffects ? In.TurnEffects.Get() : nullptr,
+				InstigatorActor);
+		}
+	}
+
+	return true;
+}
+
+bool ProdigyCombatSnapshot::BuildCoreState(const FCombatSnapshot& Snapshot, FCombatCoreState& OutState, TArray<int32>* OutCoreIndexBySlot)
+{
+	TArray<FCombatCoreAction> Library;
+	TMap<const UActionDefinition*, int32> IndexByDef;
+
+	OutState = FCombatCoreState();
+	OutState.CurrentIndex = INDEX_NONE;
+
+	TArray<int32> CoreIndexBySlot;
+	CoreIndexBySlot.Init(INDEX_NONE, Snapshot.Combatants.Num());
+
+	for (int32 Slot = 0; Slot < Snapshot.Combatants.Num(); ++Slot)
+	{
+		const FCombatantSnapshot& S = Snapshot.Combatants[Slot];
+		if (!S.bInFight) continue;
+
+		FCombatCoreCombatant C;
+		if (!ProdigyCombatCore::MakeCombatantFromSnapshot(S, Library, IndexByDef, C)) continue;
+
+		CoreIndexBySlot[Slot] = OutState.Combatants.Add(MoveTemp(C));
+	}
+
+	OutState.Actions = MakeShared<TArray<FCombatCoreAction>, ESPMode::ThreadSafe>(MoveTemp(Library));
+	OutState.TurnClock = Snapshot.TurnClock;
+	OutState.Rng = Snapshot.Rng;
+
+	// Same order as UCombatEncounter::BuildCoreState: current actor first, then the queue
+	if (CoreIndexBySlot.IsValidIndex(Snapshot.CurrentSlot))
+	{
+		OutState.CurrentIndex = CoreIndexBySlot[Snapshot.CurrentSlot];
+		if (OutState.CurrentIndex != INDEX_NONE && !Snapshot.TurnQueue.Contains(Snapshot.CurrentSlot))
+		{
+			OutState.TurnQueue.Insert(OutState.CurrentIndex, Snapshot.TurnClock);
+		}
+	}
+
+	TArray<FCombatTurnQueueEntry> Ordered;
+	Snapshot.TurnQueue.GetOrderedEntries(Snapshot.TurnQueue.Num(), Ordered);
+
+	for (const FCombatTurnQueueEntry& E : Ordered)
+	{
+		const int32 CoreIndex = CoreIndexBySlot.IsValidIndex(E.Id) ? CoreIndexBySlot[E.Id] : INDEX_NONE;
+		if (CoreIndex == INDEX_NONE) continue;
+
+		OutState.TurnQueue.Insert(CoreIndex, E.ReadyTime);
+	}
+
+	if (OutCoreIndexBySlot)
+	{
+		*OutCoreIndexBySlot = MoveTemp(CoreIndexBySlot);
+	}
+
+	return OutState.Combatants.Num() >= 2;
+}
@@ -2,9 +2,14 @@
 
 #include "AbilitySystem/ActionAgentInterface.h"
 #include "AbilitySystem/ActionComponent.h"
-#include "AbilitySystem/ActionCueSubsystem.h"
+#include "AbilitySystem/CombatCore.h"
 #include "AbilitySystem/ProdigyAbilityUtils.h"
 #include "AbilitySystem/ProdigyGameplayTags.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 
 bool UCombatSubsystem::IsValidCombatant(AActor* A) const
 {
@@ -47,458 +52,554 @@ bool UCombatSubsystem::IsValidCombatant(AActor* A) const
 }
 
 
-void UCombatSubsystem::ExitCombat()
+void UCombatSubsystem::Deinitialize()
 {
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] ExitCombat Started"));
-
-	if (!bInCombat) return;
-
-	// Stop any scheduled work first
-	CancelScheduledBeginTurn();
-
-	if (UWorld* World = GetWorld())
-	{
-		World->GetTimerManager().ClearTimer(TimerHandle_AITakeAction);
-	}
+	// End() removes from the map, iterate a copy
+	TArray<TObjectPtr<UCombatEncounter>> ToEnd;
+	Encounters.GenerateValueArray(ToEnd);
 
-	// Unbind + reset combat flags on current participants
-	// (use the current array before we clear it)
-	for (TWeakObjectPtr<AActor>& W : Participants)
+	for (UCombatEncounter* E : ToEnd)
 	{
-		AActor* A = W.Get();
-		if (!IsValid(A)) continue;
-
-		if (UActionComponent* AC = A->FindComponentByClass<UActionComponent>())
+		if (IsValid(E))
 		{
-			AC->SetInCombat(false);
-			AC->OnActionExecuted.RemoveDynamic(this, &UCombatSubsystem::HandleActionExecuted);
+			E->End();
 		}
 	}
 
-	// ---- IMPORTANT: update state BEFORE broadcasting ----
-	Participants.Reset();
-	TurnIndex = 0;
-	bAdvancingTurn = false;
-	bInCombat = false;
-
-	// Now notify listeners with correct, final state
-	OnCombatStateChanged.Broadcast(false);
-	OnTurnActorChanged.Broadcast(nullptr);
-	OnParticipantsChanged.Broadcast();
+	Encounters.Reset();
+	EncounterByActor.Reset();
+	PrimaryHandle.Reset();
+	Bubble.RestoreAll();
+	Scheduler.Reset();
 
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] ExitCombat Completed"));
+	Super::Deinitialize();
 }
 
-void UCombatSubsystem::EnterCombat(const TArray<AActor*>& InParticipants, AActor* FirstToAct)
-{
-	// If we're already in combat, ignore
-	if (bInCombat) return;
+// =======================
+// Scheduler
+// =======================
 
-	// Build a filtered list first (do NOT flip bInCombat yet)
-	TArray<TWeakObjectPtr<AActor>> NewParticipants;
-	NewParticipants.Reserve(InParticipants.Num());
+TStatId UCombatSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatSubsystem, STATGROUP_Tickables);
+}
 
-	for (AActor* A : InParticipants)
-	{
-		if (!IsValidCombatant(A)) continue;
-		NewParticipants.Add(A);
-	}
+ETickableTickType UCombatSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
 
-	// ✅ No combat if we don't have at least 2 combatants
-	if (NewParticipants.Num() < 2)
-	{
-		UE_LOG(LogActionExec, Warning,
-		       TEXT("[Combat] EnterCombat ABORTED: ValidParticipants=%d (need >= 2). FirstToAct=%s"),
-		       NewParticipants.Num(), *GetNameSafe(FirstToAct));
-		return;
-	}
+bool UCombatSubsystem::IsTickable() const
+{
+	return Scheduler.HasPending();
+}
 
+double UCombatSubsystem::GetSchedulerTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
 
-	// Now we can enter combat
-	bInCombat = true;
-	bAdvancingTurn = false;
+void UCombatSubsystem::Tick(float DeltaTime)
+{
+	const double Now = GetSchedulerTime();
 
-	Participants = MoveTemp(NewParticipants);
+	Scheduler.BeginPump();
 
-	for (TWeakObjectPtr<AActor>& W : Participants)
+	FCombatScheduledEvent Event;
+	while (Scheduler.PopDue(Now, Event))
 	{
-		AActor* A = W.Get();
-		if (!IsValid(A)) continue;
+		UE_LOG(LogActionExec, Verbose, TEXT("[Combat] Scheduler: Enc=%d %s Slot=%d Target=%d Late=%.1fms"),
+		       Event.EncounterId, LexToString(Event.Type), Event.Slot, Event.TargetSlot, (Now - Event.Time) * 1000.0);
 
-		if (UActionComponent* AC = A->FindComponentByClass<UActionComponent>())
-		{
-			AC->SetInCombat(true);
+		FCombatEncounterHandle Handle;
+		Handle.Id = Event.EncounterId;
 
-			AC->OnActionExecuted.RemoveDynamic(this, &UCombatSubsystem::HandleActionExecuted);
-			AC->OnActionExecuted.AddDynamic(this, &UCombatSubsystem::HandleActionExecuted);
+		if (UCombatEncounter* Encounter = GetEncounter(Handle))
+		{
+			Encounter->HandleScheduledEvent(Event);
 		}
 	}
+}
 
-	TurnIndex = Participants.IndexOfByKey(FirstToAct);
-	if (TurnIndex == INDEX_NONE)
-	{
-		TurnIndex = 0;
-	}
+void UCombatSubsystem::ScheduleEncounterEvent(UCombatEncounter* Encounter, ECombatEventType Type, float DelaySeconds, int32 Slot, int32 TargetSlot)
+{
+	if (!Encounter) return;
 
-	OnCombatStateChanged.Broadcast(true);
-	OnTurnActorChanged.Broadcast(GetCurrentTurnActor());
+	Scheduler.Schedule(Encounter->GetHandle().Id, Type, GetSchedulerTime(), DelaySeconds, Slot, TargetSlot);
+}
 
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] EnterCombat: Participants=%d FirstToAct=%s TurnIndex=%d"),
-	       Participants.Num(), *GetNameSafe(FirstToAct), TurnIndex);
+void UCombatSubsystem::CancelEncounterEvent(UCombatEncounter* Encounter, ECombatEventType Type)
+{
+	if (!Encounter) return;
 
-	for (int32 i = 0; i < Participants.Num(); ++i)
-	{
-		AActor* P = Participants[i].Get();
-		UE_LOG(LogActionExec, Warning, TEXT("[Combat]  P[%d]=%s Valid=%d HasActionComp=%d"),
-		       i,
-		       *GetNameSafe(P),
-		       IsValid(P),
-		       IsValid(P) && P->FindComponentByClass<UActionComponent>() != nullptr);
-	}
+	Scheduler.Cancel(Encounter->GetHandle().Id, Type);
+}
+
+void UCombatSubsystem::CancelEncounterEvents(UCombatEncounter* Encounter)
+{
+	if (!Encounter) return;
 
+	Scheduler.CancelEncounter(Encounter->GetHandle().Id);
+}
 
-	ScheduleBeginTurnForIndex(TurnIndex, EnterCombatDelaySeconds);
+void UCombatSubsystem::DumpSchedulerTrace() const
+{
+	TArray<FString> Lines;
+	Scheduler.DumpTrace(GetSchedulerTime(), Lines);
 
-	if (UActionCueSubsystem* Cues = GetWorld()->GetSubsystem<UActionCueSubsystem>())
+	UE_LOG(LogActionExec, Display, TEXT("[Combat] Scheduler trace @ %.3fs (Encounters=%d)"), GetSchedulerTime(), Encounters.Num());
+	for (const FString& Line : Lines)
 	{
-		FActionCueContext Ctx;
-		Ctx.InstigatorActor = FirstToAct;
-		Ctx.TargetActor = nullptr;
-		Cues->PlayCue(ActionCueTags::Cue_Combat_Enter, Ctx);
+		UE_LOG(LogActionExec, Display, TEXT("[Combat] %s"), *Line);
 	}
 }
 
-void UCombatSubsystem::BeginTurnForIndex(int32 Index)
+void UCombatSubsystem::SetPlaybackSpeed(ECombatPlaybackSpeed NewSpeed)
 {
-	PruneParticipants();
-	if (!bInCombat) return;
+	if (PlaybackSpeed == NewSpeed) return;
 
-	if (Participants.Num() == 0) return;
-	if (!Participants.IsValidIndex(Index)) return;
+	PlaybackSpeed = NewSpeed;
 
-	AActor* TurnActor = Participants[Index].Get();
-	if (!IsValid(TurnActor)) return;
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Playback speed: %s"), *UEnum::GetDisplayValueAsText(NewSpeed).ToString());
+}
 
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] BeginTurn: Index=%d Actor=%s"),
-	       Index, *GetNameSafe(TurnActor));
+float UCombatSubsystem::ScaleDelay(float Seconds) const
+{
+	Seconds = FMath::Max(0.f, Seconds);
 
-	// ✅ only begin-turn work now (AP refresh etc.)
-	if (UActionComponent* AC = TurnActor->FindComponentByClass<UActionComponent>())
+	switch (PlaybackSpeed)
 	{
-		AC->OnTurnBegan();
+	case ECombatPlaybackSpeed::Double:    return Seconds * 0.5f;
+	case ECombatPlaybackSpeed::Quadruple: return Seconds * 0.25f;
+	case ECombatPlaybackSpeed::Instant:   return 0.f;
+	case ECombatPlaybackSpeed::Normal:
+	default:                              return Seconds;
 	}
+}
 
-	OnTurnActorChanged.Broadcast(TurnActor);
-
-	// Player waits
-	APawn* PawnOwner = Cast<APawn>(TurnActor);
-	const bool bIsPlayer = PawnOwner && PawnOwner->IsPlayerControlled();
-	if (bIsPlayer)
+static FAutoConsoleCommandWithWorldAndArgs GCombatPlaybackSpeedCmd(
+	TEXT("Prodigy.Combat.PlaybackSpeed"),
+	TEXT("Sets combat playback speed.\n")
+	TEXT("Usage: Prodigy.Combat.PlaybackSpeed <1|2|4|instant>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
 	{
-		UE_LOG(LogActionExec, Warning, TEXT("[Combat] Player turn: waiting for input"));
-		return;
-	}
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+		if (!Combat) return;
 
-	// ---- AI TURN ----
+		const FString Arg = Args.IsValidIndex(0) ? Args[0] : FString();
 
-	// Choose target (simple 2-participant case)
-	AActor* Target = nullptr;
-	for (const TWeakObjectPtr<AActor>& W : Participants)
-	{
-		AActor* A = W.Get();
-		if (IsValid(A) && A != TurnActor && !ProdigyAbilityUtils::IsDeadByAttributes(A))
+		if (Arg == TEXT("1"))                      Combat->SetPlaybackSpeed(ECombatPlaybackSpeed::Normal);
+		else if (Arg == TEXT("2"))                 Combat->SetPlaybackSpeed(ECombatPlaybackSpeed::Double);
+		else if (Arg == TEXT("4"))                 Combat->SetPlaybackSpeed(ECombatPlaybackSpeed::Quadruple);
+		else if (Arg.Equals(TEXT("instant"), ESearchCase::IgnoreCase)) Combat->SetPlaybackSpeed(ECombatPlaybackSpeed::Instant);
+		else
 		{
-			Target = A;
-			break;
+			UE_LOG(LogActionExec, Warning, TEXT("[Combat] Usage: Prodigy.Combat.PlaybackSpeed <1|2|4|instant> (now %s)"),
+			       *UEnum::GetDisplayValueAsText(Combat->PlaybackSpeed).ToString());
 		}
-	}
-	if (!IsValid(Target))
-	{
-		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI turn: no valid target -> passing"));
-		AdvanceTurn();
-		return;
-	}
+	}));
 
-	UActionComponent* AC = TurnActor->FindComponentByClass<UActionComponent>();
-	if (!IsValid(AC))
+static FAutoConsoleCommandWithWorld GCombatRewindTurnCmd(
+	TEXT("Prodigy.Combat.RewindTurn"),
+	TEXT("Undoes the local player's actions this turn (back to the turn-begin snapshot)."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
 	{
-		UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI turn: no ActionComponent -> passing"));
-		AdvanceTurn();
-		return;
-	}
-
-	// Build context
-	FActionContext Ctx;
-	Ctx.Instigator = TurnActor;
-	Ctx.TargetActor = Target;
-
-	// Execute after an optional AI delay (and still avoid re-entrancy)
-	if (UWorld* World = GetWorld())
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+		APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		if (!Combat || !PC) return;
+
+		Combat->RewindTurn(PC->GetPawn());
+	}));
+
+static FAutoConsoleCommandWithWorld GCombatSchedulerTraceCmd(
+	TEXT("Prodigy.Combat.Scheduler.Trace"),
+	TEXT("Logs recently fired and pending combat scheduler events (begin turn, AI act, end)."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
 	{
-		// Cancel any pending AI action from previous state
-		World->GetTimerManager().ClearTimer(TimerHandle_AITakeAction);
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		if (const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr)
+		{
+			Combat->DumpSchedulerTrace();
+		}
+	}));
 
-		const float Delay = FMath::Max(0.f, AITakeActionDelaySeconds);
+void UCombatSubsystem::AddCombatLog(ECombatLogKind Kind, int32 EncounterId, const AActor* Source, const AActor* Target, FName Tag, float Value)
+{
+	if (!bCombatLog) return;
 
-		const TWeakObjectPtr<UCombatSubsystem> SelfWeak(this);
-		const TWeakObjectPtr<UActionComponent> ACWeak(AC);
-		const TWeakObjectPtr<AActor> TurnWeak(TurnActor);
-		const TWeakObjectPtr<AActor> TargetWeak(Target);
+	CombatLog.Add(Kind, EncounterId, Source, Target, Tag, Value);
+}
 
-		// IMPORTANT: capture a *fresh* context that uses the chosen target
-		FActionContext LocalCtx = Ctx;
+static FAutoConsoleCommandWithWorldAndArgs GCombatLogDumpCmd(
+	TEXT("Prodigy.Combat.Log.Dump"),
+	TEXT("Prints the newest combat log entries.\n")
+	TEXT("Usage: Prodigy.Combat.Log.Dump [Count=30]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UGameInstance* GI = World ? World->GetGameInstance() : nullptr;
+		const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+		if (!Combat) return;
 
-		FTimerDelegate D = FTimerDelegate::CreateLambda([SelfWeak, ACWeak, TurnWeak, TargetWeak, LocalCtx]()
-		{
-			if (!SelfWeak.IsValid()) return;
+		const FCombatLog& Log = Combat->GetCombatLog();
+		const int32 Count = FMath::Clamp(Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 30, 1, FMath::Max(1, Log.Num()));
 
-			// If combat ended while waiting
-			if (!SelfWeak->IsInCombat())
-			{
-				return;
-			}
+		UE_LOG(LogActionExec, Log, TEXT("[CombatLog] %d entries, %d total, %.1f KB"),
+		       Log.Num(), static_cast<int32>(Log.GetEndSequence()), Log.GetAllocatedBytes() / 1024.f);
 
-			if (!ACWeak.IsValid() || !TurnWeak.IsValid() || !TargetWeak.IsValid())
+		for (uint64 Seq = Log.GetEndSequence() - FMath::Min<uint64>(Count, Log.Num()); Seq < Log.GetEndSequence(); ++Seq)
+		{
+			if (const FCombatLogEntry* E = Log.FindBySequence(Seq))
 			{
-				SelfWeak->AdvanceTurn();
-				return;
+				UE_LOG(LogActionExec, Log, TEXT("[CombatLog] %s"), *Log.FormatEntry(*E));
 			}
+		}
+	}));
 
-			// Still must be the current actor when we act
-			if (SelfWeak->GetCurrentTurnActor() != TurnWeak.Get())
-			{
-				return;
-			}
+// =======================
+// Encounters
+// =======================
 
-			const FGameplayTag AttackTag = FGameplayTag::RequestGameplayTag(FName("Action.Attack.Basic"));
-			const bool bOk = ACWeak->ExecuteAction(AttackTag, LocalCtx);
+FCombatEncounterHandle UCombatSubsystem::StartEncounter(const TArray<AActor*>& InParticipants, AActor* FirstToAct)
+{
+	// Build a filtered list first
+	TArray<AActor*> NewParticipants;
+	NewParticipants.Reserve(InParticipants.Num());
 
-			// If blocked (cooldown / AP / invalid), PASS TURN so combat never stalls.
-			if (!bOk)
-			{
-				UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI action failed -> passing turn (%s)"),
-				       *GetNameSafe(TurnWeak.Get()));
-				SelfWeak->AdvanceTurn();
-			}
-			// If succeeded, HandleActionExecuted will AdvanceTurn() normally.
-		});
+	for (AActor* A : InParticipants)
+	{
+		if (NewParticipants.Contains(A)) continue;
+		if (!IsValidCombatant(A)) continue;
 
-		if (Delay <= 0.f)
+		if (IsActorInCombat(A))
 		{
-			// still avoid re-entrancy (next tick)
-			World->GetTimerManager().SetTimerForNextTick(D);
+			UE_LOG(LogActionExec, Warning, TEXT("[Combat] StartEncounter: %s already in encounter %d -> skipped"),
+			       *GetNameSafe(A), FindEncounterForActor(A).Id);
+			continue;
 		}
-		else
-		{
-			World->GetTimerManager().SetTimer(TimerHandle_AITakeAction, D, Delay, false);
 
-			UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI scheduled: Actor=%s Delay=%.2f"),
-			       *GetNameSafe(TurnActor), Delay);
-		}
+		NewParticipants.Add(A);
+	}
+
+	// ✅ No combat if we don't have at least 2 combatants
+	if (NewParticipants.Num() < 2)
+	{
+		UE_LOG(LogActionExec, Warning,
+		       TEXT("[Combat] StartEncounter ABORTED: ValidParticipants=%d (need >= 2). FirstToAct=%s"),
+		       NewParticipants.Num(), *GetNameSafe(FirstToAct));
+		return FCombatEncounterHandle();
+	}
+
+	FCombatEncounterHandle Handle;
+	Handle.Id = NextEncounterId++;
+
+	// Log size is a setting: picked up once per fight, not per entry
+	if (bCombatLog)
+	{
+		CombatLog.SetMaxEntries(CombatLogMaxEntries);
+	}
+
+	UCombatEncounter* Encounter = NewObject<UCombatEncounter>(this);
+	Encounters.Add(Handle.Id, Encounter);
+
+	// Register before Start: listeners fired from Start query the actor -> encounter map
+	for (AActor* A : NewParticipants)
+	{
+		EncounterByActor.Add(A, Handle);
 	}
-	else
+
+	if (!Encounter->Start(Handle, GetWorld(), NewParticipants, FirstToAct))
 	{
-		// Fallback: immediate execute, still pass if it fails
-		const bool bOk = AC->ExecuteAction(FGameplayTag::RequestGameplayTag(FName("Action.Attack.Basic")), Ctx);
-		if (!bOk)
+		for (AActor* A : NewParticipants)
 		{
-			UE_LOG(LogActionExec, Warning, TEXT("[Combat] AI action failed (no world) -> passing turn"));
-			AdvanceTurn();
+			UnregisterEncounterActor(A, Handle);
 		}
+		Encounters.Remove(Handle.Id);
+		return FCombatEncounterHandle();
 	}
+
+	// Start may already have ended it (everyone dead on arrival)
+	return Encounter->IsActive() ? Handle : FCombatEncounterHandle();
 }
 
-AActor* UCombatSubsystem::GetCurrentTurnActor() const
+void UCombatSubsystem::EndEncounter(FCombatEncounterHandle Handle)
 {
-	return Participants.IsValidIndex(TurnIndex) ? Participants[TurnIndex].Get() : nullptr;
+	if (UCombatEncounter* Encounter = GetEncounter(Handle))
+	{
+		Encounter->End();
+	}
 }
 
-void UCombatSubsystem::AdvanceTurn()
+bool UCombatSubsystem::JoinEncounter(FCombatEncounterHandle Handle, AActor* Actor)
 {
-	if (!bInCombat) return;
+	UCombatEncounter* Encounter = GetEncounter(Handle);
+	if (!Encounter || !Encounter->IsActive()) return false;
+
+	if (IsActorInCombat(Actor)) return false;
+	if (!IsValidCombatant(Actor)) return false;
 
-	PruneParticipants();
-	if (!bInCombat) return;
-	if (Participants.Num() == 0) return;
+	EncounterByActor.Add(Actor, Handle);
 
-	// Guard: don't schedule another begin-turn if one is already queued
-	if (bTurnBeginScheduled)
+	if (!Encounter->AddCombatant(Actor))
 	{
-		UE_LOG(LogActionExec, Verbose, TEXT("[Combat] AdvanceTurn ignored (begin turn already scheduled)"));
-		return;
+		UnregisterEncounterActor(Actor, Handle);
+		return false;
 	}
 
-	AActor* CurrentActor = GetCurrentTurnActor();
+	// Walked in from outside the bubble: it and its surroundings wake up
+	if (Bubble.IsActive())
+	{
+		TArray<FVector> Centers;
+		GatherBubbleCenters(nullptr, Actor, Centers);
+		Bubble.ReleaseAround(Centers);
+	}
 
-	const int32 NextIndex = (TurnIndex + 1) % Participants.Num();
+	// Player wandered into an AI skirmish: it becomes the one the HUD follows
+	if (!PrimaryHandle.IsValid() && Encounter->ContainsPlayer())
+	{
+		PrimaryHandle = Handle;
 
-	UE_LOG(LogActionExec, Warning,
-		TEXT("[Combat] AdvanceTurn: CurrentIndex=%d Current=%s NextIndex=%d Next=%s"),
-		TurnIndex,
-		*GetNameSafe(CurrentActor),
-		NextIndex,
-		*GetNameSafe(Participants.IsValidIndex(NextIndex) ? Participants[NextIndex].Get() : nullptr));
+		OnCombatStateChanged.Broadcast(true);
+		OnTurnActorChanged.Broadcast(Encounter->GetCurrentTurnActor());
+		OnParticipantsChanged.Broadcast();
+	}
 
-	ScheduleBeginTurnForIndex(NextIndex, BetweenTurnsDelaySeconds);
+	return true;
 }
 
-void UCombatSubsystem::HandleActionExecuted(FGameplayTag ActionTag, const FActionContext& Context)
+UCombatEncounter* UCombatSubsystem::GetEncounter(FCombatEncounterHandle Handle) const
 {
-	if (!bInCombat) return;
+	const TObjectPtr<UCombatEncounter>* Found = Encounters.Find(Handle.Id);
+	return Found ? Found->Get() : nullptr;
+}
 
-	AActor* Current = GetCurrentTurnActor();
-	if (!IsValid(Current)) return;
+FCombatEncounterHandle UCombatSubsystem::FindEncounterForActor(AActor* Actor) const
+{
+	const FCombatEncounterHandle* Found = EncounterByActor.Find(Actor);
+	return Found ? *Found : FCombatEncounterHandle();
+}
 
-	if (Context.Instigator != Current)
-	{
-		UE_LOG(LogActionExec, Verbose,
-			   TEXT("[Combat] Ignoring ActionExecuted (not current turn): Inst=%s Current=%s"),
-			   *GetNameSafe(Context.Instigator), *GetNameSafe(Current));
-		return;
-	}
+UCombatEncounter* UCombatSubsystem::FindEncounterObjectForActor(AActor* Actor) const
+{
+	return GetEncounter(FindEncounterForActor(Actor));
+}
 
-	// ✅ Defer pruning by one tick so killing-blow cues can spawn before ExitCombat clears state / gates cues.
-	if (UWorld* World = GetWorld())
-	{
-		const TWeakObjectPtr<UCombatSubsystem> SelfWeak(this);
+void UCombatSubsystem::HandleEncounterStarted(UCombatEncounter* Encounter)
+{
+	if (!Encounter) return;
 
-		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([SelfWeak]()
-		{
-			if (!SelfWeak.IsValid()) return;
-			if (!SelfWeak->IsInCombat()) return;
+	const FCombatEncounterHandle Handle = Encounter->GetHandle();
+
+	if (!PrimaryHandle.IsValid() && Encounter->ContainsPlayer())
+	{
+		PrimaryHandle = Handle;
 
-			SelfWeak->PruneParticipants();
-		}));
+		OnCombatStateChanged.Broadcast(true);
+		OnTurnActorChanged.Broadcast(Encounter->GetCurrentTurnActor());
 	}
 
-	// ✅ Player can act multiple times per turn; only EndTurn should advance.
-	APawn* PawnOwner = Cast<APawn>(Current);
-	const bool bIsPlayer = PawnOwner && PawnOwner->IsPlayerControlled();
-	if (bIsPlayer)
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d started (Primary=%d Active=%d)"),
+	       Handle.Id, Handle == PrimaryHandle, Encounters.Num());
+
+	// First fight builds the bubble; later ones carve their own area out of it
+	if (bCombatBubble || Bubble.IsActive())
 	{
-		UE_LOG(LogActionExec, Verbose,
-			   TEXT("[Combat] ActionExecuted by player: staying on same turn (wait for EndTurn)"));
-		return;
+		TArray<FVector> Centers;
+		GatherBubbleCenters(Encounter, nullptr, Centers);
+
+		if (Bubble.IsActive())
+		{
+			Bubble.ReleaseAround(Centers);
+		}
+		else
+		{
+			FCombatBubbleSettings Settings;
+			Settings.Radius = CombatBubbleRadius;
+			Settings.ThrottledTickInterval = CombatBubbleTickInterval;
+			Bubble.Apply(GetWorld(), Centers, Settings);
+		}
 	}
 
-	// ✅ AI still advances automatically after a successful action
-	AdvanceTurn();
+	OnEncounterStateChanged.Broadcast(Handle, true);
 }
 
-bool UCombatSubsystem::EndCurrentTurn(AActor* Instigator)
+void UCombatSubsystem::HandleEncounterEnded(UCombatEncounter* Encounter)
 {
-	if (!bInCombat) return false;
-	if (!IsValid(Instigator)) return false;
+	if (!Encounter) return;
 
-	AActor* Current = GetCurrentTurnActor();
-	if (Current != Instigator) return false;
+	const FCombatEncounterHandle Handle = Encounter->GetHandle();
+	const bool bWasPrimary = (Handle == PrimaryHandle);
 
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] EndCurrentTurn: %s"), *GetNameSafe(Instigator));
+	// ---- IMPORTANT: update state BEFORE broadcasting ----
+	Encounters.Remove(Handle.Id);
+	if (bWasPrimary)
+	{
+		PrimaryHandle.Reset();
+	}
 
-	AdvanceTurn();
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] Encounter %d ended (WasPrimary=%d Active=%d)"),
+	       Handle.Id, bWasPrimary, Encounters.Num());
 
-	return true;
-}
+	if (Encounters.Num() == 0)
+	{
+		Bubble.RestoreAll();
+	}
 
-void UCombatSubsystem::PruneParticipants()
-{
-	const int32 Before = Participants.Num();
+	OnEncounterStateChanged.Broadcast(Handle, false);
 
-	Participants.RemoveAll([this](const TWeakObjectPtr<AActor>& W)
+	if (bWasPrimary)
 	{
-		AActor* A = W.Get();
-		return !IsValid(A) || A->IsActorBeingDestroyed() || ProdigyAbilityUtils::IsDeadByAttributes(A);
-	});
+		// Now notify listeners with correct, final state
+		OnCombatStateChanged.Broadcast(false);
+		OnTurnActorChanged.Broadcast(nullptr);
+		OnParticipantsChanged.Broadcast();
+	}
+}
 
-	if (Participants.Num() != Before)
+void UCombatSubsystem::GatherBubbleCenters(const UCombatEncounter* Encounter, const AActor* Actor, TArray<FVector>& OutCenters) const
+{
+	if (Encounter)
 	{
-		OnParticipantsChanged.Broadcast();
+		for (const TWeakObjectPtr<AActor>& P : Encounter->GetParticipants())
+		{
+			if (const AActor* A = P.Get())
+			{
+				OutCenters.Add(A->GetActorLocation());
+			}
+		}
 	}
 
-	if (Participants.Num() <= 1)
+	if (Actor)
 	{
-		ExitCombat();   // ExitCombat already broadcasts CombatStateChanged / TurnActorChanged
-		return;
+		OutCenters.Add(Actor->GetActorLocation());
 	}
 
-	TurnIndex = TurnIndex % Participants.Num();
-	if (PendingTurnIndex != INDEX_NONE)
+	if (const UWorld* World = GetWorld())
 	{
-		PendingTurnIndex = PendingTurnIndex % Participants.Num();
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PC = It->Get();
+			if (const APawn* Pawn = PC ? PC->GetPawn() : nullptr)
+			{
+				OutCenters.Add(Pawn->GetActorLocation());
+			}
+		}
 	}
 }
 
-void UCombatSubsystem::CancelScheduledBeginTurn()
+void UCombatSubsystem::HandleEncounterTurnActorChanged(UCombatEncounter* Encounter, AActor* TurnActor)
 {
-	if (UWorld* World = GetWorld())
+	if (!Encounter) return;
+
+	OnEncounterTurnActorChanged.Broadcast(Encounter->GetHandle(), TurnActor);
+
+	if (Encounter->GetHandle() == PrimaryHandle)
 	{
-		World->GetTimerManager().ClearTimer(TimerHandle_BeginTurn);
+		OnTurnActorChanged.Broadcast(TurnActor);
 	}
-	bTurnBeginScheduled = false;
-	PendingTurnIndex = INDEX_NONE;
 }
 
-void UCombatSubsystem::ScheduleBeginTurnForIndex(int32 Index, float DelaySeconds)
+void UCombatSubsystem::HandleEncounterParticipantsChanged(UCombatEncounter* Encounter)
 {
-	if (!bInCombat) return;
+	if (Encounter && Encounter->GetHandle() == PrimaryHandle)
+	{
+		OnParticipantsChanged.Broadcast();
+	}
+}
 
-	PruneParticipants();
-	if (!bInCombat) return; // Prune may ExitCombat
-	if (Participants.Num() == 0) return;
+void UCombatSubsystem::UnregisterEncounterActor(const TWeakObjectPtr<AActor>& Actor, FCombatEncounterHandle Handle)
+{
+	// Only drop the mapping if it still points at this encounter
+	const FCombatEncounterHandle* Found = EncounterByActor.Find(Actor);
+	if (Found && *Found == Handle)
+	{
+		EncounterByActor.Remove(Actor);
+	}
+}
 
-	Index = Index % Participants.Num();
+// =======================
+// Legacy single-fight API
+// =======================
 
-	CancelScheduledBeginTurn();
+void UCombatSubsystem::EnterCombat(const TArray<AActor*>& InParticipants, AActor* FirstToAct)
+{
+	StartEncounter(InParticipants, FirstToAct);
+}
 
-	PendingTurnIndex = Index;
-	bTurnBeginScheduled = true;
+void UCombatSubsystem::ExitCombat()
+{
+	UE_LOG(LogActionExec, Warning, TEXT("[Combat] ExitCombat (primary encounter %d)"), PrimaryHandle.Id);
 
-	UWorld* World = GetWorld();
-	if (!World) return;
+	EndEncounter(PrimaryHandle);
+}
 
-	const float Delay = FMath::Max(0.f, DelaySeconds);
+AActor* UCombatSubsystem::GetCurrentTurnActor() const
+{
+	const UCombatEncounter* Encounter = GetPrimaryEncounterObject();
+	return Encounter ? Encounter->GetCurrentTurnActor() : nullptr;
+}
 
-	if (Delay <= 0.f)
+void UCombatSubsystem::AdvanceTurn()
+{
+	if (UCombatEncounter* Encounter = GetPrimaryEncounterObject())
 	{
-		HandleScheduledBeginTurn();
-		return;
+		Encounter->AdvanceTurn();
 	}
+}
+
+bool UCombatSubsystem::EndCurrentTurn(AActor* Instigator)
+{
+	UCombatEncounter* Encounter = FindEncounterObjectForActor(Instigator);
+	return Encounter ? Encounter->EndCurrentTurn(Instigator) : false;
+}
+
+bool UCombatSubsystem::DelayTurn(AActor* Actor, float TurnTime)
+{
+	UCombatEncounter* Encounter = FindEncounterObjectForActor(Actor);
+	return Encounter ? Encounter->DelayTurn(Actor, TurnTime) : false;
+}
 
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] ScheduleBeginTurn: Index=%d Delay=%.2f"), Index, Delay);
+bool UCombatSubsystem::RewindTurn(AActor* Actor)
+{
+	UCombatEncounter* Encounter = FindEncounterObjectForActor(Actor);
+	if (!Encounter || Encounter->GetCurrentTurnActor() != Actor) return false;
 
-	World->GetTimerManager().SetTimer(
-		TimerHandle_BeginTurn,
-		this,
-		&UCombatSubsystem::HandleScheduledBeginTurn,
-		Delay,
-		false
-	);
+	return Encounter->RewindTurn();
 }
 
-void UCombatSubsystem::HandleScheduledBeginTurn()
+const TArray<TWeakObjectPtr<AActor>>& UCombatSubsystem::GetParticipants() const
 {
-	UE_LOG(LogActionExec, Warning, TEXT("[Combat] HandleScheduledBeginTurn: Pending=%d"), PendingTurnIndex);
+	static const TArray<TWeakObjectPtr<AActor>> Empty;
 
-	bTurnBeginScheduled = false;
+	const UCombatEncounter* Encounter = GetPrimaryEncounterObject();
+	return Encounter ? Encounter->GetParticipants() : Empty;
+}
 
-	if (!bInCombat) return;
+bool UCombatSubsystem::BuildCoreState(FCombatCoreState& OutState) const
+{
+	const UCombatEncounter* Encounter = GetPrimaryEncounterObject();
+	return Encounter ? Encounter->BuildCoreState(OutState) : false;
+}
 
-	PruneParticipants();
-	if (!bInCombat) return;
-	if (Participants.Num() == 0) return;
+TArray<FCombatTimelineEntry> UCombatSubsystem::GetTurnTimeline(int32 NumTurns)
+{
+	UCombatEncounter* Encounter = GetPrimaryEncounterObject();
+	return Encounter ? Encounter->GetTurnTimeline(NumTurns) : TArray<FCombatTimelineEntry>();
+}
 
-	if (PendingTurnIndex == INDEX_NONE)
-	{
-		// Fallback – keep current
-		PendingTurnIndex = TurnIndex % Participants.Num();
-	}
-	else
+bool UCombatSubsystem::GetLatestReplay(FCombatReplayLog& OutLog) const
+{
+	const UCombatEncounter* Encounter = GetPrimaryEncounterObject();
+	if (Encounter && Encounter->GetReplayRecorder().IsRecording())
 	{
-		PendingTurnIndex = PendingTurnIndex % Participants.Num();
+		Encounter->GetReplayRecorder().BuildLog(OutLog);
+		return true;
 	}
 
-	TurnIndex = PendingTurnIndex;
-	PendingTurnIndex = INDEX_NONE;
+	if (LastEndedReplay.Snapshot.Num() == 0) return false;
 
-	BeginTurnForIndex(TurnIndex);
+	OutLog = LastEndedReplay;
+	return true;
 }
@@ -0,0 +1,250 @@
+﻿#include "AbilitySystem/CombatTimeline.h"
+
+#include "AbilitySystem/ActionAgentInterface.h"
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatTurnQueue.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/StatusComponent.h"
+
+void FCombatTimeline::Reset()
+{
+	Projections.Reset();
+	DirtySlots.Reset();
+	bOrderDirty = true;
+	BuiltNumTurns = 0;
+	Entries.Reset();
+}
+
+void FCombatTimeline::MarkSlotDirty(int32 Slot)
+{
+	if (Slot < 0) return;
+
+	if (Slot >= DirtySlots.Num())
+	{
+		DirtySlots.Add(true, Slot + 1 - DirtySlots.Num());
+	}
+	DirtySlots[Slot] = true;
+
+	// A slot's own projection also shifts every later turn in the merge
+	bOrderDirty = true;
+}
+
+bool FCombatTimeline::IsUpToDate(int32 NumTurns) const
+{
+	return !bOrderDirty && BuiltNumTurns == NumTurns;
+}
+
+bool FCombatTimeline::NeedsProjection(int32 Slot, int32 Depth) const
+{
+	if (!Projections.IsValidIndex(Slot)) return true;
+	if (DirtySlots.IsValidIndex(Slot) && DirtySlots[Slot]) return true;
+
+	return Projections[Slot].Turns.Num() < Depth;
+}
+
+void FCombatTimeline::SetProjection(int32 Slot, FCombatTimelineProjection&& Projection)
+{
+	if (Slot < 0) return;
+
+	if (Slot >= Projections.Num())
+	{
+		Projections.SetNum(Slot + 1);
+	}
+	Projections[Slot] = MoveTemp(Projection);
+
+	if (DirtySlots.IsValidIndex(Slot))
+	{
+		DirtySlots[Slot] = false;
+	}
+	bOrderDirty = true;
+}
+
+void FCombatTimeline::Build(int32 NumTurns, int32 CurrentSlot, double TurnClock, const FCombatTurnQueue& Queue, TFunctionRef<AActor*(int32)> GetActor)
+{
+	struct FCandidate
+	{
+		double Time = 0.0;
+
+		// Queue rank for first turns, then "after everything queued now" in acting order,
+		// matching the Sequence each re-insert gets live
+		int32 Tie = 0;
+
+		int32 Slot = INDEX_NONE;
+		int32 TurnIndex = 0;
+
+		bool operator<(const FCandidate& Other) const
+		{
+			return (Time < Other.Time) || (Time == Other.Time && Tie < Other.Tie);
+		}
+	};
+
+	Entries.Reset(NumTurns);
+
+	TArray<FCombatTurnQueueEntry> Ordered;
+	Queue.GetOrderedEntries(Queue.Num(), Ordered);
+
+	TArray<FCandidate> Heap;
+	Heap.Reserve(Ordered.Num() + 1);
+
+	for (int32 Rank = 0; Rank < Ordered.Num(); ++Rank)
+	{
+		const int32 Slot = Ordered[Rank].Id;
+		if (!Projections.IsValidIndex(Slot) || Projections[Slot].Turns.Num() == 0 || !GetActor(Slot)) continue;
+
+		Heap.HeapPush({ Ordered[Rank].ReadyTime, Rank, Slot, 0 });
+	}
+
+	// Turn in progress: shown first, then re-queued one delay later (after everyone queued now)
+	AActor* CurrentActor = CurrentSlot != INDEX_NONE ? GetActor(CurrentSlot) : nullptr;
+	if (CurrentActor && Projections.IsValidIndex(CurrentSlot) && NumTurns > 0)
+	{
+		const FCombatTimelineProjection& P = Projections[CurrentSlot];
+
+		FCombatTimelineEntry& E = Entries.AddDefaulted_GetRef();
+		E.Actor = CurrentActor;
+		E.TurnsFromNow = 0;
+		E.ReadyTime = static_cast<float>(TurnClock);
+		E.ExpectedAP = P.CurrentAP;
+
+		if (!Queue.Contains(CurrentSlot) && P.Turns.Num() > 0)
+		{
+			Heap.HeapPush({ TurnClock + P.DelayAfterCurrent, Ordered.Num(), CurrentSlot, 0 });
+		}
+	}
+
+	int32 NextTie = Ordered.Num() + 1;
+
+	while (Entries.Num() < NumTurns && Heap.Num() > 0)
+	{
+		FCandidate C;
+		Heap.HeapPop(C, EAllowShrinking::No);
+
+		const FCombatTimelineProjection::FTurn& T = Projections[C.Slot].Turns[C.TurnIndex];
+
+		FCombatTimelineEntry& E = Entries.AddDefaulted_GetRef();
+		E.Actor = GetActor(C.Slot);
+		E.TurnsFromNow = Entries.Num() - 1;
+		E.ReadyTime = static_cast<float>(C.Time);
+		E.ExpectedAP = T.ExpectedAP;
+		E.ExpiringStatuses = T.ExpiringStatuses;
+		E.ExpiringTurnEffects = T.ExpiringTurnEffects;
+		E.ActionsReady = T.ActionsReady;
+
+		if (C.TurnIndex + 1 < Projections[C.Slot].Turns.Num())
+		{
+			Heap.HeapPush({ C.Time + T.DelayAfter, NextTie++, C.Slot, C.TurnIndex + 1 });
+		}
+	}
+
+	BuiltNumTurns = NumTurns;
+	bOrderDirty = false;
+	++Version;
+}
+
+void ProdigyCombatTimeline::ProjectActor(AActor* Actor, int32 Depth, FCombatTimelineProjection& Out)
+{
+	Out = FCombatTimelineProjection();
+	if (!IsValid(Actor) || Depth <= 0) return;
+
+	const bool bAgent = Actor->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass());
+
+	const auto GetFinal = [Actor, bAgent](const FGameplayTag& Tag, float Default)
+	{
+		return bAgent && IActionAgentInterface::Execute_HasAttribute(Actor, Tag)
+			? IActionAgentInterface::Execute_GetAttributeFinalValue(Actor, Tag)
+			: Default;
+	};
+
+	const float MaxAP = GetFinal(ProdigyTags::Attr::MaxAP, 0.f);
+	const float Speed = GetFinal(ProdigyTags::Attr::Speed, ProdigyCombatCore::DefaultSpeed);
+
+	Out.CurrentAP = bAgent && IActionAgentInterface::Execute_HasAttribute(Actor, ProdigyTags::Attr::AP)
+		? IActionAgentInterface::Execute_GetAttributeCurrentValue(Actor, ProdigyTags::Attr::AP)
+		: 0.f;
+
+	FGameplayTagContainer Owned;
+	if (bAgent)
+	{
+		IActionAgentInterface::Execute_GetOwnedGameplayTags(Actor, Owned);
+	}
+
+	// Turn at which a haste / slow status runs out (MAX_int32 = not turn-limited)
+	const auto ExpiryTurn = [](const UStatusComponent* Status, const FGameplayTag& Tag)
+	{
+		if (Status)
+		{
+			for (const FStatusEntry& S : Status->Statuses)
+			{
+				if (S.Tag == Tag && S.TurnsRemaining > 0 && S.SecondsRemaining <= 0.f)
+				{
+					return S.TurnsRemaining;
+				}
+			}
+		}
+		return MAX_int32;
+	};
+
+	const UStatusComponent* Status = Actor->FindComponentByClass<UStatusComponent>();
+	const UActionComponent* AC = Actor->FindComponentByClass<UActionComponent>();
+	const UAttributesComponent* Attr = Actor->FindComponentByClass<UAttributesComponent>();
+
+	const int32 HasteEnds = Owned.HasTagExact(ProdigyTags::Status::Hasted) ? ExpiryTurn(Status, ProdigyTags::Status::Hasted) : 0;
+	const int32 SlowEnds = Owned.HasTagExact(ProdigyTags::Status::Slowed) ? ExpiryTurn(Status, ProdigyTags::Status::Slowed) : 0;
+
+	Out.DelayAfterCurrent = ProdigyCombatCore::ComputeTurnDelay(Speed, HasteEnds > 0, SlowEnds > 0);
+
+	Out.Turns.SetNum(Depth);
+
+	for (int32 Turn = 1; Turn <= Depth; ++Turn)
+	{
+		FCombatTimelineProjection::FTurn& T = Out.Turns[Turn - 1];
+
+		// Same order as UActionComponent::OnTurnBegan: AP refresh, cooldowns, turn effects, statuses
+		float AP = MaxAP;
+
+		if (AC)
+		{
+			const TConstArrayView<int32> CooldownTurns = AC->GetCooldownTurnsBySlot();
+			for (int32 Slot = 0; Slot < CooldownTurns.Num(); ++Slot)
+			{
+				if (CooldownTurns[Slot] == Turn)
+				{
+					T.ActionsReady.Add(AC->GetActionTagForSlot(Slot));
+				}
+			}
+		}
+
+		if (Attr)
+		{
+			for (const FPeriodicTurnEffect& E : Attr->GetTurnEffects())
+			{
+				if (!E.EffectTag.IsValid() || FMath::IsNearlyZero(E.DeltaPerTurn) || E.TurnsRemaining < Turn) continue;
+
+				if (E.AttributeTag == ProdigyTags::Attr::AP)
+				{
+					AP += E.DeltaPerTurn;
+				}
+				if (E.TurnsRemaining == Turn)
+				{
+					T.ExpiringTurnEffects.Add(E.EffectTag);
+				}
+			}
+		}
+
+		if (Status)
+		{
+			for (const FStatusEntry& S : Status->Statuses)
+			{
+				if (S.TurnsRemaining == Turn && S.SecondsRemaining <= 0.f)
+				{
+					T.ExpiringStatuses.Add(S.Tag);
+				}
+			}
+		}
+
+		T.ExpectedAP = FMath::Clamp(AP, 0.f, MaxAP);
+		T.DelayAfter = ProdigyCombatCore::ComputeTurnDelay(Speed, HasteEnds > Turn, SlowEnds > Turn);
+	}
+}
@@ -0,0 +1,188 @@
+﻿#include "AbilitySystem/CombatTurnQueue.h"
+
+void FCombatTurnQueue::Reset()
+{
+	Heap.Reset();
+	HeapIndexById.Reset();
+	NextSequence = 0;
+}
+
+void FCombatTurnQueue::Insert(int32 Id, double ReadyTime)
+{
+	if (Id < 0) return;
+
+	const int32 Existing = GetHeapIndex(Id);
+	if (Existing != INDEX_NONE)
+	{
+		FCombatTurnQueueEntry& E = Heap[Existing];
+		const bool bEarlier = ReadyTime < E.ReadyTime;
+
+		E.ReadyTime = ReadyTime;
+		E.Sequence = NextSequence++;
+
+		// A later (or equal) time with a newer sequence can only move down
+		if (bEarlier)
+		{
+			SiftUp(Existing);
+		}
+		else
+		{
+			SiftDown(Existing);
+		}
+		return;
+	}
+
+	if (Id >= HeapIndexById.Num())
+	{
+		const int32 OldNum = HeapIndexById.Num();
+		HeapIndexById.SetNumUninitialized(Id + 1);
+		for (int32 i = OldNum; i < HeapIndexById.Num(); ++i)
+		{
+			HeapIndexById[i] = INDEX_NONE;
+		}
+	}
+
+	FCombatTurnQueueEntry NewE;
+	NewE.Id = Id;
+	NewE.ReadyTime = ReadyTime;
+	NewE.Sequence = NextSequence++;
+
+	const int32 HeapIndex = Heap.Add(NewE);
+	HeapIndexById[Id] = HeapIndex;
+	SiftUp(HeapIndex);
+}
+
+bool FCombatTurnQueue::Remove(int32 Id)
+{
+	const int32 HeapIndex = GetHeapIndex(Id);
+	if (HeapIndex == INDEX_NONE) return false;
+
+	RemoveAtHeapIndex(HeapIndex);
+	return true;
+}
+
+bool FCombatTurnQueue::Delay(int32 Id, double DeltaTime)
+{
+	const int32 HeapIndex = GetHeapIndex(Id);
+	if (HeapIndex == INDEX_NONE) return false;
+
+	Insert(Id, Heap[HeapIndex].ReadyTime + DeltaTime);
+	return true;
+}
+
+bool FCombatTurnQueue::Contains(int32 Id) const
+{
+	return GetHeapIndex(Id) != INDEX_NONE;
+}
+
+int32 FCombatTurnQueue::Peek() const
+{
+	return Heap.Num() > 0 ? Heap[0].Id : INDEX_NONE;
+}
+
+int32 FCombatTurnQueue::Pop(double* OutReadyTime)
+{
+	if (Heap.Num() == 0) return INDEX_NONE;
+
+	const FCombatTurnQueueEntry Top = Heap[0];
+	RemoveAtHeapIndex(0);
+
+	if (OutReadyTime)
+	{
+		*OutReadyTime = Top.ReadyTime;
+	}
+	return Top.Id;
+}
+
+double FCombatTurnQueue::GetReadyTime(int32 Id) const
+{
+	const int32 HeapIndex = GetHeapIndex(Id);
+	return HeapIndex != INDEX_NONE ? Heap[HeapIndex].ReadyTime : 0.0;
+}
+
+void FCombatTurnQueue::GetOrderedEntries(int32 MaxCount, TArray<FCombatTurnQueueEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+	if (MaxCount <= 0 || Heap.Num() == 0) return;
+
+	// Walk the heap with a frontier of candidate heap indices, itself a min-heap (at most k + 1 entries),
+	// instead of copying the whole queue
+	TArray<int32, TInlineAllocator<32>> Frontier;
+	Frontier.Add(0);
+
+	const auto FrontierLess = [this](int32 A, int32 B) { return Less(Heap[A], Heap[B]); };
+
+	OutEntries.Reserve(FMath::Min(MaxCount, Heap.Num()));
+	while (Frontier.Num() > 0 && OutEntries.Num() < MaxCount)
+	{
+		int32 HeapIndex = INDEX_NONE;
+		Frontier.HeapPop(HeapIndex, FrontierLess, EAllowShrinking::No);
+
+		OutEntries.Add(Heap[HeapIndex]);
+
+		const int32 Left = 2 * HeapIndex + 1;
+		const int32 Right = Left + 1;
+		if (Left < Heap.Num()) Frontier.HeapPush(Left, FrontierLess);
+		if (Right < Heap.Num()) Frontier.HeapPush(Right, FrontierLess);
+	}
+}
+
+void FCombatTurnQueue::SwapEntries(int32 A, int32 B)
+{
+	Heap.Swap(A, B);
+	HeapIndexById[Heap[A].Id] = A;
+	HeapIndexById[Heap[B].Id] = B;
+}
+
+void FCombatTurnQueue::SiftUp(int32 HeapIndex)
+{
+	while (HeapIndex > 0)
+	{
+		const int32 Parent = (HeapIndex - 1) / 2;
+		if (!Less(Heap[HeapIndex], Heap[Parent])) break;
+
+		SwapEntries(HeapIndex, Parent);
+		HeapIndex = Parent;
+	}
+}
+
+void FCombatTurnQueue::SiftDown(int32 HeapIndex)
+{
+	const int32 Num = Heap.Num();
+
+	for (;;)
+	{
+		const int32 Left = 2 * HeapIndex + 1;
+		const int32 Right = Left + 1;
+		int32 Smallest = HeapIndex;
+
+		if (Left < Num && Less(Heap[Left], Heap[Smallest])) Smallest = Left;
+		if (Right < Num && Less(Heap[Right], Heap[Smallest])) Smallest = Right;
+
+		if (Smallest == HeapIndex) break;
+
+		SwapEntries(HeapIndex, Smallest);
+		HeapIndex = Smallest;
+	}
+}
+
+void FCombatTurnQueue::RemoveAtHeapIndex(int32 HeapIndex)
+{
+	const int32 RemovedId = Heap[HeapIndex].Id;
+	const int32 LastIndex = Heap.Num() - 1;
+
+	if (HeapIndex != LastIndex)
+	{
+		SwapEntries(HeapIndex, LastIndex);
+	}
+
+	Heap.Pop(EAllowShrinking::No);
+	HeapIndexById[RemovedId] = INDEX_NONE;
+
+	if (HeapIndex < Heap.Num())
+	{
+		// The moved-in entry may need to go either way
+		SiftUp(HeapIndex);
+		SiftDown(HeapIndex);
+	}
+}
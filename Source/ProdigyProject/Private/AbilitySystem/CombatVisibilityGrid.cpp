@@ -0,0 +1,236 @@
+﻿#include "AbilitySystem/CombatVisibilityGrid.h"
+
+#include "AbilitySystem/ActionComponent.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+
+// ---- Grid ----
+
+int32 FCombatVisibilityGrid::ToCell(const FVector& Location) const
+{
+	if (SizeX <= 0 || SizeY <= 0) return INDEX_NONE;
+
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+	if (X < 0 || Y < 0 || X >= SizeX || Y >= SizeY) return INDEX_NONE;
+
+	return Y * SizeX + X;
+}
+
+FVector FCombatVisibilityGrid::GetEyeLocation(int32 Cell) const
+{
+	const int32 X = Cell % SizeX;
+	const int32 Y = Cell / SizeX;
+	return FVector(Origin.X + (X + 0.5f) * CellSize, Origin.Y + (Y + 0.5f) * CellSize, FloorZ[Cell] + EyeHeight);
+}
+
+ECombatLineOfSight FCombatVisibilityGrid::Query(const FVector& From, const FVector& To) const
+{
+	const int32 A = ToCell(From);
+	const int32 B = ToCell(To);
+	if (A == INDEX_NONE || B == INDEX_NONE || !HasFloor[A] || !HasFloor[B]) return ECombatLineOfSight::Unknown;
+	if (A == B) return ECombatLineOfSight::Visible;
+
+	const int32 Bit = A * NumCells() + B;
+	if (!Traced[Bit]) return ECombatLineOfSight::Unknown;
+
+	return Visible[Bit] ? ECombatLineOfSight::Visible : ECombatLineOfSight::Blocked;
+}
+
+// ---- Builder ----
+
+namespace
+{
+	FCollisionObjectQueryParams GetSightBlockers()
+	{
+		return FCollisionObjectQueryParams(ECC_WorldStatic);
+	}
+
+	FCollisionQueryParams GetSightParams()
+	{
+		return FCollisionQueryParams(SCENE_QUERY_STAT(CombatVisibility), false);
+	}
+}
+
+void FCombatVisibilityGridBuilder::Start(UWorld* InWorld, const FBox& Area, const FCombatVisibilitySettings& InSettings, FOnBuilt InOnBuilt)
+{
+	if (!InWorld || !Area.IsValid) return;
+
+	World = InWorld;
+	Settings = InSettings;
+	OnBuilt = MoveTemp(InOnBuilt);
+	StartTime = FPlatformTime::Seconds();
+
+	const FBox Box = Area.ExpandBy(FVector(Settings.Margin, Settings.Margin, 0.f));
+	const FVector Size = Box.GetSize();
+
+	// Coarser cells for big fights instead of more of them (pairs grow with the square)
+	float Cell = FMath::Max(50.f, Settings.CellSize);
+	while (FMath::CeilToInt32(Size.X / Cell) * FMath::CeilToInt32(Size.Y / Cell) > FMath::Max(1, Settings.MaxCells))
+	{
+		Cell *= 1.25f;
+	}
+
+	Grid = MakeShared<FCombatVisibilityGrid, ESPMode::ThreadSafe>();
+	Grid->Origin = FVector2D(Box.Min);
+	Grid->CellSize = Cell;
+	Grid->SizeX = FMath::Max(1, FMath::CeilToInt32(Size.X / Cell));
+	Grid->SizeY = FMath::Max(1, FMath::CeilToInt32(Size.Y / Cell));
+	Grid->EyeHeight = Settings.EyeHeight;
+
+	const int32 N = Grid->NumCells();
+	Grid->FloorZ.Init(Area.Min.Z, N);
+	Grid->HasFloor.Init(false, N);
+	Grid->Traced.Init(false, N * N);
+	Grid->Visible.Init(false, N * N);
+
+	// Combatant locations are capsule centers: floors are somewhere below them
+	TopZ = Area.Max.Z + 500.f;
+	BottomZ = Area.Min.Z - 1000.f;
+
+	Pairs.Reset();
+	NextFloorCell = 0;
+	NextPair = 0;
+	InFlight = 0;
+	bFloorPhase = true;
+	bBuilding = true;
+
+	IssueNextBatch();
+}
+
+void FCombatVisibilityGridBuilder::IssueNextBatch()
+{
+	UWorld* W = World.Get();
+	if (!W)
+	{
+		bBuilding = false;
+		return;
+	}
+
+	const int32 Batch = FMath::Max(1, Settings.TracesPerBatch);
+	const FCollisionObjectQueryParams Blockers = GetSightBlockers();
+	const FCollisionQueryParams Params = GetSightParams();
+
+	if (bFloorPhase)
+	{
+		const FTraceDelegate Delegate = FTraceDelegate::CreateSP(this, &FCombatVisibilityGridBuilder::HandleFloorTrace);
+		const int32 N = Grid->NumCells();
+
+		for (; NextFloorCell < N && InFlight < Batch; ++NextFloorCell)
+		{
+			const FVector Center = Grid->GetEyeLocation(NextFloorCell);
+
+			++InFlight;
+			W->AsyncLineTraceByObjectType(EAsyncTraceType::Single, FVector(Center.X, Center.Y, TopZ), FVector(Center.X, Center.Y, BottomZ),
+			                              Blockers, Params, &Delegate, static_cast<uint32>(NextFloorCell));
+		}
+
+		if (InFlight > 0) return;
+
+		bFloorPhase = false;
+		BuildPairList();
+	}
+
+	const FTraceDelegate Delegate = FTraceDelegate::CreateSP(this, &FCombatVisibilityGridBuilder::HandleSightTrace);
+	const uint32 N = static_cast<uint32>(Grid->NumCells());
+
+	for (; NextPair < Pairs.Num() && InFlight < Batch; ++NextPair)
+	{
+		const uint32 Packed = Pairs[NextPair];
+
+		++InFlight;
+		W->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Grid->GetEyeLocation(Packed / N), Grid->GetEyeLocation(Packed % N),
+		                              Blockers, Params, &Delegate, Packed);
+	}
+
+	if (InFlight == 0)
+	{
+		Finish();
+	}
+}
+
+void FCombatVisibilityGridBuilder::BuildPairList()
+{
+	const int32 N = Grid->NumCells();
+	const float MaxDistSq = FMath::Square(Settings.MaxPairDistance);
+
+	for (int32 A = 0; A < N; ++A)
+	{
+		if (!Grid->HasFloor[A]) continue;
+		const FVector EyeA = Grid->GetEyeLocation(A);
+
+		for (int32 B = A + 1; B < N; ++B)
+		{
+			if (!Grid->HasFloor[B]) continue;
+			if (FVector::DistSquared2D(EyeA, Grid->GetEyeLocation(B)) > MaxDistSq) continue;
+
+			Pairs.Add(static_cast<uint32>(A * N + B));
+		}
+	}
+}
+
+void FCombatVisibilityGridBuilder::HandleFloorTrace(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	const int32 Cell = static_cast<int32>(Datum.UserData);
+
+	if (Grid->FloorZ.IsValidIndex(Cell) && Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+	{
+		Grid->FloorZ[Cell] = Datum.OutHits[0].ImpactPoint.Z;
+		Grid->HasFloor[Cell] = true;
+	}
+
+	if (--InFlight == 0)
+	{
+		IssueNextBatch();
+	}
+}
+
+void FCombatVisibilityGridBuilder::HandleSightTrace(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	const int32 N = Grid->NumCells();
+	const int32 A = static_cast<int32>(Datum.UserData) / N;
+	const int32 B = static_cast<int32>(Datum.UserData) % N;
+	const bool bClear = Datum.OutHits.Num() == 0 || !Datum.OutHits[0].bBlockingHit;
+
+	Grid->Traced[A * N + B] = true;
+	Grid->Traced[B * N + A] = true;
+	Grid->Visible[A * N + B] = bClear;
+	Grid->Visible[B * N + A] = bClear;
+
+	if (--InFlight == 0)
+	{
+		IssueNextBatch();
+	}
+}
+
+void FCombatVisibilityGridBuilder::Finish()
+{
+	bBuilding = false;
+
+	UE_LOG(LogActionExec, Log, TEXT("[Combat] Visibility grid: %dx%d cells of %.0f, %d sight pairs (%.1f ms)"),
+	       Grid->SizeX, Grid->SizeY, Grid->CellSize, Pairs.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	Pairs.Empty();
+
+	// Read-only from here on
+	TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe> Built = MoveTemp(Grid);
+	OnBuilt.ExecuteIfBound(Built);
+}
+
+// ---- Queries ----
+
+bool ProdigyCombatVisibility::HasLineOfSight(const UWorld* World, const FCombatVisibilityGrid* Grid, const FVector& From, const FVector& To)
+{
+	if (Grid)
+	{
+		const ECombatLineOfSight Cached = Grid->Query(From, To);
+		if (Cached != ECombatLineOfSight::Unknown)
+		{
+			return Cached == ECombatLineOfSight::Visible;
+		}
+	}
+
+	if (!World) return true;
+
+	return !World->LineTraceTestByObjectType(From, To, GetSightBlockers(), GetSightParams());
+}
@@ -0,0 +1,67 @@
+﻿#include "AbilitySystem/CombatantTable.h"
+
+#include "AbilitySystem/ActionAgentInterface.h"
+#include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatMovementComponent.h"
+#include "AbilitySystem/ProdigyAbilityUtils.h"
+#include "AbilitySystem/ProdigyGameplayTags.h"
+#include "AbilitySystem/StatusComponent.h"
+#include "GameFramework/Pawn.h"
+
+void FCombatantTable::Reset()
+{
+	Actors.Reset();
+	Teams.Reset();
+	ParticipantIndices.Reset();
+	ActionComponents.Reset();
+	AttributeComponents.Reset();
+	StatusComponents.Reset();
+	MovementComponents.Reset();
+	Alive.Reset();
+	Players.Reset();
+	Agents.Reset();
+}
+
+int32 FCombatantTable::Add(AActor* Actor, int32 ParticipantIndex)
+{
+	const int32 Slot = Actors.Add(Actor);
+
+	Teams.Add(ProdigyCombatCore::ResolveTeamForActor(Actor));
+	ParticipantIndices.Add(ParticipantIndex);
+
+	ActionComponents.Add(Actor ? Actor->FindComponentByClass<UActionComponent>() : nullptr);
+	AttributeComponents.Add(Actor ? Actor->FindComponentByClass<UAttributesComponent>() : nullptr);
+	StatusComponents.Add(Actor ? Actor->FindComponentByClass<UStatusComponent>() : nullptr);
+	MovementComponents.Add(Actor ? Actor->FindComponentByClass<UCombatMovementComponent>() : nullptr);
+
+	const APawn* Pawn = Cast<APawn>(Actor);
+	Players.Add(Pawn && Pawn->IsPlayerControlled());
+	Agents.Add(Actor && Actor->GetClass()->ImplementsInterface(UActionAgentInterface::StaticClass()));
+
+	Alive.Add(false);
+	RefreshAlive(Slot);
+
+	return Slot;
+}
+
+bool FCombatantTable::RefreshAlive(int32 Slot)
+{
+	if (!IsValidIndex(Slot)) return false;
+
+	AActor* A = Actors[Slot].Get();
+
+	// Same rule as ProdigyAbilityUtils::IsDeadByAttributes, without the interface hop when we can
+	bool bAlive = IsValid(A);
+	if (bAlive && Agents[Slot])
+	{
+		const UAttributesComponent* Attr = AttributeComponents[Slot].Get();
+		bAlive = Attr
+			? !Attr->IsDead() && Attr->GetCurrentValue(ProdigyTags::Attr::Health) > 0.f
+			: !ProdigyAbilityUtils::IsDeadByAttributes(A);
+	}
+
+	Alive[Slot] = bAlive;
+	return bAlive;
+}
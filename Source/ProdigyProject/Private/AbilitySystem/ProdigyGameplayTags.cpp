@@ -43,6 +43,9 @@ namespace ProdigyTags::Status
 	UE_DEFINE_GAMEPLAY_TAG(Stealthed, "Status.Stealthed");
 	UE_DEFINE_GAMEPLAY_TAG(Surprised, "Status.Surprised");
 	UE_DEFINE_GAMEPLAY_TAG(Bleeding,  "Status.Bleeding");
+
+	UE_DEFINE_GAMEPLAY_TAG(Hasted,    "Status.Hasted");
+	UE_DEFINE_GAMEPLAY_TAG(Slowed,    "Status.Slowed");
 }
 
 // =======================
@@ -71,6 +74,8 @@ namespace ProdigyTags::Attr
 
 	UE_DEFINE_GAMEPLAY_TAG(AP,     "Attr.AP");
 	UE_DEFINE_GAMEPLAY_TAG(MaxAP,  "Attr.MaxAP");
+
+	UE_DEFINE_GAMEPLAY_TAG(Speed,  "Attr.Speed");
 }
 
 
@@ -2,12 +2,13 @@
 #include "Character/CombatantCharacterBase.h"
 
 #include "AbilitySystem/ActionComponent.h"
+#include "AbilitySystem/CombatAggroSubsystem.h"
+#include "AbilitySystem/CombatMovementComponent.h"
 #include "AbilitySystem/StatusComponent.h"
 
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AIController.h"
 #include "BrainComponent.h"
-#include "AbilitySystem/ProdigyGameplayTags.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/HealthBarWidgetComponent.h"
 
@@ -16,6 +17,7 @@ ACombatantCharacterBase::ACombatantCharacterBase()
 	Status       = CreateDefaultSubobject<UStatusComponent>(TEXT("Status"));
 	ActionComponent = CreateDefaultSubobject<UActionComponent>(TEXT("ActionComponent"));
 	Attributes = CreateDefaultSubobject<UAttributesComponent>(TEXT("Attributes"));
+	CombatMovement = CreateDefaultSubobject<UCombatMovementComponent>(TEXT("CombatMovement"));
 }
 
 void ACombatantCharacterBase::BeginPlay()
@@ -31,11 +33,26 @@ void ACombatantCharacterBase::BeginPlay()
 
 	if (IsValid(Attributes))
 	{
-		Attributes->OnAttributeChanged.RemoveDynamic(this, &ACombatantCharacterBase::HandleDeathIfNeeded);
-		Attributes->OnAttributeChanged.AddDynamic(this, &ACombatantCharacterBase::HandleDeathIfNeeded);
+		Attributes->OnDied.RemoveDynamic(this, &ACombatantCharacterBase::HandleDeathIfNeeded);
+		Attributes->OnDied.AddDynamic(this, &ACombatantCharacterBase::HandleDeathIfNeeded);
+	}
+
+	if (UCombatAggroSubsystem* Aggro = GetWorld() ? GetWorld()->GetSubsystem<UCombatAggroSubsystem>() : nullptr)
+	{
+		Aggro->Register(this);
 	}
 }
 
+void ACombatantCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCombatAggroSubsystem* Aggro = GetWorld() ? GetWorld()->GetSubsystem<UCombatAggroSubsystem>() : nullptr)
+	{
+		Aggro->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ACombatantCharacterBase::EnableRagdoll()
 {
 	if (bDidRagdoll) return;
@@ -67,14 +84,11 @@ void ACombatantCharacterBase::EnableRagdoll()
 	MeshComp->SetCollisionEnabled(ECollisionEnabled::PhysicsOnly);
 }
 
-void ACombatantCharacterBase::HandleDeathIfNeeded(FGameplayTag Tag, float NewValue, float Delta, AActor* InstigatorActor)
+void ACombatantCharacterBase::HandleDeathIfNeeded(AActor* Killer, FGameplayTag ResourceTag)
 {
+	// Raised once per death by the attributes component
 	if (bDidRagdoll) return;
 
-	if (Tag != ProdigyTags::Attr::Health) return;
-
-	if (NewValue > 0.f) return;
-
 	RemoveHealthBar();
 	EnableRagdoll();
 }
@@ -1,14 +1,18 @@
-#include "Player/ProdigyPlayerController.h"
+﻿#include "Player/ProdigyPlayerController.h"
 
 #include "AbilitySystem/ActionComponent.h"
 #include "AbilitySystem/ActionTypes.h"
 #include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatAggroSubsystem.h"
+#include "AbilitySystem/CombatCore.h"
+#include "AbilitySystem/CombatMovementComponent.h"
 #include "AbilitySystem/CombatSubsystem.h"
 #include "AbilitySystem/EquipModSource.h"
 #include "AbilitySystem/ProdigyAbilityUtils.h"
 #include "AbilitySystem/ProdigyGameplayTags.h"
 #include "AbilitySystem/WorldCombatEvents.h"
 #include "Blueprint/UserWidget.h"
+#include "Character/CombatantCharacterBase.h"
 #include "Character/Components/DamageTextComponent.h"
 #include "Character/Components/HealthBarWidgetComponent.h"
 #include "Quest/QuestLogComponent.h"
@@ -47,10 +51,24 @@ void AProdigyPlayerController::OnPossess(APawn* InPawn)
 {
 	Super::OnPossess(InPawn);
 
+	// Player party, unless the pawn has its own team or faction set
+	if (ACombatantCharacterBase* Combatant = Cast<ACombatantCharacterBase>(InPawn))
+	{
+		if (Combatant->CombatTeam == INDEX_NONE && Combatant->AggroFaction.IsNone())
+		{
+			Combatant->CombatTeam = ProdigyCombatCore::PlayerTeam;
+		}
+	}
+
 	if (UAttributesComponent* Attr = InPawn->FindComponentByClass<UAttributesComponent>())
 	{
 		Attr->OnAttributeChanged.AddDynamic(this, &AProdigyPlayerController::HandleAttrChanged_ForHUD);
 	}
+
+	if (UActionComponent* Actions = InPawn->FindComponentByClass<UActionComponent>())
+	{
+		Actions->OnCooldownChanged.AddUniqueDynamic(this, &AProdigyPlayerController::HandleCooldownChanged_ForHUD);
+	}
 }
 
 
@@ -76,6 +94,11 @@ void AProdigyPlayerController::HandleTurnChanged_ForHUD()
 	OnCombatHUDDirty.Broadcast();
 }
 
+void AProdigyPlayerController::HandleCooldownChanged_ForHUD(FGameplayTag ActionTag, bool bReady)
+{
+	OnCombatHUDDirty.Broadcast();
+}
+
 void AProdigyPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
@@ -95,11 +118,10 @@ void AProdigyPlayerController::BeginPlay()
 	{
 		if (UWorldCombatEvents* Events = World->GetSubsystem<UWorldCombatEvents>())
 		{
-			Events->OnWorldDamageEvent.RemoveAll(this);
-			Events->OnWorldHealEvent.RemoveAll(this);
+			Events->OnWorldCombatEventBatch.RemoveAll(this);
 
-			Events->OnWorldDamageEvent.AddDynamic(this, &ThisClass::HandleWorldDamageEvent);
-			Events->OnWorldHealEvent.AddDynamic(this, &ThisClass::HandleWorldHealEvent);
+			// Batch only: the per-hit events carry the same results
+			Events->OnWorldCombatEventBatch.AddDynamic(this, &ThisClass::HandleWorldCombatEventBatch);
 		}
 	}
 
@@ -123,9 +145,44 @@ bool AProdigyPlayerController::HandlePrimaryClickActor(AActor* ClickedActor)
 		return true;
 	}
 
+	// In combat the ground click is a tactical move (or nothing), never free click-to-move
+	UCombatSubsystem* Combat = GetCombatSubsystem();
+	if (Combat && Combat->IsActorInCombat(GetPawn()))
+	{
+		TryCombatMoveUnderCursor();
+		return true;
+	}
+
 	return false;
 }
 
+bool AProdigyPlayerController::UI_GetMovePreviewUnderCursor(TArray<FVector>& OutPath, int32& OutAPCost)
+{
+	OutPath.Reset();
+	OutAPCost = 0;
+
+	APawn* P = GetPawn();
+	UCombatMovementComponent* Move = P ? P->FindComponentByClass<UCombatMovementComponent>() : nullptr;
+	if (!Move || !IsMyTurn()) return false;
+
+	FHitResult Hit;
+	if (!GetHitResultUnderCursorByChannel(UEngineTypes::ConvertToTraceType(ECC_Visibility), true, Hit)) return false;
+
+	return Move->GetMovePreview(Hit.ImpactPoint, OutPath, OutAPCost);
+}
+
+bool AProdigyPlayerController::TryCombatMoveUnderCursor()
+{
+	APawn* P = GetPawn();
+	UCombatMovementComponent* Move = P ? P->FindComponentByClass<UCombatMovementComponent>() : nullptr;
+	if (!Move || !IsMyTurn()) return false;
+
+	FHitResult Hit;
+	if (!GetHitResultUnderCursorByChannel(UEngineTypes::ConvertToTraceType(ECC_Visibility), true, Hit)) return false;
+
+	return Move->MoveTo(Hit.ImpactPoint);
+}
+
 void AProdigyPlayerController::CacheComponents()
 {
 	if (!QuestLog)
@@ -158,6 +215,21 @@ void AProdigyPlayerController::CacheComponents()
 	       EquipmentComp.Get());
 }
 
+void AProdigyPlayerController::HandleWorldCombatEventBatch(const TArray<FWorldCombatEvent>& Events)
+{
+	for (const FWorldCombatEvent& E : Events)
+	{
+		if (E.bHeal)
+		{
+			HandleWorldHealEvent(E.TargetActor, E.InstigatorActor, E.Amount, E.OldHP, E.NewHP);
+		}
+		else
+		{
+			HandleWorldDamageEvent(E.TargetActor, E.InstigatorActor, E.Amount, E.OldHP, E.NewHP);
+		}
+	}
+}
+
 void AProdigyPlayerController::HandleWorldDamageEvent(
 	AActor* TargetActor,
 	AActor* InstigatorActor,
@@ -490,8 +562,7 @@ bool AProdigyPlayerController::TryUseAbilityOnLockedTarget(FGameplayTag AbilityT
 	if (!Combat->IsInCombat())
 	{
 		TArray<AActor*> Parts;
-		Parts.Add(Target);
-		Parts.Add(P);
+		GatherFightParticipants(P, Target, Parts);
 		Combat->EnterCombat(Parts, /*FirstToAct*/ P);
 	}
 
@@ -1054,12 +1125,25 @@ void AProdigyPlayerController::UI_StartFight()
 	if (Combat->IsInCombat()) return;
 
 	TArray<AActor*> Parts;
-	Parts.Add(Target);
-	Parts.Add(P);
+	GatherFightParticipants(P, Target, Parts);
 
 	Combat->EnterCombat(Parts, /*FirstToAct*/ P);
 }
 
+void AProdigyPlayerController::GatherFightParticipants(APawn* P, AActor* Target, TArray<AActor*>& OutParts) const
+{
+	// Target's allies nearby / link group come along
+	if (const UCombatAggroSubsystem* Aggro = GetWorld() ? GetWorld()->GetSubsystem<UCombatAggroSubsystem>() : nullptr)
+	{
+		Aggro->GatherCombatPull(P, Target, OutParts);
+		return;
+	}
+
+	OutParts.Reset();
+	OutParts.Add(Target);
+	OutParts.Add(P);
+}
+
 void AProdigyPlayerController::UI_EndTurn()
 {
 	EndTurn();
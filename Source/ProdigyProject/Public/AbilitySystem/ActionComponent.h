@@ -5,8 +5,13 @@
 #include "GameplayTagContainer.h"
 #include "ActionTypes.h"
 #include "ActionDefinition.h"
+#include "ActionTimerWheel.h"
 #include "ActionComponent.generated.h"
 
+class UCombatAIUtilityProfile;
+class UCombatEncounter;
+struct FActionExecutionHandle;
+
 DEFINE_LOG_CATEGORY_STATIC(LogActionExec, Log, All);
 
 #define ACTION_LOG(Verbosity, Fmt, ...) \
@@ -15,6 +20,9 @@ UE_LOG(LogActionExec, Verbosity, TEXT("[ActionComp:%s] " Fmt), \
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnActionExecuted, FGameplayTag, ActionTag, const FActionContext&, Context);
 
+// Started (bReady false) or ready again; not sent for every turn / second that passes
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnActionCooldownChanged, FGameplayTag, ActionTag, bool, bReady);
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class PRODIGYPROJECT_API UActionComponent : public UActorComponent
 {
@@ -28,6 +36,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Action")
 	TArray<TObjectPtr<UActionDefinition>> KnownActions;
 
+	// AI only: scores (action, target) pairs each turn; empty = lookahead planner / basic attack
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Action|AI")
+	TObjectPtr<UCombatAIUtilityProfile> AIUtilityProfile = nullptr;
+
 	// Simple “time model” switch (Combat subsystem will set this)
 	UFUNCTION(BlueprintCallable, Category="Action")
 	void SetInCombat(bool bNowInCombat);
@@ -35,15 +47,31 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Action")
 	bool IsInCombat() const { return bInCombat; }
 
+	// Pure (no cues, no logging), safe for UI / AI previews; ExecuteAction plays the failure feedback
 	UFUNCTION(BlueprintCallable,Category="Action")
 	FActionQueryResult QueryAction(FGameplayTag ActionTag, const FActionContext& Context) const;
 
+	// QueryAction for many actions in one pass: owned tags, AP and time are read once. OutResults[i] is ActionTags[i].
+	void QueryActions(TConstArrayView<FGameplayTag> ActionTags, const FActionContext& Context, TArrayView<FActionQueryResult> OutResults) const;
+
 	UFUNCTION(Category="Action")
 	bool ExecuteAction(FGameplayTag ActionTag, const FActionContext& Context);
 
+	// ExecuteAction + the running action's handle (invalid when it already completed, or was refused)
+	bool ExecuteActionTracked(FGameplayTag ActionTag, const FActionContext& Context, FActionExecutionHandle& OutHandle);
+
 	UPROPERTY(BlueprintAssignable)
 	FOnActionExecuted OnActionExecuted;
 
+	UPROPERTY(BlueprintAssignable)
+	FOnActionCooldownChanged OnCooldownChanged;
+
+	// One impact of an action already paid for: its effects on Targets (UActionExecutionSubsystem, projectiles)
+	void ApplyActionImpact(const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets);
+
+	// Action fully played out (impacts, projectiles, recovery): OnActionExecuted
+	void FinishAction(const UActionDefinition* Def, const FActionContext& Context);
+
 	UFUNCTION(BlueprintCallable, Category="Actions|Combat")
 	void OnTurnBegan();
 
@@ -55,6 +83,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Action|UI")
 	TArray<FGameplayTag> GetKnownActionTags() const;
 
+	// Combat (turn-based) cooldown only; 0 when ready or unknown
+	int32 GetCooldownTurnsRemaining(FGameplayTag ActionTag) const;
+
+	// Action slots: KnownActions order (invalid / untagged entries skipped), index into the dense cooldown arrays
+	int32 GetNumActionSlots() const { return SlotDefinitions.Num(); }
+	int32 FindActionSlot(FGameplayTag ActionTag) const;
+	FGameplayTag GetActionTagForSlot(int32 Slot) const;
+
+	// Combat cooldown turns left per action slot
+	TConstArrayView<int32> GetCooldownTurnsBySlot() const { return CooldownTurns; }
+
+	// Actions still cooling down, by tag (snapshot / rewind format)
+	TMap<FGameplayTag, FActionCooldownState> GetCooldowns() const;
+
+	// Bumped whenever Cooldowns changes (combat snapshots share their last copy while it holds)
+	uint32 GetCooldownsRevision() const { return CooldownsRevision; }
+
+	// Snapshot rewind
+	void RestoreCooldowns(const TMap<FGameplayTag, FActionCooldownState>& InCooldowns);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -62,15 +110,50 @@ protected:
 private:
 	UPROPERTY() bool bInCombat = false;
 
-	UPROPERTY() TMap<FGameplayTag, TObjectPtr<UActionDefinition>> ActionMap;
-	UPROPERTY() TMap<FGameplayTag, FActionCooldownState> Cooldowns;
+	// Tag -> action slot
+	UPROPERTY() TMap<FGameplayTag, int32> ActionSlots;
+	UPROPERTY() TArray<TObjectPtr<UActionDefinition>> SlotDefinitions;
+
+	// Cooldowns, dense by action slot (0 = ready): combat turns left / exploration end time (world seconds)
+	TArray<int32> CooldownTurns;
+	TArray<float> CooldownEndTimes;
+
+	// Exploration end times; the component only ticks while it holds any
+	FActionTimerWheel CooldownWheel;
+
+	uint32 CooldownsRevision = 0;
 
 	const UActionDefinition* FindDef(FGameplayTag Tag) const;
 	void BuildMapIfNeeded();
 
-	bool PassesTagGates(AActor* Instigator, const UActionDefinition* Def, EActionFailReason& OutFail) const;
+	void ScheduleCooldownExpiry(int32 Slot);
+
+	// What every query of one QueryActions call shares
+	struct FQueryInputs
+	{
+		FGameplayTagContainer OwnedTags;
+		float CurrentAP = 0.f;
+		bool bInstigatorIsAgent = false;
+		float Now = 0.f;
+
+		// Line of sight only: looked up the first time an action needs it
+		const UCombatEncounter* Encounter = nullptr;
+		bool bEncounterResolved = false;
+	};
+
+	void GatherQueryInputs(const FActionContext& Context, FQueryInputs& Out) const;
+	FActionQueryResult QueryWithInputs(FGameplayTag ActionTag, const FActionContext& Context, FQueryInputs& Inputs) const;
+
+	static bool PassesTagGates(const FGameplayTagContainer& Owned, const UActionDefinition* Def, EActionFailReason& OutFail);
 	bool IsTargetValid(const UActionDefinition* Def, const FActionContext& Context) const;
 
+	// MinRange / MaxRange / bRequiresLineOfSight; in combat sight comes from the encounter's visibility grid
+	bool PassesRangeAndSight(const UActionDefinition* Def, const FActionContext& Context, FQueryInputs& Inputs, EActionFailReason& OutFail) const;
+
+	// Area actions: everyone the shape hits (encounter roster in combat, pawn overlap outside)
+	void ResolveAreaTargets(const UActionDefinition* Def, const FActionContext& Context, TArray<AActor*>& Out) const;
+
 	void StartCooldown(const UActionDefinition* Def);
+	bool IsSlotOnCooldown(int32 Slot, float Now) const;
 };
 
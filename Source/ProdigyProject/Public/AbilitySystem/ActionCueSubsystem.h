@@ -52,6 +52,12 @@ struct FActionCueContext
     float AppliedDamage = 0.f;
 };
 
+struct FActionCueBatchEntry
+{
+    FGameplayTag CueTag;
+    FActionCueContext Context;
+};
+
 UCLASS()
 class PRODIGYPROJECT_API UActionCueSubsystem : public UWorldSubsystem
 {
@@ -61,6 +67,14 @@ public:
     UFUNCTION(BlueprintCallable, Category="Cues")
     void PlayCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx);
 
+    // All cues of one action (AoE hits); the global cue set is looked up once for the whole batch
+    void PlayCueBatch(TConstArrayView<FActionCueBatchEntry> Entries);
+
+    // Instant combat playback: cues played in between are merged (one per tag + target, first HP snapshot kept)
+    // and played as one batch by the outermost EndCoalesce
+    void BeginCoalesce();
+    void EndCoalesce();
+
     // Resolver uses layered providers (Step D)
     bool ResolveCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx, FActionCueDef& OutDef) const;
 
@@ -73,6 +87,17 @@ private:
     UPROPERTY(Transient)
     TArray<TObjectPtr<UActionCueSet>> ActionOverrideStack;
 
+    // Global cue set resolved once for the batch in flight (PlayCueBatch)
+    UPROPERTY(Transient)
+    TObjectPtr<UActionCueSet> BatchGlobalCueSet = nullptr;
+
+    bool bInCueBatch = false;
+
+    int32 CoalesceDepth = 0;
+    TArray<FActionCueBatchEntry> CoalescedCues;
+
+    void CoalesceCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx);
+
     // Cooldown bookkeeping
     mutable TMap<uint64, double> LastPlayedTimeByKey;
 
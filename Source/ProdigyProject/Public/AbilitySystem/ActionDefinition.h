@@ -5,6 +5,7 @@
 #include "GameplayTagContainer.h"
 #include "ActionTypes.h"
 #include "ActionEffect.h"
+#include "ActionProgram.h"
 #include "ActionDefinition.generated.h"
 
 USTRUCT(BlueprintType)
@@ -46,6 +47,27 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action")
 	EActionTargetingMode TargetingMode = EActionTargetingMode::Unit;
 
+	// Optional AoE around / towards the Unit or Point target; every effect then runs on everyone hit, in one batch
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Area")
+	FActionAreaOfEffect Area;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Projectile")
+	FActionProjectile Projectile;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Timing")
+	FActionTiming Timing;
+
+	// Unit / Point targets only, measured flat (XY) from the instigator. 0 = no limit.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Range", meta=(ClampMin="0"))
+	float MaxRange = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Range", meta=(ClampMin="0"))
+	float MinRange = 0.f;
+
+	// Static geometry between instigator and target blocks it (combat: the encounter's visibility grid)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Range")
+	bool bRequiresLineOfSight = false;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Availability")
 	bool bUsableInExploration = true;
 
@@ -66,4 +88,16 @@ public:
 
 	UPROPERTY(EditDefaultsOnly, Instanced, BlueprintReadOnly, Category="Action|Effects")
 	TArray<TObjectPtr<UActionEffect>> Effects;
+
+	// Effects compiled to native ops (built on load, rebuilt after edits)
+	const FActionProgram& GetProgram() const;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	mutable FActionProgram Program;
+	mutable bool bProgramCompiled = false;
 };
@@ -5,6 +5,8 @@
 #include "ActionTypes.h"
 #include "ActionEffect.generated.h"
 
+struct FActionEffectBatch;
+
 UCLASS(Abstract, BlueprintType, EditInlineNew, DefaultToInstanced)
 class PRODIGYPROJECT_API UActionEffect : public UObject
 {
@@ -14,4 +16,9 @@ public:
 	// Return true if effect applied successfully (useful for analytics/logging)
 	UFUNCTION(BlueprintNativeEvent, Category="Action|Effect")
 	bool Apply(const FActionContext& Context) const;
+
+	// Batched path used by UActionComponent (single target and AoE alike): queue writes / cues into Batch, the caller flushes.
+	// Default: one Apply per target with TargetActor swapped in (Blueprint effects keep working, unbatched).
+	// Returns how many targets it applied to.
+	virtual int32 ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const;
 };
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/ActionCueSubsystem.h"
+#include "AbilitySystem/WorldCombatEvents.h"
+
+class IActionAgentInterface;
+
+/**
+ * Everything one action does to its targets, applied in one pass by Flush:
+ * - attribute writes (merged per actor + attribute, so stacked effects change each value once),
+ * - then cues (one UActionCueSubsystem::PlayCueBatch call),
+ * - then damage / heal results (one UWorldCombatEvents::BroadcastBatch).
+ * Effects read values through the batch so they see each other's pending writes.
+ * Agents whose attribute / status events aren't overridden in Blueprint are called natively (no ProcessEvent).
+ */
+struct PRODIGYPROJECT_API FActionEffectBatch
+{
+	// Value as this batch will leave it (pending write first, else the live attribute). False if A lacks the attribute.
+	bool GetValue(AActor* A, const FGameplayTag& Tag, float& OutValue) const;
+
+	// Queues A.Tag = NewValue. bReportHealth: emit a damage / heal world event for it on flush.
+	void SetValue(AActor* A, const FGameplayTag& Tag, float NewValue, AActor* Instigator, bool bReportHealth);
+
+	// Base + mods (not affected by pending writes). False if A lacks the attribute.
+	bool GetFinalValue(AActor* A, const FGameplayTag& Tag, float& OutValue) const;
+
+	// Statuses aren't merged: applied right away
+	bool AddStatus(AActor* A, const FGameplayTag& StatusTag, int32 Turns, float Seconds, AActor* Instigator) const;
+
+	void AddCue(const FGameplayTag& CueTag, const FActionCueContext& Ctx);
+
+	// Applies and clears everything. Returns the number of attribute writes that went through.
+	int32 Flush(UWorld* World);
+
+	bool IsEmpty() const { return Writes.Num() == 0 && Cues.Num() == 0; }
+
+private:
+	struct FWrite
+	{
+		TObjectPtr<AActor> Actor = nullptr;
+		FGameplayTag Tag;
+
+		float OldValue = 0.f;
+		float NewValue = 0.f;
+
+		// Last writer wins (same action, so normally the same instigator)
+		TObjectPtr<AActor> Instigator = nullptr;
+		bool bReportHealth = false;
+	};
+
+	struct FAgent
+	{
+		const AActor* Actor = nullptr;
+		bool bAgent = false;
+
+		// Null = Blueprint implements / overrides the interface: Execute_* it is
+		IActionAgentInterface* Native = nullptr;
+	};
+
+	// Once per actor per batch
+	const FAgent& GetAgent(AActor* A) const;
+
+	const FWrite* FindWrite(const AActor* A, const FGameplayTag& Tag) const;
+	FWrite* FindWrite(const AActor* A, const FGameplayTag& Tag) { return const_cast<FWrite*>(AsConst(*this).FindWrite(A, Tag)); }
+
+	TArray<FWrite, TInlineAllocator<16>> Writes;
+	TArray<FActionCueBatchEntry, TInlineAllocator<16>> Cues;
+	mutable TArray<FAgent, TInlineAllocator<16>> Agents;
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystem/ActionEffect.h"
+#include "AbilitySystem/CombatFormula.h"
 #include "GameplayTagContainer.h"
 #include "ActionEffect_DealDamage.generated.h"
 
@@ -19,6 +20,11 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Damage", meta=(ClampMin="0.0"))
 	float Damage = 0.f;
 
+	// Optional: damage computed per target instead of Damage (see FCombatFormula), e.g.
+	// "Attr.Strength * 1.5 - Target.Attr.Armor". Negative results deal nothing.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Damage")
+	FCombatFormula DamageFormula;
+
 	// Explicit: clamp at 0 (recommended)
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Damage")
 	bool bClampMinZero = true;
@@ -39,6 +45,11 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Cue")
 	float SurfaceTraceDistanceExtra = 50.f;
 
+	virtual void PostLoad() override;
+
 	virtual bool Apply_Implementation(const FActionContext& Context) const override;
-	
+	virtual int32 ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const override;
+
+	// Surface tag + impact point from Instigator towards Toward (false = nothing hit)
+	bool TraceSurface(UWorld* World, const AActor* Instigator, const FVector& Toward, FGameplayTag& OutSurfaceTag, FVector& OutImpact) const;
 };
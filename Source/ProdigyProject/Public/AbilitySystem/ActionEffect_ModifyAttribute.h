@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "AbilitySystem/ActionEffect.h"
+#include "AbilitySystem/CombatFormula.h"
 #include "ActionEffect_ModifyAttribute.generated.h"
 
 UENUM(BlueprintType)
@@ -25,6 +26,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Effect")
 	float Delta = 0.f;
 
+	// Optional: signed delta computed per target instead of Delta (see FCombatFormula), e.g. "Attr.Wisdom * 2"
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Effect")
+	FCombatFormula DeltaFormula;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Effect")
 	EActionEffectTarget Target = EActionEffectTarget::Target;
 
@@ -39,8 +44,8 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Action|Effect|Clamp", meta=(EditCondition="bClampToMaxAttribute"))
 	FGameplayTag MaxAttributeTag;
 
-	virtual bool Apply_Implementation(const FActionContext& Context) const override;
+	virtual void PostLoad() override;
 
-private:
-	AActor* ResolveTargetActor(const FActionContext& Context) const;
+	virtual bool Apply_Implementation(const FActionContext& Context) const override;
+	virtual int32 ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const override;
 };
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "AbilitySystem/ActionEffect.h"
+#include "AbilitySystem/ActionCueSubsystem.h"
 #include "AbilitySystem/CombatCueSet.h"
 #include "ActionEffect_PlayCue.generated.h"
 
@@ -20,4 +21,5 @@ public:
 	ECombatCueAnchor DefaultAnchor = ECombatCueAnchor::Target;
 
 	virtual bool Apply_Implementation(const FActionContext& Context) const override;
+	virtual int32 ApplyToTargets(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const override;
 };
@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AbilitySystem/ActionTypes.h"
+#include "ActionExecutionSubsystem.generated.h"
+
+class UActionComponent;
+class UActionDefinition;
+
+// One executing action; 0 = none (refused, or nothing to wait for)
+struct FActionExecutionHandle
+{
+	uint32 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+	bool operator==(const FActionExecutionHandle& Other) const { return Id == Other.Id; }
+};
+
+// Every execution that ran out (not Cancel); bFinished = OnActionExecuted went out too (source / def still there)
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnActionExecutionCompletedNative, FActionExecutionHandle /*Handle*/, bool /*bFinished*/);
+
+/**
+ * Runs paid-for actions through their phases (UActionDefinition::Timing), all of them from one tick:
+ * Commit (montage starts) -> Windup -> Impact(s) -> Recovery -> OnActionExecuted.
+ * - An impact applies the effects (or launches the projectile, which then counts as pending until it lands).
+ * - Impacts come on fixed times, or from UAnimNotify_ActionImpact in the montage (fixed times + NotifyGraceSeconds
+ *   as the fallback when a notify never arrives).
+ * - Actions without phases run start to finish inside Execute, same as before.
+ */
+UCLASS()
+class PRODIGYPROJECT_API UActionExecutionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Notify-driven impact this late (past its fixed time) goes ahead without it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Actions", meta=(ClampMin="0.0"))
+	float NotifyGraceSeconds = 1.f;
+
+	// Hard cap per action (lost projectile, broken montage): it completes anyway
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Actions", meta=(ClampMin="0.1"))
+	float MaxActionSeconds = 10.f;
+
+	// Action is paid for, targets resolved. Invalid handle = it already completed.
+	FActionExecutionHandle Execute(UActionComponent* Source, const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets);
+
+	// Anim notify: next impact of Instigator's notify-driven action
+	void SignalImpact(const AActor* Instigator);
+
+	// Projectile launched by an impact of Handle landed (or was dropped)
+	void NotifyProjectileResolved(FActionExecutionHandle Handle);
+
+	// Dropped without impacts or OnActionExecuted (encounter ended under it)
+	void Cancel(FActionExecutionHandle Handle);
+
+	bool IsRunning(FActionExecutionHandle Handle) const;
+	int32 NumRunning() const { return Executions.Num(); }
+	bool HasExecutionsFrom(const AActor* Instigator) const;
+
+	FOnActionExecutionCompletedNative OnExecutionCompletedNative;
+
+private:
+	enum class EPhase : uint8
+	{
+		Windup,     // impacts still to come
+		Landing,    // all impacts done, projectiles in flight
+		Recovery,
+	};
+
+	struct FExecution
+	{
+		FActionExecutionHandle Handle;
+		TWeakObjectPtr<UActionComponent> Source;
+		TWeakObjectPtr<const UActionDefinition> Def;
+
+		// Context, without strong pointers across frames
+		TWeakObjectPtr<AActor> Instigator;
+		TWeakObjectPtr<AActor> TargetActor;
+		FVector TargetLocation = FVector::ZeroVector;
+		FGameplayTag OptionalSubTarget;
+		TArray<TWeakObjectPtr<AActor>> Targets;
+
+		EPhase Phase = EPhase::Windup;
+		float Age = 0.f;
+
+		// Scaled by combat playback speed at commit
+		float Windup = 0.f;
+		float Interval = 0.f;
+		float Recovery = 0.f;
+		int32 NumImpacts = 1;
+
+		int32 ImpactsDone = 0;
+		int32 PendingNotifies = 0;
+		int32 PendingProjectiles = 0;
+		float RecoveryStart = 0.f;
+		bool bWaitsForNotifies = false;
+	};
+
+	// By handle throughout: impacts run gameplay that can start or cancel executions under us
+
+	// Advances the execution by its own clock; true once it's done (false if it's gone)
+	bool Step(FActionExecutionHandle Handle);
+	void Impact(FActionExecutionHandle Handle);
+
+	// Removes it, then OnActionExecuted (if it still can), then OnExecutionCompletedNative
+	void Complete(FActionExecutionHandle Handle);
+
+	FActionContext MakeContext(const FExecution& E) const;
+	FExecution* Find(FActionExecutionHandle Handle);
+	const FExecution* Find(FActionExecutionHandle Handle) const;
+
+	TArray<FExecution> Executions;
+	uint32 NextId = 1;
+};
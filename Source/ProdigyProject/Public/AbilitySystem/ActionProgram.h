@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+class AActor;
+class UActionDefinition;
+class UActionEffect;
+struct FActionContext;
+struct FActionEffectBatch;
+struct FCombatFormula;
+
+enum class EActionOpKind : uint8
+{
+	ModifyAttribute,
+	DealDamage,
+	ApplyStatus,
+	PlayCue,
+
+	// Anything else (Blueprint effects, project subclasses): UActionEffect::ApplyToTargets
+	Effect,
+};
+
+// One effect, flattened: every tag resolved, no UObject calls needed to run it
+struct FActionOp
+{
+	EActionOpKind Kind = EActionOpKind::Effect;
+
+	// Attribute written (DealDamage: its health tag) + optional clamp attribute
+	FGameplayTag AttributeTag;
+	FGameplayTag MaxAttributeTag;
+
+	// Flat amount: damage (>= 0) or signed delta; Formula (when set) replaces it per target
+	float Value = 0.f;
+	const FCombatFormula* Formula = nullptr;
+
+	// Status (ApplyStatus) or cue (PlayCue; DealDamage: hit cue, invalid = none)
+	FGameplayTag Tag;
+	int32 Turns = 0;
+	float Seconds = 0.f;
+
+	bool bTargetsInstigator = false;
+	bool bClampMinZero = false;
+	bool bClampToMax = false;
+	bool bReportHealth = false;
+
+	// Owner (formula errors, DealDamage surface trace, fallback dispatch). Kept alive by the definition.
+	const UActionEffect* Effect = nullptr;
+
+	// Game thread; null / unknown classes become Effect ops
+	static FActionOp FromEffect(const UActionEffect* InEffect);
+};
+
+/**
+ * A UActionDefinition's effects compiled into a flat op list (cached on the definition).
+ * - Built-in effects run as a switch over plain structs: no UFunction thunk, no virtual call per effect.
+ * - Attribute / status reads and writes go through FActionEffectBatch, which calls native agents directly
+ *   (one interface lookup per actor per action) unless a Blueprint overrides the agent events.
+ * - Other effects stay as Effect ops and run through UActionEffect::ApplyToTargets as before.
+ */
+struct PRODIGYPROJECT_API FActionProgram
+{
+	TArray<FActionOp> Ops;
+
+	// Ops that still dispatch into UActionEffect
+	int32 NumFallbackOps = 0;
+
+	bool IsNative() const { return NumFallbackOps == 0; }
+
+	void Compile(const UActionDefinition& Def);
+
+	// All ops into Batch (caller flushes). Returns how many ops ran.
+	int32 Execute(const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch) const;
+};
+
+namespace ProdigyActionProgram
+{
+	// Single op (the built-in effects' own ApplyToTargets run through here too). Returns targets applied to.
+	int32 ExecuteOp(const FActionOp& Op, const FActionContext& Context, TConstArrayView<AActor*> Targets, FActionEffectBatch& Batch);
+}
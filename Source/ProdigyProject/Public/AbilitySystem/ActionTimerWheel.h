@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hashed timer wheel (exploration cooldowns): schedule is O(1), Advance only visits the buckets the clock
+ * went past, and a timer is looked at again only when its bucket comes round.
+ * - Deadlines are rounded up to the next tick, so nothing fires early.
+ * - No cancel: rescheduling an id leaves the old entry in, the owner checks its own state when an id fires.
+ */
+struct PRODIGYPROJECT_API FActionTimerWheel
+{
+	static constexpr int32 NumBuckets = 64;
+	static constexpr double TickSeconds = 0.1;
+
+	// Id: owner's handle (e.g. action slot)
+	void Schedule(int32 Id, double Now, double DueTime);
+
+	// Ids due by Now, in no particular order, into OutExpired (appended)
+	void Advance(double Now, TArray<int32, TInlineAllocator<8>>& OutExpired);
+
+	void Reset();
+
+	bool IsEmpty() const { return NumPending == 0; }
+	int32 Num() const { return NumPending; }
+
+private:
+	struct FTimer
+	{
+		int64 DueTick = 0;
+		int32 Id = INDEX_NONE;
+	};
+
+	static int64 ToTick(double Time) { return static_cast<int64>(FMath::FloorToDouble(Time / TickSeconds)); }
+
+	TArray<FTimer> Buckets[NumBuckets];
+
+	// Last tick Advance processed
+	int64 CurrentTick = 0;
+	int32 NumPending = 0;
+};
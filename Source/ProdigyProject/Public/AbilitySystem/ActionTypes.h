@@ -4,6 +4,9 @@
 #include "GameplayTagContainer.h"
 #include "ActionTypes.generated.h"
 
+class UAnimMontage;
+class UNiagaraSystem;
+
 UENUM(BlueprintType)
 enum class EActionTargetingMode : uint8
 {
@@ -31,8 +34,168 @@ enum class EActionFailReason : uint8
 	OnCooldown,
 	InsufficientAP,
 	InvalidTarget,
+
+	// Spatial gates (UActionDefinition range / line of sight)
+	OutOfRange,
+	NoLineOfSight,
+};
+
+UENUM(BlueprintType)
+enum class EActionAreaShape : uint8
+{
+	// Single target (TargetActor)
+	None UMETA(DisplayName="None"),
+
+	// Sphere around the target point / unit
+	Radius UMETA(DisplayName="Radius"),
+
+	// From the instigator towards the target, Range long, HalfAngleDegrees wide
+	Cone UMETA(DisplayName="Cone"),
+
+	// From the instigator towards the target, Range long, HalfWidth wide
+	Line UMETA(DisplayName="Line"),
+};
+
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FActionAreaOfEffect
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area")
+	EActionAreaShape Shape = EActionAreaShape::None;
+
+	// Radius (Radius) or length (Cone / Line)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area", meta=(ClampMin="0.0", EditCondition="Shape != EActionAreaShape::None"))
+	float Range = 300.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area", meta=(ClampMin="0.0", ClampMax="180.0", EditCondition="Shape == EActionAreaShape::Cone"))
+	float HalfAngleDegrees = 30.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area", meta=(ClampMin="0.0", EditCondition="Shape == EActionAreaShape::Line"))
+	float HalfWidth = 75.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area")
+	bool bAffectsEnemies = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area")
+	bool bAffectsAllies = false;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area")
+	bool bAffectsInstigator = false;
+
+	// 0 = everyone inside (closest to the area origin first otherwise)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Area", meta=(ClampMin="0"))
+	int32 MaxTargets = 0;
+
+	bool IsArea() const { return Shape != EActionAreaShape::None; }
+
+	bool AffectsTeam(int32 InstigatorTeam, int32 CandidateTeam) const
+	{
+		return CandidateTeam == InstigatorTeam ? bAffectsAllies : bAffectsEnemies;
+	}
 };
 
+// Commit -> Windup -> Impact(s) -> Recovery (UActionExecutionSubsystem). All zero / unset = effects land on execute.
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FActionTiming
+{
+	GENERATED_BODY()
+
+	// Played on the instigator (ACharacter) at commit
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing")
+	TObjectPtr<UAnimMontage> Montage = nullptr;
+
+	// Impacts come from ActionImpact notifies in Montage; the fixed times below only cap how long it waits
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing", meta=(EditCondition="Montage != nullptr"))
+	bool bImpactsFromAnimNotifies = false;
+
+	// Commit to first impact
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing", meta=(ClampMin="0.0"))
+	float WindupSeconds = 0.f;
+
+	// Each impact applies every effect once (multi-hit: size the effects per hit)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing", meta=(ClampMin="1"))
+	int32 NumImpacts = 1;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing", meta=(ClampMin="0.0", EditCondition="NumImpacts > 1"))
+	float ImpactIntervalSeconds = 0.f;
+
+	// Last impact (projectiles landed) to done; the next turn starts right after it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Timing", meta=(ClampMin="0.0"))
+	float RecoverySeconds = 0.f;
+
+	bool HasPhases() const
+	{
+		return Montage != nullptr || WindupSeconds > 0.f || NumImpacts > 1 || RecoverySeconds > 0.f;
+	}
+};
+
+// Travel time for Unit / Point actions: effects land on impact (UCombatProjectileSubsystem), not on execute
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FActionProjectile
+{
+	GENERATED_BODY()
+
+	// uu/s along the flat distance. 0 = no projectile.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile", meta=(ClampMin="0.0"))
+	float Speed = 0.f;
+
+	// Apex above the straight line, halfway (0 = straight shot)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile", meta=(ClampMin="0.0", EditCondition="Speed > 0"))
+	float ArcHeight = 0.f;
+
+	// Swept against static geometry every step; a hit before the target is a miss
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile", meta=(ClampMin="0.0", EditCondition="Speed > 0"))
+	float Radius = 10.f;
+
+	// Launch point in the instigator's space
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile", meta=(EditCondition="Speed > 0"))
+	FVector MuzzleOffset = FVector(50.f, 0.f, 40.f);
+
+	// Flight FX, from a small pool (projectiles past the pool fly unseen)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Projectile", meta=(EditCondition="Speed > 0"))
+	TObjectPtr<UNiagaraSystem> Visual = nullptr;
+
+	bool IsProjectile() const { return Speed > 0.f; }
+};
+
+// An area resolved against a concrete cast (origin / direction fixed), tested per candidate
+struct PRODIGYPROJECT_API FActionAreaQuery
+{
+	EActionAreaShape Shape = EActionAreaShape::None;
+
+	FVector Origin = FVector::ZeroVector;
+
+	// Planar (Z = 0) unit direction for Cone / Line
+	FVector Direction = FVector::ForwardVector;
+
+	float Range = 0.f;
+	float CosHalfAngle = 1.f;
+	float HalfWidth = 0.f;
+
+	// Radius: the target point / unit. Cone / Line: the instigator, aimed at the target.
+	static FActionAreaQuery Make(const FActionAreaOfEffect& Area, const FVector& InstigatorLocation, const FVector& InstigatorForward, const FVector& TargetPoint);
+
+	// Sphere that contains the whole shape (broad phase)
+	FVector GetBoundsCenter() const;
+	float GetBoundsRadius() const;
+
+	// Planar test, TargetRadius (capsule) counts towards being inside. OutDistance = from Origin (for MaxTargets).
+	bool Contains(const FVector& Location, float TargetRadius, float& OutDistance) const;
+};
+
+struct FActionAreaHit
+{
+	AActor* Actor = nullptr;
+	float Distance = 0.f;
+};
+
+namespace ActionArea
+{
+	// Closest first, capped at MaxTargets (0 = all), appended to Out
+	PRODIGYPROJECT_API void FinishHits(TArray<FActionAreaHit, TInlineAllocator<16>>& Hits, int32 MaxTargets, TArray<AActor*>& Out);
+}
+
 USTRUCT(BlueprintType)
 struct FActionContext
 {
@@ -43,6 +206,9 @@ struct FActionContext
 	UPROPERTY(BlueprintReadWrite) FVector TargetLocation = FVector::ZeroVector;
 
 	UPROPERTY(BlueprintReadWrite) FGameplayTag OptionalSubTarget;
+
+	// Everyone an area action hit (filled by UActionComponent before effects run; empty for single-target actions)
+	UPROPERTY(BlueprintReadWrite) TArray<TObjectPtr<AActor>> AreaTargets;
 };
 
 USTRUCT(BlueprintType)
@@ -0,0 +1,17 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "AnimNotify_ActionImpact.generated.h"
+
+// Impact frame of an action montage (FActionTiming::bImpactsFromAnimNotifies): effects fire here
+UCLASS(meta=(DisplayName="Action Impact"))
+class PRODIGYPROJECT_API UAnimNotify_ActionImpact : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+
+	virtual FString GetNotifyName_Implementation() const override { return TEXT("Action Impact"); }
+};
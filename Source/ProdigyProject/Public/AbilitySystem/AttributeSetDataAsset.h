@@ -18,6 +18,10 @@ struct FProdigyResourcePair
 	// Max/cap attribute tag (e.g. Attr.MaxHealth, Attr.MaxMana, Attr.MaxAP)
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Attributes")
 	FGameplayTag MaxTag;
+
+	// Owner dies when the current value drops to 0 (Attr.Health always counts)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Attributes")
+	bool bLethalAtZero = false;
 };
 
 UCLASS(BlueprintType)
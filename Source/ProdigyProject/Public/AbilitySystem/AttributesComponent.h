@@ -50,6 +50,32 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(
 	AActor*, InstigatorActor
 );
 
+class UAttributesComponent;
+
+// Native twin of FOnAttributeChanged that also carries the source component (combat systems bind many actors to one handler)
+DECLARE_MULTICAST_DELEGATE_FiveParams(
+	FOnAttributeChangedNative,
+	UAttributesComponent* /*Source*/,
+	FGameplayTag /*AttributeTag*/,
+	float /*NewValue*/,
+	float /*Delta*/,
+	AActor* /*InstigatorActor*/
+);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(
+	FOnDied,
+	AActor*, Killer,
+	FGameplayTag, ResourceTag
+);
+
+// Raised once when a lethal resource hits 0 (Killer = instigator of the killing change, may be null)
+DECLARE_MULTICAST_DELEGATE_ThreeParams(
+	FOnDiedNative,
+	UAttributesComponent* /*Source*/,
+	AActor* /*Killer*/,
+	FGameplayTag /*ResourceTag*/
+);
+
 USTRUCT(BlueprintType)
 struct FPeriodicTurnEffect
 {
@@ -91,6 +117,22 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Attributes")
 	FOnAttributeChanged OnAttributeChanged;
 
+	// Same events as OnAttributeChanged, for native listeners
+	FOnAttributeChangedNative OnAttributeChangedNative;
+
+	// Fired once when Attr.Health (or another lethal resource pair) drops to 0; re-armed if it goes back above 0
+	UPROPERTY(BlueprintAssignable, Category="Attributes")
+	FOnDied OnDied;
+
+	FOnDiedNative OnDiedNative;
+
+	UFUNCTION(BlueprintPure, Category="Attributes")
+	bool IsDead() const { return bDead; }
+
+	// Instigator of the killing blow (null if alive or unattributed)
+	UFUNCTION(BlueprintPure, Category="Attributes")
+	AActor* GetKiller() const { return Killer.Get(); }
+
 	// --- Query ---
 	UFUNCTION(BlueprintCallable, Category="Attributes")
 	bool HasAttribute(FGameplayTag AttributeTag) const;
@@ -118,6 +160,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Attributes")
 	bool CopyCurrentValue(FGameplayTag FromTag, FGameplayTag ToTag, AActor* InstigatorActor);
 
+	// Snapshot of every attribute entry (used by the headless combat core)
+	void GetAttributeEntries(TArray<FAttributeEntry>& OutEntries) const;
+
+	const TArray<FPeriodicTurnEffect>& GetTurnEffects() const { return TurnEffects; }
+
 	// --- Modifier Layer API ---
 	UFUNCTION(BlueprintCallable, Category="Attributes|Mods")
 	void SetModsForSource(UObject* Source, const TArray<FAttributeMod>& Mods, UObject* InstigatorSource);
@@ -145,6 +192,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Attributes|Periodic")
 	void ClearTurnEffect(FGameplayTag EffectTag);
 
+	// --- Snapshots (combat turn snapshots / rewind) ---
+
+	// Bumped on every write to the matching section; a snapshot keeps sharing its last copy while they hold
+	uint32 GetValuesRevision() const { return ValuesRevision; }
+	uint32 GetModsRevision() const { return ModsRevision; }
+	uint32 GetTurnEffectsRevision() const { return TurnEffectsRevision; }
+
+	const TMap<TWeakObjectPtr<UObject>, FAttrModSource>& GetModSources() const { return ModSources; }
+
+	// Same as GetFinalValue, for captured data
+	static float ComputeFinalValue(const FAttributeEntry& Entry, const TMap<TWeakObjectPtr<UObject>, FAttrModSource>& InModSources);
+
+	// Puts captured sections back (null = keep the live one). Current value changes broadcast as usual,
+	// so UI and death / revive edges follow.
+	void RestoreState(
+		const TArray<FAttributeEntry>* InEntries,
+		const TMap<TWeakObjectPtr<UObject>, FAttrModSource>* InModSources,
+		const TArray<FPeriodicTurnEffect>* InTurnEffects,
+		AActor* InstigatorActor);
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -152,6 +219,16 @@ private:
 	UPROPERTY(Transient)
 	bool bDefaultsInitialized = false;
 
+	UPROPERTY(Transient)
+	bool bDead = false;
+
+	TWeakObjectPtr<AActor> Killer;
+
+	bool IsLethalResource(const FGameplayTag& Tag) const;
+
+	// Any lethal resource at or below 0 (still dead, whatever else came back)
+	bool HasDepletedLethalResource() const;
+
 	UPROPERTY()
 	TArray<FPeriodicTurnEffect> TurnEffects;
 
@@ -185,4 +262,8 @@ private:
 	// stable "source objects" per equip slot tag so each slot has its own modifier source
 	UPROPERTY(Transient)
 	TMap<FGameplayTag, TObjectPtr<UObject>> EquipSlotSources;
+
+	uint32 ValuesRevision = 0;
+	uint32 ModsRevision = 0;
+	uint32 TurnEffectsRevision = 0;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/CombatCore.h"
+
+#include <atomic>
+
+struct FCombatAIPlannerSettings
+{
+	// Turns looked ahead (everyone's turns, not rounds). Iterative deepening stops earlier at the time budget.
+	int32 MaxDepth = 6;
+
+	// Wall-clock search budget; depth 1 always completes so there is always a plan
+	double TimeBudgetSeconds = 0.25;
+
+	// Unit actions consider at most this many targets (closest to death first), keeps branching sane in big fights
+	int32 MaxTargetsPerAction = 6;
+};
+
+// Best first move for the acting combatant
+struct FCombatAIPlan
+{
+	// Searched combatant (core index)
+	int32 CombatantIndex = INDEX_NONE;
+
+	// Action to run (invalid tag + bPass = end the turn without acting)
+	FGameplayTag ActionTag;
+	int32 ActionSlot = INDEX_NONE;
+
+	// Core index of the target (the instigator for Self / None actions)
+	int32 TargetIndex = INDEX_NONE;
+
+	bool bPass = false;
+
+	// Expected evaluation of the plan (own team's point of view)
+	float Score = 0.f;
+
+	// Deepest fully searched depth, nodes visited and wall time
+	int32 Depth = 0;
+	int32 Nodes = 0;
+	double Seconds = 0.0;
+
+	bool IsValid() const { return CombatantIndex != INDEX_NONE && (bPass || ActionSlot != INDEX_NONE); }
+};
+
+/**
+ * Depth-limited expectimax over FCombatCoreState clones.
+ * - The acting combatant (and its allies) pick their best move; other teams are chance nodes
+ *   averaging over their legal moves.
+ * - Pure plain data: safe on worker threads. The live encounter launches it on the task graph at
+ *   the start of an AI turn and reads the result when its AITakeAction event comes due.
+ */
+class PRODIGYPROJECT_API FCombatAIPlanner
+{
+public:
+	// State: CombatantIndex is about to act (BeginTurn already applied, not in the turn queue or at its front).
+	// bCancel (optional) stops the search early; the last complete depth is returned.
+	static FCombatAIPlan Plan(const FCombatCoreState& State, int32 CombatantIndex, const FCombatAIPlannerSettings& Settings,
+	                          const std::atomic<bool>* bCancel = nullptr);
+
+	// Own-team advantage: alive combatants and remaining health fraction, +/- a large bonus once the fight is decided
+	static float Evaluate(const FCombatCoreState& State, int32 Team);
+};
@@ -0,0 +1,169 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "CombatAIUtility.generated.h"
+
+class UActionDefinition;
+
+UENUM(BlueprintType)
+enum class ECombatAIConsiderationInput : uint8
+{
+	// Per target
+	TargetHealthFraction UMETA(DisplayName="Target Health %"),
+	TargetDistance       UMETA(DisplayName="Target Distance"),
+	TargetHasStatus      UMETA(DisplayName="Target Has Status (Tag)"),
+	TargetIsEnemy        UMETA(DisplayName="Target Is Enemy"),
+
+	// Per action (same for every target)
+	SelfHealthFraction   UMETA(DisplayName="Self Health %"),
+	SelfHasStatus        UMETA(DisplayName="Self Has Status (Tag)"),
+	APRemaining          UMETA(DisplayName="AP Left After Cost"),
+	CooldownReady        UMETA(DisplayName="Cooldown Ready (Tag, empty = this action)"),
+};
+
+UENUM(BlueprintType)
+enum class ECombatAIResponseCurve : uint8
+{
+	Linear,
+	Inverse,
+	Quadratic,
+	InverseQuadratic,
+
+	// 1 at or above 0.5 (after normalizing), else 0
+	Step,
+};
+
+USTRUCT(BlueprintType)
+struct FCombatAIConsideration
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	ECombatAIConsiderationInput Input = ECombatAIConsiderationInput::TargetHealthFraction;
+
+	// Status tag (HasStatus inputs) or action tag (CooldownReady)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	FGameplayTag Tag;
+
+	// Raw input range mapped to 0..1 (clamped) before the curve
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	float InputMin = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	float InputMax = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	ECombatAIResponseCurve Curve = ECombatAIResponseCurve::Linear;
+
+	// Lowest factor this consideration can give (0 = can veto the pair, 0.5 = at most halves it)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI", meta=(ClampMin="0.0", ClampMax="1.0"))
+	float MinFactor = 0.f;
+
+	bool IsPerTarget() const { return Input <= ECombatAIConsiderationInput::TargetIsEnemy; }
+};
+
+USTRUCT(BlueprintType)
+struct FCombatAIActionUtility
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	TObjectPtr<UActionDefinition> Action = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI", meta=(ClampMin="0.0"))
+	float Weight = 1.f;
+
+	// Unit actions: pick among allies (self included) instead of enemies
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	bool bTargetsAllies = false;
+
+	// Multiplied together (with Weight) per (action, target) pair
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	TArray<FCombatAIConsideration> Considerations;
+};
+
+/**
+ * Utility AI for one kind of combatant (assigned on UActionComponent::AIUtilityProfile).
+ * Every (action, target) pair is scored; the best one above MinScoreToAct is used,
+ * otherwise the encounter falls back to the planner / basic attack.
+ */
+UCLASS(BlueprintType)
+class PRODIGYPROJECT_API UCombatAIUtilityProfile : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
+	TArray<FCombatAIActionUtility> Actions;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI", meta=(ClampMin="0.0"))
+	float MinScoreToAct = 0.01f;
+};
+
+// Everything the scorer reads, gathered once on the game thread. Target arrays are parallel (living combatants only).
+struct FCombatAIUtilityInputs
+{
+	// Acting combatant
+	int32 Team = 0;
+	int32 SelfTarget = INDEX_NONE;
+	float HealthFraction = 1.f;
+	float AP = 0.f;
+	FGameplayTagContainer OwnedTags;
+
+	// Turn cooldowns still running (action tag -> turns)
+	TMap<FGameplayTag, int32> CooldownTurns;
+
+	TArray<FName> TargetNames;
+	TArray<int32> TargetTeams;
+	TArray<float> TargetHealthFractions;
+	TArray<float> TargetDistances;
+	TArray<FGameplayTagContainer> TargetTags;
+
+	// Clear sight line from the acting combatant (visibility grid lookup at gather time)
+	TBitArray<> TargetInSight;
+
+	// Optional live QueryAction verdict per (profile action, target), row-major like the matrix; empty = not checked
+	TBitArray<> Usable;
+
+	int32 NumTargets() const { return TargetTeams.Num(); }
+
+	int32 AddTarget(FName Name, int32 InTeam, float InHealthFraction, float InDistance, const FGameplayTagContainer& InTags, bool bInSight = true);
+};
+
+// Score for every (profile action, target) pair, row-major: Scores[Action * NumTargets + Target]
+struct PRODIGYPROJECT_API FCombatAIUtilityMatrix
+{
+	int32 NumActions = 0;
+	int32 NumTargets = 0;
+
+	TArray<float> Scores;
+
+	// Per action: known, off cooldown, affordable (range / sight are per target: out of reach pairs score 0)
+	TBitArray<> Ready;
+
+	TArray<FGameplayTag> ActionTags;
+	TArray<FName> TargetNames;
+
+	int32 BestAction = INDEX_NONE;
+	int32 BestTarget = INDEX_NONE;
+	float BestScore = 0.f;
+
+	float Get(int32 Action, int32 Target) const { return Scores[Action * NumTargets + Target]; }
+
+	bool HasDecision() const { return BestAction != INDEX_NONE; }
+
+	// Table: one line per action, one column per target
+	void Dump(TArray<FString>& OutLines) const;
+};
+
+namespace ProdigyCombatAIUtility
+{
+	// Column-wise pass over contiguous arrays: each consideration is evaluated for all targets at once,
+	// then multiplied into the action's row.
+	PRODIGYPROJECT_API void Score(const UCombatAIUtilityProfile& Profile, const FCombatAIUtilityInputs& In, FCombatAIUtilityMatrix& Out);
+
+	// Prodigy.Combat.AI.LogUtility
+	PRODIGYPROJECT_API bool ShouldLogMatrix();
+}
@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatAggroSubsystem.generated.h"
+
+class ACombatantCharacterBase;
+
+/**
+ * Every ACombatantCharacterBase in the world, bucketed in a uniform XY grid.
+ * - Entries move between cells from their root component's TransformUpdated (no per-frame scan).
+ * - Radius queries only visit the cells the circle overlaps, link groups have their own index.
+ * - Used for combat start (who else joins) and exploration aggro (who starts a fight on their own).
+ */
+UCLASS()
+class PRODIGYPROJECT_API UCombatAggroSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Grid cell edge (uu). Around the common query radius keeps a query at 2x2 - 3x3 cells.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Aggro", meta=(ClampMin="100"))
+	float CellSize = 1000.f;
+
+	// Faction mates of a pulled combatant within this distance of it join the fight too
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Aggro", meta=(ClampMin="0"))
+	float PullRadius = 1500.f;
+
+	// Seconds between exploration aggro checks (0 = every frame)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Aggro", meta=(ClampMin="0"))
+	float AggroCheckInterval = 0.25f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Aggro")
+	bool bExplorationAggro = true;
+
+	void Register(ACombatantCharacterBase* Combatant);
+	void Unregister(ACombatantCharacterBase* Combatant);
+
+	// Registered combatants within Radius of Center (any state). Returns how many were added.
+	int32 QueryRadius(const FVector& Center, float Radius, TArray<ACombatantCharacterBase*>& Out) const;
+
+	// Registered combatants farther than Radius (2D) from every center. Cells no circle reaches are taken whole.
+	int32 QueryOutside(TConstArrayView<FVector> Centers, float Radius, TArray<ACombatantCharacterBase*>& Out) const;
+
+	// Participants for a fight Instigator starts on Target: both of them, Target's faction within PullRadius
+	// (chained through everyone pulled) and whole link groups of anyone pulled. Skips the dead and anyone already fighting.
+	void GatherCombatPull(AActor* Instigator, AActor* Target, TArray<AActor*>& OutParticipants) const;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<ACombatantCharacterBase> Actor;
+		FVector Location = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+
+		// Position inside Cells[Cell] (swap-removal fixes it up)
+		int32 IndexInCell = INDEX_NONE;
+	};
+
+	FIntPoint ToCell(const FVector& Location) const;
+
+	void AddToCell(int32 EntryIndex);
+	void RemoveFromCell(int32 EntryIndex);
+
+	void HandleTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport);
+
+	// Alive, not fighting, not player controlled
+	bool CanBePulled(const ACombatantCharacterBase* Combatant) const;
+
+	void RunExplorationAggro();
+
+	// Sparse: freed indices are reused
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+
+	TMap<TObjectKey<AActor>, int32> EntryByActor;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// Link group -> entry indices
+	TMap<FName, TArray<int32>> LinkGroups;
+
+	// Largest AggroRadius registered (exploration query radius)
+	float MaxAggroRadius = 0.f;
+
+	float AggroCheckAccumulator = 0.f;
+};
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class APawn;
+class UWorld;
+
+struct FCombatBubbleSettings
+{
+	// Everything within this distance of a center keeps full rate
+	float Radius = 3000.f;
+
+	// Tick interval for throttled actors / components outside
+	float ThrottledTickInterval = 0.5f;
+};
+
+/**
+ * While fights run, the rest of the level slows down.
+ * - Outside the bubble: movement, AI logic and status timers are suspended, the rest of the ticking gets a long interval.
+ * - Who is outside comes from the aggro grid (combatants) and UCombatBubbleSubsystem (other pawns, movers, status holders,
+ *   tagged props), so there's no world scan. Anything of those kinds spawned outside while active is throttled on spawn.
+ * - Centers are the fighters plus every player pawn (exploring players keep their surroundings alive).
+ * - Every change is recorded once with what it replaced; RestoreAll puts it all back in one pass.
+ */
+class PRODIGYPROJECT_API FCombatBubble
+{
+public:
+	// Throttles everything tracked farther than Radius from all centers (no-op while already active)
+	void Apply(UWorld* World, TConstArrayView<FVector> Centers, const FCombatBubbleSettings& InSettings);
+
+	// A fight started / someone joined while active: everything around these centers goes back to full rate
+	void ReleaseAround(TConstArrayView<FVector> Centers);
+
+	// Last fight ended: single pass over all records
+	void RestoreAll();
+
+	bool IsActive() const { return bActive; }
+	int32 NumRecords() const { return Records.Num(); }
+
+private:
+	enum class ERecordKind : uint8
+	{
+		ActorTick,
+		ComponentTick,
+		Brain,
+	};
+
+	struct FRecord
+	{
+		// Where it stands (a controller's parts use its pawn)
+		TWeakObjectPtr<AActor> Anchor;
+
+		// Actor, component or brain component
+		TWeakObjectPtr<UObject> Object;
+
+		ERecordKind Kind = ERecordKind::ActorTick;
+
+		// Tick disabled (else only the interval was raised)
+		bool bSuspended = false;
+		float OldInterval = 0.f;
+	};
+
+	void ThrottleActor(AActor* Actor, AActor* Anchor);
+
+	// Pawn, its controller and brain. False if nothing needed a change.
+	bool ThrottlePawn(APawn* Pawn);
+
+	// Pawns as above, anything else on its own. False if nothing needed a change.
+	bool Throttle(AActor* Actor);
+
+	void HandleActorSpawned(AActor* Actor);
+
+	static void Restore(const FRecord& R);
+
+	FCombatBubbleSettings Settings;
+	TArray<FRecord> Records;
+	bool bActive = false;
+
+	// Everything released so far (spawns inside any of them keep full rate)
+	TArray<FVector> BubbleCenters;
+
+	TWeakObjectPtr<UWorld> BubbleWorld;
+	FDelegateHandle SpawnHandle;
+};
@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatBubbleSubsystem.generated.h"
+
+class ULevel;
+
+/**
+ * Everything besides combatants that the combat bubble slows down (combatants come from the aggro grid).
+ * - Tracked: non-combatant pawns, actors with a movement or status component, and actors tagged CombatBubble (ticking props, pickups).
+ * - Filled once at world begin play, then from spawns and streamed-in levels. Starting a fight never walks the world.
+ * - Entries are weak; destroyed actors drop out the next time the list is read.
+ */
+UCLASS()
+class PRODIGYPROJECT_API UCombatBubbleSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Opt-in for actors nothing else marks
+	static const FName BubbleTag;
+
+	static bool ShouldTrack(const AActor* Actor);
+
+	void Register(AActor* Actor);
+
+	// Live tracked actors (prunes the destroyed ones first)
+	TConstArrayView<TWeakObjectPtr<AActor>> GetActors();
+
+private:
+	void RegisterLevel(const ULevel* Level);
+
+	void HandleActorSpawned(AActor* Actor);
+	void HandleLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TSet<TObjectKey<AActor>> Known;
+
+	FDelegateHandle SpawnHandle;
+	FDelegateHandle LevelAddedHandle;
+};
@@ -0,0 +1,276 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Math/RandomStream.h"
+#include "UObject/SoftObjectPath.h"
+#include "ActionTypes.h"
+#include "AbilitySystem/CombatFormula.h"
+#include "AbilitySystem/CombatTurnQueue.h"
+#include "AbilitySystem/CombatVisibilityGrid.h"
+
+class AActor;
+class UActionDefinition;
+class UAttributeSetDataAsset;
+struct FCombatantSnapshot;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCombatCore, Log, All);
+
+/**
+ * Plain-data combat rules.
+ * - No UObjects, no world, no timers: everything here is safe to run on worker threads.
+ * - UCombatSubsystem drives live fights through these rules; FCombatSimulator runs them headless.
+ */
+
+enum class ECombatCoreEffectKind : uint8
+{
+	// Signed delta on an attribute (covers DealDamage + ModifyAttribute)
+	ModifyAttribute,
+
+	// Status tag with a turn duration (second durations are wall-clock and never simulated)
+	ApplyStatus,
+
+	// Cue / Blueprint effects: live path only, ignored headless
+	Opaque,
+};
+
+struct FCombatCoreEffect
+{
+	ECombatCoreEffectKind Kind = ECombatCoreEffectKind::Opaque;
+
+	// Attribute (ModifyAttribute) or status (ApplyStatus)
+	FGameplayTag Tag;
+
+	float Delta = 0.f;
+	int32 Turns = 0;
+
+	bool bTargetsInstigator = false;
+	bool bClampMinZero = false;
+
+	// Optional cap (Current clamped to this attribute's Current value, same as UActionEffect_ModifyAttribute)
+	FGameplayTag ClampMaxTag;
+
+	// Replaces Delta when valid (evaluated against instigator + action target); damage formulas are negated, floored at 0
+	FCombatFormulaProgram Formula;
+	bool bFormulaIsDamage = false;
+};
+
+struct FCombatCoreAction
+{
+	FGameplayTag ActionTag;
+	EActionTargetingMode TargetingMode = EActionTargetingMode::Unit;
+
+	int32 APCost = 0;
+	int32 CooldownTurns = 0;
+	bool bUsableInCombat = true;
+
+	float MinRange = 0.f;
+	float MaxRange = 0.f;
+	bool bRequiresLineOfSight = false;
+
+	FGameplayTagContainer RequiredTags;
+	FGameplayTagContainer BlockedTags;
+
+	TArray<FCombatCoreEffect> Effects;
+
+	// Hits everyone inside instead of the target (resolved from combatant positions)
+	FActionAreaOfEffect Area;
+
+	// Every effect lands once per impact
+	int32 NumImpacts = 1;
+
+	// False when the headless rules can't reproduce it (e.g. a status lasting seconds):
+	// QueryAction refuses it, so the simulator and the planner never pick it
+	bool bSimulatable = true;
+
+	// Source asset (replays reload it so balance changes can be A/B'd on the same fight)
+	FSoftObjectPath Definition;
+
+	// Game thread only (reads the instanced effect objects)
+	static FCombatCoreAction FromDefinition(const UActionDefinition& Def);
+};
+
+struct FCombatCoreAttribute
+{
+	FGameplayTag Tag;
+
+	// Runtime value (Health, AP...)
+	float Current = 0.f;
+
+	// Base + mods at snapshot time (MaxHealth, MaxAP...)
+	float Final = 0.f;
+};
+
+struct FCombatCoreTurnEffect
+{
+	FGameplayTag EffectTag;
+	FGameplayTag AttributeTag;
+	float DeltaPerTurn = 0.f;
+	int32 TurnsRemaining = 0;
+};
+
+// Turn duration only: SecondsRemaining of a live status isn't carried (it runs on wall-clock time)
+struct FCombatCoreStatus
+{
+	FGameplayTag Tag;
+	int32 TurnsRemaining = 0;
+};
+
+struct FCombatCoreCombatant
+{
+	FName DebugName;
+	int32 Team = 0;
+
+	// World position when built from a live fight; asset-built combatants have none (range / sight not checked)
+	FVector Location = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	float Radius = 0.f;
+	bool bHasLocation = false;
+
+	TArray<FCombatCoreAttribute> Attributes;
+
+	// (Current, Max) pairs clamped after every change, mirrors UAttributeSetDataAsset::ResourcePairs
+	TArray<TPair<FGameplayTag, FGameplayTag>> ResourcePairs;
+
+	// Indices into FCombatCoreState::Actions, with a parallel turn cooldown per slot
+	TArray<int32> ActionIndices;
+	TArray<int32> CooldownTurns;
+
+	TArray<FCombatCoreTurnEffect> TurnEffects;
+	TArray<FCombatCoreStatus> Statuses;
+
+	FCombatCoreAttribute* FindAttribute(const FGameplayTag& Tag);
+	const FCombatCoreAttribute* FindAttribute(const FGameplayTag& Tag) const;
+
+	float GetCurrent(const FGameplayTag& Tag) const;
+	float GetFinal(const FGameplayTag& Tag) const;
+
+	bool HasStatus(const FGameplayTag& Tag) const;
+	void GetOwnedTags(FGameplayTagContainer& OutTags) const;
+
+	bool IsAlive() const;
+};
+
+// Minimal per-participant view used by the turn sequencing rules.
+// Live fights fill it from actors, headless fights from FCombatCoreCombatant.
+struct FCombatCoreRosterEntry
+{
+	int32 Team = 0;
+	bool bAlive = false;
+};
+
+struct FCombatCoreState
+{
+	// Immutable action library, shared by every state cloned from the same template
+	TSharedPtr<const TArray<FCombatCoreAction>, ESPMode::ThreadSafe> Actions;
+
+	TArray<FCombatCoreCombatant> Combatants;
+
+	int32 CurrentIndex = INDEX_NONE;
+	int32 TurnNumber = 0;
+
+	// Initiative order (ids = combatant indices). Seeded on the first RunToCompletion if empty.
+	FCombatTurnQueue TurnQueue;
+	double TurnClock = 0.0;
+
+	FRandomStream Rng;
+
+	// Live fights only: the encounter's sight lines (immutable, safe to share with workers)
+	TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe> Visibility;
+
+	const FCombatCoreAction* GetAction(int32 CombatantIndex, int32 Slot) const;
+	int32 FindActionSlot(int32 CombatantIndex, const FGameplayTag& ActionTag) const;
+
+	void BuildRoster(TArray<FCombatCoreRosterEntry>& OutRoster) const;
+};
+
+struct FCombatCoreOutcome
+{
+	// INDEX_NONE = draw (turn limit)
+	int32 WinningTeam = INDEX_NONE;
+	int32 Turns = 0;
+};
+
+namespace ProdigyCombatCore
+{
+	// --- Shared effect math (live effects call this too) ---
+
+	// Old + Delta, then optional min-zero and max clamps. Returns the new value.
+	float ResolveModifiedValue(float OldValue, float Delta, bool bClampMinZero, bool bHasMax, float MaxValue);
+
+	// --- Shared turn sequencing (live subsystem calls this too) ---
+
+	// Speed used when a combatant has no Attr.Speed
+	constexpr float DefaultSpeed = 100.f;
+
+	// Turn-clock time between two turns of the same combatant.
+	// Speed 100 = 1.0; Status.Hasted halves the wait, Status.Slowed doubles it.
+	double ComputeTurnDelay(float Speed, bool bHasted, bool bSlowed);
+
+	double GetTurnDelay(const FCombatCoreCombatant& C);
+
+	// Flat distance against an action's range (MaxRange 0 = unlimited)
+	bool IsInRange(float Distance2D, float MinRange, float MaxRange);
+
+	// First living participant on another team; falls back to any other living participant.
+	int32 SelectAITarget(TArrayView<const FCombatCoreRosterEntry> Roster, int32 SelfIndex);
+
+	// Team that is the only one left alive. INDEX_NONE while 2+ teams are standing (or nobody is).
+	int32 GetWinningTeam(TArrayView<const FCombatCoreRosterEntry> Roster);
+
+	// True once fewer than two teams are standing
+	bool IsCombatOver(TArrayView<const FCombatCoreRosterEntry> Roster);
+
+	// Tag used by the default AI policy (live + headless)
+	FGameplayTag GetDefaultAIActionTag();
+
+	// --- Headless rules on FCombatCoreState ---
+
+	// AP refresh, cooldown decrement, turn effects, status durations (same order as UActionComponent::OnTurnBegan)
+	void BeginTurn(FCombatCoreState& State, int32 CombatantIndex);
+
+	EActionFailReason QueryAction(const FCombatCoreState& State, int32 CombatantIndex, int32 Slot, int32 TargetIndex);
+
+	// Area hits from combatant positions, same rules as UCombatEncounter::QueryArea. False without positions.
+	bool ResolveAreaTargets(const FCombatCoreState& State, int32 CombatantIndex, const FCombatCoreAction& Action, int32 TargetIndex, TArray<int32>& Out);
+
+	// AreaTargets: hits the live fight resolved (replays carry no positions); null = ResolveAreaTargets
+	bool ExecuteAction(FCombatCoreState& State, int32 CombatantIndex, int32 Slot, int32 TargetIndex, const TArray<int32>* AreaTargets = nullptr);
+
+	// Default AI: basic attack on SelectAITarget, pass if blocked
+	void RunAITurn(FCombatCoreState& State, int32 CombatantIndex);
+
+	// FirstToAct at clock 0, everyone else after one turn delay (slot order breaks ties)
+	void SeedTurnQueue(FCombatCoreState& State, int32 FirstToAct);
+
+	// Runs turns until one team is left or MaxTurns is hit
+	FCombatCoreOutcome RunToCompletion(FCombatCoreState& State, int32 MaxTurns);
+
+	// --- Builders (game thread only) ---
+
+	// Teams: explicit ACombatantCharacterBase::CombatTeam, else one per AggroFaction, else UnalignedTeam
+	constexpr int32 PlayerTeam = 0;
+	constexpr int32 UnalignedTeam = 1;
+
+	// Stable across runs and machines (replays store it); never collides with a hand-set team
+	int32 GetFactionTeam(FName Faction);
+
+	int32 ResolveTeamForActor(const AActor* Actor);
+
+	// Adds (or reuses) the action in the library and returns its index
+	int32 AddActionToLibrary(TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, const UActionDefinition* Def);
+
+	bool MakeCombatantFromActor(AActor* Actor, TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, FCombatCoreCombatant& Out);
+
+	// Same as MakeCombatantFromActor, from a turn snapshot (no component reads)
+	bool MakeCombatantFromSnapshot(const FCombatantSnapshot& Snapshot, TArray<FCombatCoreAction>& Library, TMap<const UActionDefinition*, int32>& IndexByDef, FCombatCoreCombatant& Out);
+
+	bool MakeCombatantFromAssets(
+		FName DebugName,
+		int32 Team,
+		const UAttributeSetDataAsset* AttributeSet,
+		TConstArrayView<TObjectPtr<UActionDefinition>> Actions,
+		TArray<FCombatCoreAction>& Library,
+		TMap<const UActionDefinition*, int32>& IndexByDef,
+		FCombatCoreCombatant& Out);
+}
@@ -0,0 +1,295 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "AbilitySystem/ActionExecutionSubsystem.h"
+#include "AbilitySystem/CombatAIPlanner.h"
+#include "AbilitySystem/CombatTurnQueue.h"
+#include "AbilitySystem/CombatReplay.h"
+#include "AbilitySystem/CombatScheduler.h"
+#include "AbilitySystem/CombatSnapshot.h"
+#include "AbilitySystem/CombatTimeline.h"
+#include "AbilitySystem/CombatVisibilityGrid.h"
+#include "AbilitySystem/CombatantTable.h"
+#include "Tasks/Task.h"
+#include "CombatEncounter.generated.h"
+
+class UCombatSubsystem;
+class UAttributesComponent;
+class UCombatMovementComponent;
+class UStatusComponent;
+struct FActionContext;
+struct FCombatCoreState;
+struct FCombatCoreRosterEntry;
+enum class ECombatLogKind : uint8;
+
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FCombatEncounterHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Combat")
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+	void Reset() { Id = INDEX_NONE; }
+
+	bool operator==(const FCombatEncounterHandle& Other) const { return Id == Other.Id; }
+	bool operator!=(const FCombatEncounterHandle& Other) const { return Id != Other.Id; }
+
+	friend uint32 GetTypeHash(const FCombatEncounterHandle& H) { return ::GetTypeHash(H.Id); }
+};
+
+/**
+ * One running fight: its own participants and initiative queue.
+ * - Created / owned by UCombatSubsystem (Outer), several can run in the same world.
+ * - Participants' OnActionExecuted is bound straight to the encounter they're in.
+ * - Delayed work (begin turn, AI act, deferred end) goes through the subsystem's FCombatScheduler.
+ */
+UCLASS(BlueprintType)
+class PRODIGYPROJECT_API UCombatEncounter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual UWorld* GetWorld() const override;
+
+	// Called by UCombatSubsystem right after creation (participants already validated)
+	bool Start(FCombatEncounterHandle InHandle, UWorld* InWorld, const TArray<AActor*>& InParticipants, AActor* FirstToAct);
+
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	void End();
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	FCombatEncounterHandle GetHandle() const { return Handle; }
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	bool IsActive() const { return bActive; }
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	AActor* GetCurrentTurnActor() const;
+
+	// True if a player-controlled pawn is still fighting here
+	bool ContainsPlayer() const;
+
+	bool ContainsActor(AActor* Actor) const { return SlotByActor.Contains(Actor); }
+
+	// Living combatants inside the area that it affects (team filter, closest first, MaxTargets). Returns how many were added.
+	int32 QueryArea(const FActionAreaQuery& Query, const FActionAreaOfEffect& Area, AActor* Instigator, TArray<AActor*>& Out) const;
+
+	const TArray<TWeakObjectPtr<AActor>>& GetParticipants() const
+	{
+		return Participants;
+	}
+
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	void AdvanceTurn(); // call after an action resolves
+
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool EndCurrentTurn(AActor* Instigator);
+
+	// Pushes a waiting combatant back in the initiative order (in turn-clock units, 1.0 = one turn at speed 100)
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool DelayTurn(AActor* Actor, float TurnTime);
+
+	// Turn-clock wait between two turns of this actor (Attr.Speed, Status.Hasted / Status.Slowed)
+	double GetTurnDelayForActor(AActor* Actor) const;
+	double GetTurnDelayForSlot(int32 Slot) const;
+
+	// Call this instead of calling BeginTurn directly (next actor is popped from the turn queue when the timer fires)
+	void ScheduleNextTurn(float DelaySeconds);
+
+	// AdvanceTurn with an explicit gap before the next turn begins
+	void AdvanceTurnAfter(float GapSeconds);
+
+	void BeginTurnForSlot(int32 Slot);
+
+	// Snapshot of this fight as plain data (headless simulation / what-if).
+	// OutCoreIndexBySlot: slot -> combatant index in OutState (INDEX_NONE if skipped).
+	bool BuildCoreState(FCombatCoreState& OutState, TArray<int32>* OutCoreIndexBySlot = nullptr) const;
+
+	// Full state in replay indices, so a wrapped replay ring can still be decoded from here on
+	void RecordReplayKeyframe();
+
+	// Next NumTurns turns (turn in progress first). Cached; only dirty combatants are re-projected.
+	const TArray<FCombatTimelineEntry>& GetTurnTimeline(int32 NumTurns);
+
+	uint32 GetTurnTimelineVersion() const { return Timeline.GetVersion(); }
+
+	// Replay recorded so far (still recording while active)
+	const FCombatReplayRecorder& GetReplayRecorder() const { return Recorder; }
+
+	// State at the start of a recent turn (0 = the turn in progress), null past the kept history.
+	// Immutable and thread safe: what-if code can keep it and read it off the game thread.
+	TSharedPtr<const FCombatSnapshot, ESPMode::ThreadSafe> GetTurnSnapshot(int32 TurnsAgo = 0) const;
+
+	// Player's turn, nobody died or joined since it began, nothing scheduled
+	bool CanRewindTurn() const;
+
+	// Undoes everything done since the current (player) turn began: attributes, mods, turn effects, statuses,
+	// cooldowns and turn order go back to the turn's snapshot. The replay is flagged incomplete.
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool RewindTurn();
+
+	// Sight lines over the fight area, null until the async build at Start is done
+	const FCombatVisibilityGrid* GetVisibilityGrid() const { return VisibilityGrid.Get(); }
+
+	UFUNCTION()
+	void HandleActionExecuted(FGameplayTag ActionTag, const FActionContext& Context);
+
+	UFUNCTION()
+	void HandleParticipantDestroyed(AActor* DestroyedActor);
+
+private:
+
+	friend class UCombatSubsystem;
+
+	UCombatSubsystem* GetCombatSubsystem() const;
+
+	// Adds a combatant to the running fight; it acts one turn delay after the current turn clock.
+	// Goes through UCombatSubsystem::JoinEncounter so the actor -> encounter map stays in sync.
+	bool AddCombatant(AActor* Actor);
+
+	bool bTurnBeginScheduled = false;
+
+	void CancelScheduledBeginTurn();
+	void HandleScheduledBeginTurn();
+
+	// Zero-delay begin turn. Instant playback chains whole AI turns here in one frame (looped, capped per frame).
+	void RunTurnsNow();
+
+	bool bRunningTurnsNow = false;
+	bool bMoreTurnsNow = false;
+
+	static constexpr int32 MaxTurnsPerFrame = 256;
+
+	// Dispatched by UCombatSubsystem when one of our events comes due
+	void HandleScheduledEvent(const FCombatScheduledEvent& Event);
+
+	// AI act for Slot (must still be the current turn): utility profile, else the lookahead plan if ready,
+	// else the default attack on TargetSlot.
+	// Passes the turn if it can't act.
+	void TakeAIAction(int32 Slot, int32 TargetSlot);
+
+	// Snapshots the fight and searches Slot's move on the task graph; TakeAIAction picks the result up
+	void RequestAIPlan(int32 Slot, float BudgetSeconds);
+
+	// Finished plan for Slot (a late plan is cancelled and dropped, never waited on)
+	bool ConsumeAIPlan(int32 Slot, FCombatAIPlan& OutPlan, int32& OutTargetSlot);
+	void CancelAIPlan();
+
+	// Scores Slot's UCombatAIUtilityProfile against everyone in the fight; false = no profile / nothing above threshold
+	bool ChooseUtilityAction(int32 Slot, FGameplayTag& OutActionTag, int32& OutTargetSlot) const;
+
+	// ---- Team phase (UCombatSubsystem::bTeamPhaseAI) ----
+
+	// Slot's turn began: pulls every queued AI teammate into the same phase (their turns begin now too)
+	void BeginTeamPhase(int32 Slot);
+
+	// Next member acts. Phase order is initiative order and each action commits before the next,
+	// so results are the same as sequential turns, just without the waits.
+	void HandleTeamPhaseAct();
+	void TakeTeamPhaseAction(int32 Slot);
+
+	// Re-queues every member after its own turn delay and moves on
+	void EndTeamPhase();
+
+	// Every member acted and every action played out
+	bool IsTeamPhaseDone() const { return !TeamPhaseSlots.IsValidIndex(TeamPhaseNext) && TeamPhaseHandles.Num() == 0; }
+
+	bool IsInTeamPhase() const { return TeamPhaseSlots.Num() > 0; }
+
+	// Turn begin: copy-on-write snapshot sharing every unchanged section with the previous one
+	void CaptureTurnSnapshot(int32 Slot);
+
+	void BuildVisibilityGrid();
+	void HandleVisibilityGridBuilt(TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe> Grid);
+
+	// Live view of Combatants (index = slot) for the shared ProdigyCombatCore sequencing rules
+	void BuildRoster(TArray<FCombatCoreRosterEntry>& OutRoster) const;
+
+	bool IsSlotAlive(int32 Slot) const;
+
+	int32 AddSlot(AActor* Actor);
+	void RemoveSlot(int32 Slot);
+	void BindParticipant(int32 Slot);
+
+	void HandleAttributeChangedNative(UAttributesComponent* Attributes, FGameplayTag Tag, float NewValue, float Delta, AActor* Instigator);
+	void HandleDiedNative(UAttributesComponent* Attributes, AActor* Killer, FGameplayTag ResourceTag);
+
+	// Death / destroy: drops the slot from the fight (O(1) roster, O(log n) queue) and ends the fight if decided
+	void RemoveFromFight(int32 Slot);
+	void HandleStatusChangedNative(UStatusComponent* Status, FGameplayTag Tag, bool bAdded);
+
+	void HandleMoveStartedNative(UCombatMovementComponent* Mover, int32 APCost);
+
+	// Executor: an execution ran out; picks up the ones whose OnActionExecuted never came (source gone) + team phase acts
+	void HandleExecutionCompletedNative(FActionExecutionHandle ExecutionHandle, bool bFinished);
+
+	void MarkTimelineDirty(AActor* Actor);
+
+	// Player combat log (UCombatSubsystem::GetCombatLog)
+	void AddLog(ECombatLogKind Kind, const AActor* Source, const AActor* Target, FName Tag = NAME_None, float Value = 0.f) const;
+
+	// Replay index of a slot (INDEX_NONE for joiners / not recording)
+	int32 GetReplayIndex(int32 Slot) const { return ReplayIndexBySlot.IsValidIndex(Slot) ? ReplayIndexBySlot[Slot] : INDEX_NONE; }
+
+	FCombatEncounterHandle Handle;
+	TWeakObjectPtr<UWorld> World;
+
+	bool bActive = false;
+
+	// A death decided the fight; no more turns, End runs after the cue window
+	bool bEndPending = false;
+
+	// Slot whose turn it is (or who was announced first, before the first BeginTurn)
+	int32 CurrentSlot = INDEX_NONE;
+
+	// Ready time of the current turn
+	double TurnClock = 0.0;
+
+	FCombatTurnQueue TurnQueue;
+
+	// One slot per combatant for the whole encounter; the slot is the turn queue id and never shifts
+	FCombatantTable Combatants;
+	TMap<TWeakObjectPtr<AActor>, int32> SlotByActor;
+
+	// Living combatants (unordered, swap-removed); ParticipantSlots is parallel
+	TArray<TWeakObjectPtr<AActor>> Participants;
+	TArray<int32> ParticipantSlots;
+
+	// Seeded per encounter and stored in the replay
+	FRandomStream Rng;
+
+	FCombatReplayRecorder Recorder;
+	TArray<int32> ReplayIndexBySlot;
+
+	// Lookahead search for the current AI turn (worker thread)
+	UE::Tasks::TTask<FCombatAIPlan> PendingAIPlan;
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> PendingAIPlanCancel;
+	int32 PendingAIPlanSlot = INDEX_NONE;
+
+	// Snapshot core index -> slot for the pending plan
+	TArray<int32> PendingAIPlanSlotByCore;
+
+	// AI action still playing out (UActionExecutionSubsystem); its OnActionExecuted moves the turn on (its completion does, if that never comes)
+	FActionExecutionHandle PendingActionHandle;
+
+	FCombatTimeline Timeline;
+
+	// Running team phase: members in acting order, next to act, gap between acts
+	TArray<int32> TeamPhaseSlots;
+	int32 TeamPhaseNext = 0;
+	float TeamPhaseStagger = 0.f;
+
+	// Members' actions still playing out; the phase ends when the last one completes
+	TArray<FActionExecutionHandle> TeamPhaseHandles;
+
+	// Newest last, capped at UCombatSubsystem::TurnSnapshotHistory
+	TArray<TSharedPtr<const FCombatSnapshot, ESPMode::ThreadSafe>> TurnSnapshots;
+	int32 TurnsBegun = 0;
+
+	TSharedPtr<FCombatVisibilityGridBuilder> VisibilityBuilder;
+	TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe> VisibilityGrid;
+};
@@ -0,0 +1,112 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "CombatFormula.generated.h"
+
+class AActor;
+struct FActionEffectBatch;
+struct FCombatCoreCombatant;
+
+/**
+ * Damage / heal amounts written as expressions instead of flat numbers, e.g.
+ *   Attr.Strength * 1.5 - Target.Attr.Armor
+ *   max(1, Attr.Intellect * 2 - current(Target.Attr.Health) * 0.1)
+ * - Attribute references: "Attr.X" / "Source.Attr.X" = instigator, "Target.Attr.X" = target. They read the
+ *   final value (base + mods); current(...) reads the runtime value instead (Health, AP).
+ * - Operators + - * / and unary -, parentheses, min(a,b) max(a,b) clamp(x,lo,hi) abs(x) floor(x).
+ * - Compiled once into FCombatFormulaProgram: register bytecode, constants folded, every attribute reference
+ *   pre-resolved to a slot. Evaluating is a flat loop over the code with no lookups.
+ */
+
+enum class ECombatFormulaOp : uint8
+{
+	Const,  // R[Dst] = Constants[Index]
+	Load,   // R[Dst] = SlotValues[Index]
+	Add,    // R[Dst] = R[A] + R[B]
+	Sub,
+	Mul,
+	Div,    // x / 0 = 0
+	Min,
+	Max,
+	Clamp,  // R[Dst] = clamp(R[Dst], R[A], R[B])
+	Neg,    // R[Dst] = -R[A]
+	Abs,
+	Floor,
+};
+
+struct FCombatFormulaInstr
+{
+	ECombatFormulaOp Op = ECombatFormulaOp::Const;
+	uint8 Dst = 0;
+	uint8 A = 0;
+	uint8 B = 0;
+	uint16 Index = 0;
+};
+
+// One attribute read by the formula
+struct FCombatFormulaSlot
+{
+	FGameplayTag Tag;
+	bool bTarget = false;
+	bool bCurrent = false;
+
+	bool operator==(const FCombatFormulaSlot& Other) const
+	{
+		return Tag == Other.Tag && bTarget == Other.bTarget && bCurrent == Other.bCurrent;
+	}
+};
+
+// Compiled form (plain data, safe to copy into headless states and evaluate on workers)
+struct PRODIGYPROJECT_API FCombatFormulaProgram
+{
+	static constexpr int32 MaxRegisters = 16;
+
+	TArray<FCombatFormulaInstr> Code;
+	TArray<float> Constants;
+	TArray<FCombatFormulaSlot> Slots;
+	int32 NumRegisters = 0;
+
+	bool IsValid() const { return Code.Num() > 0; }
+	bool ReadsTarget() const { return Slots.ContainsByPredicate([](const FCombatFormulaSlot& S) { return S.bTarget; }); }
+
+	// SlotValues[i] = value of Slots[i]
+	float Evaluate(TConstArrayView<float> SlotValues) const;
+
+	// Headless: straight from combat core combatants
+	float EvaluateCore(const FCombatCoreCombatant& Source, const FCombatCoreCombatant* Target) const;
+};
+
+namespace ProdigyCombatFormula
+{
+	// False (with a readable error) on syntax errors, unknown functions / tags, or too deep an expression
+	bool Compile(const FString& Expression, FCombatFormulaProgram& OutProgram, FString& OutError);
+}
+
+// Authored expression + its compiled program, for effect properties
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FCombatFormula
+{
+	GENERATED_BODY()
+
+	// Empty = the effect's flat value is used
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Formula")
+	FString Expression;
+
+	bool IsSet() const { return !Expression.IsEmpty(); }
+
+	// Compiles now (PostLoad / edits); errors are logged against Owner
+	void Compile(const UObject* Owner) const;
+
+	// Compiled on first use if nothing did it yet; invalid when empty or broken
+	const FCombatFormulaProgram& GetProgram(const UObject* Owner) const;
+
+	// Live: one value per target into OutValues (same size as Targets). Source slots are read once, target slots
+	// per target, through the batch (so pending writes of the same action are seen).
+	void EvaluateLive(const UObject* Owner, AActor* Source, TConstArrayView<AActor*> Targets, const FActionEffectBatch& Batch, TArrayView<float> OutValues) const;
+
+private:
+	mutable FCombatFormulaProgram Program;
+	mutable FString CompiledExpression;
+	mutable bool bCompiled = false;
+};
@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+enum class ECombatLogKind : uint8
+{
+	EncounterStart,
+	EncounterEnd,
+	TurnBegin,
+	Action,
+	Damage,
+	Heal,
+	StatusApplied,
+	StatusRemoved,
+	Death,
+};
+
+// One record, fixed size and pointer free; actors / tags are indices into FCombatLog's name table
+struct FCombatLogEntry
+{
+	// Seconds since the log's first entry
+	float Time = 0.f;
+
+	int32 EncounterId = INDEX_NONE;
+	int32 Source = INDEX_NONE;
+	int32 Target = INDEX_NONE;
+
+	// Action / status / resource tag
+	int32 Tag = INDEX_NONE;
+
+	// Damage / heal amount, turn clock, winning team
+	float Value = 0.f;
+
+	ECombatLogKind Kind = ECombatLogKind::Action;
+};
+
+static_assert(sizeof(FCombatLogEntry) <= 32, "FCombatLogEntry is meant to stay small");
+
+/**
+ * Session-wide player combat log.
+ * - Entries go into a ring that grows by doubling up to MaxEntries, then overwrites the oldest.
+ * - Recording never formats text; FormatEntry is only called for rows a viewer actually shows.
+ * - Entries are addressed by sequence number (count of entries ever added), stable while older ones drop out.
+ */
+class PRODIGYPROJECT_API FCombatLog
+{
+public:
+	void SetMaxEntries(int32 InMaxEntries);
+
+	void Add(ECombatLogKind Kind, int32 EncounterId, const AActor* Source, const AActor* Target, FName Tag = NAME_None, float Value = 0.f);
+
+	void Reset();
+
+	int32 Num() const { return Count; }
+
+	// [GetFirstSequence, GetEndSequence) are still in the ring
+	uint64 GetFirstSequence() const { return TotalAdded - Count; }
+	uint64 GetEndSequence() const { return TotalAdded; }
+
+	const FCombatLogEntry* FindBySequence(uint64 Sequence) const;
+
+	FString FormatEntry(const FCombatLogEntry& Entry) const;
+
+	// Ring + name table
+	int32 GetAllocatedBytes() const;
+
+private:
+	TArray<FCombatLogEntry> Entries;
+	int32 Head = 0;   // oldest
+	int32 Count = 0;
+	uint64 TotalAdded = 0;
+	int32 MaxEntries = 128 * 1024;
+
+	double StartSeconds = 0.0;
+
+	TArray<FName> Names;
+	TMap<FName, int32> NameIndex;
+
+	int32 GetNameIndex(FName Name);
+	FString GetName(int32 Index) const;
+};
@@ -0,0 +1,132 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatMovementComponent.generated.h"
+
+/**
+ * Reachable area of one mover: a square grid centered on it, filled by a bounded Dijkstra (8-way, no corner cutting).
+ * Cells are sampled from the navmesh lazily as the search reaches them, so the work is proportional
+ * to the reachable area, not to the square.
+ */
+struct PRODIGYPROJECT_API FCombatMoveField
+{
+	enum class ECell : uint8 { Unknown, Walkable, Blocked };
+
+	FVector Center = FVector::ZeroVector;
+	float CellSize = 100.f;
+	int32 HalfCells = 0;
+
+	// Max path length (uu) the search expanded to
+	float Budget = 0.f;
+
+	int32 StartIndex = INDEX_NONE;
+
+	// Per cell (row-major, Side x Side)
+	TArray<ECell> State;
+	TArray<float> FloorZ;
+	TArray<float> Cost;
+	TArray<int32> Parent;
+
+	int32 Side() const { return HalfCells * 2 + 1; }
+	bool IsValid() const { return StartIndex != INDEX_NONE; }
+
+	int32 ToIndex(const FVector& Location) const;
+	FVector ToLocation(int32 Index) const;
+
+	// Path length to the cell holding Location, or a negative value if it can't be reached within Budget
+	float GetCostTo(const FVector& Location) const;
+
+	// Cell centers (floor height) from the start to Location, start excluded, collinear points dropped. O(path length).
+	bool ExtractPath(const FVector& Location, TArray<FVector>& OutPoints) const;
+
+	// Lays out an empty field around Start (StartFloorZ = floor under the mover)
+	void Init(const FVector& Start, float StartFloorZ, float InBudget, float InCellSize);
+
+	// Occupied ground (other combatants): never entered
+	void MarkBlocked(const FVector& Location, float Radius);
+
+	/**
+	 * Bounded Dijkstra from the start cell.
+	 * SampleFloor(point near the cell center, OutZ): floor height there, false = not walkable. Called at most once per cell.
+	 */
+	void Search(float MaxStepHeight, TFunctionRef<bool(const FVector&, float&)> SampleFloor);
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCombatMoveFinished, AActor*, Mover);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCombatMoveStartedNative, UCombatMovementComponent* /*Mover*/, int32 /*APCost*/);
+
+/**
+ * AP-costed tactical movement in combat: one reachable field per turn (cached for hover previews),
+ * a click spends AP and walks the owner along the extracted path.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class PRODIGYPROJECT_API UCombatMovementComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCombatMovementComponent();
+
+	// Distance (uu) one AP buys
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Movement", meta=(ClampMin="1"))
+	float DistancePerAP = 200.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Movement", meta=(ClampMin="10"))
+	float CellSize = 50.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Movement", meta=(ClampMin="0"))
+	float MaxStepHeight = 45.f;
+
+	// Walk speed along the path (uu/s)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Movement", meta=(ClampMin="1"))
+	float MoveSpeed = 600.f;
+
+	UPROPERTY(BlueprintAssignable, Category="Combat|Movement")
+	FOnCombatMoveFinished OnCombatMoveFinished;
+
+	// AP already spent, walk just starting (the encounter records it for replays)
+	FOnCombatMoveStartedNative OnMoveStartedNative;
+
+	// Drops the cached field (turn began, something moved)
+	void InvalidateReachable() { Field = FCombatMoveField(); }
+
+	// Builds the field for the current AP if the cache is stale. Turn begin calls it so hovering never pays for it.
+	void EnsureReachable();
+
+	// Hover preview: path + AP cost to Location. False if out of reach / not in combat.
+	UFUNCTION(BlueprintCallable, Category="Combat|Movement")
+	bool GetMovePreview(FVector Location, TArray<FVector>& OutPath, int32& OutAPCost);
+
+	// Spends the AP and starts walking. Only on the owner's turn, not while already moving.
+	UFUNCTION(BlueprintCallable, Category="Combat|Movement")
+	bool MoveTo(FVector Location);
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Movement")
+	bool IsMoving() const { return MovePath.Num() > 0; }
+
+	const FCombatMoveField& GetField() const { return Field; }
+
+protected:
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	bool CanMoveNow() const;
+	float GetCurrentAP() const;
+	int32 ToAPCost(float Distance) const;
+
+	// Cells under other living combatants of the owner's fight
+	void MarkBlockers();
+
+	FCombatMoveField Field;
+
+	// What Field was built for
+	FVector FieldOrigin = FVector::ZeroVector;
+	float FieldAP = -1.f;
+
+	// Actor Z above the nav floor (capsule half height), taken when the field is built
+	float FloorToActorZ = 0.f;
+
+	TArray<FVector> MovePath;
+	int32 MovePathNext = 0;
+};
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AbilitySystem/ActionExecutionSubsystem.h"
+#include "AbilitySystem/ActionTypes.h"
+#include "CombatProjectileSubsystem.generated.h"
+
+class UActionComponent;
+class UActionDefinition;
+class UNiagaraComponent;
+
+/**
+ * Travelling projectiles for UActionDefinition::Projectile, as plain structs.
+ * - One update for all of them per frame: analytic arc position, then one sphere sweep from the last position.
+ * - Reaching the aim point applies the action's effects through UActionComponent::ApplyActionImpact;
+ *   static geometry in the way is a miss (nobody is hit). Either way the launching execution is told it landed.
+ * - Flight FX come from a small pool of Niagara components; no actors, no movement components.
+ */
+UCLASS()
+class PRODIGYPROJECT_API UCombatProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Visuals alive at once (pooled, reused across projectiles)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Projectiles", meta=(ClampMin="0"))
+	int32 MaxVisuals = 16;
+
+	// Flight time cap, so a bad speed can't hold a turn forever
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Projectiles", meta=(ClampMin="0.1"))
+	float MaxFlightSeconds = 3.f;
+
+	// Impact of Execution launches it; effects wait for it to land
+	void Launch(UActionComponent* Source, const UActionDefinition* Def, const FActionContext& Context, TConstArrayView<AActor*> Targets,
+	            FActionExecutionHandle Execution = FActionExecutionHandle());
+
+	// Drops Execution's projectiles unresolved (it was cancelled / timed out): no effects, no notify
+	void CancelForExecution(FActionExecutionHandle Execution);
+
+	int32 NumInFlight() const { return Projectiles.Num(); }
+
+	// In flight from this actor (turn rewind waits for them)
+	bool HasProjectilesFrom(const AActor* Instigator) const;
+
+private:
+	struct FProjectile
+	{
+		TWeakObjectPtr<UActionComponent> Source;
+		TWeakObjectPtr<const UActionDefinition> Def;
+		FActionExecutionHandle Execution;
+
+		// Context, without strong pointers across frames
+		TWeakObjectPtr<AActor> Instigator;
+		TWeakObjectPtr<AActor> TargetActor;
+		FVector TargetLocation = FVector::ZeroVector;
+		FGameplayTag OptionalSubTarget;
+		TArray<TWeakObjectPtr<AActor>> Targets;
+
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		float ArcHeight = 0.f;
+		float Radius = 0.f;
+
+		float Duration = 0.f;
+		float Age = 0.f;
+		FVector LastLocation = FVector::ZeroVector;
+
+		// Into VisualPool, INDEX_NONE = unseen
+		int32 Visual = INDEX_NONE;
+	};
+
+	static FVector EvaluateArc(const FProjectile& P, float Alpha);
+
+	// Effects (or a miss) for a finished projectile, then its execution hears about it
+	void Resolve(const FProjectile& P, bool bHit);
+
+	void NotifyExecution(FActionExecutionHandle Execution) const;
+
+	int32 AcquireVisual(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation);
+	void ReleaseVisual(int32 Index);
+
+	TArray<FProjectile> Projectiles;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNiagaraComponent>> VisualPool;
+
+	// Parallel to VisualPool
+	TBitArray<> VisualInUse;
+};
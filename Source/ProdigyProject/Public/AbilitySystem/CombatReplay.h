@@ -0,0 +1,216 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+struct FCombatCoreState;
+
+/**
+ * Compact binary record of one encounter.
+ * - Snapshot of the starting FCombatCoreState + event stream (turn begins, actions, moves, attribute results, end).
+ * - Events live in a byte ring buffer: varint / zigzag ints, clock and attribute values delta-encoded.
+ * - Every KeyframeInterval records a keyframe (full state) resets the delta bases, so once the ring drops
+ *   its oldest records, decoding starts at the first keyframe that survived.
+ * - Replays run headless through ProdigyCombatCore (no timers, no world) and report where the fight diverges.
+ */
+
+enum class ECombatReplayRecord : uint8
+{
+	TurnBegin = 1,
+	Action = 2,
+	AttributeChanged = 3,
+	EncounterEnd = 4,
+
+	// Absolute clock + a full encoded state; later deltas are based on it
+	Keyframe = 5,
+
+	// Tactical move: only its AP cost is replayed (no positions headless)
+	Move = 6,
+};
+
+namespace ProdigyCombatReplay
+{
+	constexpr uint32 Magic = 0x31524350; // "PCR1"
+	constexpr uint32 Version = 2;
+
+	// Records between two keyframes
+	constexpr int32 KeyframeInterval = 256;
+
+	// Attribute values are stored in 1/100 units, turn clock in 1/1000 turns
+	constexpr float ValueScale = 100.f;
+	constexpr double ClockScale = 1000.0;
+
+	void WriteVarUInt(TArray<uint8>& Out, uint64 Value);
+	void WriteVarInt(TArray<uint8>& Out, int64 Value);
+	void WriteFloat(TArray<uint8>& Out, float Value);
+	void WriteDouble(TArray<uint8>& Out, double Value);
+}
+
+struct FCombatReplayReader
+{
+	FCombatReplayReader(TConstArrayView<uint8> InData) : Data(InData) {}
+
+	uint8 ReadByte();
+	uint64 ReadVarUInt();
+	int64 ReadVarInt();
+	float ReadFloat();
+	double ReadDouble();
+
+	// Next Len bytes (empty + error if fewer are left)
+	TConstArrayView<uint8> ReadBytes(uint64 Len);
+
+	bool IsAtEnd() const { return Pos >= Data.Num(); }
+	bool HasError() const { return bError; }
+	int32 GetRemaining() const { return Data.Num() - Pos; }
+
+private:
+	TConstArrayView<uint8> Data;
+	int32 Pos = 0;
+	bool bError = false;
+};
+
+// Fixed-capacity byte ring of length-prefixed records; oldest whole records are dropped on overflow
+class PRODIGYPROJECT_API FCombatReplayRing
+{
+public:
+	void Init(int32 InCapacityBytes);
+
+	// False if the record can never fit (nothing written)
+	bool Push(TConstArrayView<uint8> Record);
+
+	// Oldest -> newest, still length-prefixed
+	void Linearize(TArray<uint8>& Out) const;
+
+	bool HasDropped() const { return bDropped; }
+	int32 GetUsedBytes() const { return Used; }
+
+private:
+	TArray<uint8> Buffer;
+	int32 Head = 0;  // next write
+	int32 Tail = 0;  // oldest record
+	int32 Used = 0;
+	bool bDropped = false;
+
+	void WriteByte(uint8 Byte);
+	uint8 ReadAt(int32 Pos) const { return Buffer[Pos % Buffer.Num()]; }
+	void DropOldest();
+};
+
+// Self-contained repro (what gets written to disk)
+struct PRODIGYPROJECT_API FCombatReplayLog
+{
+	int32 EncounterId = INDEX_NONE;
+	uint32 Seed = 0;
+
+	// Roster changed mid-fight: events can't be fully re-simulated
+	bool bIncomplete = false;
+
+	// Ring overflowed: the oldest events are gone, replay starts at the first surviving keyframe
+	bool bTruncated = false;
+
+	// Tags, asset paths, debug names (indexed by snapshot + events)
+	TArray<FName> Names;
+
+	TArray<uint8> Snapshot;
+	TArray<uint8> Events;
+
+	int32 GetTotalBytes() const;
+
+	void Serialize(TArray<uint8>& Out) const;
+	bool Deserialize(TConstArrayView<uint8> In);
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+};
+
+class PRODIGYPROJECT_API FCombatReplayRecorder
+{
+public:
+	// Combatant indices below are indices into this snapshot
+	void Begin(const FCombatCoreState& Snapshot, uint32 Seed, int32 EncounterId, int32 RingCapacityBytes);
+
+	bool IsRecording() const { return bRecording; }
+
+	void RecordTurnBegin(int32 CombatantIndex, double TurnClock);
+	// AreaTargets: who an area cast hit (null for single-target actions)
+	void RecordAction(int32 InstigatorIndex, const FGameplayTag& ActionTag, int32 TargetIndex, const FVector& TargetLocation, const TArray<int32>* AreaTargets = nullptr);
+	void RecordAttributeChanged(int32 CombatantIndex, const FGameplayTag& AttributeTag, float NewValue);
+	void RecordMove(int32 CombatantIndex, int32 APCost);
+	void RecordEnd(int32 WinningTeam);
+
+	// Due a keyframe (record one before the next turn begins)
+	bool WantsKeyframe() const { return bRecording && RecordsSinceKeyframe >= ProdigyCombatReplay::KeyframeInterval; }
+
+	// Same combatant indices as the Begin snapshot
+	void RecordKeyframe(const FCombatCoreState& State);
+
+	// Roster changed in a way the snapshot can't express (join etc.)
+	void MarkIncomplete() { bIncomplete = true; }
+
+	void BuildLog(FCombatReplayLog& Out) const;
+
+private:
+	bool bRecording = false;
+	bool bIncomplete = false;
+
+	int32 EncounterId = INDEX_NONE;
+	uint32 Seed = 0;
+
+	TArray<FName> Names;
+	TMap<FName, int32> NameIndex;
+
+	TArray<uint8> Snapshot;
+	FCombatReplayRing Ring;
+
+	// Delta bases
+	int64 LastClock = 0;
+	TMap<uint64, int64> LastValueByKey;
+
+	int32 RecordsSinceKeyframe = 0;
+
+	TArray<uint8> Scratch;
+
+	int32 GetNameIndex(FName Name);
+
+	// Appends the state to Out; OutBases gets each attribute's value (the delta base after it)
+	void EncodeState(const FCombatCoreState& State, TArray<uint8>& Out, TMap<uint64, int64>& OutBases);
+
+	void PushScratch();
+};
+
+struct FCombatReplayResult
+{
+	bool bLoaded = false;
+
+	int32 NumRecords = 0;
+	int32 NumTurns = 0;
+	int32 NumActions = 0;
+	int32 NumFailedActions = 0;
+
+	int32 NumChecks = 0;
+	int32 NumDivergences = 0;
+	FString FirstDivergence;
+
+	int32 RecordedWinningTeam = INDEX_NONE;
+	int32 ReplayedWinningTeam = INDEX_NONE;
+
+	double Seconds = 0.0;
+
+	FString ToString() const;
+};
+
+namespace ProdigyCombatReplay
+{
+	// Game thread (reloads action definitions by path, so current balance data is used).
+	// The start snapshot, or the first surviving keyframe of a truncated log.
+	bool DecodeSnapshot(const FCombatReplayLog& Log, FCombatCoreState& OutState);
+
+	// Decode + ReplayFrom
+	FCombatReplayResult Replay(const FCombatReplayLog& Log);
+
+	// Re-runs the event stream at full speed from an already decoded start state (thread-safe, no UObjects)
+	// and compares attribute results against the recording
+	FCombatReplayResult ReplayFrom(const FCombatReplayLog& Log, FCombatCoreState State);
+
+	FString GetDefaultReplayDir();
+}
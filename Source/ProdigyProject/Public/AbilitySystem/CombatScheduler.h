@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ECombatEventType : uint8
+{
+	// Pop the next combatant from the encounter's turn queue and start its turn
+	BeginTurn,
+
+	// AI combatant (Slot) acts on TargetSlot
+	AITakeAction,
+
+	// Next AI of the running team phase acts (chained, one stagger apart)
+	TeamPhaseAct,
+
+	// Deferred End once a death decided the fight (cue window: killing-blow cues play before End runs)
+	EndCombat,
+
+	Count
+};
+
+const TCHAR* LexToString(ECombatEventType Type);
+
+struct FCombatScheduledEvent
+{
+	// World time (seconds) the event becomes due
+	double Time = 0.0;
+
+	// Schedule order; breaks Time ties and identifies the live event for a key
+	uint32 Sequence = 0;
+
+	int32 EncounterId = INDEX_NONE;
+	ECombatEventType Type = ECombatEventType::BeginTurn;
+
+	// Event payload (slots), INDEX_NONE if unused
+	int32 Slot = INDEX_NONE;
+	int32 TargetSlot = INDEX_NONE;
+
+	// Scheduled at (for the trace)
+	double ScheduledAt = 0.0;
+};
+
+/**
+ * Time-ordered queue for all combat-phase work, shared by every encounter.
+ * - Plain data: no delegates, no allocations per event once the heap has grown.
+ * - At most one pending event per (encounter, type); scheduling again replaces it.
+ * - Cancelled / replaced events stay in the heap and are skipped when popped.
+ * - Events scheduled while pumping wait for the next pump (same as "next tick" timers).
+ */
+class PRODIGYPROJECT_API FCombatScheduler
+{
+public:
+	void Reset();
+
+	void Schedule(int32 EncounterId, ECombatEventType Type, double Now, double DelaySeconds,
+	              int32 Slot = INDEX_NONE, int32 TargetSlot = INDEX_NONE);
+
+	bool Cancel(int32 EncounterId, ECombatEventType Type);
+	void CancelEncounter(int32 EncounterId);
+
+	bool IsScheduled(int32 EncounterId, ECombatEventType Type) const;
+
+	// Call once before a pump's PopDue loop
+	void BeginPump() { PumpSequenceLimit = NextSequence; }
+
+	// Next live event due at Now (scheduled before BeginPump). False when nothing is due.
+	bool PopDue(double Now, FCombatScheduledEvent& OutEvent);
+
+	bool HasPending() const { return LiveByKey.Num() > 0; }
+
+	// --- Trace ---
+
+	// Live events, in firing order
+	void GetPendingEvents(TArray<FCombatScheduledEvent>& OutEvents) const;
+
+	// Most recently fired events, oldest first (with the time they actually fired)
+	void GetRecentEvents(TArray<TPair<FCombatScheduledEvent, double>>& OutEvents) const;
+
+	// One line per pending + recent event, times relative to Now
+	void DumpTrace(double Now, TArray<FString>& OutLines) const;
+
+private:
+	TArray<FCombatScheduledEvent> Heap;
+
+	// (encounter, type) -> Sequence of the live event
+	TMap<uint64, uint32> LiveByKey;
+
+	uint32 NextSequence = 0;
+	uint32 PumpSequenceLimit = 0;
+
+	static constexpr int32 HistorySize = 64;
+	TArray<TPair<FCombatScheduledEvent, double>> History;
+	int32 HistoryHead = 0;
+
+	static uint64 MakeKey(int32 EncounterId, ECombatEventType Type)
+	{
+		return (static_cast<uint64>(static_cast<uint32>(EncounterId)) << 8) | static_cast<uint8>(Type);
+	}
+
+	bool IsLive(const FCombatScheduledEvent& E) const;
+};
@@ -0,0 +1,105 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "AbilitySystem/CombatCore.h"
+#include "CombatSimulation.generated.h"
+
+class UActionDefinition;
+class UAttributeSetDataAsset;
+
+USTRUCT(BlueprintType)
+struct FCombatSimulationCombatantSpec
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation")
+	FName Name;
+
+	// Combatants on the same team never target each other
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation", meta=(ClampMin="0"))
+	int32 Team = 1;
+
+	// How many copies of this combatant join the fight
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation", meta=(ClampMin="1"))
+	int32 Count = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation")
+	TObjectPtr<UAttributeSetDataAsset> AttributeSet = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation")
+	TArray<TObjectPtr<UActionDefinition>> Actions;
+};
+
+// Designer-authored encounter for headless balancing runs
+UCLASS(BlueprintType)
+class PRODIGYPROJECT_API UCombatSimulationEncounter : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation")
+	TArray<FCombatSimulationCombatantSpec> Combatants;
+
+	// Fights longer than this count as draws
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation", meta=(ClampMin="1"))
+	int32 MaxTurns = 200;
+
+	// If false, the first listed combatant always opens
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Simulation")
+	bool bRandomizeFirstToAct = true;
+
+	// Game thread only
+	bool BuildTemplateState(FCombatCoreState& OutState) const;
+};
+
+struct FCombatSimulationSettings
+{
+	int32 NumRuns = 1000;
+	int32 BaseSeed = 1;
+	int32 MaxTurns = 200;
+	bool bRandomizeFirstToAct = true;
+
+	// Runs per worker task (keeps scheduling overhead low for tiny fights)
+	int32 BatchSize = 64;
+};
+
+struct FCombatSimulationReport
+{
+	int32 NumRuns = 0;
+	int32 Draws = 0;
+	double TotalTurns = 0.0;
+	int32 MinTurns = 0;
+	int32 MaxTurns = 0;
+	double WallSeconds = 0.0;
+
+	// Team -> wins
+	TMap<int32, int32> WinsByTeam;
+
+	// Team -> summed turn counts of the fights that team won
+	TMap<int32, double> TurnsByWinningTeam;
+
+	// Turn-count histogram, TurnBucketSize turns per bucket
+	int32 TurnBucketSize = 5;
+	TArray<int32> TurnHistogram;
+
+	double GetAverageTurns() const { return NumRuns > 0 ? TotalTurns / NumRuns : 0.0; }
+	double GetWinRate(int32 Team) const;
+
+	// Plain-text tables (win rate per team + turn histogram)
+	FString ToTable() const;
+	void LogTable() const;
+};
+
+/**
+ * Batch-runs a template state through ProdigyCombatCore on worker threads.
+ * Each run copies the template and reseeds its RNG with BaseSeed + RunIndex, so results are reproducible.
+ */
+class PRODIGYPROJECT_API FCombatSimulator
+{
+public:
+	static FCombatSimulationReport Run(const FCombatCoreState& Template, const FCombatSimulationSettings& Settings);
+
+	// Convenience: builds the template on the calling (game) thread, then runs
+	static bool RunEncounter(const UCombatSimulationEncounter* Encounter, int32 NumRuns, int32 BaseSeed, FCombatSimulationReport& OutReport);
+};
@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CombatSimulationCommandlet.generated.h"
+
+/**
+ * Headless balancing entry point (no world, no rendering):
+ *   UnrealEditor-Cmd ProdigyProject.uproject -run=CombatSimulation -Encounter=/Game/Path/Asset -Runs=10000 -Seed=1 -nullrhi
+ * Several encounters can be passed as -Encounter=A+B+C.
+ */
+UCLASS()
+class PRODIGYPROJECT_API UCombatSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCombatSimulationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,105 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/ActionTypes.h"
+#include "AbilitySystem/AttributesComponent.h"
+#include "AbilitySystem/CombatTurnQueue.h"
+#include "AbilitySystem/StatusComponent.h"
+
+class UActionDefinition;
+class UAttributeSetDataAsset;
+struct FCombatantTable;
+struct FCombatCoreState;
+
+// Immutable once captured; consecutive snapshots point at the same block until the live section changes
+template<typename T>
+using TCombatSnapshotBlock = TSharedPtr<const T, ESPMode::ThreadSafe>;
+
+// Live section revisions a combatant's blocks were copied at
+struct FCombatantSnapshotRevisions
+{
+	uint32 Values = 0;
+	uint32 Mods = 0;
+	uint32 TurnEffects = 0;
+	uint32 Statuses = 0;
+	uint32 Cooldowns = 0;
+};
+
+struct PRODIGYPROJECT_API FCombatantSnapshot
+{
+	TWeakObjectPtr<AActor> Actor;
+	FName DebugName;
+	int32 Team = 0;
+
+	// Still fighting when captured (dead / removed slots keep their last blocks, nothing is copied for them)
+	bool bInFight = false;
+
+	// Where it stood (tactical movement is undone with the AP it cost)
+	FTransform Transform = FTransform::Identity;
+	float CollisionRadius = 0.f;
+
+	TCombatSnapshotBlock<TArray<FAttributeEntry>> Attributes;
+	TCombatSnapshotBlock<TMap<TWeakObjectPtr<UObject>, FAttrModSource>> ModSources;
+	TCombatSnapshotBlock<TArray<FPeriodicTurnEffect>> TurnEffects;
+	TCombatSnapshotBlock<TArray<FStatusEntry>> Statuses;
+	TCombatSnapshotBlock<TMap<FGameplayTag, FActionCooldownState>> Cooldowns;
+
+	// Config, not state: captured once per slot and shared for the rest of the fight
+	TCombatSnapshotBlock<TArray<const UActionDefinition*>> Actions;
+	TWeakObjectPtr<const UAttributeSetDataAsset> AttributeSet;
+
+	FCombatantSnapshotRevisions Revisions;
+
+	const FAttributeEntry* FindAttribute(const FGameplayTag& Tag) const;
+
+	float GetCurrentValue(const FGameplayTag& Tag) const;
+
+	// Base + captured mods
+	float GetFinalValue(const FGameplayTag& Tag) const;
+
+	bool HasStatus(const FGameplayTag& Tag) const;
+	int32 GetCooldownTurnsRemaining(const FGameplayTag& ActionTag) const;
+};
+
+/**
+ * Encounter state at the start of one turn (UCombatEncounter takes one per BeginTurn).
+ * Sections are copy-on-write: a snapshot only copies the component sections whose revision moved since
+ * the previous snapshot and shares the rest, so a turn where one combatant acted costs one combatant's worth of copies.
+ * Safe to read from any thread once published.
+ */
+struct PRODIGYPROJECT_API FCombatSnapshot
+{
+	// Turns begun in this encounter when it was taken (1 = first turn)
+	int32 TurnNumber = 0;
+
+	int32 CurrentSlot = INDEX_NONE;
+	double TurnClock = 0.0;
+
+	// Everyone still waiting, the current slot already popped
+	FCombatTurnQueue TurnQueue;
+
+	FRandomStream Rng;
+
+	// Index = encounter slot
+	TArray<FCombatantSnapshot> Combatants;
+
+	// Blocks copied for this snapshot / reused from the previous one
+	int32 NumCopiedBlocks = 0;
+	int32 NumSharedBlocks = 0;
+
+	const FCombatantSnapshot* FindCombatant(const AActor* Actor) const;
+};
+
+namespace ProdigyCombatSnapshot
+{
+	// Slot of the live table into Out, sharing every block of Prev (same slot, previous snapshot) whose revision still holds
+	void CaptureCombatant(const FCombatantTable& Table, int32 Slot, bool bInFight, const FCombatantSnapshot* Prev,
+	                      FCombatantSnapshot& Out, int32& InOutCopied, int32& InOutShared);
+
+	// Writes the captured sections back into the slot's components, skipping sections that haven't moved.
+	// Returns false if a component is gone.
+	bool RestoreCombatant(const FCombatantTable& Table, int32 Slot, const FCombatantSnapshot& In, AActor* InstigatorActor);
+
+	// Plain-data fight for the headless core (planner / what-if) built from captured data only
+	bool BuildCoreState(const FCombatSnapshot& Snapshot, FCombatCoreState& OutState, TArray<int32>* OutCoreIndexBySlot = nullptr);
+}
@@ -1,22 +1,57 @@
 ﻿#pragma once
 
+#include "Tickable.h"
+#include "AbilitySystem/CombatBubble.h"
+#include "AbilitySystem/CombatEncounter.h"
+#include "AbilitySystem/CombatLog.h"
 #include "CombatSubsystem.generated.h"
 
 struct FGameplayTag;
-struct FActionContext;
+struct FCombatCoreState;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCombatTurnActorChanged, AActor*, CurrentTurnActor);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCombatStateChanged, bool, bNowInCombat);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnParticipantsChanged);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCombatEncounterStateChanged, FCombatEncounterHandle, Encounter, bool, bActive);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCombatEncounterTurnActorChanged, FCombatEncounterHandle, Encounter, AActor*, CurrentTurnActor);
+
+UENUM(BlueprintType)
+enum class ECombatPlaybackSpeed : uint8
+{
+	Normal    UMETA(DisplayName="1x"),
+	Double    UMETA(DisplayName="2x"),
+	Quadruple UMETA(DisplayName="4x"),
+
+	// No waits: AI turns resolve in the frame they start, cues / damage numbers merged into one pass
+	Instant   UMETA(DisplayName="Instant"),
+};
+
+/**
+ * Owns every running UCombatEncounter.
+ * - Several encounters can run at once; each actor is in at most one.
+ * - The legacy single-fight API (IsInCombat, GetCurrentTurnActor, OnTurnActorChanged...) reflects the
+ *   "primary" encounter: the one the player is fighting in.
+ * - One FCombatScheduler holds every encounter's delayed work and is pumped once per tick.
+ */
 UCLASS()
-class PRODIGYPROJECT_API UCombatSubsystem : public UGameInstanceSubsystem
+class PRODIGYPROJECT_API UCombatSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
 public:
 
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject (pumps the scheduler)
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
 	// Delay between end of one turn and begin of next turn (seconds)
+	// (not after AI actions with FActionTiming phases: their recovery is the pause)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Timing")
 	float BetweenTurnsDelaySeconds = 1.00f;
 
@@ -31,41 +66,164 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Timing")
 	float AITakeActionDelaySeconds = 1.0f;
 
-	// Call this instead of calling BeginTurn directly
-	void ScheduleBeginTurnForIndex(int32 Index, float DelaySeconds);
+	// AI searches its move (FCombatAIPlanner) on a worker during AITakeActionDelaySeconds; off = basic attack
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|AI")
+	bool bUseAIPlanner = true;
 
-	FTimerHandle TimerHandle_AITakeAction;
-	
-	UFUNCTION(BlueprintCallable)
-	void EnterCombat(const TArray<AActor*>& InParticipants, AActor* FirstToAct);
+	// Search time per AI turn, capped below AITakeActionDelaySeconds (no delay = no search)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|AI", meta=(ClampMin="0"))
+	float AIPlanningBudgetSeconds = 0.5f;
+
+	// Turns looked ahead (everyone's turns)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|AI", meta=(ClampMin="1"))
+	int32 AIPlanningMaxDepth = 6;
+
+	// All AI of one side act in a single phase (one AI delay, then staggered back to back) instead of one turn each
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|TeamPhase")
+	bool bTeamPhaseAI = false;
+
+	// Gap between two AI actions inside a phase (their cues / animations overlap)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|TeamPhase", meta=(ClampMin="0"))
+	float TeamPhaseStaggerSeconds = 0.2f;
+
+	// Cap on first-to-last action spread; big teams get a tighter stagger so a round stays about as long
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|TeamPhase", meta=(ClampMin="0"))
+	float TeamPhaseMaxSpreadSeconds = 1.0f;
+
+	// Time given to cues (killing blows) after the deciding death before the encounter ends (0 = next tick)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Timing")
+	float CueWindowSeconds = 0.0f;
+
+	// Scales every combat wait above (and the team phase stagger); applies to waits scheduled from now on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Playback")
+	ECombatPlaybackSpeed PlaybackSpeed = ECombatPlaybackSpeed::Normal;
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Playback")
+	void SetPlaybackSpeed(ECombatPlaybackSpeed NewSpeed);
+
+	bool IsInstantPlayback() const { return PlaybackSpeed == ECombatPlaybackSpeed::Instant; }
+
+	// A combat wait at the current playback speed (0 when Instant)
+	float ScaleDelay(float Seconds) const;
+
+	// Every encounter records a compact replay (Prodigy.Combat.Replay.Save / .Run)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Replay")
+	bool bRecordReplays = true;
+
+	// Event ring size per encounter; oldest events are dropped past this (log flagged incomplete)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Replay", meta=(ClampMin="1024"))
+	int32 ReplayRingCapacityBytes = 64 * 1024;
+
+	// Turn-begin snapshots kept per encounter (rewind, what-if). Unchanged sections are shared between them. 0 = off.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Snapshots", meta=(ClampMin="0"))
+	int32 TurnSnapshotHistory = 8;
+
+	// Coarse sight-line grid over each fight area, filled by async traces at encounter start (range / LOS checks read it)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility")
+	bool bBuildVisibilityGrid = true;
+
+	// Starting cell edge; big fights get coarser cells to stay under VisibilityMaxCells
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="50"))
+	float VisibilityCellSize = 200.f;
+
+	// Pair traces grow with the square of this
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="4"))
+	int32 VisibilityMaxCells = 256;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="0"))
+	float VisibilityMargin = 800.f;
+
+	// Cell pairs further apart aren't precomputed (checked with a trace if ever asked)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="0"))
+	float VisibilityMaxPairDistance = 3000.f;
+
+	// Sight line height above each cell's floor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="0"))
+	float VisibilityEyeHeight = 90.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Visibility", meta=(ClampMin="1"))
+	int32 VisibilityTracesPerBatch = 1024;
+
+	// While any fight runs, whatever is farther than CombatBubbleRadius from every fighter and player is
+	// suspended (movement, AI, status timers) or ticks at CombatBubbleTickInterval. Restored when the last fight ends.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Bubble")
+	bool bCombatBubble = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Bubble", meta=(ClampMin="0"))
+	float CombatBubbleRadius = 3000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Bubble", meta=(ClampMin="0.05"))
+	float CombatBubbleTickInterval = 0.5f;
+
+	// Player-facing log of every fight (actions, damage, heals, statuses, deaths, turns); text is only built when shown
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Log")
+	bool bCombatLog = true;
+
+	// Ring size in entries (~28 bytes each); the oldest are overwritten past this. Applied when a fight starts.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Log", meta=(ClampMin="256"))
+	int32 CombatLogMaxEntries = 128 * 1024;
 
 	bool IsValidCombatant(AActor* A) const;
 
+	// --- Encounters ---
+
+	// Starts an independent fight. Actors already fighting elsewhere are skipped; invalid handle if < 2 remain.
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	FCombatEncounterHandle StartEncounter(const TArray<AActor*>& InParticipants, AActor* FirstToAct);
+
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	void EndEncounter(FCombatEncounterHandle Handle);
+
+	// Adds a combatant to a running encounter; it acts one turn delay after the current turn clock
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool JoinEncounter(FCombatEncounterHandle Handle, AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	UCombatEncounter* GetEncounter(FCombatEncounterHandle Handle) const;
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	FCombatEncounterHandle FindEncounterForActor(AActor* Actor) const;
+
+	UCombatEncounter* FindEncounterObjectForActor(AActor* Actor) const;
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	FCombatEncounterHandle GetPrimaryEncounter() const { return PrimaryHandle; }
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	bool IsActorInCombat(AActor* Actor) const { return FindEncounterForActor(Actor).IsValid(); }
+
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	int32 GetNumActiveEncounters() const { return Encounters.Num(); }
+
+	// --- Legacy single-fight API (primary encounter) ---
+
 	UFUNCTION(BlueprintCallable)
-	void ExitCombat();
+	void EnterCombat(const TArray<AActor*>& InParticipants, AActor* FirstToAct);
 
-	void BeginTurnForIndex(int32 Index);
+	UFUNCTION(BlueprintCallable)
+	void ExitCombat();
 
 	UFUNCTION(BlueprintCallable)
-	bool IsInCombat() const { return bInCombat; }
+	bool IsInCombat() const { return PrimaryHandle.IsValid(); }
 
 	AActor* GetCurrentTurnActor() const;
 
 	UFUNCTION(BlueprintCallable)
 	void AdvanceTurn(); // call after an action resolves
 
-	UFUNCTION()
-	void HandleActionExecuted(FGameplayTag ActionTag, const FActionContext& Context);
-
+	// Routed to the instigator's own encounter
 	UFUNCTION(BlueprintCallable, Category="Combat")
 	bool EndCurrentTurn(AActor* Instigator);
 
-	void PruneParticipants();
+	// Routed to the actor's own encounter (turn-clock units, 1.0 = one turn at speed 100)
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool DelayTurn(AActor* Actor, float TurnTime);
+
+	// Undo for the player: puts Actor's encounter back to the start of Actor's current turn (see UCombatEncounter::RewindTurn)
+	UFUNCTION(BlueprintCallable, Category="Combat")
+	bool RewindTurn(AActor* Actor);
 
-	const TArray<TWeakObjectPtr<AActor>>& GetParticipants() const
-	{
-		return Participants;
-	}
+	const TArray<TWeakObjectPtr<AActor>>& GetParticipants() const;
 
 	UPROPERTY(BlueprintAssignable, Category="Combat|Events")
 	FOnCombatTurnActorChanged OnTurnActorChanged;
@@ -76,25 +234,76 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Combat")
 	FOnParticipantsChanged OnParticipantsChanged;
 
+	// Every encounter (primary or not)
+	UPROPERTY(BlueprintAssignable, Category="Combat|Events")
+	FOnCombatEncounterStateChanged OnEncounterStateChanged;
+
+	UPROPERTY(BlueprintAssignable, Category="Combat|Events")
+	FOnCombatEncounterTurnActorChanged OnEncounterTurnActorChanged;
+
 	UFUNCTION(BlueprintCallable, Category="Combat|Query")
 	AActor* GetCurrentTurnActor_BP() const { return GetCurrentTurnActor(); }
 
-	
+	// Snapshot of the primary fight as plain data (headless simulation / what-if)
+	bool BuildCoreState(FCombatCoreState& OutState) const;
+
+	// Next NumTurns turns of the primary fight (turn in progress first) for the timeline UI.
+	// Maintained incrementally: cheap to call every HUD refresh.
+	UFUNCTION(BlueprintCallable, Category="Combat|Query")
+	TArray<FCombatTimelineEntry> GetTurnTimeline(int32 NumTurns = 8);
+
+	// Primary encounter's replay so far, else the last encounter that ended
+	bool GetLatestReplay(FCombatReplayLog& OutLog) const;
+
+	const FCombatScheduler& GetScheduler() const { return Scheduler; }
+
+	// Recently fired + pending scheduler events to the log (Prodigy.Combat.Scheduler.Trace)
+	void DumpSchedulerTrace() const;
+
+	const FCombatLog& GetCombatLog() const { return CombatLog; }
+
+	// Called by encounters (no-op with bCombatLog off)
+	void AddCombatLog(ECombatLogKind Kind, int32 EncounterId, const AActor* Source, const AActor* Target, FName Tag = NAME_None, float Value = 0.f);
+
+
 private:
 
-	FTimerHandle TimerHandle_BeginTurn;
-	bool bTurnBeginScheduled = false;
+	friend class UCombatEncounter;
 
-	void CancelScheduledBeginTurn();
-	void HandleScheduledBeginTurn();
+	// Called by UCombatEncounter
+	void HandleEncounterStarted(UCombatEncounter* Encounter);
+	void HandleEncounterEnded(UCombatEncounter* Encounter);
+	void HandleEncounterTurnActorChanged(UCombatEncounter* Encounter, AActor* TurnActor);
+	void HandleEncounterParticipantsChanged(UCombatEncounter* Encounter);
+	void UnregisterEncounterActor(const TWeakObjectPtr<AActor>& Actor, FCombatEncounterHandle Handle);
 
-	int32 PendingTurnIndex = INDEX_NONE;
-	
-	bool bInCombat = false;
-	int32 TurnIndex = 0;
-	TArray<TWeakObjectPtr<AActor>> Participants;
+	void ScheduleEncounterEvent(UCombatEncounter* Encounter, ECombatEventType Type, float DelaySeconds,
+	                            int32 Slot = INDEX_NONE, int32 TargetSlot = INDEX_NONE);
+	void CancelEncounterEvent(UCombatEncounter* Encounter, ECombatEventType Type);
+	void CancelEncounterEvents(UCombatEncounter* Encounter);
 
-	UPROPERTY()
-	bool bAdvancingTurn = false;
-};
+	// Scheduler clock: world time, so pause / time dilation behave like the old timers
+	double GetSchedulerTime() const;
+
+	// Fighters of Encounter (or just Actor) plus every player pawn
+	void GatherBubbleCenters(const UCombatEncounter* Encounter, const AActor* Actor, TArray<FVector>& OutCenters) const;
+
+	FCombatBubble Bubble;
+
+	FCombatLog CombatLog;
+
+	FCombatScheduler Scheduler;
 
+	UCombatEncounter* GetPrimaryEncounterObject() const { return GetEncounter(PrimaryHandle); }
+
+	UPROPERTY(Transient)
+	TMap<int32, TObjectPtr<UCombatEncounter>> Encounters;
+
+	TMap<TWeakObjectPtr<AActor>, FCombatEncounterHandle> EncounterByActor;
+
+	FCombatEncounterHandle PrimaryHandle;
+	int32 NextEncounterId = 0;
+
+	// Filled by UCombatEncounter::End
+	FCombatReplayLog LastEndedReplay;
+};
@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "CombatTimeline.generated.h"
+
+class FCombatTurnQueue;
+
+// One upcoming turn in the timeline UI
+USTRUCT(BlueprintType)
+struct PRODIGYPROJECT_API FCombatTimelineEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	TObjectPtr<AActor> Actor = nullptr;
+
+	// 0 = the turn in progress, 1 = next turn...
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	int32 TurnsFromNow = 0;
+
+	// Turn-clock time the turn starts at
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	float ReadyTime = 0.f;
+
+	// AP after OnTurnBegan (refresh to MaxAP + AP turn effects); current AP for the turn in progress
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	float ExpectedAP = 0.f;
+
+	// Statuses that run out at the start of this turn
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	TArray<FGameplayTag> ExpiringStatuses;
+
+	// Periodic effects doing their last tick at the start of this turn
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	TArray<FGameplayTag> ExpiringTurnEffects;
+
+	// Actions whose combat cooldown reaches 0 at the start of this turn
+	UPROPERTY(BlueprintReadOnly, Category="Combat|Timeline")
+	TArray<FGameplayTag> ActionsReady;
+};
+
+// What OnTurnBegan will do to one combatant over its next turns (index 0 = its next turn)
+struct FCombatTimelineProjection
+{
+	struct FTurn
+	{
+		float ExpectedAP = 0.f;
+
+		// Wait until the following turn (statuses as they are after this turn's tick)
+		double DelayAfter = 1.0;
+
+		TArray<FGameplayTag> ExpiringStatuses;
+		TArray<FGameplayTag> ExpiringTurnEffects;
+		TArray<FGameplayTag> ActionsReady;
+	};
+
+	float CurrentAP = 0.f;
+
+	// Wait after the turn in progress (statuses as they are now)
+	double DelayAfterCurrent = 1.0;
+
+	TArray<FTurn> Turns;
+};
+
+/**
+ * Incrementally maintained "next N turns" preview for one encounter.
+ * - Per-combatant projections are cached and only rebuilt when that combatant is marked dirty
+ *   (actions, attribute / status changes, its own turn starting).
+ * - The merged order is rebuilt from the cached projections when the turn queue changes (O(N log n)).
+ * - Queries with nothing dirty return the cached entries.
+ */
+class PRODIGYPROJECT_API FCombatTimeline
+{
+public:
+	void Reset();
+
+	void MarkSlotDirty(int32 Slot);
+	void MarkOrderDirty() { bOrderDirty = true; }
+
+	// True if the cached entries can be returned as-is
+	bool IsUpToDate(int32 NumTurns) const;
+
+	// Slots needing a fresh projection at this depth
+	bool NeedsProjection(int32 Slot, int32 Depth) const;
+	void SetProjection(int32 Slot, FCombatTimelineProjection&& Projection);
+
+	// Merges queued slots (+ the current one) into NumTurns entries. GetActor(Slot) must be non-null for live slots.
+	void Build(int32 NumTurns, int32 CurrentSlot, double TurnClock, const FCombatTurnQueue& Queue, TFunctionRef<AActor*(int32)> GetActor);
+
+	const TArray<FCombatTimelineEntry>& GetEntries() const { return Entries; }
+
+	// Bumped on every rebuild (HUD can skip refreshes)
+	uint32 GetVersion() const { return Version; }
+
+private:
+	TArray<FCombatTimelineProjection> Projections;
+	TBitArray<> DirtySlots;
+
+	bool bOrderDirty = true;
+	int32 BuiltNumTurns = 0;
+	uint32 Version = 0;
+
+	TArray<FCombatTimelineEntry> Entries;
+};
+
+namespace ProdigyCombatTimeline
+{
+	// Game thread: reads AP / speed, statuses, turn effects and cooldowns from the actor's components
+	void ProjectActor(AActor* Actor, int32 Depth, FCombatTimelineProjection& Out);
+}
@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCombatTurnQueueEntry
+{
+	int32 Id = INDEX_NONE;
+
+	// Turn-clock time at which this combatant acts
+	double ReadyTime = 0.0;
+
+	// Insertion order; breaks ReadyTime ties so equal-speed combatants keep a stable order
+	uint32 Sequence = 0;
+};
+
+/**
+ * Initiative queue: indexed binary min-heap keyed on (ReadyTime, Sequence).
+ * - Ids are small non-negative ints (combatant slots), never reused inside one encounter.
+ * - Insert / Remove / Update / Pop are O(log n); Contains / Peek are O(1).
+ * - Plain data, safe to copy into headless simulations.
+ */
+class PRODIGYPROJECT_API FCombatTurnQueue
+{
+public:
+	void Reset();
+
+	// Inserts, or re-times if already queued (re-timing counts as a fresh insert for tie-breaking)
+	void Insert(int32 Id, double ReadyTime);
+
+	bool Remove(int32 Id);
+
+	// Pushes an already-queued combatant back (or forward, if negative)
+	bool Delay(int32 Id, double DeltaTime);
+
+	bool Contains(int32 Id) const;
+
+	// INDEX_NONE when empty
+	int32 Peek() const;
+
+	// INDEX_NONE when empty
+	int32 Pop(double* OutReadyTime = nullptr);
+
+	// Ready time of a queued id (0 if not queued)
+	double GetReadyTime(int32 Id) const;
+
+	int32 Num() const { return Heap.Num(); }
+	bool IsEmpty() const { return Heap.Num() == 0; }
+
+	// Raw heap entries (unordered) for snapshots / debug
+	const TArray<FCombatTurnQueueEntry>& GetEntries() const { return Heap; }
+
+	// First MaxCount entries in acting order (O(k log k) heap walk, queue untouched)
+	void GetOrderedEntries(int32 MaxCount, TArray<FCombatTurnQueueEntry>& OutEntries) const;
+
+private:
+	TArray<FCombatTurnQueueEntry> Heap;
+
+	// Id -> heap index (INDEX_NONE when not queued)
+	TArray<int32> HeapIndexById;
+
+	uint32 NextSequence = 0;
+
+	static bool Less(const FCombatTurnQueueEntry& A, const FCombatTurnQueueEntry& B)
+	{
+		return (A.ReadyTime < B.ReadyTime) || (A.ReadyTime == B.ReadyTime && A.Sequence < B.Sequence);
+	}
+
+	int32 GetHeapIndex(int32 Id) const
+	{
+		return HeapIndexById.IsValidIndex(Id) ? HeapIndexById[Id] : INDEX_NONE;
+	}
+
+	void SwapEntries(int32 A, int32 B);
+	void SiftUp(int32 HeapIndex);
+	void SiftDown(int32 HeapIndex);
+	void RemoveAtHeapIndex(int32 HeapIndex);
+};
@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+struct FTraceDatum;
+struct FTraceHandle;
+
+enum class ECombatLineOfSight : uint8
+{
+	// Outside the grid, no floor there, pair too far apart, or not built yet: caller has to trace
+	Unknown,
+	Visible,
+	Blocked,
+};
+
+/**
+ * Coarse cell-to-cell visibility over one combat area, built once when the fight starts (FCombatVisibilityGridBuilder).
+ * - Every cell has one floor height; sight lines run between cell floors + EyeHeight.
+ * - Only static world geometry blocks sight, combatants never do.
+ * - Immutable once built, so worker threads (AI planner) read it through a shared pointer as is.
+ */
+struct PRODIGYPROJECT_API FCombatVisibilityGrid
+{
+	// Min XY corner
+	FVector2D Origin = FVector2D::ZeroVector;
+	float CellSize = 200.f;
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	float EyeHeight = 90.f;
+
+	// Per cell
+	TArray<float> FloorZ;
+	TBitArray<> HasFloor;
+
+	// NumCells x NumCells, symmetric (Traced = pair was checked at all)
+	TBitArray<> Traced;
+	TBitArray<> Visible;
+
+	int32 NumCells() const { return SizeX * SizeY; }
+
+	// INDEX_NONE outside the grid
+	int32 ToCell(const FVector& Location) const;
+
+	FVector GetEyeLocation(int32 Cell) const;
+
+	// Two cell lookups and a bit test
+	ECombatLineOfSight Query(const FVector& From, const FVector& To) const;
+};
+
+struct FCombatVisibilitySettings
+{
+	// Starting cell edge; grows until the area fits in MaxCells
+	float CellSize = 200.f;
+	int32 MaxCells = 256;
+
+	// Added around the combatants' bounds
+	float Margin = 800.f;
+
+	// Pairs further apart are left Unknown (no action reaches that far)
+	float MaxPairDistance = 3000.f;
+
+	float EyeHeight = 90.f;
+
+	// Traces in flight at once; the next batch goes out when this one is back
+	int32 TracesPerBatch = 1024;
+};
+
+/**
+ * Fills a grid from async traces: one floor trace per cell, then one sight trace per cell pair in reach.
+ * Nothing blocks the game thread; dropping the builder cancels the build (late results hit an unbound delegate).
+ */
+class PRODIGYPROJECT_API FCombatVisibilityGridBuilder : public TSharedFromThis<FCombatVisibilityGridBuilder>
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnBuilt, TSharedPtr<const FCombatVisibilityGrid, ESPMode::ThreadSafe>);
+
+	// Area = bounds of the combatants (the margin is added here)
+	void Start(UWorld* InWorld, const FBox& Area, const FCombatVisibilitySettings& InSettings, FOnBuilt InOnBuilt);
+
+	bool IsBuilding() const { return bBuilding; }
+
+private:
+	void IssueNextBatch();
+	void BuildPairList();
+	void Finish();
+
+	void HandleFloorTrace(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void HandleSightTrace(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	TWeakObjectPtr<UWorld> World;
+	FCombatVisibilitySettings Settings;
+	FOnBuilt OnBuilt;
+
+	TSharedPtr<FCombatVisibilityGrid, ESPMode::ThreadSafe> Grid;
+
+	// Floor traces run from TopZ down to BottomZ
+	float TopZ = 0.f;
+	float BottomZ = 0.f;
+
+	// Packed A * NumCells + B (A < B)
+	TArray<uint32> Pairs;
+
+	int32 NextFloorCell = 0;
+	int32 NextPair = 0;
+	int32 InFlight = 0;
+
+	bool bFloorPhase = true;
+	bool bBuilding = false;
+	double StartTime = 0.0;
+};
+
+namespace ProdigyCombatVisibility
+{
+	// Grid lookup; one synchronous trace between the two points when the grid can't tell (game thread)
+	bool HasLineOfSight(const UWorld* World, const FCombatVisibilityGrid* Grid, const FVector& From, const FVector& To);
+}
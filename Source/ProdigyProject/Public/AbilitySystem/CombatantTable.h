@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UActionComponent;
+class UAttributesComponent;
+class UCombatMovementComponent;
+class UStatusComponent;
+
+/**
+ * Per-encounter combatant data, struct-of-arrays indexed by slot (slots never shift inside one encounter).
+ * - Components, team and player / agent flags are resolved once, when the combatant enters the fight.
+ * - Liveness is cached and only flipped by events (UAttributesComponent::OnDiedNative, actor destroyed),
+ *   so turn transitions do no component searches or interface calls.
+ */
+struct PRODIGYPROJECT_API FCombatantTable
+{
+	TArray<TWeakObjectPtr<AActor>> Actors;
+
+	// ProdigyCombatCore::ResolveTeamForActor at join (explicit team / faction, never the controller)
+	TArray<int32> Teams;
+
+	// Index into UCombatEncounter::Participants while in the fight, INDEX_NONE once removed
+	TArray<int32> ParticipantIndices;
+
+	TArray<TWeakObjectPtr<UActionComponent>> ActionComponents;
+	TArray<TWeakObjectPtr<UAttributesComponent>> AttributeComponents;
+	TArray<TWeakObjectPtr<UStatusComponent>> StatusComponents;
+	TArray<TWeakObjectPtr<UCombatMovementComponent>> MovementComponents;
+
+	// Cached "not dead"
+	TBitArray<> Alive;
+
+	// Player-controlled when the combatant joined
+	TBitArray<> Players;
+
+	// Implements UActionAgentInterface
+	TBitArray<> Agents;
+
+	void Reset();
+
+	int32 Num() const { return Actors.Num(); }
+	bool IsValidIndex(int32 Slot) const { return Actors.IsValidIndex(Slot); }
+
+	// Resolves everything for a new combatant; returns its slot
+	int32 Add(AActor* Actor, int32 ParticipantIndex);
+
+	// Re-reads Health / death state (component first, interface fallback). Returns the new liveness.
+	bool RefreshAlive(int32 Slot);
+
+	// Still in the fight, not dead, actor not gone
+	bool IsInFight(int32 Slot) const
+	{
+		if (!IsValidIndex(Slot) || ParticipantIndices[Slot] == INDEX_NONE || !Alive[Slot]) return false;
+
+		const AActor* A = Actors[Slot].Get();
+		return A && !A->IsActorBeingDestroyed();
+	}
+
+	bool IsPlayer(int32 Slot) const { return IsValidIndex(Slot) && Players[Slot]; }
+};
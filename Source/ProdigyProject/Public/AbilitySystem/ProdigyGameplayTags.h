@@ -49,6 +49,10 @@ namespace ProdigyTags::Status
 	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Stealthed);
 	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Surprised);
 	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Bleeding);
+
+	// Initiative
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Hasted);
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Slowed);
 }
 
 // =======================
@@ -74,6 +78,8 @@ namespace ProdigyTags::Attr
 
 	UE_DECLARE_GAMEPLAY_TAG_EXTERN(AP);
 	UE_DECLARE_GAMEPLAY_TAG_EXTERN(MaxAP);
+
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Speed);
 }
 
 namespace ActionCueTags
@@ -25,6 +25,11 @@ struct FStatusEntry
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnStatusChanged, FGameplayTag, StatusTag, bool, bAdded);
 
+class UStatusComponent;
+
+// Native twin of FOnStatusChanged that also carries the source component
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnStatusChangedNative, UStatusComponent* /*Source*/, FGameplayTag /*StatusTag*/, bool /*bAdded*/);
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class PRODIGYPROJECT_API UStatusComponent : public UActorComponent
 {
@@ -39,6 +44,9 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnStatusChanged OnStatusChanged;
 
+	// Same events as OnStatusChanged, plus duration refreshes (bAdded = true), for native listeners
+	FOnStatusChangedNative OnStatusChangedNative;
+
 	// Active statuses
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Status")
 	TArray<FStatusEntry> Statuses;
@@ -71,6 +79,8 @@ public:
 			{
 				E.TurnsRemaining = FMath::Max(E.TurnsRemaining, Turns);
 				E.SecondsRemaining = FMath::Max(E.SecondsRemaining, Seconds);
+				++Revision;
+				OnStatusChangedNative.Broadcast(this, Tag, true);
 				return true;
 			}
 		}
@@ -82,7 +92,9 @@ public:
 
 		Statuses.Add(NewE);
 		OwnedTags.AddTag(Tag);
+		++Revision;
 		OnStatusChanged.Broadcast(Tag, true);
+		OnStatusChangedNative.Broadcast(this, Tag, true);
 		return true;
 	}
 
@@ -95,7 +107,9 @@ public:
 		if (Removed > 0)
 		{
 			OwnedTags.RemoveTag(Tag);
+			++Revision;
 			OnStatusChanged.Broadcast(Tag, false);
+			OnStatusChangedNative.Broadcast(this, Tag, false);
 			return true;
 		}
 		return false;
@@ -107,6 +121,9 @@ public:
 	{
 		bool bChanged = false;
 
+		// Durations move even when nothing expires
+		++Revision;
+
 		for (int32 i = Statuses.Num() - 1; i >= 0; --i)
 		{
 			FStatusEntry& E = Statuses[i];
@@ -118,6 +135,7 @@ public:
 				Statuses.RemoveAtSwap(i);
 				OwnedTags.RemoveTag(Tag);
 				OnStatusChanged.Broadcast(Tag, false);
+				OnStatusChangedNative.Broadcast(this, Tag, false);
 				bChanged = true;
 			}
 		}
@@ -125,6 +143,51 @@ public:
 		(void)bChanged;
 	}
 
+	// Bumped by every add / remove / turn tick (combat snapshots share their last copy while it holds).
+	// Writing Statuses directly bypasses it.
+	uint32 GetRevision() const { return Revision; }
+
+	// Snapshot rewind: replaces the live list, broadcasting removed / added tags so listeners resync
+	void RestoreStatuses(const TArray<FStatusEntry>& InStatuses)
+	{
+		TArray<FGameplayTag, TInlineAllocator<8>> Removed;
+		for (const FStatusEntry& E : Statuses)
+		{
+			if (!InStatuses.ContainsByPredicate([&](const FStatusEntry& In){ return In.Tag == E.Tag; }))
+			{
+				Removed.Add(E.Tag);
+			}
+		}
+
+		TArray<FGameplayTag, TInlineAllocator<8>> Added;
+		for (const FStatusEntry& In : InStatuses)
+		{
+			if (!OwnedTags.HasTagExact(In.Tag))
+			{
+				Added.Add(In.Tag);
+			}
+		}
+
+		Statuses = InStatuses;
+		OwnedTags.Reset();
+		for (const FStatusEntry& E : Statuses)
+		{
+			OwnedTags.AddTag(E.Tag);
+		}
+		++Revision;
+
+		for (const FGameplayTag& Tag : Removed)
+		{
+			OnStatusChanged.Broadcast(Tag, false);
+			OnStatusChangedNative.Broadcast(this, Tag, false);
+		}
+		for (const FGameplayTag& Tag : Added)
+		{
+			OnStatusChanged.Broadcast(Tag, true);
+			OnStatusChangedNative.Broadcast(this, Tag, true);
+		}
+	}
+
 protected:
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override
 	{
@@ -144,8 +207,13 @@ protected:
 				const FGameplayTag Tag = E.Tag;
 				Statuses.RemoveAtSwap(i);
 				OwnedTags.RemoveTag(Tag);
+				++Revision;
 				OnStatusChanged.Broadcast(Tag, false);
+				OnStatusChangedNative.Broadcast(this, Tag, false);
 			}
 		}
 	}
+
+private:
+	uint32 Revision = 0;
 };
@@ -1 +1,61 @@
 ﻿#include "WorldCombatEvents.h"
+
+void UWorldCombatEvents::BroadcastBatch(const TArray<FWorldCombatEvent>& Events)
+{
+	if (Events.Num() == 0) return;
+
+	if (CoalesceDepth > 0)
+	{
+		for (const FWorldCombatEvent& E : Events)
+		{
+			FWorldCombatEvent* Merged = CoalescedEvents.FindByPredicate([&E](const FWorldCombatEvent& M)
+			{
+				return M.TargetActor == E.TargetActor && M.bHeal == E.bHeal;
+			});
+
+			if (!Merged)
+			{
+				CoalescedEvents.Add(E);
+				continue;
+			}
+
+			// First OldHP, last NewHP
+			Merged->Amount += E.Amount;
+			Merged->NewHP = E.NewHP;
+			Merged->InstigatorActor = E.InstigatorActor;
+		}
+		return;
+	}
+
+	OnWorldCombatEventBatch.Broadcast(Events);
+
+	if (!OnWorldDamageEvent.IsBound() && !OnWorldHealEvent.IsBound()) return;
+
+	for (const FWorldCombatEvent& E : Events)
+	{
+		if (E.bHeal)
+		{
+			OnWorldHealEvent.Broadcast(E.TargetActor, E.InstigatorActor, E.Amount, E.OldHP, E.NewHP);
+		}
+		else
+		{
+			OnWorldDamageEvent.Broadcast(E.TargetActor, E.InstigatorActor, E.Amount, E.OldHP, E.NewHP);
+		}
+	}
+}
+
+void UWorldCombatEvents::BeginCoalesce()
+{
+	++CoalesceDepth;
+}
+
+void UWorldCombatEvents::EndCoalesce()
+{
+	if (CoalesceDepth <= 0) return;
+	if (--CoalesceDepth > 0) return;
+
+	const TArray<FWorldCombatEvent> Events = MoveTemp(CoalescedEvents);
+	CoalescedEvents.Reset();
+
+	BroadcastBatch(Events);
+}
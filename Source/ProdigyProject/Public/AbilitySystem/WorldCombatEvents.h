@@ -22,6 +22,28 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(
 	float, NewHP
 );
 
+// One damage / heal result inside a batch (an action's hits, flushed together)
+USTRUCT(BlueprintType)
+struct FWorldCombatEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly) TObjectPtr<AActor> TargetActor = nullptr;
+	UPROPERTY(BlueprintReadOnly) TObjectPtr<AActor> InstigatorActor = nullptr;
+
+	// Positive; bHeal tells which way it went
+	UPROPERTY(BlueprintReadOnly) float Amount = 0.f;
+	UPROPERTY(BlueprintReadOnly) bool bHeal = false;
+
+	UPROPERTY(BlueprintReadOnly) float OldHP = 0.f;
+	UPROPERTY(BlueprintReadOnly) float NewHP = 0.f;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+	FOnWorldCombatEventBatch,
+	const TArray<FWorldCombatEvent>&, Events
+);
+
 UCLASS()
 class PRODIGYPROJECT_API UWorldCombatEvents : public UWorldSubsystem
 {
@@ -32,4 +54,19 @@ public:
 
 	UPROPERTY(BlueprintAssignable)
 	FOnWorldHealEvent OnWorldHealEvent;
+
+	// Every hit of one action in a single broadcast (prefer this over the per-hit events)
+	UPROPERTY(BlueprintAssignable)
+	FOnWorldCombatEventBatch OnWorldCombatEventBatch;
+
+	// Batch listeners once, then the per-hit events (only walked if someone still listens to them)
+	void BroadcastBatch(const TArray<FWorldCombatEvent>& Events);
+
+	// Instant combat playback: batches in between merge per target (and damage / heal) into one broadcast
+	void BeginCoalesce();
+	void EndCoalesce();
+
+private:
+	int32 CoalesceDepth = 0;
+	TArray<FWorldCombatEvent> CoalescedEvents;
 };
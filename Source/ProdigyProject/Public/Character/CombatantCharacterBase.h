@@ -11,6 +11,7 @@
 #include "CombatantCharacterBase.generated.h"
 
 class UActionComponent;
+class UCombatMovementComponent;
 class UStatusComponent;
 class UHealthBarWidgetComponent;
 
@@ -23,6 +24,30 @@ public:
 	ACombatantCharacterBase();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// ---- Team ----
+
+	// Same team = allies in a fight (targeting, area effects, who won). INDEX_NONE = from AggroFaction
+	// (no faction either = the unaligned team). The player controller puts an unset pawn on the player team.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Combat|Team", meta=(ClampMin="-1"))
+	int32 CombatTeam = INDEX_NONE;
+
+	// ---- Aggro (UCombatAggroSubsystem) ----
+
+	// Same faction = fight together: pulling one pulls the others nearby. None = only its link group.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Aggro")
+	FName AggroFaction = NAME_None;
+
+	// Everyone in the group joins when one of them is pulled, wherever they stand
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Aggro")
+	FName AggroLinkGroup = NAME_None;
+
+	// Starts a fight on its own when a player comes this close while exploring (0 = never)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Combat|Aggro", meta=(ClampMin="0"))
+	float AggroRadius = 0.f;
+
+	bool IsDead() const { return IsValid(Attributes) && Attributes->IsDead(); }
 
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Combat|Components")
@@ -34,6 +59,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Combat|Components")
 	TObjectPtr<UAttributesComponent> Attributes = nullptr;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Combat|Components")
+	TObjectPtr<UCombatMovementComponent> CombatMovement = nullptr;
+
 	UPROPERTY(Transient)
 	bool bDidRagdoll = false;
 
@@ -41,7 +69,7 @@ protected:
 	void EnableRagdoll();
 
 	UFUNCTION()
-	void HandleDeathIfNeeded(FGameplayTag Tag, float NewValue, float Delta, AActor* InstigatorActor);
+	void HandleDeathIfNeeded(AActor* Killer, FGameplayTag ResourceTag);
 
 	UPROPERTY(Transient)
 	TObjectPtr<UHealthBarWidgetComponent> WorldHealthBar = nullptr;
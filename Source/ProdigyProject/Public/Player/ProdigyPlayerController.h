@@ -1,10 +1,11 @@
-// Fill out your copyright notice in the Description page of Project Settings.
+﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #pragma once
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "AbilitySystem/ActionTypes.h"
+#include "AbilitySystem/WorldCombatEvents.h"
 #include "ProdigyInventory/InvPlayerController.h"
 #include "Quest/Interfaces/QuestInventoryProvider.h"
 #include "ProdigyPlayerController.generated.h"
@@ -84,6 +85,9 @@ public:
 	UFUNCTION()
 	void ShowDamageNumber(float DamageAmount, ACharacter* TargetCharacter);
 
+	UFUNCTION()
+	void HandleWorldCombatEventBatch(const TArray<FWorldCombatEvent>& Events);
+
 	UFUNCTION()
 	void HandleWorldDamageEvent(AActor* TargetActor, AActor* InstigatorActor, float AppliedDamage, float OldHP, float NewHP);
 
@@ -104,6 +108,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Combat|Abilities")
 	bool TryUseAbilityOnLockedTarget(FGameplayTag AbilityTag);
 
+	// Tactical move to the ground under the cursor (path + AP cost for hover, click spends it)
+	UFUNCTION(BlueprintCallable, Category="Combat|Movement")
+	bool UI_GetMovePreviewUnderCursor(TArray<FVector>& OutPath, int32& OutAPCost);
+
+	bool TryCombatMoveUnderCursor();
+
 	UFUNCTION(BlueprintCallable, Category="Combat|Abilities")
 	void EndTurn();
 
@@ -141,6 +151,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category="UI")
 	void UI_StartFight();
 
+	// Everyone a fight on Target pulls in (UCombatAggroSubsystem), player included
+	void GatherFightParticipants(APawn* P, AActor* Target, TArray<AActor*>& OutParts) const;
+
 	UFUNCTION(BlueprintCallable, Category="UI")
 	void UI_EndTurn();
 
@@ -222,6 +235,10 @@ protected:
 	UFUNCTION()
 	void HandleTurnChanged_ForHUD();
 
+	// Cooldown started / ready: the only cooldown changes buttons need to repaint for
+	UFUNCTION()
+	void HandleCooldownChanged_ForHUD(FGameplayTag ActionTag, bool bReady);
+
 private:
 	void CacheComponents();
 
@@ -386,6 +386,16 @@ OutOperation = nullptr;
 }
 
 void UProdigyHotbarSlotWidget::Refresh()
+{
+	RefreshInternal(nullptr);
+}
+
+void UProdigyHotbarSlotWidget::RefreshWithQuery(const FActionQueryResult& Query)
+{
+	RefreshInternal(&Query);
+}
+
+void UProdigyHotbarSlotWidget::RefreshInternal(const FActionQueryResult* Query)
 {
 	AProdigyPlayerController* PC = GetOwningPlayer<AProdigyPlayerController>();
 
@@ -483,7 +493,7 @@ void UProdigyHotbarSlotWidget::Refresh()
 			QtyText->SetVisibility(ESlateVisibility::Hidden);
 		}
 
-		// Avoid invalid-target cue spam
+		// Target mode gating first (cheap, and the slot stays blank instead of showing a stale cooldown)
 		FActionContext Ctx;
 		Ctx.Instigator  = P;
 		Ctx.TargetActor = PC->GetLockedTarget();
@@ -517,7 +527,7 @@ void UProdigyHotbarSlotWidget::Refresh()
 			return;
 		}
 
-		const FActionQueryResult Q = AC->QueryAction(E.AbilityTag, Ctx);
+		const FActionQueryResult Q = Query ? *Query : AC->QueryAction(E.AbilityTag, Ctx);
 
 		bool bEnabled = Q.bCanExecute;
 
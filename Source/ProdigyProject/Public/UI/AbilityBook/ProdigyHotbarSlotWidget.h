@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
 #include "GameplayTagContainer.h"
+#include "AbilitySystem/ActionTypes.h"
 #include "ProdigyHotbarWidget.h"
 #include "ProdigyHotbarSlotWidget.generated.h"
 
@@ -23,6 +24,9 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category="Hotbar")
 	void Refresh();
+
+	// Refresh with the ability query already done (UProdigyHotbarWidget queries all slots at once)
+	void RefreshWithQuery(const FActionQueryResult& Query);
 	
 	UPROPERTY(EditDefaultsOnly, Category="Hotbar|Tooltip")
 	TSubclassOf<UProdigyAbilityTooltipWidget> AbilityTooltipClass;
@@ -61,6 +65,9 @@ private:
 
 	void ApplyVisuals(bool bEnabled, const FText& InCooldownText);
 
+	// Query: precomputed ability query, null = ask the action component
+	void RefreshInternal(const FActionQueryResult* Query);
+
 	// Finds first slot with this ItemID, returns INDEX_NONE if not found
 	int32 FindFirstItemSlotByID(class UInventoryComponent* Inv, FName ItemID) const;
 };
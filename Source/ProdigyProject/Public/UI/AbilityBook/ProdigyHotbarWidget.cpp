@@ -4,6 +4,7 @@
 #include "Components/PanelWidget.h"
 
 #include "ProdigyHotbarSlotWidget.h"
+#include "AbilitySystem/ActionComponent.h"
 #include "Components/HorizontalBox.h"
 #include "Player/ProdigyPlayerController.h"
 
@@ -144,9 +145,48 @@ FProdigyHotbarEntry UProdigyHotbarWidget::GetSlotEntry(int32 SlotIndex) const
 
 void UProdigyHotbarWidget::RefreshAllSlots()
 {
-	for (UProdigyHotbarSlotWidget* W : SlotWidgets)
+	// Ability slots are queried in one pass (instigator tags / AP / cooldowns read once)
+	const AProdigyPlayerController* PC = GetOwningPlayer<AProdigyPlayerController>();
+	APawn* P = PC ? PC->GetPawn() : nullptr;
+	const UActionComponent* AC = IsValid(P) ? P->FindComponentByClass<UActionComponent>() : nullptr;
+
+	TArray<FGameplayTag, TInlineAllocator<16>> QueryTags;
+	TArray<int32, TInlineAllocator<16>> QueryBySlot;
+	QueryBySlot.Init(INDEX_NONE, SlotWidgets.Num());
+
+	if (AC)
+	{
+		for (int32 i = 0; i < SlotWidgets.Num(); ++i)
+		{
+			const FProdigyHotbarEntry Entry = GetSlotEntry(i);
+			if (Entry.bEnabled && Entry.Type == EProdigyHotbarEntryType::Ability && Entry.AbilityTag.IsValid())
+			{
+				QueryBySlot[i] = QueryTags.Add(Entry.AbilityTag);
+			}
+		}
+	}
+
+	TArray<FActionQueryResult, TInlineAllocator<16>> Queries;
+	if (QueryTags.Num() > 0)
 	{
-		if (IsValid(W))
+		FActionContext Ctx;
+		Ctx.Instigator = P;
+		Ctx.TargetActor = PC->GetLockedTarget();
+
+		Queries.SetNum(QueryTags.Num());
+		AC->QueryActions(QueryTags, Ctx, Queries);
+	}
+
+	for (int32 i = 0; i < SlotWidgets.Num(); ++i)
+	{
+		UProdigyHotbarSlotWidget* W = SlotWidgets[i];
+		if (!IsValid(W)) continue;
+
+		if (QueryBySlot[i] != INDEX_NONE)
+		{
+			W->RefreshWithQuery(Queries[QueryBySlot[i]]);
+		}
+		else
 		{
 			W->Refresh();
 		}
@@ -157,6 +157,14 @@ void UProdigyCombatHUDWidget::Refresh()
 	// If your widget stores the tag internally, you can swap Tag = AbilityTags[i] -> W->GetAbilityTag().
 	const int32 Num = FMath::Min(AbilityButtonWidgets.Num(), AbilityTags.Num());
 
+	// Every button in one pass (instigator tags / AP read once)
+	TArray<FActionQueryResult, TInlineAllocator<16>> Queries;
+	if (bCanEvaluateAbilities)
+	{
+		Queries.SetNum(Num);
+		AC->QueryActions(MakeArrayView(AbilityTags.GetData(), Num), Ctx, Queries);
+	}
+
 	for (int32 i = 0; i < Num; ++i)
 	{
 		UProdigyAbilityButtonWidget* W = AbilityButtonWidgets[i];
@@ -166,9 +174,7 @@ void UProdigyCombatHUDWidget::Refresh()
 
 		if (bEnable)
 		{
-			const FGameplayTag Tag = AbilityTags[i];
-
-			const FActionQueryResult Q = AC->QueryAction(Tag, Ctx);
+			const FActionQueryResult& Q = Queries[i];
 
 			// Disable ONLY if the ability is on turn-based cooldown
 			if (Q.FailReason == EActionFailReason::OnCooldown && Q.CooldownTurns > 0)
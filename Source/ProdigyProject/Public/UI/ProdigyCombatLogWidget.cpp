@@ -0,0 +1,140 @@
+﻿#include "ProdigyCombatLogWidget.h"
+
+#include "AbilitySystem/CombatLog.h"
+#include "AbilitySystem/CombatSubsystem.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/TextBlock.h"
+#include "Components/VerticalBox.h"
+#include "Engine/GameInstance.h"
+
+void UProdigyCombatLogWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	RebuildRows();
+	RefreshRows(true);
+}
+
+void UProdigyCombatLogWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	RefreshRows(false);
+}
+
+FReply UProdigyCombatLogWidget::NativeOnMouseWheel(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent)
+{
+	// Wheel up = older entries
+	const float Delta = InMouseEvent.GetWheelDelta();
+	if (FMath::IsNearlyZero(Delta))
+	{
+		return Super::NativeOnMouseWheel(InGeometry, InMouseEvent);
+	}
+
+	ScrollBy(Delta > 0.f ? -WheelRows : WheelRows);
+	return FReply::Handled();
+}
+
+const FCombatLog* UProdigyCombatLogWidget::GetLog() const
+{
+	const UGameInstance* GI = GetGameInstance();
+	const UCombatSubsystem* Combat = GI ? GI->GetSubsystem<UCombatSubsystem>() : nullptr;
+	return Combat ? &Combat->GetCombatLog() : nullptr;
+}
+
+void UProdigyCombatLogWidget::RebuildRows()
+{
+	Rows.Reset();
+	if (!RowBox) return;
+
+	for (UWidget* Child : RowBox->GetAllChildren())
+	{
+		if (UTextBlock* Text = Cast<UTextBlock>(Child))
+		{
+			Rows.Add(Text);
+		}
+	}
+
+	while (Rows.Num() < VisibleRows && WidgetTree)
+	{
+		UTextBlock* Text = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass());
+		RowBox->AddChildToVerticalBox(Text);
+		Rows.Add(Text);
+	}
+
+	ShownTop = MAX_uint64;
+}
+
+void UProdigyCombatLogWidget::ScrollBy(int32 InRows)
+{
+	const FCombatLog* Log = GetLog();
+	if (!Log || InRows == 0) return;
+
+	const uint64 First = Log->GetFirstSequence();
+	const uint64 End = Log->GetEndSequence();
+	const uint64 NumRows = static_cast<uint64>(Rows.Num());
+	const uint64 MaxTop = End > First + NumRows ? End - NumRows : First;
+
+	const uint64 From = bFollowNewest ? MaxTop : FMath::Clamp(TopSequence, First, MaxTop);
+	const int64 To = static_cast<int64>(From) + InRows;
+
+	// Scrolling back to the bottom resumes following
+	if (To >= static_cast<int64>(MaxTop))
+	{
+		bFollowNewest = true;
+	}
+	else
+	{
+		bFollowNewest = false;
+		TopSequence = static_cast<uint64>(FMath::Max<int64>(static_cast<int64>(First), To));
+	}
+
+	RefreshRows(false);
+}
+
+void UProdigyCombatLogWidget::ScrollToNewest()
+{
+	bFollowNewest = true;
+	RefreshRows(false);
+}
+
+void UProdigyCombatLogWidget::RefreshRows(bool bForce)
+{
+	const FCombatLog* Log = GetLog();
+
+	const uint64 First = Log ? Log->GetFirstSequence() : 0;
+	const uint64 End = Log ? Log->GetEndSequence() : 0;
+	const uint64 NumRows = static_cast<uint64>(Rows.Num());
+	const uint64 MaxTop = End > First + NumRows ? End - NumRows : First;
+
+	// Entries scrolled to can drop out of the ring underneath: clamp to what's still there
+	const uint64 Top = bFollowNewest ? MaxTop : FMath::Clamp(TopSequence, First, MaxTop);
+	TopSequence = Top;
+
+	if (!bForce && Top == ShownTop && End == ShownEnd) return;
+
+	// A new entry below a window that is already full changes nothing on screen except the position
+	const bool bRowsChanged = bForce || Top != ShownTop || FMath::Min(End, Top + NumRows) != FMath::Min(ShownEnd, ShownTop + NumRows);
+
+	ShownTop = Top;
+	ShownEnd = End;
+
+	if (bRowsChanged)
+	{
+		for (int32 i = 0; i < Rows.Num(); ++i)
+		{
+			UTextBlock* Row = Rows[i];
+			if (!Row) continue;
+
+			const FCombatLogEntry* Entry = Log ? Log->FindBySequence(Top + i) : nullptr;
+			Row->SetText(Entry ? FText::FromString(Log->FormatEntry(*Entry)) : FText::GetEmpty());
+		}
+	}
+
+	if (PositionText)
+	{
+		PositionText->SetText(End > First
+			? FText::FromString(FString::Printf(TEXT("%llu-%llu / %llu"), Top + 1, FMath::Min(End, Top + NumRows), End))
+			: FText::GetEmpty());
+	}
+}
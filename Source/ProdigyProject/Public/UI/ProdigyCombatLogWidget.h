@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ProdigyCombatLogWidget.generated.h"
+
+class FCombatLog;
+class UTextBlock;
+class UVerticalBox;
+
+/**
+ * Scrollable view of UCombatSubsystem's combat log.
+ * - A fixed set of VisibleRows text blocks is reused for whatever window is scrolled to; only those entries get formatted.
+ * - Sticks to the newest entry until the player scrolls up, and again once scrolled back down.
+ */
+UCLASS()
+class PRODIGYPROJECT_API UProdigyCombatLogWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CombatLog", meta=(ClampMin="1"))
+	int32 VisibleRows = 12;
+
+	// Rows per mouse wheel notch
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CombatLog", meta=(ClampMin="1"))
+	int32 WheelRows = 3;
+
+	UFUNCTION(BlueprintCallable, Category="CombatLog")
+	void ScrollBy(int32 Rows);
+
+	UFUNCTION(BlueprintCallable, Category="CombatLog")
+	void ScrollToNewest();
+
+protected:
+	virtual void NativeConstruct() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	virtual FReply NativeOnMouseWheel(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+private:
+	// Required binding in WBP. Text blocks already placed in it are used as rows (style them there);
+	// plain ones are added up to VisibleRows.
+	UPROPERTY(meta=(BindWidget)) TObjectPtr<UVerticalBox> RowBox = nullptr;
+
+	// Optional "120-131 / 4051"
+	UPROPERTY(meta=(BindWidgetOptional)) TObjectPtr<UTextBlock> PositionText = nullptr;
+
+	UPROPERTY(Transient) TArray<TObjectPtr<UTextBlock>> Rows;
+
+	// Sequence number of the top row (only used while not following)
+	uint64 TopSequence = 0;
+	bool bFollowNewest = true;
+
+	// Window the rows currently show; nothing is reformatted while it stays the same
+	uint64 ShownTop = MAX_uint64;
+	uint64 ShownEnd = MAX_uint64;
+
+	const FCombatLog* GetLog() const;
+
+	void RebuildRows();
+	void RefreshRows(bool bForce);
+};